@@ -55,10 +55,20 @@ list(APPEND SOURCE_FILES
 
         "src/Renderer/RenderSystemV2.cpp"
         "src/Renderer/GraphicsPipeline.cpp"
+        "src/Renderer/ShaderDataPacking.cpp"
+        "src/Renderer/ShaderReflection.cpp"
+        "src/Renderer/UniformFrameAllocator.cpp"
+        "src/Renderer/ShaderHotReloader.cpp"
+        "src/Renderer/ShaderPermutation.cpp"
         "src/Renderer/GraphicsContext.cpp"
         "src/Renderer/CommandBuffer.cpp"
         "src/Renderer/Event.cpp"
         "src/Renderer/Texture2D.cpp"
+        "src/Renderer/TextureResidency.cpp"
+        "src/Renderer/TextureRegistry.cpp"
+        "src/Renderer/TextureDecoder.cpp"
+        "src/Renderer/BlockCompression.cpp"
+        "src/Renderer/MipGenerator.cpp"
         "src/Renderer/TextureResource.cpp"
         "src/Renderer/TextureView.cpp"
         "src/Renderer/Swapchain.cpp"
@@ -86,6 +96,21 @@ list(APPEND SOURCE_FILES
         "src/Core/Scene.cpp"
         "src/Core/Light.cpp"
         "src/Core/GenericFactory.cpp"
+        "src/Core/FileWatcher.cpp"
+        "src/Core/TransformHierarchy.cpp"
+        "src/Core/TransformKernels.cpp"
+        "src/Core/JobSystem.cpp"
+        "src/Core/FrustumCulling.cpp"
+        "src/Core/VisibilitySet.cpp"
+        "src/Core/DynamicBVH.cpp"
+        "src/Core/SpatialIndex.cpp"
+        "src/Core/OcclusionBuffer.cpp"
+        "src/Core/MeshSimplifier.cpp"
+        "src/Core/Meshlets.cpp"
+        "src/Core/MeshOptimizer.cpp"
+        "src/Core/MappedFile.cpp"
+        "src/Core/CookedMesh.cpp"
+        "src/Core/ImportCache.cpp"
 
         "src/application.cpp"
         "src/window.cpp"
@@ -103,15 +128,26 @@ list(APPEND INCLUDE_FILES
         "includes/Components/PrimitiveProxyComponent.hpp"
         "includes/Components/GridMaterialComponent.hpp"
         "includes/Components/MatCapMaterialComponent.hpp"
+        "includes/Components/BoundsComponent.hpp"
 
         "includes/Window/Desktop/DesktopWindow.hpp"
 
         "includes/Renderer/RenderSystemV2.hpp"
         "includes/Renderer/GraphicsPipeline.hpp"
+        "includes/Renderer/ShaderDataPacking.hpp"
+        "includes/Renderer/ShaderReflection.hpp"
+        "includes/Renderer/UniformFrameAllocator.hpp"
+        "includes/Renderer/ShaderHotReloader.hpp"
+        "includes/Renderer/ShaderPermutation.hpp"
         "includes/Renderer/GraphicsContext.hpp"
         "includes/Renderer/CommandBuffer.hpp"
         "includes/Renderer/Event.hpp"
         "includes/Renderer/Texture2D.hpp"
+        "includes/Renderer/TextureResidency.hpp"
+        "includes/Renderer/TextureRegistry.hpp"
+        "includes/Renderer/TextureDecoder.hpp"
+        "includes/Renderer/BlockCompression.hpp"
+        "includes/Renderer/MipGenerator.hpp"
         "includes/Renderer/TextureResource.hpp"
         "includes/Renderer/TextureView.hpp"
         "includes/Renderer/Swapchain.hpp"
@@ -129,6 +165,10 @@ list(APPEND INCLUDE_FILES
         "includes/Renderer/CommandEncoders/BlitCommandEncoder.hpp"
         "includes/Renderer/Processors/MaterialProcessors.hpp"
         "includes/Renderer/Processors/TransformProcessor.hpp"
+        "includes/Renderer/Processors/VisibilityProcessor.hpp"
+        "includes/Renderer/Processors/LodProcessor.hpp"
+        "includes/Renderer/Processors/MeshletProcessor.hpp"
+        "includes/Renderer/Processors/TextureStreamingProcessor.hpp"
         "includes/Renderer/Processors/GeometryProcessors.hpp"
         "includes/Renderer/RenderPass/RenderPassRegistration.inl"
         "includes/Renderer/RenderPass/RenderPassInterface.hpp"
@@ -149,6 +189,21 @@ list(APPEND INCLUDE_FILES
         "includes/Core/GenericInstanceWrapper.hpp"
         "includes/Core/Light.hpp"
         "includes/Core/GenericFactory.hpp"
+        "includes/Core/FileWatcher.hpp"
+        "includes/Core/TransformHierarchy.hpp"
+        "includes/Core/TransformKernels.hpp"
+        "includes/Core/JobSystem.hpp"
+        "includes/Core/FrustumCulling.hpp"
+        "includes/Core/VisibilitySet.hpp"
+        "includes/Core/DynamicBVH.hpp"
+        "includes/Core/SpatialIndex.hpp"
+        "includes/Core/OcclusionBuffer.hpp"
+        "includes/Core/MeshSimplifier.hpp"
+        "includes/Core/Meshlets.hpp"
+        "includes/Core/MeshOptimizer.hpp"
+        "includes/Core/MappedFile.hpp"
+        "includes/Core/CookedMesh.hpp"
+        "includes/Core/ImportCache.hpp"
         "includes/Core/Cache/Cache.hpp"
         "includes/Core/Containers/ObjectPool.hpp"
         "includes/window.hpp"
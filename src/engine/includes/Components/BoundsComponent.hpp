@@ -0,0 +1,17 @@
+#pragma once
+#include "Components/Common.hpp"
+#include "glm/glm.hpp"
+
+// Local space bounds of a primitive, computed once at import. The sphere shares the box center so culling can use
+// whichever of the two is tighter along each plane.
+class BoundsComponent : public CommonComponent {
+public:
+    DECLARE_CONSTRUCTOR(BoundsComponent, CommonComponent)
+    glm::vec3 _min = glm::vec3(0.0f);
+    glm::vec3 _max = glm::vec3(0.0f);
+    float _radius = 0.0f;
+
+    glm::vec3 GetCenter() const { return (_min + _max) * 0.5f; }
+
+    glm::vec3 GetExtents() const { return (_max - _min) * 0.5f; }
+};
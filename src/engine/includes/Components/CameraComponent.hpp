@@ -11,5 +11,11 @@ public:
     glm::vec3 m_CameraFront = glm::vec3(1.0f, 0.0f, 0.0f);
     glm::vec3 _currentPivotPosition = glm::vec3(0.0f);
     float _radius = 2.0f;
+    float _nearPlane = 0.1f;
+    float _farPlane = 300.f;
     bool _isActive = false;
+    
+    // Last primitive picked with the left mouse button
+    std::optional<ComponentID> _selectedEntity;
+    bool _bWasPicking = false;
 };
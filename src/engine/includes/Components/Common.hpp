@@ -1,19 +1,19 @@
 #pragma once
 #include "entt/fwd.hpp"
+#include <atomic>
 
 using ComponentID = entt::entity;
 
 class ComponentIDCounter {
 public:
+    // Components are also built on worker threads by the model import
     static int Increment() {
         static ComponentIDCounter counter;
-        counter._id = ++counter._id;
-        
-        return counter._id;
+        return ++counter._id;
     };
     
 private:
-    int _id = -1;
+    std::atomic<int> _id = -1;
 };
 
 
@@ -8,4 +8,5 @@ public:
     std::unordered_map<int, bool> m_MouseButtons;
     glm::vec2 m_MouseDelta = glm::vec2(0.0f, 0.0f);
     glm::vec2 m_WheelDelta = glm::vec2(0.0f, 0.0f);
+    glm::vec2 m_MousePosition = glm::vec2(0.0f, 0.0f);
 };
@@ -1,10 +1,14 @@
 #pragma once
 #include "Common.hpp"
+#include "Renderer/ShaderPermutation.hpp"
 
 class MaterialComponent : public CommonComponent {
 public:
     DECLARE_CONSTRUCTOR(MaterialComponent, CommonComponent)
     std::string _identifier;
+    
+    // Features this material provides, passes pick the shader permutation from them
+    ShaderFeatureKey _shaderFeatures = SF_None;
 
 protected:
     std::string _fragShaderPath;
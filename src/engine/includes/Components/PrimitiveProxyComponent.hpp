@@ -2,6 +2,15 @@
 #include "Components/Common.hpp"
 #include "Renderer/Buffer.hpp"
 #include "Renderer/GPUDefinitions.h"
+#include "Core/CookedMesh.hpp"
+#include "Core/Meshlets.hpp"
+
+// Index range of one level of detail inside the geometry buffer, every level indexes the same vertex data
+struct PrimitiveLodRange {
+    unsigned int _indicesOffset = 0;
+    unsigned int _indicesCount = 0;
+    float _error = 0.0f; // Local space distance the simplified surface may be off by, 0 for the full mesh
+};
 
 class PrimitiveProxyComponent : public CommonComponent
 {
@@ -13,12 +22,27 @@ public:
      * we then use the offsets to gather the relevant portion of data from this big buffer
      */
     std::shared_ptr<Buffer> _gpuBuffer;
+    std::vector<PrimitiveLodRange> _lods; // Finest first, the first one is the full mesh
     
     // Computed per frame
     glm::mat4x4 _transformMatrix;
-    unsigned _indicesOffset = 0;
+    unsigned _indicesOffset = 0; // Range of the selected level of detail
     unsigned int _vertexOffset = 0;
     unsigned int _indicesCount = 0;
+    unsigned int _lodIndex = 0;
+    std::vector<IndexRange> _drawRanges; // Meshlets left after culling, relative to _indicesOffset
+    bool _bDrawRanges = false;           // Draw only _drawRanges instead of the whole level
+};
+
+// Simplified indices generated at import, they index the same _vertexData as the full mesh
+struct PrimitiveLod {
+    std::vector<unsigned int> _indices;
+    float _error = 0.0f; // Local space distance to the full mesh
+};
+
+struct PrimitiveLodView {
+    std::span<const unsigned int> _indices;
+    float _error = 0.0f;
 };
 
 // We separate the CPU data into a specific component, so that when rendering we dont need to use much cache space
@@ -29,4 +53,34 @@ public:
     DECLARE_CONSTRUCTOR(PrimitiveProxyComponentCPU, CommonComponent)
     std::vector<unsigned int> _indices{};
     std::vector<VertexData> _vertexData{};
+    std::vector<PrimitiveLod> _lods{}; // Coarser levels after the full mesh, each one about half the triangles of the previous
+    MeshletData _meshlets{};           // Of the full mesh, when there are any _indices is in meshlet order
+
+    // Set for cooked assets, the geometry is read from the mapped file and the vectors above stay empty
+    std::shared_ptr<const CookedMesh> _cookedMesh;
+    const CookedPrimitive* _cookedPrimitive = nullptr;
+
+    // Geometry wherever it lives, use these instead of the vectors
+    [[nodiscard]] std::span<const unsigned int> GetIndices() const {
+        return _cookedPrimitive ? _cookedMesh->GetIndices(*_cookedPrimitive) : std::span<const unsigned int>(_indices);
+    }
+
+    [[nodiscard]] std::span<const VertexData> GetVertexData() const {
+        if(_cookedPrimitive) {
+            return {static_cast<const VertexData*>(_cookedMesh->GetVertices(*_cookedPrimitive)), _cookedPrimitive->_vertexCount};
+        }
+        return _vertexData;
+    }
+
+    [[nodiscard]] std::size_t GetLodCount() const {
+        return _cookedPrimitive ? _cookedPrimitive->_lodCount : _lods.size();
+    }
+
+    [[nodiscard]] PrimitiveLodView GetLod(std::size_t index) const {
+        if(_cookedPrimitive) {
+            const CookedLod& lod = _cookedMesh->GetLods(*_cookedPrimitive)[index];
+            return {_cookedMesh->GetIndices(lod), lod._error};
+        }
+        return {_lods[index]._indices, _lods[index]._error};
+    }
 };
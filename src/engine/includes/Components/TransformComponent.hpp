@@ -7,7 +7,8 @@ class TransformComponent : public CommonComponent {
 public:
     DECLARE_CONSTRUCTOR(TransformComponent, CommonComponent)
 
-    // Later we can have utilities that can build the computed matrix directly when modify data in this component
+    // Changes must be signaled with registry.patch<TransformComponent> (or TransformHierarchy::MarkDirty), only dirty
+    // transforms and their descendants get _computedMatrix recomputed
     glm::vec3 m_Position = glm::vec3(0.0f);
     glm::quat m_Rotation = glm::vec3(0.0f);
     glm::vec3 m_Scale = glm::vec3(1.0f);
@@ -1,4 +1,6 @@
 #pragma once
+#include <list>
+#include <optional>
 
 namespace Core {
     template <typename Key, typename... Args>
@@ -11,58 +13,72 @@ namespace Core {
         void Update(const Key& key) noexcept {};
         void Erase(const Key& key) noexcept {};
         void Clear() noexcept {};
+        
+        // The default policy never evicts, entries live until removed or cleared
+        std::optional<Key> Evict() const noexcept { return std::nullopt; };
     };
 
-    template <typename Key, std::size_t MaxAccessCount = 100>
+    // Keeps track of the access order and evicts the least recently used key once
+    // more than Capacity entries are alive.
+    template <typename Key, std::size_t Capacity = 100>
     class CacheLRUPolicy {
 
-        using Container = std::unordered_map<Key, std::size_t>;
+        using Order = std::list<Key>;
+        using Container = std::unordered_map<Key, typename Order::iterator>;
 
     public:
         CacheLRUPolicy() = default;
 
         void Insert(const Key& key) noexcept {
-            _access[key] = 0;
+            Touch(key);
         };
 
         void Get(const Key& key) noexcept {
-            _access[key] = 0;
-            Increment(key);
+            Touch(key);
         };
 
         void Update(const Key& key) noexcept {
-            Increment(key);
+            Touch(key);
         };
 
         void Erase(const Key& key) noexcept {
-            _access.erase(key);
+            auto it = _access.find(key);
+            if(it == _access.end()) {
+                return;
+            }
+            
+            _order.erase(it->second);
+            _access.erase(it);
         };
 
         void Clear() noexcept {
             _access.clear();
+            _order.clear();
         };
-
-    private:
-        void Increment(const Key& key) noexcept {
-            for (auto& [cKey, count] : _access) {
-                if (cKey != key) {
-                    count++;
-                }
+        
+        std::optional<Key> Evict() const noexcept {
+            if(_access.size() <= Capacity || _order.empty()) {
+                return std::nullopt;
             }
-
-            // After Increment evict if necessary
-            Evict();
+            
+            return _order.back();
         };
 
-        void Evict() noexcept {
-            std::for_each(_access.begin(), _access.end(), [&](const Key& key, std::size_t count) {
-                if (count > MaxAccessCount) {
-                    _access.erase(key);
-                }
-            });
+    private:
+        void Touch(const Key& key) noexcept {
+            auto it = _access.find(key);
+            if(it != _access.end()) {
+                // Move the key to the front, most recently used entries live at the front
+                _order.splice(_order.begin(), _order, it->second);
+                return;
+            }
+            
+            _order.push_front(key);
+            _access[key] = _order.begin();
         };
 
     private:
+        Order _order;
         Container _access;
     };
 
@@ -103,6 +119,25 @@ namespace Core {
         Value Get(const Key& key) {
             return GetInternal(key);
         };
+        
+        /**
+         * Looks up the key without throwing, counts as a hit or a miss.
+         * @return true if the key was found and value was written
+         */
+        bool TryGet(const Key& key, Value& value) noexcept {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            
+            auto it = _cache.find(key);
+            if (it == _cache.end()) {
+                _misses++;
+                return false;
+            }
+            
+            _hits++;
+            _invictionPolicy.Get(key);
+            value = it->second;
+            return true;
+        };
 
         bool Contains(const Key& key) const noexcept {
             return Find(key) != _cache.end();
@@ -121,6 +156,7 @@ namespace Core {
             }
             
             _cache.clear();
+            _invictionPolicy.Clear();
         };
 
         std::size_t Size() noexcept {
@@ -128,6 +164,29 @@ namespace Core {
             return _cache.size();
         };
 
+        /**
+         * Visits every entry while holding the lock, safe to call from other threads than the one filling the cache.
+         * Does not count as an access for the inviction policy.
+         */
+        template <typename Fn>
+        void ForEach(Fn&& fn) const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (const auto& [key, value] : _cache) {
+                fn(key, value);
+            }
+        };
+
+        std::size_t GetHitCount() const noexcept {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return _hits;
+        };
+        
+        std::size_t GetMissCount() const noexcept {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return _misses;
+        };
+
         Const_Iterator begin() const noexcept {
             return _cache.begin();
         };
@@ -150,16 +209,25 @@ namespace Core {
             std::lock_guard<std::mutex> lock(m_mutex);
             
             // Check if the key exists in the cache
-            if (_cache.find(key) == _cache.end()) {
+            auto it = _cache.find(key);
+            if (it == _cache.end()) {
+                _misses++;
                 throw std::out_of_range("Key not found in the cache.");
             }
 
-            return _cache[key];
+            _hits++;
+            _invictionPolicy.Get(key);
+            return it->second;
         };
 
         void Insert(const Key& key, const Value&& value) noexcept {
             std::lock_guard<std::mutex> lock(m_mutex);
             _cache.emplace(key, std::move(value));
+            _invictionPolicy.Insert(key);
+            
+            while (std::optional<Key> victim = _invictionPolicy.Evict()) {
+                EraseLocked(victim.value());
+            }
         };
 
         void Update(const Key& key, const Value&& value) noexcept {
@@ -167,6 +235,7 @@ namespace Core {
             
             if (_cache.find(key) != _cache.end()) {
                 _cache[key] = std::move(value);
+                _invictionPolicy.Update(key);
             }
         };
 
@@ -182,15 +251,27 @@ namespace Core {
 
         void Erase(const Key& key) {
             std::lock_guard<std::mutex> lock(m_mutex);
-
-            _onErase(key, _cache[key]);
-            _cache.erase(key);
+            EraseLocked(key);
+        };
+        
+        void EraseLocked(const Key& key) {
+            _invictionPolicy.Erase(key);
+            
+            auto it = _cache.find(key);
+            if (it == _cache.end()) {
+                return;
+            }
+            
+            _onErase(key, it->second);
+            _cache.erase(it);
         };
 
     private:
         Container _cache;
         OnErase _onErase;
         InvictionPolicy _invictionPolicy;
+        std::size_t _hits = 0;
+        std::size_t _misses = 0;
         mutable std::mutex m_mutex;
     };
 
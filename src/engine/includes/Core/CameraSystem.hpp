@@ -1,7 +1,11 @@
 #pragma once
 
+#include "Components/Common.hpp"
+#include "glm/vec2.hpp"
+
 class Window;
 class Scene;
+class CameraComponent;
 
 struct InitializationParams;
 
@@ -13,6 +17,9 @@ public:
 private:
 //    void ComputeFirstPersonCamera(entt::registry& registry);
     void ComputeArcBallCamera(Scene* scene) const;
+    
+    // Closest primitive under the cursor, tested against the world boxes in the scene spatial index
+    std::optional<ComponentID> PickEntity(Scene* scene, const CameraComponent& cameraComponent, const glm::vec2& mousePosition) const;
 
     Window* m_Window;
 };
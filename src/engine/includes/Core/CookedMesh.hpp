@@ -0,0 +1,147 @@
+#pragma once
+#include "Core/MappedFile.hpp"
+#include "Core/Meshlets.hpp"
+#include <span>
+
+/**
+ *  Engine native model file, what the import produces already laid out the way the renderer consumes it, so loading
+ * one is mapping the file and pointing at it.
+ *
+ *  Layout: the header, the tables (nodes, primitives, levels of detail, textures) and then the blobs (vertices, indices,
+ * meshlets, encoded textures), each one 16 byte aligned. Offsets are from the start of the file. Vertices are stored as
+ * opaque blobs of the header's vertex size, a file cooked with a different vertex layout, version or endianness is
+ * rejected and simply cooked again.
+ */
+struct CookedMeshHeader {
+    std::uint32_t _magic = 0;
+    std::uint32_t _version = 0;
+    std::uint32_t _vertexSize = 0;
+    std::uint32_t _nodeCount = 0;
+    std::uint32_t _primitiveCount = 0;
+    std::uint32_t _lodCount = 0;
+    std::uint32_t _textureCount = 0;
+    std::uint32_t _reserved = 0;
+    std::uint64_t _fileSize = 0;
+    std::uint64_t _nodesOffset = 0;
+    std::uint64_t _primitivesOffset = 0;
+    std::uint64_t _lodsOffset = 0;
+    std::uint64_t _texturesOffset = 0;
+};
+
+struct CookedNode {
+    glm::mat4 _matrix = glm::mat4(1.0f); // Relative to the parent
+    std::int32_t _parent = -1;           // Always before its children, -1 for the root
+    std::uint32_t _reserved = 0;
+};
+
+struct CookedPrimitive {
+    std::uint32_t _node = 0;
+    std::int32_t _diffuseTexture = -1;
+    std::uint32_t _shaderFeatures = 0;
+    std::uint32_t _vertexCount = 0;
+    std::uint32_t _indexCount = 0;
+    std::uint32_t _firstLod = 0; // Coarser levels, a range of the level table
+    std::uint32_t _lodCount = 0;
+    std::uint32_t _meshletCount = 0;
+    std::uint64_t _verticesOffset = 0;
+    std::uint64_t _indicesOffset = 0;
+    std::uint64_t _meshletsOffset = 0;
+    glm::vec3 _boundsMin = glm::vec3(0.0f);
+    glm::vec3 _boundsMax = glm::vec3(0.0f);
+    float _boundsRadius = 0.0f;
+    std::uint32_t _reserved = 0;
+};
+
+struct CookedLod {
+    std::uint64_t _indicesOffset = 0;
+    std::uint32_t _indexCount = 0;
+    float _error = 0.0f;
+};
+
+// Image file bytes (png, jpg...) as found in the source, decoded at load
+struct CookedTexture {
+    std::uint64_t _offset = 0;
+    std::uint64_t _size = 0;
+};
+
+// Geometry of one primitive to cook, the pointed data only has to stay valid until Write
+struct CookedPrimitiveSource {
+    std::uint32_t _node = 0;
+    std::int32_t _diffuseTexture = -1;
+    std::uint32_t _shaderFeatures = 0;
+    const void* _vertices = nullptr;
+    std::uint32_t _vertexCount = 0;
+    std::span<const std::uint32_t> _indices;
+    std::vector<std::pair<std::span<const std::uint32_t>, float>> _lods; // Indices and error of every coarser level
+    std::span<const Meshlet> _meshlets;
+    glm::vec3 _boundsMin = glm::vec3(0.0f);
+    glm::vec3 _boundsMax = glm::vec3(0.0f);
+    float _boundsRadius = 0.0f;
+};
+
+class CookedMeshWriter {
+public:
+    explicit CookedMeshWriter(std::uint32_t vertexSize) : _vertexSize(vertexSize) {}
+
+    // Returns the index primitives and children refer to it with
+    std::uint32_t AddNode(const glm::mat4& matrix, std::int32_t parent);
+
+    // Copies the encoded image, returns the index primitives refer to it with
+    std::uint32_t AddTexture(const void* data, std::size_t size);
+
+    void AddPrimitive(CookedPrimitiveSource primitive);
+
+    // Writes next to the destination and renames it, a reader never maps a partially written file and the last of
+    // concurrent writers wins
+    bool Write(const std::string& path) const;
+
+private:
+    std::uint32_t _vertexSize = 0;
+    std::vector<CookedNode> _nodes;
+    std::vector<CookedPrimitiveSource> _primitives;
+    std::vector<std::vector<std::uint8_t>> _textures;
+};
+
+class CookedMesh {
+public:
+    static constexpr std::uint32_t Magic = 0x48534D43; // "CMSH"
+    static constexpr std::uint32_t Version = 1;
+    static constexpr std::size_t Alignment = 16;
+
+    // Null when the file is missing, truncated, or was cooked by another version or vertex layout
+    static std::shared_ptr<const CookedMesh> Open(const std::string& path, std::uint32_t vertexSize);
+
+    [[nodiscard]] std::span<const CookedNode> GetNodes() const { return GetArray<CookedNode>(_header->_nodesOffset, _header->_nodeCount); }
+
+    [[nodiscard]] std::span<const CookedPrimitive> GetPrimitives() const { return GetArray<CookedPrimitive>(_header->_primitivesOffset, _header->_primitiveCount); }
+
+    [[nodiscard]] std::span<const CookedLod> GetLods(const CookedPrimitive& primitive) const {
+        return GetArray<CookedLod>(_header->_lodsOffset, _header->_lodCount).subspan(primitive._firstLod, primitive._lodCount);
+    }
+
+    [[nodiscard]] const void* GetVertices(const CookedPrimitive& primitive) const { return _file->GetData() + primitive._verticesOffset; }
+
+    [[nodiscard]] std::span<const std::uint32_t> GetIndices(const CookedPrimitive& primitive) const { return GetArray<std::uint32_t>(primitive._indicesOffset, primitive._indexCount); }
+
+    [[nodiscard]] std::span<const std::uint32_t> GetIndices(const CookedLod& lod) const { return GetArray<std::uint32_t>(lod._indicesOffset, lod._indexCount); }
+
+    [[nodiscard]] std::span<const Meshlet> GetMeshlets(const CookedPrimitive& primitive) const { return GetArray<Meshlet>(primitive._meshletsOffset, primitive._meshletCount); }
+
+    [[nodiscard]] std::uint32_t GetTextureCount() const { return _header->_textureCount; }
+
+    [[nodiscard]] std::span<const std::uint8_t> GetTexture(std::uint32_t index) const;
+
+    [[nodiscard]] std::size_t GetSize() const { return _file->GetSize(); }
+
+private:
+    template <typename T>
+    std::span<const T> GetArray(std::uint64_t offset, std::uint64_t count) const {
+        return {reinterpret_cast<const T*>(_file->GetData() + offset), static_cast<std::size_t>(count)};
+    }
+
+    bool Validate(std::uint32_t vertexSize) const;
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    const CookedMeshHeader* _header = nullptr;
+};
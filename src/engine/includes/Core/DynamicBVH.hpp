@@ -0,0 +1,252 @@
+#pragma once
+#include <entt/entity/entity.hpp>
+#include "glm/glm.hpp"
+#include "Core/FrustumCulling.hpp"
+
+struct AABB {
+    glm::vec3 _min = glm::vec3(0.0f);
+    glm::vec3 _max = glm::vec3(0.0f);
+
+    static AABB Union(const AABB& lhs, const AABB& rhs) {
+        return {glm::min(lhs._min, rhs._min), glm::max(lhs._max, rhs._max)};
+    }
+
+    // Half the surface area, the constant factor does not matter for SAH comparisons
+    [[nodiscard]] float GetArea() const {
+        const glm::vec3 size = _max - _min;
+        return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+
+    [[nodiscard]] glm::vec3 GetCenter() const { return (_min + _max) * 0.5f; }
+
+    [[nodiscard]] glm::vec3 GetExtents() const { return (_max - _min) * 0.5f; }
+
+    [[nodiscard]] bool Contains(const AABB& other) const {
+        return _min.x <= other._min.x && _min.y <= other._min.y && _min.z <= other._min.z
+            && other._max.x <= _max.x && other._max.y <= _max.y && other._max.z <= _max.z;
+    }
+
+    [[nodiscard]] bool Overlaps(const AABB& other) const {
+        return _min.x <= other._max.x && other._min.x <= _max.x
+            && _min.y <= other._max.y && other._min.y <= _max.y
+            && _min.z <= other._max.z && other._min.z <= _max.z;
+    }
+
+    // Box around the transformed box, grows with rotation (Arvo)
+    static AABB Transform(const glm::mat4& matrix, const AABB& box) {
+        const glm::vec3 center = glm::vec3(matrix * glm::vec4(box.GetCenter(), 1.0f));
+        const glm::vec3 extents = box.GetExtents();
+
+        glm::vec3 worldExtents(0.0f);
+        for(int column = 0; column < 3; column++) {
+            worldExtents += glm::abs(glm::vec3(matrix[column])) * extents[column];
+        }
+
+        return {center - worldExtents, center + worldExtents};
+    }
+};
+
+struct Ray {
+    glm::vec3 _origin = glm::vec3(0.0f);
+    glm::vec3 _direction = glm::vec3(0.0f, 0.0f, -1.0f); // Does not need to be normalized, distances are in its units
+
+    /**
+     * Slab test against a box
+     * @param distance - entry distance along the ray, 0 when the origin is inside
+     * @return true if the box is hit before maxDistance
+     */
+    bool Intersects(const AABB& box, float maxDistance, float& distance) const;
+};
+
+enum class FrustumTest : std::uint8_t {
+    Outside,
+    Intersecting,
+    Inside
+};
+
+/**
+ *  Incrementally maintained bounding volume hierarchy over entities, the proxy id returned by Insert is the leaf node
+ * and stays valid until Remove, also across rebuilds.
+ *
+ *  Leaves store enlarged bounds so small moves do not touch the tree. New leaves are placed next to the sibling that
+ * adds the least surface area to the tree (branch and bound over the inherited cost), moves that leave the enlarged
+ * box refit the ancestors in place. Refits slowly degrade the tree, once enough leaves were refit since the last build
+ * the internal nodes are rebuilt top down with binned SAH, which keeps the amortized cost of a move logarithmic.
+ */
+class DynamicBVH {
+public:
+    static constexpr std::int32_t NullNode = -1;
+
+    std::int32_t Insert(const AABB& bounds, entt::entity entity);
+
+    // Bulk loading, the leaf is hung under the root without searching for a sibling, call Rebuild once done
+    std::int32_t InsertDeferred(const AABB& bounds, entt::entity entity);
+
+    void Remove(std::int32_t proxy);
+
+    /**
+     * Updates the bounds of a leaf
+     * @return true if the tree changed, false when the new bounds still fit the enlarged leaf box
+     */
+    bool Move(std::int32_t proxy, const AABB& bounds);
+
+    // Rebuilds every internal node with binned SAH, leaves (and proxy ids) are kept
+    void Rebuild();
+
+    [[nodiscard]] entt::entity GetEntity(std::int32_t proxy) const { return _nodes[proxy]._entity; }
+
+    [[nodiscard]] const AABB& GetBounds(std::int32_t proxy) const { return _nodes[proxy]._bounds; }
+
+    [[nodiscard]] std::size_t GetLeafCount() const { return _leafCount; }
+
+    [[nodiscard]] std::uint32_t GetHeight() const;
+
+    // Sum of the internal node areas relative to the root, the expected traversal cost of a random query
+    [[nodiscard]] float GetCost() const;
+
+    static FrustumTest TestFrustum(const Frustum& frustum, const AABB& box);
+
+    /**
+     * Visits the leaves that may be inside the frustum, subtrees fully inside are reported without testing their nodes
+     * @param fn - void(entity, proxy, bool bFullyInside)
+     */
+    template<typename Fn>
+    void QueryFrustum(const Frustum& frustum, Fn&& fn) const {
+        Traverse([&](const Node& node) {
+            return TestFrustum(frustum, node._bounds);
+        }, fn);
+    }
+
+    // fn - void(entity, proxy)
+    template<typename Fn>
+    void QueryAABB(const AABB& box, Fn&& fn) const {
+        Traverse([&](const Node& node) {
+            return box.Overlaps(node._bounds) ? FrustumTest::Intersecting : FrustumTest::Outside;
+        }, [&](entt::entity entity, std::int32_t proxy, bool) {
+            fn(entity, proxy);
+        });
+    }
+
+    /**
+     * Visits the leaves hit by the ray, the nearer child of a node is visited first
+     * @param fn - float(entity, proxy, float maxDistance), returns the new max distance so later nodes can be skipped,
+     * return maxDistance to keep going unchanged or 0 to stop
+     */
+    template<typename Fn>
+    void Raycast(const Ray& ray, float maxDistance, Fn&& fn) const {
+        if(_root == NullNode) {
+            return;
+        }
+
+        std::vector<std::pair<float, std::int32_t>> stack;
+        stack.reserve(64);
+
+        float distance = 0.0f;
+        if(ray.Intersects(_nodes[_root]._bounds, maxDistance, distance)) {
+            stack.emplace_back(distance, _root);
+        }
+
+        while(!stack.empty()) {
+            const auto [entryDistance, index] = stack.back();
+            stack.pop_back();
+
+            if(entryDistance > maxDistance) {
+                continue;
+            }
+
+            const Node& node = _nodes[index];
+            if(node.IsLeaf()) {
+                maxDistance = fn(node._entity, index, maxDistance);
+                if(maxDistance <= 0.0f) {
+                    return;
+                }
+                continue;
+            }
+
+            float leftDistance = 0.0f, rightDistance = 0.0f;
+            const bool bLeft = ray.Intersects(_nodes[node._left]._bounds, maxDistance, leftDistance);
+            const bool bRight = ray.Intersects(_nodes[node._right]._bounds, maxDistance, rightDistance);
+
+            // Far child first so the near one is popped next
+            if(bLeft && bRight) {
+                if(leftDistance < rightDistance) {
+                    stack.emplace_back(rightDistance, node._right);
+                    stack.emplace_back(leftDistance, node._left);
+                }
+                else {
+                    stack.emplace_back(leftDistance, node._left);
+                    stack.emplace_back(rightDistance, node._right);
+                }
+            }
+            else if(bLeft) {
+                stack.emplace_back(leftDistance, node._left);
+            }
+            else if(bRight) {
+                stack.emplace_back(rightDistance, node._right);
+            }
+        }
+    }
+
+private:
+    struct Node {
+        AABB _bounds;
+        std::int32_t _parent = NullNode;
+        std::int32_t _left = NullNode;
+        std::int32_t _right = NullNode;
+        entt::entity _entity = entt::null;
+        bool _bFree = false;
+
+        [[nodiscard]] bool IsLeaf() const { return _left == NullNode; }
+    };
+
+    // Test returns Outside to skip a subtree, Inside to accept it whole
+    template<typename Test, typename Fn>
+    void Traverse(Test&& test, Fn&& fn) const {
+        if(_root == NullNode) {
+            return;
+        }
+
+        std::vector<std::pair<std::int32_t, bool>> stack;
+        stack.reserve(64);
+        stack.emplace_back(_root, false);
+
+        while(!stack.empty()) {
+            const auto [index, bInside] = stack.back();
+            stack.pop_back();
+
+            const Node& node = _nodes[index];
+            bool bNodeInside = bInside;
+            if(!bNodeInside) {
+                const FrustumTest result = test(node);
+                if(result == FrustumTest::Outside) {
+                    continue;
+                }
+                bNodeInside = result == FrustumTest::Inside;
+            }
+
+            if(node.IsLeaf()) {
+                fn(node._entity, index, bNodeInside);
+                continue;
+            }
+
+            stack.emplace_back(node._right, bNodeInside);
+            stack.emplace_back(node._left, bNodeInside);
+        }
+    }
+
+    std::int32_t AllocateNode();
+    void FreeNode(std::int32_t index);
+
+    std::int32_t FindBestSibling(const AABB& bounds) const;
+    void InsertLeaf(std::int32_t leaf, std::int32_t sibling);
+    void RemoveLeaf(std::int32_t leaf);
+    void RefitAncestors(std::int32_t index);
+    std::int32_t BuildRange(std::vector<std::int32_t>& leaves, std::size_t begin, std::size_t end);
+
+private:
+    std::vector<Node> _nodes;
+    std::vector<std::int32_t> _freeNodes;
+    std::int32_t _root = NullNode;
+    std::size_t _leafCount = 0;
+    std::size_t _refitsSinceBuild = 0;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <filesystem>
+
+/**
+ * Polls the last write time of a set of files, there is no portable change notification so the owner
+ * decides how often Poll runs. Not thread safe, Watch and Poll are expected to run on the same thread.
+ */
+class FileWatcher {
+public:
+    /**
+     * Starts tracking the file, the current write time is the baseline so the file is not reported until it changes again.
+     * Watching an already watched file does nothing.
+     */
+    void Watch(const std::string& path);
+
+    void Unwatch(const std::string& path);
+
+    /**
+     * @return files whose write time changed since they were last seen, files that are missing (e.g. in the
+     * middle of an editor save) are skipped and reported once they show up again with a new write time
+     */
+    std::vector<std::string> Poll();
+
+    [[nodiscard]] bool IsWatching(const std::string& path) const { return _files.contains(path); }
+
+private:
+    std::unordered_map<std::string, std::filesystem::file_time_type> _files;
+};
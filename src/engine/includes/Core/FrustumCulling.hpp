@@ -0,0 +1,46 @@
+#pragma once
+#include "glm/glm.hpp"
+#include "Core/TransformKernels.hpp"
+
+class BoundsComponent;
+
+/**
+ * View frustum as six planes (left, right, bottom, top, near, far), xyz is the normal pointing inside and w the
+ * distance, a point p is inside a plane when dot(xyz, p) + w >= 0
+ */
+struct Frustum {
+    std::array<glm::vec4, 6> _planes;
+
+    // Gribb/Hartmann extraction, expects the -1..1 clip depth glm::perspective produces by default
+    static Frustum FromViewProjection(const glm::mat4& viewProjection);
+};
+
+/**
+ * World space bounds of many primitives in structure of arrays form, box center and half extents plus the radius of
+ * the sphere around the same center
+ */
+struct CullingBoundsSoA {
+    std::vector<float> _centerX, _centerY, _centerZ;
+    std::vector<float> _extentX, _extentY, _extentZ;
+    std::vector<float> _radius;
+
+    void Resize(std::size_t size);
+
+    [[nodiscard]] std::size_t Size() const { return _centerX.size(); }
+};
+
+/**
+ *  Batched frustum tests, same runtime dispatch as TransformKernels. Every plane is tested against the box and the
+ * sphere at once, the projected radius is the smaller of the sphere radius and the box extents along the plane normal.
+ */
+class FrustumCulling {
+public:
+    // Moves local bounds into world space, the box stays axis aligned so it grows with rotation
+    static void TransformBounds(const glm::mat4& matrix, const BoundsComponent& bounds, CullingBoundsSoA& out, std::size_t index);
+
+    /**
+     * Tests bounds [begin, end) against the frustum, 4 (SSE/NEON) or 8 (AVX2) at a time
+     * @param visible - one byte per bounds, indexed from begin, 1 when any part may be inside
+     */
+    static void Cull(SimdIsa isa, const Frustum& frustum, const CullingBoundsSoA& bounds, std::size_t begin, std::size_t end, std::uint8_t* visible);
+};
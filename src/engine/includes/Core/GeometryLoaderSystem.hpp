@@ -1,16 +1,82 @@
 #pragma once
 #include <entt/entity/registry.hpp>
+#include <atomic>
+#include <chrono>
+#include <optional>
 
 struct MeshNode;
 class Scene;
+class ImportCache;
 
+enum class ImportState : std::uint8_t {
+    Importing,  // Parsing and processing on a worker thread
+    Committing, // Waiting for the main thread to move it into the registry
+    Finished,
+    Cancelled,
+    Failed
+};
+
+struct ImportProgress {
+    std::uint32_t _id = 0;
+    std::string _filePath;
+    ImportState _state = ImportState::Importing;
+    float _progress = 0.0f; // 0 to 1 over the whole import, commit included
+};
+
+/**
+ *  Imports model files without blocking the frame. Parsing, texture decoding and the geometry processing run on the
+ * job system and produce a staging scene that nothing else sees, Process then moves it into the registry a few
+ * primitives at a time within a time budget. Nodes go in before the primitives so no primitive is ever drawn without
+ * its parent transform.
+ *
+ *  Every imported file is cooked (see CookedMesh) into the import cache, later loads of the same content map the cached
+ * file instead and the geometry is uploaded straight from the mapping. A .cmesh can be loaded directly too.
+ *
+ *  Cancelling stops the worker at the next check, Assimp included, or drops what was not committed yet. What was
+ * already committed stays in the scene, its primitives grouped in a MeshComponentNew of their own.
+ */
 class GeometryLoaderSystem {
 public:
+    // Caches imports in ImportCache::GetDefaultDirectory()
+    GeometryLoaderSystem();
+
+    ~GeometryLoaderSystem();
+
+    // Commits finished imports, call once per frame from the thread owning the scene
     void Process(Scene* scene);
-    void EnqueueFileLoad(const std::string& filePath);
+
+    // Starts importing right away, returns the id progress and cancellation refer to
+    std::uint32_t EnqueueFileLoad(const std::string& filePath);
+
+    void Cancel(std::uint32_t importId);
+
+    void CancelAll();
+
+    // Imports that did not finish as of the last Process
+    [[nodiscard]] std::vector<ImportProgress> GetProgress() const;
+
+    // Main thread time Process may spend committing per frame, at least one primitive is always committed
+    void SetCommitBudget(std::chrono::microseconds budget) { _commitBudget = budget; }
+
+    // Used by the imports enqueued from now on, null always imports from the source
+    void SetImportCache(std::shared_ptr<ImportCache> importCache) { _importCache = std::move(importCache); }
+
+private:
+    struct ImportJob;
+
+    static void Import(const std::shared_ptr<ImportJob>& job);
+
+    static ImportState ImportCooked(ImportJob& job, const std::string& cookedPath);
+
+    // Imports with Assimp and stores the result in the cache when there is a sourceKey, the hash of the file alone
+    static ImportState ImportSource(ImportJob& job, std::optional<std::uint64_t> sourceKey);
+
+    // True once the whole job is in the registry
+    static bool Commit(Scene* scene, ImportJob& job, std::chrono::steady_clock::time_point deadline);
 
 private:
-    static void LoadFromFile(Scene* scene, const std::string& filePath);
-    
-    std::queue<std::string> _loadQueue;
+    std::vector<std::shared_ptr<ImportJob>> _jobs;
+    std::shared_ptr<ImportCache> _importCache;
+    std::uint32_t _nextImportId = 0;
+    std::chrono::microseconds _commitBudget = std::chrono::microseconds(2000);
 };
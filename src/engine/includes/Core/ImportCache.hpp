@@ -0,0 +1,71 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <optional>
+
+class CookedMeshWriter;
+
+/**
+ *  On disk cache of cooked imports, keyed by a hash of the source file content, of every other file the import read
+ * (the .bin of a .gltf, the .mtl of an .obj, see StoreDependencies) and of the settings the import ran with. Moving,
+ * renaming or touching the files keeps their entry, editing any of them or changing the import makes a new one. Compressed
+ * textures (see TextureDecoder) are cached next to the meshes, under their own extension, and share the size limit.
+ *
+ *  Entries are plain files in one directory, shared by every engine instance of the user. The recency is the write
+ * time of the entry, refreshed on every hit, so the least recently used ones are evicted first once the directory is
+ * over its size limit. Entries are written under a unique name and renamed into place, a reader never sees a partial
+ * one, and eviction runs under a lock file so two instances never trim at the same time. An entry evicted by another
+ * instance between lookup and load just reads as a miss.
+ */
+class ImportCache {
+public:
+    static constexpr const char* EntryExtension = ".cmesh";
+
+    static constexpr const char* TextureEntryExtension = ".ctex";
+
+    // Lists the files an import read besides its source
+    static constexpr const char* DependencyEntryExtension = ".cdeps";
+
+    static constexpr std::uint64_t DefaultMaxSize = 2ull << 30;
+
+    ImportCache(std::filesystem::path directory, std::uint64_t maxSize);
+
+    // Default location, in the cache directory of the user: $XDG_CACHE_HOME or ~/.cache, %LOCALAPPDATA% on Windows. The
+    // system temporary directory when none is set
+    static std::filesystem::path GetDefaultDirectory();
+
+    // Combine with the settings key into the key of an import, null when the file cannot be read
+    static std::optional<std::uint64_t> HashFile(const std::string& path, std::uint64_t seed = 0);
+
+    static std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+    // Key the last import of sourcePath was stored under, sourceKey being its HashFile. Null when it was never stored or
+    // one of the files it read cannot be read anymore
+    [[nodiscard]] std::optional<std::uint64_t> FindImportKey(std::uint64_t sourceKey, const std::string& sourcePath) const;
+
+    // Records the files an import of sourcePath read, the source itself may be among them. Returns the key to store the
+    // import under, null when one of them cannot be read
+    std::optional<std::uint64_t> StoreDependencies(std::uint64_t sourceKey, const std::string& sourcePath, const std::vector<std::string>& dependencies) const;
+
+    // Where the entry for key is, whether or not it exists
+    [[nodiscard]] std::string GetEntryPath(std::uint64_t key, const char* extension = EntryExtension) const;
+
+    // Marks the entry as just used, false when there is none
+    bool Touch(std::uint64_t key, const char* extension = EntryExtension) const;
+
+    // Writes the entry and evicts the least recently used ones over the size limit
+    bool Store(std::uint64_t key, const CookedMeshWriter& writer) const;
+
+    // Same for entries of another kind, write fills the stream and returns false when it could not
+    bool Store(std::uint64_t key, const char* extension, const std::function<bool(std::ostream&)>& write) const;
+
+    void Trim() const;
+
+    [[nodiscard]] const std::filesystem::path& GetDirectory() const { return _directory; }
+
+    [[nodiscard]] std::uint64_t GetMaxSize() const { return _maxSize; }
+
+private:
+    std::filesystem::path _directory;
+    std::uint64_t _maxSize = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
+/**
+ * Fixed pool of worker threads for CPU work that can be split in independent pieces.
+ *
+ *  Jobs are plain functions, there is no dependency tracking, callers that need ordering wait on ParallelFor or build
+ * it themselves. The thread calling ParallelFor also processes chunks so nesting ParallelFor inside a job can not
+ * deadlock, it just runs with less help.
+ */
+class JobSystem {
+public:
+    using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // Sized to the hardware threads minus the main thread
+    static JobSystem& Get();
+
+    explicit JobSystem(std::size_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    [[nodiscard]] std::size_t GetWorkerCount() const { return _workers.size(); }
+
+    void Schedule(std::function<void()> job);
+
+    /**
+     * Calls function over [0, count) split in chunks and returns once every chunk finished
+     * @param grainSize - minimum chunk size, chunks are also rounded to it so neighbouring chunks do not share cache
+     * lines when grainSize elements fill whole lines
+     */
+    void ParallelFor(std::size_t count, std::size_t grainSize, const RangeFunction& function);
+
+private:
+    void WorkerLoop();
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    bool _bStopping = false;
+};
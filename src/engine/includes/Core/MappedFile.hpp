@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ *  Read only view of a whole file mapped into memory. Pages are loaded by the OS on first access, reading a large
+ * file costs no copy and no allocation, and the data stays valid as long as the object lives.
+ */
+class MappedFile {
+public:
+    // Null when the file is missing, empty or cannot be mapped
+    static std::shared_ptr<MappedFile> Open(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const std::uint8_t* GetData() const { return _data; }
+
+    [[nodiscard]] std::size_t GetSize() const { return _size; }
+
+private:
+    MappedFile() = default;
+
+private:
+    const std::uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
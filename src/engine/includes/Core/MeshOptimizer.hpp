@@ -0,0 +1,52 @@
+#pragma once
+
+// Post transform cache behaviour of an index list, counts add up over meshes
+struct VertexCacheStatistics {
+    std::size_t _misses = 0;
+    std::size_t _triangles = 0;
+    std::size_t _vertices = 0; // Referenced by the indices
+
+    // Average cache miss ratio, transformed vertices per triangle. 0.5 is the best a large regular grid can get, 3 the worst
+    [[nodiscard]] float GetAcmr() const { return _triangles ? static_cast<float>(_misses) / static_cast<float>(_triangles) : 0.0f; }
+
+    // Average transform to vertex ratio, 1 means every vertex is transformed once
+    [[nodiscard]] float GetAtvr() const { return _vertices ? static_cast<float>(_misses) / static_cast<float>(_vertices) : 0.0f; }
+
+    void Add(const VertexCacheStatistics& other) {
+        _misses += other._misses;
+        _triangles += other._triangles;
+        _vertices += other._vertices;
+    }
+};
+
+/**
+ *  Import time reordering of indexed triangle meshes for the GPU, the stages are meant to run in the order below:
+ * deduplication, vertex cache, overdraw and vertex fetch. Vertices are opaque blobs of vertexSize bytes, only the
+ * overdraw stage reads positions.
+ *
+ *  Every stage is deterministic, the same input always gives the same bytes, so the results can be cached by content.
+ */
+class MeshOptimizer {
+public:
+    // FIFO size the cache stages optimize for and analyze with, about what current GPUs keep per batch
+    static constexpr std::size_t CacheSize = 16;
+
+    // Merges vertices with identical bytes and drops the unreferenced ones, keeps first occurrence order. Returns the new vertex count
+    static std::size_t DeduplicateVertices(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::uint32_t* indices, std::size_t indexCount);
+
+    // Tipsify (Sander, Nehab and Barczak), fans around recently used vertices while they are likely still in the cache
+    static void OptimizeVertexCache(std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t cacheSize = CacheSize);
+
+    /**
+     *  Splits the cache ordered triangles into clusters that each keep their ACMR within threshold of the input and
+     * draws the clusters facing out of the mesh first, so they hide the rest from the depth test. Run after OptimizeVertexCache.
+     * @param positions - first vertex position (3 floats), vertices are stride bytes apart
+     */
+    static void OptimizeOverdraw(std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t vertexCount, std::size_t stride,
+        float threshold = 1.05f);
+
+    // Renumbers vertices in the order the indices first use them and moves them to match, drops the unreferenced ones. Returns the new vertex count
+    static std::size_t OptimizeVertexFetch(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::uint32_t* indices, std::size_t indexCount);
+
+    static VertexCacheStatistics AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t cacheSize = CacheSize);
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+/**
+ *  Quadric error metric simplification (Garland and Heckbert) that only removes triangles, the result indexes the
+ * same vertices so every level of detail can share one vertex buffer.
+ *
+ *  Vertices with the same position are welded so the topology is seen through attribute seams, an edge collapse moves
+ * one position onto the other and each wedge of the removed vertex is remapped to the wedge of the kept one with the
+ * closest attributes. Open borders and attribute seams only collapse along themselves and carry extra quadrics that
+ * keep their shape, non manifold vertices never move. Collapses that would flip a triangle are rejected.
+ *
+ *  Collapses happen in passes, each pass sorts the candidate edges by quadric error and collapses the cheapest ones
+ * whose vertices were not touched yet in that pass. The quadric only ranks them, every removed vertex is measured
+ * against the simplified triangles around it and a collapse moving one of them further than the max error is skipped.
+ */
+class MeshSimplifier {
+public:
+    struct Result {
+        std::vector<std::uint32_t> _indices;
+        float _error = 0.0f; // Largest distance from a removed vertex to the simplified surface, in position units
+    };
+
+    /**
+     * @param positions - first vertex position (3 floats), vertices are stride bytes apart
+     * @param attributes - optional, attributeCount floats per vertex with the same stride, used to pick wedges
+     * @param targetIndexCount - stops once the result has at most this many indices
+     * @param maxError - no removed vertex ends up further than this from the simplified surface
+     */
+    static Result Simplify(const float* positions, const float* attributes, std::size_t attributeCount, std::size_t vertexCount, std::size_t stride,
+        const std::uint32_t* indices, std::size_t indexCount, std::size_t targetIndexCount, float maxError);
+};
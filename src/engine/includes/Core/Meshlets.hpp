@@ -0,0 +1,78 @@
+#pragma once
+#include "glm/glm.hpp"
+#include "Core/FrustumCulling.hpp"
+
+/**
+ *  Small cluster of triangles, the unit mesh shaders work on. Vertices and triangles are ranges of the arrays in
+ * MeshletData, triangles are 3 local vertex indices each.
+ *
+ *  Culling data is in the same space as the positions. The normal cone holds every triangle normal of the meshlet
+ * (counter clockwise front faces, as imported), when the camera looks at its sphere from behind the cone every triangle
+ * is back facing.
+ */
+struct Meshlet {
+    std::uint32_t _vertexOffset = 0;
+    std::uint32_t _vertexCount = 0;
+    std::uint32_t _triangleOffset = 0;
+    std::uint32_t _triangleCount = 0;
+
+    glm::vec3 _center = glm::vec3(0.0f);
+    float _radius = 0.0f;
+    glm::vec3 _coneAxis = glm::vec3(0.0f, 0.0f, 1.0f);
+    float _coneCutoff = 1.0f; // Sine of the cone spread, 1 when the normals are too spread out to ever be culled
+};
+
+struct MeshletData {
+    std::vector<Meshlet> _meshlets;
+    std::vector<std::uint32_t> _vertices; // Mesh vertex of every meshlet vertex
+    std::vector<std::uint8_t> _triangles; // 3 per triangle, indexes into the meshlet vertices
+};
+
+/**
+ *  Splits indexed triangles into meshlets. A meshlet starts from the first triangle not used yet and grows through
+ * triangles sharing its vertices, always taking the one adding the fewest new vertices, until either limit is hit or
+ * no neighbour fits.
+ */
+class MeshletBuilder {
+public:
+    static constexpr std::size_t MaxVertices = 64;
+    static constexpr std::size_t MaxTriangles = 124;
+
+    /**
+     * @param positions - first vertex position (3 floats), vertices are stride bytes apart
+     */
+    static MeshletData Build(const float* positions, std::size_t vertexCount, std::size_t stride, const std::uint32_t* indices,
+        std::size_t indexCount, std::size_t maxVertices = MaxVertices, std::size_t maxTriangles = MaxTriangles);
+
+    // Mesh indices of every meshlet one after the other, meshlet i covers [_triangleOffset * 3, (_triangleOffset + _triangleCount) * 3)
+    static std::vector<std::uint32_t> BuildIndices(const MeshletData& data);
+};
+
+// Indices [_firstIndex, _firstIndex + _indexCount) of an index list
+struct IndexRange {
+    std::uint32_t _firstIndex = 0;
+    std::uint32_t _indexCount = 0;
+};
+
+/**
+ *  Per draw meshlet culling on the CPU. Spheres go through the batched frustum test, the ones left through the normal
+ * cone test, and the meshlets that survive are turned into index ranges of the BuildIndices order with neighbours merged.
+ */
+class MeshletCulling {
+public:
+    /**
+     * @param clipMatrix - view projection times world, the frustum is tested in the space of the meshlets
+     * @param cameraPosition - camera in the space of the meshlets
+     * @param bBackfaceCulling - off for mirroring transforms, they swap which side is the front
+     * @return number of triangles culled
+     */
+    std::size_t Cull(SimdIsa isa, const MeshletData& data, const glm::mat4& clipMatrix, const glm::vec3& cameraPosition, bool bBackfaceCulling,
+        std::vector<IndexRange>& ranges);
+
+    // True when every triangle of the meshlet faces away from a camera at that position, same space as the meshlet
+    [[nodiscard]] static bool IsBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition);
+
+private:
+    CullingBoundsSoA _bounds;
+    std::vector<std::uint8_t> _visible;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include "glm/glm.hpp"
+#include "Core/TransformKernels.hpp"
+#include "Core/DynamicBVH.hpp"
+
+/**
+ *  Low resolution depth buffer rasterized on the CPU from a few large occluders, with a depth pyramid to test boxes
+ * against it in constant time.
+ *
+ *  Texels store 1/w (w is the view depth), it interpolates linearly in screen space and does not depend on the clip
+ * depth convention. Bigger is nearer and 0 means nothing was drawn. Triangles are clipped against the near plane in
+ * clip space (z >= -w, like Frustum) and drawn double sided. Rasterization is conservative, a texel is only written
+ * when it is entirely inside a triangle and gets the farthest depth the triangle has over it, so whatever shows through
+ * a texel an occluder only partly covers is never hidden. The texels along an edge shared by two triangles are covered
+ * by neither, occluders are best made of few large triangles. Pyramid levels keep the farthest depth of the texels
+ * below, a box is occluded when its nearest point is behind every texel its screen rect touches.
+ */
+class OcclusionBuffer {
+public:
+    // Sizes are rounded up to powers of two, the width to at least 8 so rows fill whole registers
+    void Resize(std::uint32_t width, std::uint32_t height);
+
+    void Clear();
+
+    /**
+     * Draws indexed triangles into level 0, rows are filled 4 (SSE/NEON) or 8 (AVX2) texels at a time. Every version
+     * produces the exact same depths as the scalar one.
+     * @param clipMatrix - object to clip space, view projection times world
+     * @param positions - first vertex position (3 floats), vertices are stride bytes apart
+     */
+    void RasterizeTriangles(SimdIsa isa, const glm::mat4& clipMatrix, const float* positions, std::size_t stride, const std::uint32_t* indices, std::size_t indexCount);
+
+    // Call once every occluder was drawn and before testing
+    void BuildPyramid();
+
+    // True when the world box is certainly hidden, boxes crossing the near plane or off screen are never occluded
+    [[nodiscard]] bool IsOccluded(const glm::mat4& viewProjection, const AABB& box) const;
+
+    [[nodiscard]] float GetDepth(std::uint32_t x, std::uint32_t y, std::uint32_t level = 0) const;
+
+    [[nodiscard]] std::uint32_t GetWidth() const { return _width; }
+
+    [[nodiscard]] std::uint32_t GetHeight() const { return _height; }
+
+    [[nodiscard]] std::uint32_t GetLevelCount() const { return static_cast<std::uint32_t>(_levels.size()); }
+
+private:
+    void RasterizeTriangle(SimdIsa isa, const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+
+    [[nodiscard]] std::uint32_t GetLevelWidth(std::uint32_t level) const { return std::max(_width >> level, 1u); }
+
+    [[nodiscard]] std::uint32_t GetLevelHeight(std::uint32_t level) const { return std::max(_height >> level, 1u); }
+
+private:
+    std::vector<std::vector<float>> _levels; // Level 0 is the raster target
+    std::uint32_t _width = 0;
+    std::uint32_t _height = 0;
+};
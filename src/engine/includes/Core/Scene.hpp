@@ -2,15 +2,23 @@
 #include "entt/entt.hpp"
 #include "Core/IBaseObject.hpp"
 #include "GenericInstanceWrapper.hpp"
+#include "Core/TransformHierarchy.hpp"
+#include "Core/SpatialIndex.hpp"
+#include "Core/VisibilitySet.hpp"
+#include "Renderer/TextureResidency.hpp"
+#include <iterator>
+#include <ranges>
+#include <span>
 
 class Camera;
+class CameraComponent;
 class Mesh;
 class Light;
 
 /// Scene class holds information about objects used in a renderable world. Ex: meshes, cameras, etc..
 class Scene {
 public:
-    Scene() = default;
+    Scene();
 
     template <typename T>
     void AddObject(T&& object) {
@@ -26,9 +34,45 @@ public:
     bool GetActiveCamera(Camera& camera);
     
     Light* GetLight();
+    
+    /// Camera flagged as active, the one the processors cull and stream with and the passes render with
+    /// - Returns: entt::null when no camera is active
+    entt::entity GetActiveCameraEntity();
+    
+    /// CameraComponent of GetActiveCameraEntity, nullptr when no camera is active
+    CameraComponent* GetActiveCameraComponent();
 
     inline entt::registry& GetRegistry() { return _registry; };
     
+    inline TransformHierarchy& GetTransformHierarchy() { return _transformHierarchy; };
+    
+    inline SpatialIndex& GetSpatialIndex() { return _spatialIndex; };
+    
+    inline VisibilitySet& GetVisibilitySet() { return _visibilitySet; };
+    
+    inline TextureResidency& GetTextureResidency() { return _textureResidency; };
+
+    // Bulk insertion, for imports committing thousands of entities a frame. The construction signals still fire once
+    // per entity, in order, same as with emplace
+    
+    /// Creates an entity for every element of entities at once
+    void CreateEntities(std::span<entt::entity> entities) {
+        _registry.create(entities.begin(), entities.end());
+    }
+    
+    /// Grows the storage of a component ahead of inserting count more, once for a whole import
+    template<typename Component>
+    void ReserveComponents(std::size_t count) {
+        auto& storage = _registry.storage<Component>();
+        storage.reserve(storage.size() + count);
+    }
+    
+    /// Moves one component out of components into each entity, e.g. a member of a range of structs through std::views::transform
+    template<typename Component, std::ranges::input_range Range>
+    void InsertComponents(std::span<const entt::entity> entities, Range&& components) {
+        _registry.insert<Component>(entities.begin(), entities.end(), std::make_move_iterator(std::ranges::begin(components)));
+    }
+    
     // Deprecate
     template <typename ...Components>
     decltype(auto) GetComponents(entt::entity entity) {
@@ -56,5 +100,11 @@ private:
 private:
     std::vector<GenericInstanceWrapper<IBaseObject>> _wrappedObjects;
     entt::entity _activeCamera;
+    TextureResidency _textureResidency;
+    
+    // Listen to registry signals, declared first so they outlive the registry
+    TransformHierarchy _transformHierarchy;
+    SpatialIndex _spatialIndex;
+    VisibilitySet _visibilitySet;
     entt::registry _registry;
 };
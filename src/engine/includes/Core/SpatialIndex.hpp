@@ -0,0 +1,51 @@
+#pragma once
+#include <entt/entity/registry.hpp>
+#include "Core/DynamicBVH.hpp"
+
+class TransformHierarchy;
+
+struct RaycastHit {
+    entt::entity _entity = entt::null;
+    float _distance = 0.0f;
+};
+
+/**
+ *  Keeps a DynamicBVH in sync with the registry, one leaf per entity with a BoundsComponent and a computed transform.
+ *
+ *  Only the transforms the hierarchy recomputed this frame are looked at, so the update cost follows what moved. Leaf
+ * boxes are enlarged, the queries test the exact world box of the leaves they reach.
+ */
+class SpatialIndex {
+public:
+    // Listens to the bounds storage of the registry, must be called once and the index must outlive the registry
+    void Attach(entt::registry& registry);
+
+    // Call after the transform hierarchy update
+    void Update(entt::registry& registry, const TransformHierarchy& hierarchy);
+
+    /**
+     * Entities whose bounds may be inside the frustum
+     * @param bFullyInside - optional, one flag per entity, set when the enlarged leaf box is inside every plane
+     */
+    void QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& entities, std::vector<std::uint8_t>* bFullyInside = nullptr) const;
+
+    // Entities whose world box overlaps the box
+    void QueryAABB(const AABB& box, std::vector<entt::entity>& entities) const;
+
+    // Closest entity whose world box the ray hits
+    std::optional<RaycastHit> Raycast(const Ray& ray, float maxDistance) const;
+
+    [[nodiscard]] const DynamicBVH& GetTree() const { return _tree; }
+
+private:
+    void OnBoundsConstructed(entt::registry& registry, entt::entity entity);
+    void OnBoundsDestroyed(entt::registry& registry, entt::entity entity);
+
+    void InsertOrMove(entt::registry& registry, entt::entity entity, bool bDeferred);
+
+private:
+    DynamicBVH _tree;
+    std::unordered_map<entt::entity, std::int32_t> _proxies;
+    std::vector<AABB> _worldBounds; // Exact boxes indexed by proxy, the tree only holds the enlarged ones
+    std::vector<entt::entity> _pendingEntities; // Got bounds since the last update
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <entt/entity/registry.hpp>
+#include "glm/glm.hpp"
+#include "Core/TransformKernels.hpp"
+
+class TransformComponent;
+
+/**
+ * Flattened view of the transform hierarchy, kept in depth first order so parents always come before their children
+ * and the subtree of a node is the contiguous range [index, index + subtreeSize).
+ *
+ *  The order is only rebuilt when transforms are created or destroyed, moving a transform marks it dirty and the next
+ * Update only recomputes the dirty subtrees. Large ranges are split across the job system, local matrices in
+ * contiguous chunks and world matrices one hierarchy level at a time, since every node of a level only depends on the
+ * level above it. Writers either go through registry.patch<TransformComponent> or call MarkDirty after changing the
+ * component in place.
+ */
+class TransformHierarchy {
+public:
+    // Listens to the transform storage of the registry, must be called once and the hierarchy must outlive the registry
+    void Attach(entt::registry& registry);
+
+    void MarkDirty(entt::entity entity);
+
+    // Call after editing _childs of a transform that already lives in the registry
+    void MarkStructureDirty() { _bStructureDirty = true; }
+
+    // Recomputes the world matrix of every dirty transform and its descendants into TransformComponent::_computedMatrix
+    void Update(entt::registry& registry);
+
+    [[nodiscard]] std::size_t GetSize() const { return _entities.size(); }
+
+    [[nodiscard]] const std::vector<entt::entity>& GetEntities() const { return _entities; }
+
+    [[nodiscard]] const std::vector<glm::mat4>& GetWorldMatrices() const { return _worldMatrices; }
+
+    // Transforms whose world matrix was recomputed by the last Update
+    [[nodiscard]] const std::vector<entt::entity>& GetUpdatedEntities() const { return _updatedEntities; }
+
+private:
+    void OnStructureChanged(entt::registry& registry, entt::entity entity);
+    void OnTransformUpdated(entt::registry& registry, entt::entity entity);
+
+    void Rebuild(entt::registry& registry);
+    void UpdateRange(std::uint32_t begin, std::uint32_t end);
+    void ComposeLocalMatrices(std::uint32_t begin, std::uint32_t end);
+    // Nodes in an order where parents come first, or whose parents are final already
+    void ComposeWorldMatrices(const std::uint32_t* nodes, std::size_t count);
+
+private:
+    // One entry per transform, all in depth first order
+    std::vector<entt::entity> _entities;
+    std::vector<TransformComponent*> _components; // Stable until the next structural change, which triggers a rebuild
+    std::vector<std::int32_t> _parents; // -1 for roots
+    std::vector<std::uint32_t> _depths;
+    std::vector<std::uint32_t> _subtreeSizes; // Includes the node itself
+    std::vector<glm::mat4> _worldMatrices;
+    std::vector<glm::mat4> _localMatrices;
+    TransformSoA _localTransforms; // Copy of the component values the batch kernels read from, refreshed for dirty ranges
+    std::vector<std::uint8_t> _dirtyFlags;
+
+    std::unordered_map<entt::entity, std::uint32_t> _indices;
+    std::vector<std::uint32_t> _dirtyNodes;
+    std::vector<entt::entity> _updatedEntities;
+    std::vector<std::uint32_t> _levelNodes; // Scratch, nodes of a range grouped by depth, or in order for a serial update
+    std::vector<std::uint32_t> _levelOffsets;
+    bool _bStructureDirty = true;
+    SimdIsa _isa = TransformKernels::GetBestIsa();
+};
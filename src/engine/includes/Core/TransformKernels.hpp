@@ -0,0 +1,52 @@
+#pragma once
+
+/**
+ * Translation, rotation and scale of many transforms in structure of arrays form, the layout the batch kernels read
+ * from. Rotations are quaternions.
+ */
+struct TransformSoA {
+    std::vector<float> _positionX, _positionY, _positionZ;
+    std::vector<float> _rotationX, _rotationY, _rotationZ, _rotationW;
+    std::vector<float> _scaleX, _scaleY, _scaleZ;
+
+    void Resize(std::size_t size);
+
+    [[nodiscard]] std::size_t Size() const { return _positionX.size(); }
+};
+
+enum class SimdIsa : std::uint8_t {
+    Scalar,
+    SSE,
+    AVX2,
+    NEON
+};
+
+/**
+ * Batched matrix kernels used by the transform hierarchy, all matrices are column major 4x4 (glm::mat4 layout).
+ *
+ *  Each kernel has a scalar version and SSE/AVX2/NEON versions, the best one the CPU supports is picked at runtime.
+ * AVX2 is compiled through function target attributes so the engine does not need to be built with -mavx2.
+ */
+class TransformKernels {
+public:
+    static SimdIsa GetBestIsa();
+
+    static bool IsSupported(SimdIsa isa);
+
+    static const char* GetIsaName(SimdIsa isa);
+
+    /**
+     * Builds translate * rotate * scale for transforms [begin, end), 4 (SSE/NEON) or 8 (AVX2) transforms at a time
+     * @param matrices - 16 floats per transform, indexed from begin
+     */
+    static void ComposeLocal(SimdIsa isa, const TransformSoA& transforms, std::size_t begin, std::size_t end, float* matrices);
+
+    // out = lhs * rhs, out may alias rhs but not lhs
+    static void MultiplyMatrix(SimdIsa isa, const float* lhs, const float* rhs, float* out);
+
+    /**
+     * out[k] = lhs[k] * rhs[k] for a batch of products, the kernel is picked once for the whole batch. Products run in
+     * order, so lhs[k] may point at the out of an earlier product, e.g. a parent world matrix of the same batch
+     */
+    static void MultiplyMatrices(SimdIsa isa, const float* const* lhs, const float* const* rhs, float* const* out, std::size_t count);
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <entt/entity/registry.hpp>
+#include "Core/FrustumCulling.hpp"
+#include "Core/OcclusionBuffer.hpp"
+
+class SpatialIndex;
+class TransformComponent;
+class BoundsComponent;
+
+/**
+ *  Primitives that survived frustum culling this frame, render passes iterate this list instead of every entity with
+ * a PrimitiveProxyComponent.
+ *
+ *  Candidates come from the spatial index, leaves whose box is fully inside the frustum are accepted as they are and
+ * only the ones crossing a plane go through the batched plane tests. Primitives without a BoundsComponent can not be
+ * tested and are always treated as visible.
+ *
+ *  What survives the frustum then goes through occlusion culling, the few primitives covering the most screen are
+ * rasterized on the CPU as occluders and every bounded primitive is tested against their depth pyramid.
+ */
+class VisibilitySet {
+public:
+    // Listens to the primitive and bounds storages of the registry to track primitives that can not be culled
+    void Attach(entt::registry& registry);
+
+    // A missing view projection (no active camera) keeps every primitive visible
+    void Update(entt::registry& registry, const SpatialIndex& spatialIndex, const std::optional<glm::mat4>& viewProjection);
+
+    void SetOcclusionCulling(bool bEnabled) { _bOcclusionCulling = bEnabled; }
+
+    [[nodiscard]] const std::vector<entt::entity>& GetVisibleEntities() const { return _visibleEntities; }
+
+private:
+    void OnPrimitiveConstructed(entt::registry& registry, entt::entity entity);
+    void OnPrimitiveDestroyed(entt::registry& registry, entt::entity entity);
+    void OnBoundsConstructed(entt::registry& registry, entt::entity entity);
+    void OnBoundsDestroyed(entt::registry& registry, entt::entity entity);
+
+    void CullRange(const Frustum& frustum, std::size_t begin, std::size_t end);
+    void CullOccluded(entt::registry& registry, const glm::mat4& viewProjection);
+
+private:
+    std::vector<entt::entity> _queryEntities;
+    std::vector<std::uint8_t> _queryFullyInside;
+
+    // Primitives crossing a frustum plane, parallel arrays
+    std::vector<entt::entity> _candidates;
+    std::vector<const TransformComponent*> _transforms;
+    std::vector<const BoundsComponent*> _localBounds;
+    CullingBoundsSoA _worldBounds;
+    std::vector<std::uint8_t> _visibleFlags;
+
+    // Occlusion stage, the candidates are the visible primitives with bounds
+    OcclusionBuffer _occlusionBuffer;
+    std::vector<std::pair<float, entt::entity>> _occluders; // Screen size, entity
+    std::vector<entt::entity> _occlusionCandidates;
+    std::vector<AABB> _occlusionBounds;
+    std::vector<std::uint8_t> _occludedFlags;
+    bool _bOcclusionCulling = true;
+
+    std::unordered_set<entt::entity> _unboundedPrimitives;
+    std::vector<entt::entity> _visibleEntities;
+    SimdIsa _isa = TransformKernels::GetBestIsa();
+};
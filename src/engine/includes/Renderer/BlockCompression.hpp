@@ -0,0 +1,58 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+
+// What a texture may be compressed to once decoded, the exact format is picked from its content
+enum class TextureCompression : std::uint8_t {
+    None,             // Kept as RGBA8, the ratios below are against it
+    Color,            // BC1 when fully opaque, BC3 otherwise. 8:1 and 4:1
+    ColorHighQuality, // BC7, 4:1 with far less banding than BC1/BC3
+    TwoChannel        // BC5 of the red and green channels, normal maps and other two component data. 4:1
+};
+
+/**
+ *  CPU encoder for the block compressed formats, every 4x4 texel block is stored in 8 (BC1) or 16 bytes. Textures stay
+ * compressed in GPU memory and are sampled directly, which is where the memory savings come from.
+ *
+ *  Endpoints are fitted along the principal axis of each block's colors and refined by least squares, good enough for
+ * material textures but slow, a 2048x2048 texture takes about half a second (BC7 twice that) on one thread, which is
+ * why the results are cached (see TextureDecoder). BC7 only uses mode 6 (one subset, RGBA endpoints, 16 levels).
+ * Output is deterministic so it can be cached by content.
+ *
+ *  Images that are not a multiple of 4 are padded by repeating their last row and column.
+ */
+class BlockCompression {
+public:
+    // Changes whenever the encoder output does, part of every cache key
+    static constexpr std::uint32_t Version = 1;
+
+    static constexpr std::uint32_t BlockExtent = 4;
+
+    [[nodiscard]] static bool IsCompressed(Format format);
+
+    // Bytes per 4x4 block, 0 for uncompressed formats
+    [[nodiscard]] static std::size_t GetBlockSize(Format format);
+
+    // Bytes per texel of uncompressed formats, 0 for compressed ones
+    [[nodiscard]] static std::size_t GetTexelSize(Format format);
+
+    // Bytes between two rows of texels, or of blocks for compressed formats
+    [[nodiscard]] static std::size_t GetRowPitch(Format format, std::uint32_t width);
+
+    // Rows of texels, or of blocks for compressed formats
+    [[nodiscard]] static std::uint32_t GetRowCount(Format format, std::uint32_t height);
+
+    // Size of a tightly packed image of any format
+    [[nodiscard]] static std::size_t GetImageDataSize(Format format, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * Format the texture is compressed to
+     * @param rgba - decoded image, 4 channels of 8 bits. Only read to look for transparency
+     */
+    [[nodiscard]] static Format ChooseFormat(TextureCompression compression, const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height);
+
+    /**
+     * Compresses a decoded image, blocks are written row by row
+     * @param blocks - GetImageDataSize(format, width, height) bytes
+     */
+    static void Compress(Format format, const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint8_t* blocks);
+};
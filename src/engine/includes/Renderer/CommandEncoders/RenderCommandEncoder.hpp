@@ -25,6 +25,8 @@ public:
 
     virtual void BeginRenderPass(GraphicsPipeline* pipeline, const RenderAttachments& attachments) = 0;
     virtual void EndRenderPass() = 0;
+    // Switches to another pipeline inside the current render pass, it must be compatible with the pass attachments
+    virtual void BindPipeline(GraphicsPipeline* pipeline) = 0;
     virtual void SetViewport(const glm::vec2& viewportSize) = 0;
     virtual void SetScissor(const glm::vec2& extent, const glm::vec2& offset) = 0;
     virtual void DispatchDataStreams(GraphicsPipeline* graphicsPipeline, const std::vector<ShaderDataStream> dataStreams) = 0;
@@ -22,6 +22,16 @@ public:
     
     [[nodiscard]] glm::vec2 GetSwapchainExtent() const;
     
+    // Device limits used when laying out shader data, backends override with the real values
+    [[nodiscard]] virtual bool SupportsPushConstants() const { return false; }
+    
+    [[nodiscard]] virtual std::uint32_t GetMaxPushConstantsSize() const { return 0; }
+    
+    [[nodiscard]] virtual std::size_t GetMinUniformBufferOffsetAlignment() const { return 256; }
+    
+    // Whether textures can be sampled in the BC1 to BC7 formats
+    [[nodiscard]] virtual bool SupportsBlockCompression() const { return false; }
+    
 private:
     Window* _window = nullptr;
     std::unique_ptr<Swapchain> _swapChain;
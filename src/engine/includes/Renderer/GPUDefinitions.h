@@ -168,6 +168,10 @@ enum Format {
     FORMAT_R8G8_SNORM,
     FORMAT_R8G8B8_SNORM,
     FORMAT_R32G32_UNORM,
+    FORMAT_BC1_RGBA_SRGB, // Block compressed, 4x4 texels per block (see BlockCompression)
+    FORMAT_BC3_SRGB,
+    FORMAT_BC5_UNORM,
+    FORMAT_BC7_SRGB,
     END_COLOR_FORMATS, // DO NOT USE, JUST FOR REFERENCE
     FORMAT_D32_SFLOAT,
     END_DEPTH_FORMATS,
@@ -351,7 +355,8 @@ enum class ShaderDataBlockUsage {
     NONE, // case for push constants where this is not relevant
     UNIFORM_BUFFER,
     TEXTURE,
-    SAMPLER
+    SAMPLER,
+    STORAGE_BUFFER
 };
 
 struct ShaderDataBlock {
@@ -433,7 +438,8 @@ enum TextureLoadFlags {
     TexLoad_Data, // Created with an array of pixel data
     TexLoad_DynamicData, // Created with no initial data, but pixel data is updated on the fly
     TexLoad_Attachment, // Created with no data, resources will act as attachments for render passes
-    TexLoad_ExternalResource // Created with external resource. Ex: swapchain images
+    TexLoad_ExternalResource, // Created with external resource. Ex: swapchain images
+    TexLoad_EncodedData // Created with image file bytes (png, jpg...), decoded when needed
 };
 
 enum TextureType {
@@ -495,6 +501,7 @@ struct ShaderParams {
     ShaderInputBindings _shaderInputBindings;
     std::vector<ShaderDataStream> _shaderDataStreams;
     std::string _shaderPath;
+    std::vector<std::string> _defines; // Permutation defines, see ShaderPermutation
 };
 
 struct Encoders {
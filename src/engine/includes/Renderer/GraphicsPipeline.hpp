@@ -31,12 +31,45 @@ public:
      */
     static std::shared_ptr<GraphicsPipeline> Create(const GraphicsPipelineParams& params);
     
+    /**
+     * Pipeline cache statistics, a hit means Create returned an already existing pipeline
+     */
+    static std::size_t GetCacheHitCount();
+    static std::size_t GetCacheMissCount();
+    
+    /**
+     * Pipelines currently alive in the cache that use the shader at the given path in any stage
+     */
+    static std::vector<std::shared_ptr<GraphicsPipeline>> GetPipelinesUsingShader(const std::string& shaderPath);
+    
+    /**
+     * Shader paths of every cached pipeline, used to know which files to watch for changes
+     */
+    static std::vector<std::string> GetCachedShaderPaths();
+    
+    /**
+     * Builds and compiles a new pipeline with the params of an existing one, the cache is not touched.
+     * Safe to call from a worker thread, the result is only usable once IsCompiled returns true.
+     */
+    static std::shared_ptr<GraphicsPipeline> Rebuild(const GraphicsPipelineParams& params);
+    
+    /**
+     * Makes the replacement the pipeline returned by Create for the params of pipeline.
+     * Must be called at a frame boundary, passes pick the replacement up the next time they call Create.
+     */
+    static void Replace(const std::shared_ptr<GraphicsPipeline>& pipeline, const std::shared_ptr<GraphicsPipeline>& replacement);
+    
     /**
      * @brief Compile the pipeline
      *
      */
     virtual void Compile() {};
     
+    /**
+     * @return false if Compile was not called yet or it failed
+     */
+    [[nodiscard]] virtual bool IsCompiled() const { return true; }
+    
     Shader* GetVertexShader();
     
     Shader* GetFragmentShader();
@@ -51,4 +84,7 @@ protected:
 protected:
     std::unique_ptr<Shader> _fragmentShader;
     std::unique_ptr<Shader> _vertexShader;
+    
+private:
+    std::size_t _cacheKey = 0;
 };
@@ -0,0 +1,36 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+
+/**
+ *  Builds the mip chain of decoded images on the CPU, so it can be block compressed level by level and cached with the
+ * rest of the texture. Levels are halved with a 2x2 box filter, color is averaged in linear space for sRGB images (a
+ * plain average of sRGB values darkens every level) while alpha is always averaged as is.
+ *
+ *  A chain is stored level after level, largest first, every level tightly packed in the image format.
+ */
+class MipGenerator {
+public:
+    // Levels down to 1x1
+    [[nodiscard]] static std::uint32_t GetLevelCount(std::uint32_t width, std::uint32_t height);
+
+    // Width or height of a level
+    [[nodiscard]] static std::uint32_t GetLevelExtent(std::uint32_t extent, std::uint32_t level);
+
+    // Bytes before the level in a chain
+    [[nodiscard]] static std::size_t GetLevelOffset(Format format, std::uint32_t width, std::uint32_t height, std::uint32_t level);
+
+    [[nodiscard]] static std::size_t GetChainSize(Format format, std::uint32_t width, std::uint32_t height, std::uint32_t levelCount);
+
+    /**
+     * Writes the next level of a 4 channel image, columns and rows past the edge repeat the last ones
+     * @param dst - GetLevelExtent(width, 1) x GetLevelExtent(height, 1) texels
+     * @param bSrgb - color channels are sRGB encoded
+     */
+    static void Downsample(const std::uint8_t* src, std::uint32_t width, std::uint32_t height, std::uint8_t* dst, bool bSrgb);
+
+    /**
+     * Fills every level after the first of a 4 channel image
+     * @param rgba - GetChainSize(FORMAT_R8G8B8A8_SRGB, width, height, levelCount) bytes, the first level already written
+     */
+    static void GenerateChain(std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint32_t levelCount, bool bSrgb);
+};
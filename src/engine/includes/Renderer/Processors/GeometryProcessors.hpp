@@ -74,7 +74,10 @@ public:
                 continue;
             }
         
-            allocationSize += proxyComponent._indices.size() * sizeof(unsigned int) + proxyComponent._vertexData.size() * sizeof(VertexData);
+            allocationSize += proxyComponent.GetIndices().size_bytes() + proxyComponent.GetVertexData().size_bytes();
+            for(std::size_t lod = 0; lod < proxyComponent.GetLodCount(); lod++) {
+                allocationSize += proxyComponent.GetLod(lod)._indices.size_bytes();
+            }
         }
     
         // There is no need to process any geometry, since there is nothing to allocate
@@ -97,21 +100,34 @@ public:
         
             const PrimitiveProxyComponentCPU& proxyComponent = scene->GetRegistry().get<PrimitiveProxyComponentCPU>(entity);
             
-            // Calculate the total size needed for indices and vertex data
-            size_t indicesSize = proxyComponent._indices.size() * sizeof(unsigned int);
-            size_t vertexDataSize = proxyComponent._vertexData.size() * sizeof(VertexData);
-        
-            // Copy indices data
-            memcpy(bufferPtr + bufferOffset, proxyComponent._indices.data(), indicesSize);
+            PrimitiveProxyComponent gpuProxyComponent;
+            gpuProxyComponent._gpuBuffer = buffer;
+
+            // Every level of detail gets its indices one after the other, they all share the vertex data that follows.
+            // Cooked assets are copied straight from the mapped file
+            size_t indicesSize = 0;
+            auto CopyIndices = [&](std::span<const unsigned int> indices, float error) {
+                memcpy(bufferPtr + bufferOffset + indicesSize, indices.data(), indices.size_bytes());
+                gpuProxyComponent._lods.push_back({static_cast<unsigned int>(bufferOffset + indicesSize), static_cast<unsigned int>(indices.size()), error});
+                indicesSize += indices.size_bytes();
+            };
+
+            CopyIndices(proxyComponent.GetIndices(), 0.0f);
+            for(std::size_t lod = 0; lod < proxyComponent.GetLodCount(); lod++) {
+                const PrimitiveLodView lodView = proxyComponent.GetLod(lod);
+                CopyIndices(lodView._indices, lodView._error);
+            }
+
+            const std::span<const VertexData> vertexData = proxyComponent.GetVertexData();
+            size_t vertexDataSize = vertexData.size_bytes();
         
             // Copy vertex data after the indices data
-            memcpy(bufferPtr + bufferOffset + indicesSize, proxyComponent._vertexData.data(), vertexDataSize);
+            memcpy(bufferPtr + bufferOffset + indicesSize, vertexData.data(), vertexDataSize);
 
-//            printVertexData(bufferPtr + bufferOffset + indicesSize, proxyComponent._vertexData.size());
+//            printVertexData(bufferPtr + bufferOffset + indicesSize, vertexData.size());
 
-            PrimitiveProxyComponent gpuProxyComponent;
-            gpuProxyComponent._gpuBuffer = buffer;
-            gpuProxyComponent._indicesCount = proxyComponent._indices.size();
+            // Full mesh until LodProcessor picks a level
+            gpuProxyComponent._indicesCount = proxyComponent.GetIndices().size();
             gpuProxyComponent._indicesOffset = bufferOffset;
             gpuProxyComponent._vertexOffset = bufferOffset + indicesSize;
         
@@ -0,0 +1,55 @@
+#pragma once
+#include "Core/Scene.hpp"
+#include "Components/CameraComponent.hpp"
+#include "Components/BoundsComponent.hpp"
+#include "Components/PrimitiveProxyComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include <cmath>
+#include <limits>
+
+class LodProcessor {
+public:
+    // Projected error a level of detail may have, in pixels
+    static constexpr float MaxScreenError = 1.0f;
+
+    // Picks the index range every visible primitive draws, needs the visible list so it runs after VisibilityProcessor
+    static void Process(Scene* scene, float viewportHeight) {
+        entt::registry& registry = scene->GetRegistry();
+
+        const CameraComponent* camera = scene->GetActiveCameraComponent();
+
+        // Pixels per unit of distance at depth 1, the same scale glm::perspective puts in the projection
+        const float pixelsPerUnit = camera ? std::abs(0.5f * viewportHeight / std::tan(camera->m_Fov * 0.5f)) : 0.0f;
+        const glm::vec3 cameraPosition = camera ? glm::vec3(glm::inverse(camera->m_ViewMatrix)[3]) : glm::vec3(0.0f);
+
+        for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+            auto* proxy = registry.try_get<PrimitiveProxyComponent>(entity);
+            if(!proxy || proxy->_lods.size() < 2) {
+                continue;
+            }
+
+            std::size_t lodIndex = 0;
+            const auto* bounds = registry.try_get<BoundsComponent>(entity);
+            const auto* transform = registry.try_get<TransformComponent>(entity);
+
+            // Without a camera or bounds there is no screen size, the full mesh is drawn
+            if(camera && bounds && transform && transform->_computedMatrix) {
+                const glm::mat4& matrix = transform->_computedMatrix.value();
+                const float scale = std::max({glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))});
+                const glm::vec3 center = glm::vec3(matrix * glm::vec4(bounds->GetCenter(), 1.0f));
+
+                // Nearest point of the bounding sphere, the error is projected as if it was there
+                const float distance = glm::length(center - cameraPosition) - bounds->_radius * scale;
+                const float pixelsPerError = distance > 0.0f ? scale * pixelsPerUnit / distance : std::numeric_limits<float>::max();
+
+                while(lodIndex + 1 < proxy->_lods.size() && proxy->_lods[lodIndex + 1]._error * pixelsPerError <= MaxScreenError) {
+                    lodIndex++;
+                }
+            }
+
+            proxy->_lodIndex = static_cast<unsigned int>(lodIndex);
+            proxy->_indicesOffset = proxy->_lods[lodIndex]._indicesOffset;
+            proxy->_indicesCount = proxy->_lods[lodIndex]._indicesCount;
+        }
+    };
+};
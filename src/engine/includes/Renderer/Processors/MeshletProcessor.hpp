@@ -0,0 +1,48 @@
+#pragma once
+#include "Core/Scene.hpp"
+#include "Core/Meshlets.hpp"
+#include "Components/CameraComponent.hpp"
+#include "Components/PrimitiveProxyComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+
+class MeshletProcessor {
+public:
+    // Culls the meshlets of the visible primitives drawing their full mesh, runs after LodProcessor picked the levels
+    static void Process(Scene* scene, float aspectRatio) {
+        entt::registry& registry = scene->GetRegistry();
+
+        // Same camera and projection VisibilityProcessor culls with
+        const CameraComponent* camera = scene->GetActiveCameraComponent();
+
+        const glm::mat4 viewProjection = camera ? glm::perspective(camera->m_Fov, aspectRatio, camera->_nearPlane, camera->_farPlane) * camera->m_ViewMatrix : glm::mat4(1.0f);
+        const glm::vec4 cameraPosition = camera ? glm::inverse(camera->m_ViewMatrix)[3] : glm::vec4(0.0f);
+
+        MeshletCulling culling;
+        const SimdIsa isa = TransformKernels::GetBestIsa();
+
+        for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+            auto* proxy = registry.try_get<PrimitiveProxyComponent>(entity);
+            if(!proxy) {
+                continue;
+            }
+
+            const auto* geometry = registry.try_get<PrimitiveProxyComponentCPU>(entity);
+            const auto* transform = registry.try_get<TransformComponent>(entity);
+
+            // Coarser levels have their own indices, the meshlets only index the full mesh
+            proxy->_bDrawRanges = false;
+            if(!camera || proxy->_lodIndex != 0 || !geometry || geometry->_meshlets._meshlets.empty() || !transform || !transform->_computedMatrix) {
+                continue;
+            }
+
+            // Tested in object space, the camera is moved there instead of every meshlet into the world
+            const glm::mat4& matrix = transform->_computedMatrix.value();
+            const glm::vec3 localCamera = glm::vec3(glm::inverse(matrix) * cameraPosition);
+            const bool bMirrored = glm::determinant(glm::mat3(matrix)) < 0.0f;
+
+            const std::size_t culledTriangles = culling.Cull(isa, geometry->_meshlets, viewProjection * matrix, localCamera, !bMirrored, proxy->_drawRanges);
+            proxy->_bDrawRanges = culledTriangles > 0;
+        }
+    };
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "Core/Scene.hpp"
+#include "Components/CameraComponent.hpp"
+#include "Components/BoundsComponent.hpp"
+#include "Components/PhongMaterialComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include <cmath>
+#include <limits>
+
+class TextureStreamingProcessor {
+public:
+    // Reports how large the visible primitives show their textures, the passes request them afterwards
+    static void Process(Scene* scene, float viewportHeight) {
+        entt::registry& registry = scene->GetRegistry();
+
+        const CameraComponent* camera = scene->GetActiveCameraComponent();
+
+        // Without a camera nothing is reported and every texture keeps all its levels
+        if(!camera) {
+            return;
+        }
+
+        const float pixelsPerUnit = std::abs(0.5f * viewportHeight / std::tan(camera->m_Fov * 0.5f));
+        const glm::vec3 cameraPosition = glm::vec3(glm::inverse(camera->m_ViewMatrix)[3]);
+        TextureResidency& residency = scene->GetTextureResidency();
+
+        for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+            const auto* material = registry.try_get<PhongMaterialComponent>(entity);
+            const auto* bounds = registry.try_get<BoundsComponent>(entity);
+            const auto* transform = registry.try_get<TransformComponent>(entity);
+            if(!material || !material->_diffuseTexture || !bounds || !transform || !transform->_computedMatrix) {
+                continue;
+            }
+
+            const glm::mat4& matrix = transform->_computedMatrix.value();
+            const float scale = std::max({glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))});
+            const glm::vec3 center = glm::vec3(matrix * glm::vec4(bounds->GetCenter(), 1.0f));
+
+            // Diameter of the bounding sphere at its nearest point, the camera inside of it sees the finest level
+            const float distance = glm::length(center - cameraPosition) - bounds->_radius * scale;
+            const float pixels = distance > 0.0f ? 2.0f * bounds->_radius * scale * pixelsPerUnit / distance : std::numeric_limits<float>::max();
+            residency.ReportFootprint(material->_diffuseTexture, pixels);
+        }
+    };
+};
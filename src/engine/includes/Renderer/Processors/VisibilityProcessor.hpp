@@ -0,0 +1,22 @@
+#pragma once
+#include "Core/Scene.hpp"
+#include "Components/CameraComponent.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+
+class VisibilityProcessor {
+public:
+    // Culls every primitive against the camera frustum and the occluders, needs the world matrices so it runs after TransformProcessor
+    static void Process(Scene* scene, float aspectRatio) {
+        entt::registry& registry = scene->GetRegistry();
+
+        // Same camera and projection the render passes pick
+        if(const CameraComponent* camera = scene->GetActiveCameraComponent()) {
+            const glm::mat4 projMatrix = glm::perspective(camera->m_Fov, aspectRatio, camera->_nearPlane, camera->_farPlane);
+            
+            scene->GetVisibilitySet().Update(registry, scene->GetSpatialIndex(), projMatrix * camera->m_ViewMatrix);
+            return;
+        }
+        
+        scene->GetVisibilitySet().Update(registry, scene->GetSpatialIndex(), std::nullopt);
+    };
+};
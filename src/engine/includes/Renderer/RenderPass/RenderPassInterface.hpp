@@ -1,6 +1,7 @@
 #pragma once
 #include "entt/entity/entity.hpp"
 #include "Renderer/GPUDefinitions.h"
+#include "Renderer/ShaderPermutation.hpp"
 #include <set>
 
 struct GraphicsPipelineParams;
@@ -72,6 +73,9 @@ class PrimitiveProxyComponent;
  *      std::vector<ShaderDataBlock> _blocks;
  *  }
  *
+ *   ShaderDataPackingPlan implements the fallback, push constant blocks that do not fit the device limits are packed
+ *  into a uniform block at the descriptor set that follows the data streams sets, binding 0.
+ *
  *
  *
  */
@@ -83,6 +87,12 @@ public:
     virtual ~RenderPass() = default;
             
     [[nodiscard]] GraphicsPipeline* GetGraphicsPipeline() { return _pipeline.get(); };
+    
+    /**
+     * Pipeline compiled with the defines of the given features, passes call it per draw with the features the
+     * material actually provides so each draw uses the smallest shader. SF_None is the pass pipeline.
+     */
+    [[nodiscard]] GraphicsPipeline* GetPipelineVariant(ShaderFeatureKey features);
 
     void EnqueueRendering(GraphBuilder* graphBuilder, Scene* scene);
     
@@ -109,8 +119,8 @@ public:
     
     [[nodiscard]] virtual std::string GetFragmentShaderPath() = 0;
     
-    // Returns all textures resources that are going to be consumed during this pass
-    // TODO we need to improve this in a way that we only load textures that we know that are going to be used
+    // Returns the textures consumed during this pass, material textures should go through the scene TextureResidency
+    // so only the visible ones are loaded
     [[nodiscard]] virtual std::set<std::shared_ptr<Texture2D>> GetTextureResources(Scene* scene) = 0;
     
     // Keep in mind that the buffers should already have the data, this will be called when trying to upload to gpu memory
@@ -124,7 +134,11 @@ public:
             
 protected:
     std::shared_ptr<GraphicsPipeline> _pipeline;
+    std::unordered_map<ShaderFeatureKey, std::shared_ptr<GraphicsPipeline>> _pipelineVariants; // Refreshed every Initialize
     GraphicsContext* _graphicsContext = nullptr;
+
+private:
+    GraphicsPipelineParams MakePipelineParams(GraphicsContext* graphicsContext, ShaderFeatureKey features);
 };
 
 //class RenderPassExecuter {}; // Worth it for SOLID principles?
@@ -1,6 +1,7 @@
 #pragma once
 #include "GPUDefinitions.h"
 #include "GraphBuilder.hpp"
+#include "ShaderHotReloader.hpp"
 
 struct InitializationParams;
 class GraphicsContext;
@@ -29,5 +30,6 @@ private:
     
 private:    
     GraphBuilder _graphBuilder;
+    ShaderHotReloader _shaderHotReloader;
     std::map<Window*, uint8_t> _windowsContexts;
 };
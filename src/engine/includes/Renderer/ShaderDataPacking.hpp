@@ -0,0 +1,55 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+
+/**
+ * Where a push constant block ends up, either inside the push constant range or spilled into a uniform block
+ */
+struct ShaderDataBlockPlacement {
+    std::uint32_t _offset = 0;
+    std::uint32_t _size = 0;
+    ShaderStage _stage = ShaderStage::STAGE_UNDEFINED;
+    bool _bSpilled = false;
+};
+
+/**
+ *  Layout of the push constant data streams, built once when the pipeline is compiled.
+ *
+ *  Blocks are laid out in declaration order with std430 rules, once the device push constant limit is reached (or the
+ * backend has no push constants) the remaining blocks spill into a uniform block. The spilled blocks keep the same
+ * rules, for the types we support std140 and std430 agree so the shader can declare them as a regular uniform block.
+ */
+class ShaderDataPackingPlan {
+public:
+    // Size of the fixed staging area used at draw time, larger device limits are clamped to this
+    static constexpr std::uint32_t MaxPushConstantsSize = 256;
+
+    static ShaderDataPackingPlan Build(const std::vector<ShaderDataStream>& dataStreams, bool bSupportsPushConstants, std::uint32_t maxPushConstantsSize);
+
+    /**
+     * Copies the block values into the preplanned areas, dataStreams must have the same layout the plan was built with
+     * @param pushConstantData - at least GetPushConstantsSize() bytes
+     * @param spillData - at least GetSpillSize() bytes, can be null when nothing spilled
+     */
+    void Pack(const std::vector<ShaderDataStream>& dataStreams, std::byte* pushConstantData, std::byte* spillData) const;
+
+    [[nodiscard]] std::uint32_t GetPushConstantsSize() const { return _pushConstantsSize; }
+
+    [[nodiscard]] std::uint32_t GetSpillSize() const { return _spillSize; }
+
+    [[nodiscard]] bool HasSpill() const { return _spillSize > 0; }
+
+    [[nodiscard]] ShaderStage GetSpillStages() const { return _spillStages; }
+
+    [[nodiscard]] const std::vector<ShaderDataBlockPlacement>& GetPlacements() const { return _placements; }
+
+    /**
+     * std430 alignment and size of a block
+     */
+    static std::pair<std::uint32_t, std::uint32_t> GetBlockLayout(const ShaderDataBlock& dataBlock);
+
+private:
+    std::vector<ShaderDataBlockPlacement> _placements; // One per push constant block, in declaration order
+    std::uint32_t _pushConstantsSize = 0;
+    std::uint32_t _spillSize = 0;
+    ShaderStage _spillStages = ShaderStage::STAGE_UNDEFINED;
+};
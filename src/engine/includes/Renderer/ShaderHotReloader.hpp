@@ -0,0 +1,57 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+#include "Core/FileWatcher.hpp"
+#include <thread>
+#include <condition_variable>
+
+class GraphicsPipeline;
+
+/**
+ * Watches the shaders used by the cached pipelines and rebuilds the affected pipelines when a shader changes.
+ *
+ * Compilation happens on a worker thread, the main thread only swaps the finished pipelines into the pipeline
+ * cache at a frame boundary. The replaced pipelines are kept alive until every frame that could still be
+ * recording or executing with them has finished. When a shader fails to compile nothing is swapped, the last
+ * good pipeline keeps running until the file is fixed.
+ */
+class ShaderHotReloader {
+    struct PendingSwap {
+        std::shared_ptr<GraphicsPipeline> _pipeline;
+        std::shared_ptr<GraphicsPipeline> _replacement;
+    };
+
+    struct RetiredPipeline {
+        std::shared_ptr<GraphicsPipeline> _pipeline;
+        std::uint64_t _frame = 0;
+    };
+
+public:
+    ~ShaderHotReloader();
+
+    void Start(std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250));
+
+    void Stop();
+
+    /**
+     * Swaps the pipelines the worker finished and releases the retired ones, call once per frame before any pass
+     * requests its pipeline.
+     * @param framesInFlight - how many frames can use a pipeline after it was swapped out
+     */
+    void ProcessPendingSwaps(std::size_t framesInFlight);
+
+private:
+    void Run();
+    void Reload(const std::vector<std::string>& changedShaders);
+
+private:
+    FileWatcher _watcher; // Only touched by the worker
+    std::thread _worker;
+    std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::chrono::milliseconds _pollInterval {};
+    bool _bRunning = false;
+
+    std::vector<PendingSwap> _pendingSwaps; // Guarded by _mutex
+    std::vector<RetiredPipeline> _retiredPipelines; // Main thread only
+    std::uint64_t _frame = 0;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+using ShaderFeatureKey = std::uint32_t;
+
+/**
+ * Optional features a material can provide, each one maps to a preprocessor define so the shader only pays for
+ * what the material actually uses.
+ */
+enum ShaderFeature : ShaderFeatureKey {
+    SF_None = 0,
+    SF_DiffuseTexture = 1 << 0, // HAS_DIFFUSE_TEXTURE
+    SF_VertexColor = 1 << 1, // HAS_VERTEX_COLOR
+    SF_Count = 2
+};
+
+/**
+ * Helpers to turn a feature key into the defines of a shader permutation.
+ *
+ *  Permutations are regular pipelines, the defines are part of the shader params so the pipeline cache and the shader
+ * binary cache already keep one entry per permutation.
+ */
+class ShaderPermutation {
+public:
+    static const char* GetDefine(ShaderFeature feature);
+
+    // Defines sorted by feature bit, equal keys always produce the same list
+    static std::vector<std::string> GetDefines(ShaderFeatureKey features);
+
+    /**
+     * Inserts a #define line per define right after the #version directive, or at the top if the source has none
+     */
+    static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+
+/**
+ * Descriptor binding found in a SPIR-V module
+ */
+struct ShaderResourceBinding {
+    std::uint32_t _set = 0;
+    std::uint32_t _binding = 0;
+    std::uint32_t _count = 1; // Array elements, 1 when the resource is not an array
+    std::uint32_t _size = 0; // Byte size of uniform and storage blocks without their runtime array, 0 for images and samplers
+    ShaderDataBlockUsage _usage = ShaderDataBlockUsage::NONE;
+    ShaderStage _stage = ShaderStage::STAGE_UNDEFINED;
+    std::string _identifier;
+};
+
+struct ShaderPushConstantRange {
+    std::uint32_t _offset = 0;
+    std::uint32_t _size = 0;
+    ShaderStage _stage = ShaderStage::STAGE_UNDEFINED;
+};
+
+/**
+ * Resource layout of one or more shader stages extracted from SPIR-V, bindings are sorted by set and binding.
+ */
+struct ShaderReflection {
+    std::vector<ShaderResourceBinding> _bindings;
+    std::vector<ShaderPushConstantRange> _pushConstants;
+
+    /**
+     * Parses the SPIR-V module and fills the reflection data for the given stage
+     * @return false if the module is not valid SPIR-V or declares a resource type the renderer cannot bind
+     */
+    static bool Reflect(const std::vector<unsigned int>& spirv, ShaderStage stage, ShaderReflection& reflection);
+
+    /**
+     * Merges the reflection of multiple stages, bindings shared between stages only get the stages that declare them.
+     */
+    static ShaderReflection Merge(const ShaderReflection& lhs, const ShaderReflection& rhs);
+
+    const ShaderResourceBinding* FindBinding(std::uint32_t set, std::uint32_t binding) const;
+
+    /**
+     * Checks the data streams of a pass against the layout the shaders declare. Data streams map to descriptor sets in
+     * declaration order and their blocks to bindings, push constant streams are not part of the layout. Sets past the
+     * data streams are not checked, the push constant spill goes there.
+     * @return false if a binding has no block or a block of another usage or smaller size, mismatches are printed
+     */
+    bool ValidateDataStreams(const std::vector<ShaderDataStream>& dataStreams) const;
+
+    // Number of descriptor sets the pipeline layout needs, gaps between sets are included
+    std::uint32_t GetSetCount() const;
+};
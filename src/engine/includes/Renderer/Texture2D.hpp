@@ -1,5 +1,6 @@
 #pragma once
 #include "GPUDefinitions.h"
+#include "Renderer/TextureDecoder.hpp"
 
 class TextureResource;
 class Device;
@@ -29,6 +30,12 @@ public:
 
     static std::shared_ptr<Texture2D> MakeFromData(std::uint32_t width, std::uint32_t height, Format pixelFormat, const void* data, std::size_t size);
 
+    /**
+     * Keeps the image file bytes and decodes them when the texture is needed, null when they are not an image
+     * stb_image can read. Only the header is parsed here, for the dimensions
+     */
+    static std::shared_ptr<Texture2D> MakeFromEncodedData(std::shared_ptr<const std::vector<std::uint8_t>> encoded, Format pixelFormat);
+
     static std::shared_ptr<Texture2D> MakeFromExternalResource(std::uint32_t width, std::uint32_t height, Format pixelFormat, TextureFlags flags = Tex_None, unsigned int levels = 0);
 
     static std::shared_ptr<Texture2D> MakeAttachmentTexture(std::uint32_t width, std::uint32_t height, Format pixelFormat);
@@ -89,10 +96,15 @@ public:
     std::uint32_t GetHeight() const;
     
     /*
-     * Returns pixel format for the texture
+     * Returns pixel format for the texture, a block compressed one once a compressed image was uploaded
      */
     Format GetPixelFormat() const;
     
+    /**
+     * Returns the number of mip levels, 1 unless a decoded image came with its mips
+     */
+    std::uint32_t GetMipLevels() const { return _mipLevels; }
+
     /**
      * @brief Get the Texture Flags object
      * 
@@ -138,6 +150,10 @@ public:
      * @return Image data size in bytes
      */
     [[nodiscard]] size_t GetImageDataSize() const { return _dataSize; };
+
+    // Loaded textures upload their pixels once and load them again from their source after a FreeResource, their
+    // staging can go as soon as the upload was recorded. Dynamic ones are written again through Lock
+    [[nodiscard]] bool HasTransientStaging() const { return _loadFlags == TexLoad_Path || _loadFlags == TexLoad_EncodedData || _loadFlags == TexLoad_Data; }
     
     /**
      * @brief Reloads texture from disk and store in CPU memory
@@ -150,10 +166,45 @@ public:
     void ClearDirty();
     bool IsDirty() const;
 
+    // True when the next reload has to decode an image file first, see RequestDecode
+    [[nodiscard]] bool NeedsDecode() const;
+
+    /**
+     * Starts decoding on the TextureDecoder instead of in the next reload, hand the result to SetDecodedImage
+     * @param bAllowCompression - false when the device can not sample block compressed formats
+     * @return null when there is nothing to decode or the image can not be read
+     */
+    std::shared_ptr<TextureDecodeRequest> RequestDecode(float priority, bool bAllowCompression) const;
+
+    // Compression applied by RequestDecode, images decoded in the reload itself are never compressed
+    void SetCompression(TextureCompression compression) { _compression = compression; }
+
+    [[nodiscard]] TextureCompression GetCompression() const { return _compression; }
+
+    // Decoded images get their full mip chain, from the next decode on
+    void SetGenerateMips(bool bGenerateMips) { _bGenerateMips = bGenerateMips; }
+
+    [[nodiscard]] bool GetGenerateMips() const { return _bGenerateMips; }
+
+    // Pixels the next reload uploads instead of decoding them itself, freed once uploaded
+    void SetDecodedImage(DecodedImage image);
+
+    // Uploads only the smallest levels of decoded mip chains from the next reload on, 0 uploads all of them
+    void SetMaxMipLevels(std::uint32_t levels) { _maxMipLevels = levels; }
+
+    /**
+     * Lets go of the GPU resource and its views without destroying them, the next reload creates new ones
+     * @return keeps them alive, release it once no frame in flight samples them anymore
+     */
+    [[nodiscard]] std::shared_ptr<void> DetachResource();
+
 private:
  void HandleDynamicDataReload();
  void HandleFromPathReload();
  void HandleFromDataReload();
+ void HandleFromEncodedDataReload();
+ void UploadDecodedImage();
+ [[nodiscard]] TextureDecodeSettings GetDecodeSettings(bool bAllowCompression) const;
     
 protected:
     std::shared_ptr<TextureResource> _textureResource;
@@ -165,6 +216,11 @@ protected:
     TextureFlags _flags = Tex_SAMPLED_OP; // GPU flags
     TextureLoadFlags _loadFlags = TexLoad_None;
     Format _pixelFormat = Format::FORMAT_UNDEFINED;
+    Format _uncompressedFormat = Format::FORMAT_UNDEFINED; // Decoded textures go back to it when uploaded uncompressed
+    TextureCompression _compression = TextureCompression::None;
+    bool _bGenerateMips = false;
+    std::uint32_t _mipLevels = 1;
+    std::uint32_t _maxMipLevels = 0;
     ImageLayout _imageLayout = ImageLayout::LAYOUT_UNDEFINED;
     TextureFilter _magFilter = TextureFilter::NEAREST;
     TextureFilter _minFilter = TextureFilter::NEAREST;
@@ -174,4 +230,6 @@ protected:
     unsigned char* _data  = nullptr; // CPU Pixel data from when we load an image from disk
     size_t _dataSize = 0;
     const char* _path = nullptr;
+    std::shared_ptr<const std::vector<std::uint8_t>> _encodedData; // Image file bytes, TexLoad_EncodedData only
+    DecodedImage _decodedImage; // Decoded ahead of the reload, path and encoded textures only
 };
@@ -0,0 +1,168 @@
+#pragma once
+#include "Renderer/BlockCompression.hpp"
+#include "Renderer/MipGenerator.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+class TextureDecoder;
+class ImportCache;
+class MappedFile;
+
+struct DecodedPixelsDeleter {
+    bool _bStbAllocated = true; // Otherwise allocated with new[]
+    // Set when the pixels are read in place from the import cache, nothing is freed then
+    std::shared_ptr<const MappedFile> _mapping;
+
+    void operator()(std::uint8_t* pixels) const;
+};
+
+// Pixels of a decoded image, 4 channels of 8 bits unless it was block compressed. Mip levels follow the first one
+// (see MipGenerator). Images read back from the import cache point into its read only mapping
+struct DecodedImage {
+    using PixelsDeleter = DecodedPixelsDeleter;
+
+    std::unique_ptr<std::uint8_t[], PixelsDeleter> _pixels;
+    std::uint32_t _width = 0;
+    std::uint32_t _height = 0;
+    std::uint32_t _levelCount = 1;
+    Format _format = Format::FORMAT_R8G8B8A8_SRGB;
+
+    [[nodiscard]] std::size_t GetSize() const { return MipGenerator::GetChainSize(_format, _width, _height, _levelCount); }
+};
+
+// What happens to an image after it is decoded, in this order
+struct TextureDecodeSettings {
+    TextureCompression _compression = TextureCompression::None;
+    bool _bGenerateMips = false;
+    bool _bSrgb = true; // Mips average the color in linear space
+};
+
+/**
+ *  One image being decoded by the TextureDecoder. Dropping the last reference cancels it, a queued request is never
+ * started and the pixels of a finished one are freed.
+ */
+class TextureDecodeRequest {
+public:
+    enum class State : std::uint8_t {
+        Queued,
+        Decoding,
+        Decoded,
+        Failed
+    };
+
+    ~TextureDecodeRequest();
+
+    [[nodiscard]] State GetState() const { return _state; }
+
+    [[nodiscard]] bool IsFinished() const { return _state == State::Decoded || _state == State::Failed; }
+
+    // Higher decodes first, only matters while the request is queued
+    void SetPriority(float priority) { _priority = priority; }
+
+    [[nodiscard]] float GetPriority() const { return _priority; }
+
+    // Moves the pixels out of a decoded request, their memory no longer counts against the decoder from then on
+    DecodedImage TakeImage();
+
+private:
+    friend class TextureDecoder;
+
+    TextureDecoder* _decoder = nullptr;
+    std::string _path;                                     // Either a file
+    std::shared_ptr<const std::vector<std::uint8_t>> _encoded; // or image file bytes in memory
+    std::size_t _size = 0;                                 // Decoded size from the header, mips included
+    TextureDecodeSettings _settings;
+    std::size_t _reservedBytes = 0;                        // Part of the decoder's in flight bytes, guarded by its mutex
+    std::uint64_t _sequence = 0;
+    std::atomic<float> _priority = 0.0f;
+    std::atomic<State> _state = State::Queued;
+    DecodedImage _image; // Written by the worker before _state is Decoded
+};
+
+/**
+ *  Decodes PNG/JPEG (anything stb_image reads) on the job system, highest priority first. Every started decode reserves
+ * the size of its pixels until they are taken, new decodes wait while the reserved total is over the in flight limit so
+ * a model with hundreds of textures never has them all decoded in memory at once. A single image larger than the limit
+ * still decodes, alone.
+ *
+ *  Requests are polled, there are no callbacks, the owner checks IsFinished when it suits it (see TextureResidency).
+ *
+ *  Mips are generated and the requests asking for compression are block compressed on the same worker right after
+ * decoding, level by level. The blocks are stored in the import cache under the hash of the image file, so that a
+ * texture seen before, in this run or an earlier one, is read back already compressed and skips both stb_image and the
+ * encoder.
+ */
+class TextureDecoder {
+public:
+    // 256MB in flight, as many decodes at a time as there are job system workers, caches in ImportCache::GetDefaultDirectory()
+    static TextureDecoder& Get();
+
+    TextureDecoder(std::size_t maxInFlightBytes, std::size_t maxConcurrentDecodes);
+
+    // Waits for the running decodes, every request has to be dropped before
+    ~TextureDecoder();
+
+    TextureDecoder(const TextureDecoder&) = delete;
+    TextureDecoder& operator=(const TextureDecoder&) = delete;
+
+    // Null when the file is missing or not an image, only the header is read here
+    std::shared_ptr<TextureDecodeRequest> DecodeFile(const std::string& path, float priority = 0.0f, const TextureDecodeSettings& settings = {});
+
+    // Null when the bytes are not an image
+    std::shared_ptr<TextureDecodeRequest> DecodeMemory(std::shared_ptr<const std::vector<std::uint8_t>> encoded, float priority = 0.0f,
+        const TextureDecodeSettings& settings = {});
+
+    // Dimensions from the header without decoding, false when stb does not recognize the format
+    static bool GetImageInfo(const void* encoded, std::size_t size, std::uint32_t& width, std::uint32_t& height);
+
+    // Decodes on the calling thread, for the few images that are needed right away
+    static DecodedImage DecodeFileNow(const std::string& path);
+
+    static DecodedImage DecodeMemoryNow(const void* encoded, std::size_t size);
+
+    // Copy of a decoded RGBA8 image with all of its mip levels, the image itself when it has them already
+    static DecodedImage GenerateMips(DecodedImage image, bool bSrgb);
+
+    // Block compressed copy of a decoded RGBA8 image and its mips, the image itself when compression is None
+    static DecodedImage Compress(DecodedImage image, TextureCompression compression);
+
+    // Where compressed images are cached from now on, null disables the cache
+    void SetCache(std::shared_ptr<const ImportCache> cache);
+
+    void SetMaxInFlightBytes(std::size_t bytes);
+
+    [[nodiscard]] std::size_t GetInFlightBytes() const;
+
+    [[nodiscard]] std::size_t GetQueuedCount() const;
+
+private:
+    friend class TextureDecodeRequest;
+
+    void Enqueue(const std::shared_ptr<TextureDecodeRequest>& request, float priority);
+
+    // Picks what can start now, called with the mutex held. The jobs are scheduled after it is released, the job
+    // system runs them inline when it has no workers
+    std::vector<std::shared_ptr<TextureDecodeRequest>> PopStartable();
+
+    void Start(std::vector<std::shared_ptr<TextureDecodeRequest>> requests);
+
+    void Run(const std::shared_ptr<TextureDecodeRequest>& request);
+
+    // Decodes, generates the mips and compresses the request, or reads it from the cache. Runs on a worker
+    static DecodedImage Decode(const TextureDecodeRequest& request, const ImportCache* cache);
+
+    // Gives back what the request reserved
+    void Release(TextureDecodeRequest& request);
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _idle;
+    std::vector<std::weak_ptr<TextureDecodeRequest>> _queue;
+    std::shared_ptr<const ImportCache> _cache;
+    std::size_t _maxInFlightBytes = 0;
+    std::size_t _maxConcurrentDecodes = 1;
+    std::size_t _inFlightBytes = 0;
+    std::size_t _activeDecodes = 0;
+    std::uint64_t _nextSequence = 0;
+};
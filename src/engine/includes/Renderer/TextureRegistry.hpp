@@ -0,0 +1,75 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+#include <functional>
+#include <mutex>
+
+class Texture2D;
+
+/**
+ *  Hands out one Texture2D per distinct image, so an image used by many materials or imported many times is decoded,
+ * staged and uploaded once. Textures made from a path are keyed by the path, the others by a hash of their bytes, all
+ * together with the size of the source, the image dimensions when they are known and the pixel format.
+ *
+ *  The registry only holds weak references. The users of a texture own it, once the last one lets go it is destroyed
+ * with its GPU resource and the next request for the same image makes a new one. TextureResidency tracks textures by
+ * instance, a shared texture is requested by all its visible users and counts once against the budget.
+ *
+ *  Thread safe, imports run on the JobSystem.
+ */
+class TextureRegistry {
+public:
+    // Configures a texture the registry just made, before anyone else sees it. Later users of the image share its settings
+    using Initializer = std::function<void(Texture2D&)>;
+
+    static TextureRegistry& Get();
+
+    // The path is not copied, same as Texture2D::MakeFromPath
+    std::shared_ptr<Texture2D> FindOrMakeFromPath(const char* path, Format pixelFormat, const Initializer& initialize = {});
+
+    std::shared_ptr<Texture2D> FindOrMakeFromData(std::uint32_t width, std::uint32_t height, Format pixelFormat, const void* data, std::size_t size,
+        const Initializer& initialize = {});
+
+    // The encoded bytes are only copied when no texture holds them yet
+    std::shared_ptr<Texture2D> FindOrMakeFromEncodedData(const void* encoded, std::size_t size, Format pixelFormat, const Initializer& initialize = {});
+
+    // Textures still owned by someone
+    [[nodiscard]] std::size_t GetTextureCount();
+
+    // Requests answered with an existing texture
+    [[nodiscard]] std::uint64_t GetHitCount();
+
+private:
+    enum class Source : std::uint8_t {
+        Path,
+        Data,
+        EncodedData
+    };
+
+    // The hash alone could collide, sources of another size or shape never share a texture
+    struct Key {
+        std::uint64_t _hash = 0;
+        std::size_t _size = 0;
+        std::uint32_t _width = 0; // Zero when the source is encoded, its dimensions are only known once decoded
+        std::uint32_t _height = 0;
+        Format _format = Format::FORMAT_UNDEFINED;
+        Source _source = Source::Path;
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            const std::uint64_t shape = (static_cast<std::uint64_t>(key._width) << 32) | key._height;
+            return static_cast<std::size_t>(key._hash ^ (shape * 0x9E3779B97F4A7C15ull) ^ (static_cast<std::uint64_t>(key._size) << 16) ^
+                (static_cast<std::uint64_t>(key._format) << 8) ^ static_cast<std::uint64_t>(key._source));
+        }
+    };
+
+    std::shared_ptr<Texture2D> FindOrMake(const Key& key, const std::function<std::shared_ptr<Texture2D>()>& make, const Initializer& initialize);
+
+private:
+    std::mutex _mutex;
+    std::unordered_map<Key, std::weak_ptr<Texture2D>, KeyHash> _textures;
+    std::size_t _pruneSize = 64; // Expired entries are dropped once the map grows past it
+    std::uint64_t _hitCount = 0;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include "Renderer/GPUDefinitions.h"
+
+class Texture2D;
+class TextureDecodeRequest;
+
+/**
+ *  Decides which material textures live on the GPU, a texture is only loaded once a visible primitive asks for it.
+ *
+ *  Passes call Request while gathering their texture resources, textures already resident are handed back. Image files
+ * are first decoded on the TextureDecoder, the textures requested by the most visible primitives first, and decodes
+ * whose texture went out of view are cancelled. Decoded textures are admitted for upload up to a few per frame so a big
+ * scene does not stall its first frames. Until a texture is admitted the placeholder (1x1 white) is bound instead. Once
+ * the resident textures go over the budget the ones not requested for a while are freed, least recently used first, and
+ * load again the next time they are seen.
+ *
+ *  Textures that ask for compression (Texture2D::SetCompression) are decoded to block compressed formats when the
+ * device samples them, the budget counts their compressed size.
+ *
+ *  Textures with mips are streamed per level. Only the levels the screen footprint of their users needs are uploaded
+ * (see ReportFootprint), finer ones are decoded again in the background when a user comes closer and swapped in once
+ * ready, the coarser version stays bound meanwhile. The decoder queue is ordered by how many levels are missing, fed
+ * back every frame. When what the visible textures ask for goes over the budget every texture drops its finest level
+ * (the mip bias) until it fits. Textures holding more levels than they need keep them until the budget is exceeded.
+ */
+class TextureResidency {
+    struct Entry {
+        std::weak_ptr<Texture2D> _texture;
+        std::shared_ptr<TextureDecodeRequest> _decode;
+        std::uint64_t _lastRequestedFrame = 0;
+        std::uint64_t _footprintFrame = 0;
+        float _footprint = 0.0f;         // Largest screen size of a user in _footprintFrame, in pixels
+        std::uint32_t _requestCount = 0; // Visible users in _lastRequestedFrame, the decode priority
+
+        // Full mip chain, known once the texture was decoded a first time
+        std::uint32_t _width = 0;
+        std::uint32_t _height = 0;
+        std::uint32_t _levelCount = 0;
+        Format _format = Format::FORMAT_UNDEFINED;
+
+        std::uint32_t _wantedLevels = 0;   // As of the last request, counted from the smallest level
+        std::uint32_t _residentLevels = 0; // Uploaded, or about to be
+        bool _bResident = false;
+    };
+
+public:
+    // Bias past which what is asked for is left over the budget, 4 levels are a 256th of the memory
+    static constexpr std::uint32_t MaxMipBias = 4;
+
+    /**
+     * Starts a new frame and evicts what went over the budget, call once per frame before the passes gather their textures
+     * @param framesInFlight - a texture is never freed while a frame that could still sample it is in flight
+     */
+    void BeginFrame(std::size_t framesInFlight);
+
+    /**
+     * Screen size of a user of the texture this frame, call before it is requested. Textures with no footprint in a
+     * frame get all their levels
+     * @param pixels - what the texture spans on screen, at most
+     */
+    void ReportFootprint(const std::shared_ptr<Texture2D>& texture, float pixels);
+
+    /**
+     * Marks the texture as used this frame, call once per visible user
+     * @return the texture if it is resident or was admitted for loading this frame, the placeholder otherwise
+     */
+    std::shared_ptr<Texture2D> Request(const std::shared_ptr<Texture2D>& texture);
+
+    // What to bind for the texture this frame, same answer as Request without admitting anything new
+    std::shared_ptr<Texture2D> Resolve(const std::shared_ptr<Texture2D>& texture) const;
+
+    const std::shared_ptr<Texture2D>& GetPlaceholder();
+
+    void SetBudget(std::size_t bytes) { _budget = bytes; }
+
+    void SetMaxLoadsPerFrame(std::uint32_t count) { _maxLoadsPerFrame = count; }
+
+    // Whether decodes started from now on may block compress, see Device::SupportsBlockCompression
+    void SetBlockCompression(bool bEnabled) { _bBlockCompression = bEnabled; }
+
+    // Frames a texture must go unrequested before it can be evicted
+    void SetEvictionDelay(std::uint64_t frames) { _evictionDelay = frames; }
+
+    [[nodiscard]] std::size_t GetResidentBytes() const { return _residentBytes; }
+
+    // What the textures requested last frame would take with the levels they need, mip bias included
+    [[nodiscard]] std::size_t GetRequestedBytes() const { return _requestedBytes; }
+
+    [[nodiscard]] std::size_t GetResidentCount() const { return _residentCount; }
+
+    [[nodiscard]] std::size_t GetDecodingCount() const { return _decodingCount; }
+
+    // Resident textures decoding again for a different set of levels
+    [[nodiscard]] std::size_t GetStreamingCount() const { return _streamingCount; }
+
+    [[nodiscard]] std::uint32_t GetMipBias() const { return _mipBias; }
+
+private:
+    // Tracks the texture from now on, the entries are keyed by address
+    Entry& GetEntry(const std::shared_ptr<Texture2D>& texture);
+
+    // Levels the texture needs this frame, all of them while its chain is unknown. More than are resident only once the
+    // footprint is a margin past the threshold
+    [[nodiscard]] std::uint32_t GetWantedLevels(const Entry& entry) const;
+
+    // Hands the decoded image to the texture, which uploads it on its next reload, and learns its mip chain
+    static void TakeDecodedImage(Entry& entry, Texture2D& texture);
+
+    // Swaps in a resident texture decoded again once its decode is done, starts the decode when the levels it needs changed
+    void Stream(Entry& entry, Texture2D& texture);
+
+private:
+    std::unordered_map<const Texture2D*, Entry> _entries;
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<void>>> _retired; // Replaced GPU resources, by the frame they were replaced in
+    std::shared_ptr<Texture2D> _placeholder;
+    std::size_t _budget = 512ull * 1024 * 1024;
+    std::size_t _residentBytes = 0; // As of the last BeginFrame, textures admitted since then are not counted yet
+    std::size_t _requestedBytes = 0;
+    std::size_t _residentCount = 0;
+    std::size_t _decodingCount = 0;
+    std::size_t _streamingCount = 0;
+    std::uint64_t _evictionDelay = 120;
+    std::uint64_t _frame = 0;
+    std::uint32_t _maxLoadsPerFrame = 8;
+    std::uint32_t _loadsThisFrame = 0;
+    std::uint32_t _mipBias = 0;
+    bool _bBlockCompression = false;
+};
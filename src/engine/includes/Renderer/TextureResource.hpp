@@ -44,7 +44,14 @@ public:
     void MakeDirty();
     void ClearDirty();
 
+    // False once the staging was released, there is nothing left to upload
     bool IsDirty();
+
+    /**
+     * Drops the staging buffer once its upload was recorded, the backend keeps it alive until the copy ran. Only for
+     * textures that are never written again after their upload, see Texture2D::HasTransientStaging
+     */
+    void ReleaseStaging() { _buffer.reset(); }
     
 public:
     std::shared_ptr<Buffer> GetBuffer() {
@@ -0,0 +1,35 @@
+#pragma once
+
+class Buffer;
+class Device;
+
+/**
+ *  Linear allocator over a host visible uniform buffer. Slices are handed out one after the other from the start of
+ * the buffer and never freed on their own, every graphics context owns one and resets it to the start once the gpu is
+ * done with the frame, so slices only live for the frame they were allocated in.
+ */
+class UniformFrameAllocator {
+public:
+    struct Allocation {
+        std::shared_ptr<Buffer> _buffer;
+        std::size_t _offset = 0;
+        std::byte* _data = nullptr; // Mapped memory of the slice, null when the buffer is full
+    };
+    
+    ~UniformFrameAllocator();
+
+    bool Initialize(Device* device, std::size_t size, std::size_t alignment);
+
+    /**
+     * Allocates a slice with the offset aligned to the device uniform buffer offset alignment
+     */
+    Allocation Allocate(std::size_t size);
+
+    void Reset();
+
+private:
+    std::shared_ptr<Buffer> _buffer;
+    std::byte* _mappedData = nullptr;
+    std::size_t _alignment = 1;
+    std::size_t _head = 0;
+};
@@ -1,9 +1,45 @@
 #pragma once
 #include "Renderer/GPUDefinitions.h"
+#include "Renderer/ShaderReflection.hpp"
+#include "Core/Cache/Cache.hpp"
+
+/**
+ * Compiled SPIR-V and the resource layout reflected from it
+ */
+struct ShaderBinary {
+    std::vector<unsigned int> _spirv;
+    ShaderReflection _reflection;
+    std::string _path;
+    ShaderStage _stage = ShaderStage::STAGE_UNDEFINED;
+    std::vector<std::string> _defines;
+};
 
 class ShaderCompiler {
 public:
     static ShaderCompiler& Get();
     static std::vector<char> CompileStatic(const char* path, ShaderStage shaderStage);
-    std::vector<unsigned int> Compile(const char* path, ShaderStage shaderStage);
+    std::vector<unsigned int> Compile(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines = {});
+    
+    /**
+     * Compiles and reflects the shader, results are cached per path, stage and defines so every permutation
+     * is only compiled and reflected once
+     * @param defines - injected as #define lines after the #version directive
+     * @return nullptr if the shader failed to compile
+     */
+    std::shared_ptr<ShaderBinary> CompileBinary(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines = {});
+    
+    /**
+     * Compiles every cached permutation of the shader again from disk and replaces the cached binaries, used when the
+     * source file changed.
+     * @return false if any permutation failed to compile, the previously cached binaries are kept in that case
+     */
+    bool Recompile(const std::string& path);
+
+private:
+    std::shared_ptr<ShaderBinary> CompileAndReflect(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines);
+    std::vector<unsigned int> CompileSPIRV(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines);
+    
+private:
+    Core::Cache<std::size_t, ShaderBinary> _binaries;
+    std::mutex _glslangMutex; // glslang process init and teardown are global, shaders can be compiled from the hot reload worker
 };
@@ -6,6 +6,9 @@ class Texture2D;
 
 class VKBuffer : public Buffer {
 public:
+    // The buffers are retired on the device, frames in flight may still have them bound
+    ~VKBuffer() override;
+
     virtual void Initialize(EBufferType type, EBufferUsage usage, size_t allocSize) override;
     
     void* LockBuffer() override;
@@ -17,8 +20,13 @@ public:
     
     VkDeviceMemory GetHostMemory() { return _stagingBufferMemory; }
     VkDeviceMemory GetLocalMemory() { return _localBufferMemory; }
+
+    // Hands the staging buffer over, it is destroyed once the returned handle is let go. Nothing can be locked afterwards
+    std::shared_ptr<void> DetachStaging();
     
 protected:
+    std::shared_ptr<void> Detach(VkBuffer& buffer, VkDeviceMemory& memory) const;
+
     std::pair<VkBuffer, VkDeviceMemory> MakeBuffer(VkBufferUsageFlags usage, VkMemoryPropertyFlagBits memoryFlags) const;
 
     void* _cpuData = nullptr;
@@ -5,7 +5,10 @@
 
 class VKDescriptorManager {
 public:
-    VkDescriptorSet AcquireDescriptorSet(GraphicsContext* graphicsContext, const ShaderDataStream& dataStream);
+    /**
+     * Acquires a descriptor set for the given layout, layouts are owned by the pipeline that created them
+     */
+    VkDescriptorSet AcquireDescriptorSet(GraphicsContext* graphicsContext, VkDescriptorSetLayout layout);
 
     void ResetPools();
 private:
@@ -1,8 +1,10 @@
 #pragma once
 #include "Renderer/Device.hpp"
 #include "Renderer/Vendor/Vulkan/VulkanLoader.hpp"
+#include <atomic>
 
 class Swapchain;
+class VKGraphicsContext;
 
 class VKDevice : public Device {
     struct PhysicalDeviceInfo {
@@ -41,6 +43,17 @@ public:
     
     VkPhysicalDevice GetPhysicalDeviceHandle() { return device_info_.physical_device; }
     
+    const VkPhysicalDeviceProperties& GetPhysicalDeviceProperties() const { return device_info_.device_properties; }
+    
+    bool SupportsPushConstants() const override { return true; }
+    
+    std::uint32_t GetMaxPushConstantsSize() const override { return device_info_.device_properties.limits.maxPushConstantsSize; }
+    
+    std::size_t GetMinUniformBufferOffsetAlignment() const override { return device_info_.device_properties.limits.minUniformBufferOffsetAlignment; }
+    
+    // Every supported feature is enabled on the logical device, see CreateLogicalDevice
+    bool SupportsBlockCompression() const override { return device_info_.features.textureCompressionBC == VK_TRUE; }
+    
     /**
     * The buffer memory requirements has a field called "memoryTypeBits" that tell us the required memory type
     * for this specific buffer. The ideia is to iterate over the memory types returned by the vkGetPhysicalDeviceMemoryProperties
@@ -58,6 +71,16 @@ public:
 
     VkDescriptorPool CreateDescriptorPool(unsigned int uniformsCount, unsigned int samplersCount);
     
+    // Keeps something the frames in flight may still use alive until the context recording the current frame waited on its
+    // fence. The queue runs the frames in order, the older ones are done by then as well. Released right away before the
+    // first frame
+    void Retire(std::shared_ptr<void> resource);
+    
+    // Set by the context that begins a frame, see Retire
+    void SetRecordingContext(VKGraphicsContext* context) { _recordingContext = context; }
+    
+    VKGraphicsContext* GetRecordingContext() const { return _recordingContext; }
+    
     // TODO: Need to work on the swapchaiin abstraction, this should be moved to there
     bool CreateSwapChain(VkSwapchainKHR& swapchain, std::vector<VkImage>& swapchainImages);
     bool AcquireNextImage(VkSwapchainKHR swapchain, uint32_t& swapchainImageIndex, VkSemaphore swapchainSemaphore);
@@ -80,6 +103,8 @@ private:
     uint32_t _winExtensionCount = 0;
     bool _validationEnabled = false; // Try to enable only in development
     const char** _instanceExtensions = nullptr;
+    
+    std::atomic<VKGraphicsContext*> _recordingContext = nullptr;
 
     // Can this be inside cpp?
     VulkanLoader vulkan_loader_;
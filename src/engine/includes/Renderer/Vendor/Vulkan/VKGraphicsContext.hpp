@@ -1,6 +1,7 @@
 #pragma once
 #include "Renderer/GraphicsContext.hpp"
 #include "vulkan/vulkan_core.h"
+#include <mutex>
 
 class VKGraphicsPipeline;
 class Device;
@@ -12,6 +13,7 @@ class CommandBuffer;
 class Texture2D;
 class VKDescriptorManager;
 class VKSamplerManager;
+class UniformFrameAllocator;
 
 class VKGraphicsContext : public GraphicsContext {
 public:
@@ -39,6 +41,12 @@ public:
     VKDescriptorManager* GetDescriptorManager() { return _descriptorsManager.get(); };
     
     VKSamplerManager* GetSamplerManager() { return _samplerManager.get(); };
+    
+    UniformFrameAllocator* GetUniformFrameAllocator() { return _uniformFrameAllocator.get(); };
+
+    // Keeps something the commands recorded this frame still read alive until the GPU ran them. Also called from the
+    // shader hot reload worker when it drops the last reference to a pipeline
+    void Retire(std::shared_ptr<void> resource);
                 
 private:
     VkDescriptorPool _descriptorPool;
@@ -50,6 +58,14 @@ private:
     std::shared_ptr<Fence> _fence;
     std::shared_ptr<CommandBuffer> _commandBuffer;
     std::unique_ptr<VKDescriptorManager> _descriptorsManager;
+    
+    // Per frame uniform data, like push constants that did not fit the device limits
+    std::unique_ptr<UniformFrameAllocator> _uniformFrameAllocator;
+
+    // Every context is one of the frames in flight, what its frame retired is released once its fence is waited on.
+    // The same idea as TextureResidency::_retired, which counts frames instead
+    std::vector<std::shared_ptr<void>> _retired;
+    std::mutex _retiredMutex;
 
     // Samplers are read-only they can be shared between graphics context
     static std::unique_ptr<VKSamplerManager> _samplerManager;
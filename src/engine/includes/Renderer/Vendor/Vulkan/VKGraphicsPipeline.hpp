@@ -1,6 +1,8 @@
 #pragma once
 #include "Renderer/GraphicsPipeline.hpp"
 #include "Renderer/GPUDefinitions.h"
+#include "Renderer/ShaderReflection.hpp"
+#include "Renderer/ShaderDataPacking.hpp"
 #include "vulkan/vulkan_core.h"
 
 class GraphicsContext;
@@ -9,14 +11,30 @@ class Texture2D;
 class VKGraphicsPipeline : public GraphicsPipeline {
 public:
     using VertexStateData = std::pair<std::vector<VkVertexInputBindingDescription>, std::vector<VkVertexInputAttributeDescription>>;
+    
+    // A vkCmdPushConstants call, the stage flags cover every range that overlaps the bytes
+    struct PushConstantUpdate {
+        std::uint32_t _offset = 0;
+        std::uint32_t _size = 0;
+        VkShaderStageFlags _stageFlags = 0;
+    };
 
 public:
     VKGraphicsPipeline(const GraphicsPipelineParams& params)
         : GraphicsPipeline(params) {
     };
+    
+    /**
+     * Destroys the Vulkan objects right away, the owner keeps the pipeline alive until no frame in flight uses it
+     */
+    ~VKGraphicsPipeline() override;
                     
     void Compile() override;
     
+    bool IsCompiled() const override {
+        return _bWasCompiled;
+    }
+    
     VkFramebuffer CreateFrameBuffer(std::vector<Texture2D*> textures);
     
     void DestroyFrameBuffer();
@@ -33,6 +51,30 @@ public:
         return _pipelineLayout;
     }
     
+    VkDescriptorSetLayout GetVKDescriptorSetLayout(std::uint32_t set) {
+        return set < _descriptorSetLayouts.size() ? _descriptorSetLayouts[set] : VK_NULL_HANDLE;
+    }
+    
+    /**
+     * Merged resource layout of the vertex and fragment shaders, valid after Compile
+     */
+    const ShaderReflection& GetReflection() const {
+        return _reflection;
+    }
+    
+    const ShaderDataPackingPlan& GetDataPackingPlan() const {
+        return _dataPackingPlan;
+    }
+    
+    const std::vector<PushConstantUpdate>& GetPushConstantUpdates() const {
+        return _pushConstantUpdates;
+    }
+    
+    // Descriptor set that receives the spilled push constants, it follows the data streams sets
+    std::uint32_t GetSpillSet() const {
+        return _spillSet;
+    }
+    
 private:        
     std::vector<VkPipelineColorBlendAttachmentState>  CreateColorBlendAttachemnt();
     
@@ -45,16 +87,23 @@ private:
     VkRenderPass CreateRenderPass();
     
     VertexStateData BuildVertexStateData();
-    VkPushConstantRange BuildPushConstants();
+    std::vector<VkPushConstantRange> BuildPushConstants();
     std::vector<VkDescriptorSetLayout> BuildDescriptorSetLayouts();
+    // False when push constants spill but the shaders have no uniform block to take them
+    bool BuildDataPackingPlan();
     
     
 private:
     std::vector<VkPipelineShaderStageCreateInfo> _shaderStages;
     std::unordered_map<uint32_t, VkFramebuffer> _frameBuffers;
     std::vector<VkImageView> _views;
-    VkRenderPass _renderPass;
-    VkPipeline _pipeline;
-    VkPipelineLayout _pipelineLayout;
+    std::vector<VkDescriptorSetLayout> _descriptorSetLayouts;
+    ShaderReflection _reflection;
+    ShaderDataPackingPlan _dataPackingPlan;
+    std::vector<PushConstantUpdate> _pushConstantUpdates;
+    std::uint32_t _spillSet = 0;
+    VkRenderPass _renderPass = VK_NULL_HANDLE;
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
     bool _bWasCompiled = false;
 };
@@ -2,6 +2,7 @@
 #include "Renderer/CommandEncoders/RenderCommandEncoder.hpp"
 #include "Renderer/Vendor/Vulkan/VKGeneralCommandEncoder.hpp"
 #include "Renderer/GPUDefinitions.h"
+#include "Renderer/ShaderDataPacking.hpp"
 
 class GraphicsContext;
 class Device;
@@ -14,6 +15,7 @@ public:
 
     void BeginRenderPass(GraphicsPipeline* pipeline, const RenderAttachments& attachments) override;
     void EndRenderPass() override;
+    void BindPipeline(GraphicsPipeline* pipeline) override;
     void SetViewport(const glm::vec2& viewportSize) override;
     void SetScissor(const glm::vec2& extent, const glm::vec2& offset) override;
     void DispatchDataStreams(GraphicsPipeline* graphicsPipeline, const std::vector<ShaderDataStream> dataStreams) override;
@@ -23,6 +25,10 @@ public:
     void UploadBuffer(std::shared_ptr<Buffer> buffer) override;
     void UploadImageBuffer(std::shared_ptr<Texture2D> texture) override;
 
+private:
+    // Fixed size staging for push constants, filled from the pipeline packing plan every draw
+    std::array<std::byte, ShaderDataPackingPlan::MaxPushConstantsSize> _pushConstantsStaging {};
+
 
 
 //    void ExecuteMemoryTransfer(Buffer* buffer) override;
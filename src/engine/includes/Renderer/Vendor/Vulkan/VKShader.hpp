@@ -1,6 +1,7 @@
 #pragma once
 #include "Renderer/Shader.hpp"
 #include "Renderer/GPUDefinitions.h"
+#include "Renderer/ShaderReflection.hpp"
 #include "vulkan/vulkan.hpp"
 
 class RenderContext;
@@ -9,14 +10,25 @@ class VKShader : public Shader {
 public:
     using Shader::Shader;
     
+    // The shader module is owned, copies would destroy it twice
+    VKShader(const VKShader&) = delete;
+    VKShader& operator=(const VKShader&) = delete;
+    
+    ~VKShader() override;
+    
     bool Compile() override;
     
     const VkPipelineShaderStageCreateInfo& GetShaderStageInfo() const {
         return _shaderStageInfo;
     }
+    
+    const ShaderReflection& GetReflection() const {
+        return _reflection;
+    }
             
 private:
-    VkPipelineShaderStageCreateInfo _shaderStageInfo;
+    VkPipelineShaderStageCreateInfo _shaderStageInfo {};
+    ShaderReflection _reflection;
         
     bool _bWasCompiled = false;
 };
@@ -33,6 +33,14 @@ inline VkFormat TranslateFormat(Format format) {
             return VK_FORMAT_R8G8B8_SRGB;
         case Format::FORMAT_R32G32_UNORM:
             return VK_FORMAT_R32G32_UINT;
+        case Format::FORMAT_BC1_RGBA_SRGB:
+            return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+        case Format::FORMAT_BC3_SRGB:
+            return VK_FORMAT_BC3_SRGB_BLOCK;
+        case Format::FORMAT_BC5_UNORM:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case Format::FORMAT_BC7_SRGB:
+            return VK_FORMAT_BC7_SRGB_BLOCK;
         case Format::END_COLOR_FORMATS:
             break;
         case Format::FORMAT_D32_SFLOAT:
@@ -215,6 +223,17 @@ inline VkFilter TranslateFilter(TextureFilter filter) {
     return VK_FILTER_MAX_ENUM;
 }
 
+inline VkSamplerMipmapMode TranslateMipmapMode(TextureFilter filter) {
+    switch (filter) {
+        case TextureFilter::NEAREST:
+            return VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        case TextureFilter::LINEAR:
+            return VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    }
+
+    return VK_SAMPLER_MIPMAP_MODE_MAX_ENUM;
+}
+
 inline VkSamplerAddressMode TranslateWrapMode(TextureWrapMode wrapMode) {
     switch (wrapMode) {
         case TextureWrapMode::REPEAT:
@@ -399,6 +418,10 @@ inline VkDescriptorType TranslateShaderBlockUsage(ShaderDataBlockUsage usage) {
             return VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
         case ShaderDataBlockUsage::TEXTURE:
             return VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        case ShaderDataBlockUsage::SAMPLER:
+            return VkDescriptorType::VK_DESCRIPTOR_TYPE_SAMPLER;
+        case ShaderDataBlockUsage::STORAGE_BUFFER:
+            return VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         default: break;
     }
 
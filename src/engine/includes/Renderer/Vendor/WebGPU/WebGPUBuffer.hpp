@@ -18,6 +18,10 @@ public:
         return _localBuffer;
     }
     
+protected:
+    // Lets go of the native buffers, what recorded commands still use stays alive until they ran
+    void ReleaseBuffers();
+
 private:
     WGPUBuffer _staginBuffer = nullptr;
     WGPUBuffer _localBuffer = nullptr;
@@ -11,6 +11,7 @@ public:
 
     void BeginRenderPass(GraphicsPipeline *pipeline, const RenderAttachments &attachments) override;
     void EndRenderPass() override;
+    void BindPipeline(GraphicsPipeline *pipeline) override;
     void SetViewport(const glm::vec2 &viewportSize) override;
     void SetScissor(const glm::vec2 &extent, const glm::vec2 &offset) override;
     void DispatchDataStreams(GraphicsPipeline* graphicsPipeline, const std::vector<ShaderDataStream> dataStreams) override;
@@ -7,4 +7,9 @@ public:
     {
         _device = device;
     }
+
+    // Texture staging is released right after its upload (see TextureResource::ReleaseStaging), it must not leak
+    ~WebGPUTextureBuffer() override {
+        ReleaseBuffers();
+    }
 };
@@ -4,6 +4,16 @@
 
 class WebGPUTextureResource final : public TextureResource {
 public:
+    // Buffer to texture copies need rows of a multiple of this many bytes
+    static constexpr std::uint32_t CopyRowAlignment = 256;
+
+    // Where a mip level is in the staging buffer
+    struct LevelLayout {
+        std::uint64_t _offset = 0;
+        std::uint32_t _bytesPerRow = 0; // Padded to CopyRowAlignment
+        std::uint32_t _rowCount = 0;    // Of blocks for compressed formats
+    };
+
     using TextureResource::TextureResource;
     ~WebGPUTextureResource() override {
         WebGPUTextureResource::FreeResource();
@@ -20,6 +30,18 @@ public:
         return _nativeTexture;
     };
 
+    [[nodiscard]] std::uint32_t GetMipLevelCount() const {
+        return _mipLevelCount;
+    };
+
+    // The pixels are written tightly packed between Lock and Unlock, Unlock spreads the rows out to this layout
+    [[nodiscard]] const LevelLayout& GetLevelLayout(std::uint32_t level) const {
+        return _levelLayouts[level];
+    };
+
 private:
     WGPUTexture _nativeTexture = nullptr;
+    std::uint32_t _mipLevelCount = 1;
+    std::vector<LevelLayout> _levelLayouts;
+    void* _lockedData = nullptr;
 };
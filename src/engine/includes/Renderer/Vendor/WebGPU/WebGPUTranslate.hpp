@@ -14,6 +14,14 @@ inline WGPUTextureFormat TranslateFormat(Format format) {
             return WGPUTextureFormat::WGPUTextureFormat_RGBA8UnormSrgb;
         case Format::FORMAT_B8G8R8A8_UNORM:
             return WGPUTextureFormat::WGPUTextureFormat_BGRA8Unorm;
+        case Format::FORMAT_BC1_RGBA_SRGB:
+            return WGPUTextureFormat::WGPUTextureFormat_BC1RGBAUnormSrgb;
+        case Format::FORMAT_BC3_SRGB:
+            return WGPUTextureFormat::WGPUTextureFormat_BC3RGBAUnormSrgb;
+        case Format::FORMAT_BC5_UNORM:
+            return WGPUTextureFormat::WGPUTextureFormat_BC5RGUnorm;
+        case Format::FORMAT_BC7_SRGB:
+            return WGPUTextureFormat::WGPUTextureFormat_BC7RGBAUnormSrgb;
         case Format::END_COLOR_FORMATS:
             break;
         case Format::FORMAT_D32_SFLOAT:
@@ -235,3 +243,17 @@ inline WGPUFilterMode TranslateTextureFilter(TextureFilter filter) {
     assert(0 && "Invalid WebGPU TextureFilter translation");
     return {};
 }
+
+inline WGPUMipmapFilterMode TranslateMipmapFilter(TextureFilter filter) {
+    switch (filter) {
+        case TextureFilter::LINEAR:
+            return WGPUMipmapFilterMode::WGPUMipmapFilterMode_Linear;
+        case TextureFilter::NEAREST:
+            return WGPUMipmapFilterMode::WGPUMipmapFilterMode_Nearest;
+        default:
+            break;
+    }
+    
+    assert(0 && "Invalid WebGPU mipmap TextureFilter translation");
+    return {};
+}
@@ -11,6 +11,7 @@ public:
 
     [[nodiscard]] bool ShouldWindowClose() const noexcept override;
     [[nodiscard]] glm::i32vec2 GetWindowSurfaceSize() const override;
+    [[nodiscard]] glm::i32vec2 GetWindowSize() const override;
     [[nodiscard]] std::tuple<std::uint32_t, const char **> GetRequiredExtensions() override;
     [[nodiscard]] void * GetWindow() const override;
 
@@ -45,12 +45,15 @@ public:
 
     [[nodiscard]] virtual bool ShouldWindowClose() const noexcept;
     [[nodiscard]] virtual glm::i32vec2 GetWindowSurfaceSize() const;
+    // In screen coordinates like the mouse position, smaller than the surface size on high dpi displays
+    [[nodiscard]] virtual glm::i32vec2 GetWindowSize() const;
     [[nodiscard]] virtual std::tuple<std::uint32_t, const char**> GetRequiredExtensions();
     [[nodiscard]] virtual void* GetWindow() const;
 
     void ClearDeltas();
     [[nodiscard]] glm::vec2 GetMouseDelta() const { return {m_MouseDelta.x, m_MouseDelta.y}; }
     [[nodiscard]] glm::vec2 GetMouseWheelDelta() const { return m_CurrentMouseDelta; }
+    [[nodiscard]] glm::vec2 GetMousePosition() const { return {m_MouseDelta.z, m_MouseDelta.w}; }
     [[nodiscard]] Device* GetDevice() const { return _device.get(); };
     [[nodiscard]] InputSystem* GetInputSystem() const { return _inputSystem.get(); }
     [[nodiscard]] MulticastDelegate<glm::i32vec2>& GetWindowResizeDelegate() { return _windowResizeDelegate; }
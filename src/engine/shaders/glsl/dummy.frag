@@ -1,6 +1,8 @@
 #version 450
 
+#ifdef HAS_DIFFUSE_TEXTURE
 layout(set=2, binding=0) uniform sampler2D texSampler;
+#endif
 
 layout(location = 0) in vec3 lightColor;
 layout(location = 1) in float lightIntensity;
@@ -9,6 +11,9 @@ layout(location = 3) in vec3 vertexNormal;
 layout(location = 4) in vec3 fragPosition;
 layout(location = 5) in vec3 cameraPosition;
 layout(location = 6) in vec2 tCoords;
+#ifdef HAS_VERTEX_COLOR
+layout(location = 7) in vec3 vertexColor;
+#endif
 
 layout(location = 0) out vec4 fragColor;
 
@@ -16,7 +21,14 @@ void main() {
     vec3 lightVector = normalize(lightDirection);
     vec3 cameraVector = normalize(cameraPosition - fragPosition);
     vec3 surfaceNormal = normalize(vertexNormal);
+#ifdef HAS_DIFFUSE_TEXTURE
     vec3 diffuseSample = texture(texSampler, tCoords).rgb;
+#else
+    vec3 diffuseSample = vec3(0.8);
+#endif
+#ifdef HAS_VERTEX_COLOR
+    diffuseSample *= vertexColor;
+#endif
 
     float ambientStrength = 0.05;
     vec3 ambientColor = diffuseSample;
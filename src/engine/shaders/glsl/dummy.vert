@@ -18,6 +18,9 @@ layout(set=1, binding=0) uniform PerModelData {
 layout(location = 0) in vec3 in_vertex_position;
 layout(location = 1) in vec3 in_vertex_normal;
 layout(location = 2) in vec2 coords;
+#ifdef HAS_VERTEX_COLOR
+layout(location = 3) in vec3 in_vertex_color;
+#endif
 
 layout(location = 0) out vec3 lightColor;
 layout(location = 1) out float lightIntensity;
@@ -26,6 +29,9 @@ layout(location = 3) out vec3 vertexNormal;
 layout(location = 4) out vec3 fragPos;
 layout(location = 5) out vec3 cameraPosition;
 layout(location = 6) out vec2 tCoords;
+#ifdef HAS_VERTEX_COLOR
+layout(location = 7) out vec3 vertexColor;
+#endif
 
 void main()
 {
@@ -38,6 +44,9 @@ void main()
     fragPos = finalPos.xyz;
     cameraPosition = generalData.cameraPosition;
     tCoords = coords;
+#ifdef HAS_VERTEX_COLOR
+    vertexColor = in_vertex_color;
+#endif
 
     // using last arg as 1.0 so that the normalization wont happen
     gl_Position = finalPos;
@@ -3,6 +3,7 @@
 #include "Components/CameraComponent.hpp"
 #include "Components/InputComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
 #include <window.hpp>
 #include <GLFW/glfw3.h>
 
@@ -185,6 +186,7 @@ void CameraSystem::ComputeArcBallCamera(Scene* scene) const {
         glm::vec3 finalPosition = pivot + direction;
         cameraComponent._radius = radius;
         transformComponent.m_Position = finalPosition;
+        scene->GetRegistry().patch<TransformComponent>(entity);
         
 #ifdef VULKAN_BACKEND
         cameraComponent.m_ViewMatrix = glm::lookAt(finalPosition, pivot, glm::vec3(0.0f, -1.0f, 0.0f));
@@ -193,5 +195,50 @@ void CameraSystem::ComputeArcBallCamera(Scene* scene) const {
         cameraComponent.m_ViewMatrix = glm::lookAt(finalPosition, pivot, glm::vec3(0.0f, 1.0f, 0.0f));
 #endif
         
+        // Pick once per click, not every frame the button is held
+        const bool bIsLeftMousePressed = inputComponent.m_MouseButtons.contains(GLFW_MOUSE_BUTTON_LEFT) && inputComponent.m_MouseButtons[GLFW_MOUSE_BUTTON_LEFT];
+        if(bIsLeftMousePressed && !cameraComponent._bWasPicking && !bIsCtrlPressed && !bIsShiftPressed) {
+            cameraComponent._selectedEntity = PickEntity(scene, cameraComponent, inputComponent.m_MousePosition);
+        }
+        
+        cameraComponent._bWasPicking = bIsLeftMousePressed;
+    }
+}
+
+std::optional<ComponentID> CameraSystem::PickEntity(Scene* scene, const CameraComponent& cameraComponent, const glm::vec2& mousePosition) const {
+    const glm::i32vec2 surfaceSize = m_Window->GetWindowSurfaceSize();
+    const glm::i32vec2 windowSize = m_Window->GetWindowSize();
+    if(surfaceSize.x <= 0 || surfaceSize.y <= 0 || windowSize.x <= 0 || windowSize.y <= 0) {
+        return std::nullopt;
+    }
+    
+    const glm::mat4 projMatrix = glm::perspective(cameraComponent.m_Fov, (float)surfaceSize.x / (float)surfaceSize.y, cameraComponent._nearPlane, cameraComponent._farPlane);
+    const glm::mat4 inverseViewProjection = glm::inverse(projMatrix * cameraComponent.m_ViewMatrix);
+    
+    // The cursor is in window coordinates, on high dpi displays the surface has more pixels than the window
+    const glm::vec2 surfacePosition = mousePosition * glm::vec2(surfaceSize) / glm::vec2(windowSize);
+    
+    const float x = 2.0f * surfacePosition.x / (float)surfaceSize.x - 1.0f;
+#ifdef VULKAN_BACKEND
+    // Vulkan clip space y points down like window coordinates
+    const float y = 2.0f * surfacePosition.y / (float)surfaceSize.y - 1.0f;
+#else
+    const float y = 1.0f - 2.0f * surfacePosition.y / (float)surfaceSize.y;
+#endif
+    
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(x, y, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(x, y, 1.0f, 1.0f);
+    nearPoint /= nearPoint.w;
+    farPoint /= farPoint.w;
+    
+    // The direction spans the near to the far plane, a max distance of 1 covers everything the camera sees
+    Ray ray;
+    ray._origin = glm::vec3(nearPoint);
+    ray._direction = glm::vec3(farPoint - nearPoint);
+    
+    if(auto hit = scene->GetSpatialIndex().Raycast(ray, 1.0f)) {
+        return hit->_entity;
     }
+    
+    return std::nullopt;
 }
@@ -0,0 +1,256 @@
+#include "Core/CookedMesh.hpp"
+#include <filesystem>
+#include <random>
+
+namespace {
+    std::uint64_t Align(std::uint64_t offset) {
+        return (offset + CookedMesh::Alignment - 1) & ~static_cast<std::uint64_t>(CookedMesh::Alignment - 1);
+    }
+
+    // True when count elements of size bytes at offset are inside the file and aligned
+    bool IsInside(std::uint64_t offset, std::uint64_t count, std::uint64_t size, std::uint64_t fileSize) {
+        if(offset % CookedMesh::Alignment != 0 || offset > fileSize) {
+            return false;
+        }
+        return count <= (fileSize - offset) / size;
+    }
+
+    // An index past the vertices would make the GPU read outside of the vertex buffer
+    bool AreIndicesInside(std::span<const std::uint32_t> indices, std::uint32_t vertexCount) {
+        return std::all_of(indices.begin(), indices.end(), [vertexCount](std::uint32_t index) {
+            return index < vertexCount;
+        });
+    }
+
+    // Writes the blobs in the order their offsets were handed out, padding up to each one
+    class BlobStream {
+    public:
+        explicit BlobStream(std::ofstream& stream) : _stream(stream) {}
+
+        void Write(std::uint64_t offset, const void* data, std::size_t size) {
+            static constexpr char Padding[CookedMesh::Alignment] = {};
+            assert(offset >= _offset && offset - _offset < CookedMesh::Alignment);
+            _stream.write(Padding, static_cast<std::streamsize>(offset - _offset));
+            _stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            _offset = offset + size;
+        }
+
+    private:
+        std::ofstream& _stream;
+        std::uint64_t _offset = 0;
+    };
+}
+
+std::uint32_t CookedMeshWriter::AddNode(const glm::mat4& matrix, std::int32_t parent) {
+    assert(parent < static_cast<std::int32_t>(_nodes.size()) && "Parents go before their children");
+    CookedNode& node = _nodes.emplace_back();
+    node._matrix = matrix;
+    node._parent = parent;
+    return static_cast<std::uint32_t>(_nodes.size() - 1);
+}
+
+std::uint32_t CookedMeshWriter::AddTexture(const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    _textures.emplace_back(bytes, bytes + size);
+    return static_cast<std::uint32_t>(_textures.size() - 1);
+}
+
+void CookedMeshWriter::AddPrimitive(CookedPrimitiveSource primitive) {
+    _primitives.push_back(std::move(primitive));
+}
+
+bool CookedMeshWriter::Write(const std::string& path) const {
+    CookedMeshHeader header;
+    header._magic = CookedMesh::Magic;
+    header._version = CookedMesh::Version;
+    header._vertexSize = _vertexSize;
+    header._nodeCount = static_cast<std::uint32_t>(_nodes.size());
+    header._primitiveCount = static_cast<std::uint32_t>(_primitives.size());
+    header._textureCount = static_cast<std::uint32_t>(_textures.size());
+
+    std::vector<CookedPrimitive> primitives(_primitives.size());
+    std::vector<CookedLod> lods;
+    std::vector<CookedTexture> textures(_textures.size());
+
+    for(std::size_t i = 0; i < _primitives.size(); i++) {
+        primitives[i]._firstLod = static_cast<std::uint32_t>(lods.size());
+        lods.resize(lods.size() + _primitives[i]._lods.size());
+    }
+    header._lodCount = static_cast<std::uint32_t>(lods.size());
+
+    // Tables first, then every blob, so a loader touching only the tables reads a handful of pages
+    std::uint64_t offset = sizeof(CookedMeshHeader);
+    auto Reserve = [&offset](std::uint64_t size) {
+        const std::uint64_t start = Align(offset);
+        offset = start + size;
+        return start;
+    };
+
+    header._nodesOffset = Reserve(_nodes.size() * sizeof(CookedNode));
+    header._primitivesOffset = Reserve(primitives.size() * sizeof(CookedPrimitive));
+    header._lodsOffset = Reserve(lods.size() * sizeof(CookedLod));
+    header._texturesOffset = Reserve(textures.size() * sizeof(CookedTexture));
+
+    for(std::size_t i = 0; i < _primitives.size(); i++) {
+        const CookedPrimitiveSource& source = _primitives[i];
+        CookedPrimitive& primitive = primitives[i];
+        primitive._node = source._node;
+        primitive._diffuseTexture = source._diffuseTexture;
+        primitive._shaderFeatures = source._shaderFeatures;
+        primitive._vertexCount = source._vertexCount;
+        primitive._indexCount = static_cast<std::uint32_t>(source._indices.size());
+        primitive._lodCount = static_cast<std::uint32_t>(source._lods.size());
+        primitive._meshletCount = static_cast<std::uint32_t>(source._meshlets.size());
+        primitive._boundsMin = source._boundsMin;
+        primitive._boundsMax = source._boundsMax;
+        primitive._boundsRadius = source._boundsRadius;
+
+        primitive._verticesOffset = Reserve(static_cast<std::uint64_t>(source._vertexCount) * _vertexSize);
+        primitive._indicesOffset = Reserve(source._indices.size_bytes());
+        for(std::size_t lod = 0; lod < source._lods.size(); lod++) {
+            lods[primitive._firstLod + lod]._indicesOffset = Reserve(source._lods[lod].first.size_bytes());
+            lods[primitive._firstLod + lod]._indexCount = static_cast<std::uint32_t>(source._lods[lod].first.size());
+            lods[primitive._firstLod + lod]._error = source._lods[lod].second;
+        }
+        primitive._meshletsOffset = Reserve(source._meshlets.size_bytes());
+    }
+
+    for(std::size_t i = 0; i < _textures.size(); i++) {
+        textures[i]._offset = Reserve(_textures[i].size());
+        textures[i]._size = _textures[i].size();
+    }
+
+    header._fileSize = offset;
+
+    // Unique so several writers of the same file, in this process or another, never share one
+    const std::string temporaryPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if(!stream) {
+            std::cerr << "[Error]: Could not write " << temporaryPath << std::endl;
+            return false;
+        }
+
+        BlobStream blobs(stream);
+        blobs.Write(0, &header, sizeof(header));
+        blobs.Write(header._nodesOffset, _nodes.data(), _nodes.size() * sizeof(CookedNode));
+        blobs.Write(header._primitivesOffset, primitives.data(), primitives.size() * sizeof(CookedPrimitive));
+        blobs.Write(header._lodsOffset, lods.data(), lods.size() * sizeof(CookedLod));
+        blobs.Write(header._texturesOffset, textures.data(), textures.size() * sizeof(CookedTexture));
+
+        for(std::size_t i = 0; i < _primitives.size(); i++) {
+            const CookedPrimitiveSource& source = _primitives[i];
+            const CookedPrimitive& primitive = primitives[i];
+            blobs.Write(primitive._verticesOffset, source._vertices, static_cast<std::size_t>(source._vertexCount) * _vertexSize);
+            blobs.Write(primitive._indicesOffset, source._indices.data(), source._indices.size_bytes());
+            for(std::size_t lod = 0; lod < source._lods.size(); lod++) {
+                blobs.Write(lods[primitive._firstLod + lod]._indicesOffset, source._lods[lod].first.data(), source._lods[lod].first.size_bytes());
+            }
+            blobs.Write(primitive._meshletsOffset, source._meshlets.data(), source._meshlets.size_bytes());
+        }
+
+        for(std::size_t i = 0; i < _textures.size(); i++) {
+            blobs.Write(textures[i]._offset, _textures[i].data(), _textures[i].size());
+        }
+
+        if(!stream.flush()) {
+            std::cerr << "[Error]: Could not write " << temporaryPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if(error) {
+        std::cerr << "[Error]: Could not write " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const CookedMesh> CookedMesh::Open(const std::string& path, std::uint32_t vertexSize) {
+    std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+    if(!file || file->GetSize() < sizeof(CookedMeshHeader)) {
+        return nullptr;
+    }
+
+    auto cookedMesh = std::make_shared<CookedMesh>();
+    cookedMesh->_file = std::move(file);
+    cookedMesh->_header = reinterpret_cast<const CookedMeshHeader*>(cookedMesh->_file->GetData());
+
+    if(!cookedMesh->Validate(vertexSize)) {
+        return nullptr;
+    }
+
+    return cookedMesh;
+}
+
+std::span<const std::uint8_t> CookedMesh::GetTexture(std::uint32_t index) const {
+    const CookedTexture& texture = GetArray<CookedTexture>(_header->_texturesOffset, _header->_textureCount)[index];
+    return GetArray<std::uint8_t>(texture._offset, texture._size);
+}
+
+bool CookedMesh::Validate(std::uint32_t vertexSize) const {
+    const CookedMeshHeader& header = *_header;
+    const std::uint64_t fileSize = _file->GetSize();
+
+    if(header._magic != Magic || header._version != Version || header._vertexSize != vertexSize || header._fileSize != fileSize) {
+        return false;
+    }
+
+    // Everything is checked once here, the accessors trust the offsets afterwards
+    if(!IsInside(header._nodesOffset, header._nodeCount, sizeof(CookedNode), fileSize) ||
+       !IsInside(header._primitivesOffset, header._primitiveCount, sizeof(CookedPrimitive), fileSize) ||
+       !IsInside(header._lodsOffset, header._lodCount, sizeof(CookedLod), fileSize) ||
+       !IsInside(header._texturesOffset, header._textureCount, sizeof(CookedTexture), fileSize)) {
+        return false;
+    }
+
+    const std::span<const CookedNode> nodes = GetNodes();
+    for(std::size_t i = 0; i < nodes.size(); i++) {
+        if(nodes[i]._parent >= static_cast<std::int32_t>(i)) {
+            return false;
+        }
+    }
+
+    for(const CookedPrimitive& primitive : GetPrimitives()) {
+        if(primitive._node >= header._nodeCount || primitive._diffuseTexture >= static_cast<std::int32_t>(header._textureCount) ||
+           static_cast<std::uint64_t>(primitive._firstLod) + primitive._lodCount > header._lodCount) {
+            return false;
+        }
+
+        if(!IsInside(primitive._verticesOffset, primitive._vertexCount, vertexSize, fileSize) ||
+           !IsInside(primitive._indicesOffset, primitive._indexCount, sizeof(std::uint32_t), fileSize) ||
+           !IsInside(primitive._meshletsOffset, primitive._meshletCount, sizeof(Meshlet), fileSize)) {
+            return false;
+        }
+
+        if(!AreIndicesInside(GetIndices(primitive), primitive._vertexCount)) {
+            return false;
+        }
+
+        // Meshlets draw ranges of the indices
+        for(const Meshlet& meshlet : GetMeshlets(primitive)) {
+            if((static_cast<std::uint64_t>(meshlet._triangleOffset) + meshlet._triangleCount) * 3 > primitive._indexCount) {
+                return false;
+            }
+        }
+
+        for(const CookedLod& lod : GetLods(primitive)) {
+            if(!IsInside(lod._indicesOffset, lod._indexCount, sizeof(std::uint32_t), fileSize) ||
+               !AreIndicesInside(GetIndices(lod), primitive._vertexCount)) {
+                return false;
+            }
+        }
+    }
+
+    for(const CookedTexture& texture : GetArray<CookedTexture>(header._texturesOffset, header._textureCount)) {
+        if(texture._offset > fileSize || texture._size > fileSize - texture._offset) {
+            return false;
+        }
+    }
+
+    return true;
+}
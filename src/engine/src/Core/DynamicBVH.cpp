@@ -0,0 +1,389 @@
+#include "Core/DynamicBVH.hpp"
+
+namespace {
+    // Leaves are enlarged by this fraction of their size (plus a small absolute margin) so jittering objects stay put
+    constexpr float BoundsMarginScale = 0.1f;
+    constexpr float BoundsMarginMin = 0.01f;
+
+    // Rebuild once this fraction of the leaves was refit since the last build
+    constexpr float RebuildRefitRatio = 0.5f;
+    constexpr std::size_t RebuildRefitMin = 64;
+
+    constexpr int SahBinCount = 12;
+
+    AABB Enlarge(const AABB& bounds) {
+        const glm::vec3 margin = glm::max(bounds.GetExtents() * BoundsMarginScale, glm::vec3(BoundsMarginMin));
+        return {bounds._min - margin, bounds._max + margin};
+    }
+}
+
+bool Ray::Intersects(const AABB& box, float maxDistance, float& distance) const {
+    float entry = 0.0f;
+    float exit = maxDistance;
+
+    for(int axis = 0; axis < 3; axis++) {
+        if(std::abs(_direction[axis]) < 1e-8f) {
+            // Parallel to the slab, only a hit if the origin is between the planes
+            if(_origin[axis] < box._min[axis] || _origin[axis] > box._max[axis]) {
+                return false;
+            }
+            continue;
+        }
+
+        const float inverse = 1.0f / _direction[axis];
+        float near = (box._min[axis] - _origin[axis]) * inverse;
+        float far = (box._max[axis] - _origin[axis]) * inverse;
+        if(near > far) {
+            std::swap(near, far);
+        }
+
+        entry = std::max(entry, near);
+        exit = std::min(exit, far);
+        if(entry > exit) {
+            return false;
+        }
+    }
+
+    distance = entry;
+    return true;
+}
+
+FrustumTest DynamicBVH::TestFrustum(const Frustum& frustum, const AABB& box) {
+    const glm::vec3 center = box.GetCenter();
+    const glm::vec3 extents = box.GetExtents();
+
+    FrustumTest result = FrustumTest::Inside;
+    for(const glm::vec4& plane : frustum._planes) {
+        const glm::vec3 normal = glm::vec3(plane);
+        const float distance = glm::dot(normal, center) + plane.w;
+        const float radius = glm::dot(glm::abs(normal), extents);
+
+        if(distance < -radius) {
+            return FrustumTest::Outside;
+        }
+
+        if(distance < radius) {
+            result = FrustumTest::Intersecting;
+        }
+    }
+
+    return result;
+}
+
+std::int32_t DynamicBVH::Insert(const AABB& bounds, entt::entity entity) {
+    const std::int32_t leaf = AllocateNode();
+    _nodes[leaf]._bounds = Enlarge(bounds);
+    _nodes[leaf]._entity = entity;
+
+    InsertLeaf(leaf, _root == NullNode ? NullNode : FindBestSibling(_nodes[leaf]._bounds));
+    _leafCount++;
+
+    return leaf;
+}
+
+std::int32_t DynamicBVH::InsertDeferred(const AABB& bounds, entt::entity entity) {
+    const std::int32_t leaf = AllocateNode();
+    _nodes[leaf]._bounds = Enlarge(bounds);
+    _nodes[leaf]._entity = entity;
+
+    InsertLeaf(leaf, _root);
+    _leafCount++;
+
+    return leaf;
+}
+
+void DynamicBVH::Remove(std::int32_t proxy) {
+    if(proxy < 0 || proxy >= static_cast<std::int32_t>(_nodes.size()) || _nodes[proxy]._bFree || !_nodes[proxy].IsLeaf()) {
+        assert(0 && "Invalid BVH proxy");
+        return;
+    }
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    _leafCount--;
+}
+
+bool DynamicBVH::Move(std::int32_t proxy, const AABB& bounds) {
+    Node& leaf = _nodes[proxy];
+    if(leaf._bounds.Contains(bounds)) {
+        return false;
+    }
+
+    leaf._bounds = Enlarge(bounds);
+    RefitAncestors(leaf._parent);
+
+    _refitsSinceBuild++;
+    if(_refitsSinceBuild > std::max(RebuildRefitMin, static_cast<std::size_t>(_leafCount * RebuildRefitRatio))) {
+        Rebuild();
+    }
+
+    return true;
+}
+
+void DynamicBVH::Rebuild() {
+    _refitsSinceBuild = 0;
+
+    std::vector<std::int32_t> leaves;
+    leaves.reserve(_leafCount);
+
+    for(std::int32_t i = 0; i < static_cast<std::int32_t>(_nodes.size()); i++) {
+        Node& node = _nodes[i];
+        if(node._bFree) {
+            continue;
+        }
+
+        if(node.IsLeaf()) {
+            leaves.push_back(i);
+        }
+        else {
+            FreeNode(i);
+        }
+    }
+
+    _root = leaves.empty() ? NullNode : BuildRange(leaves, 0, leaves.size());
+    if(_root != NullNode) {
+        _nodes[_root]._parent = NullNode;
+    }
+}
+
+std::uint32_t DynamicBVH::GetHeight() const {
+    if(_root == NullNode) {
+        return 0;
+    }
+
+    std::uint32_t height = 0;
+    std::vector<std::pair<std::int32_t, std::uint32_t>> stack = {{_root, 1}};
+    while(!stack.empty()) {
+        const auto [index, depth] = stack.back();
+        stack.pop_back();
+
+        height = std::max(height, depth);
+        if(!_nodes[index].IsLeaf()) {
+            stack.emplace_back(_nodes[index]._left, depth + 1);
+            stack.emplace_back(_nodes[index]._right, depth + 1);
+        }
+    }
+
+    return height;
+}
+
+float DynamicBVH::GetCost() const {
+    if(_root == NullNode || _nodes[_root]._bounds.GetArea() <= 0.0f) {
+        return 0.0f;
+    }
+
+    float area = 0.0f;
+    for(const Node& node : _nodes) {
+        if(!node._bFree && !node.IsLeaf()) {
+            area += node._bounds.GetArea();
+        }
+    }
+
+    return area / _nodes[_root]._bounds.GetArea();
+}
+
+std::int32_t DynamicBVH::AllocateNode() {
+    if(_freeNodes.empty()) {
+        _nodes.emplace_back();
+        return static_cast<std::int32_t>(_nodes.size() - 1);
+    }
+
+    const std::int32_t index = _freeNodes.back();
+    _freeNodes.pop_back();
+    _nodes[index] = Node();
+    return index;
+}
+
+void DynamicBVH::FreeNode(std::int32_t index) {
+    _nodes[index]._bFree = true;
+    _freeNodes.push_back(index);
+}
+
+std::int32_t DynamicBVH::FindBestSibling(const AABB& bounds) const {
+    // Branch and bound, the cost of a candidate is the area of its new parent plus the growth it causes on the
+    // ancestors (inherited cost). Children can only cost more than their inherited cost plus the new leaf area.
+    const float leafArea = bounds.GetArea();
+
+    std::int32_t bestSibling = _root;
+    float bestCost = AABB::Union(_nodes[_root]._bounds, bounds).GetArea();
+
+    std::vector<std::pair<std::int32_t, float>> stack = {{_root, 0.0f}};
+    while(!stack.empty()) {
+        const auto [index, inheritedCost] = stack.back();
+        stack.pop_back();
+
+        const Node& node = _nodes[index];
+        const float unionArea = AABB::Union(node._bounds, bounds).GetArea();
+        const float cost = unionArea + inheritedCost;
+        if(cost < bestCost) {
+            bestCost = cost;
+            bestSibling = index;
+        }
+
+        const float childInheritedCost = inheritedCost + unionArea - node._bounds.GetArea();
+        if(!node.IsLeaf() && leafArea + childInheritedCost < bestCost) {
+            stack.emplace_back(node._left, childInheritedCost);
+            stack.emplace_back(node._right, childInheritedCost);
+        }
+    }
+
+    return bestSibling;
+}
+
+void DynamicBVH::InsertLeaf(std::int32_t leaf, std::int32_t sibling) {
+    if(_root == NullNode) {
+        _root = leaf;
+        _nodes[leaf]._parent = NullNode;
+        return;
+    }
+
+    const std::int32_t oldParent = _nodes[sibling]._parent;
+
+    const std::int32_t newParent = AllocateNode();
+    _nodes[newParent]._parent = oldParent;
+    _nodes[newParent]._left = sibling;
+    _nodes[newParent]._right = leaf;
+    _nodes[newParent]._bounds = AABB::Union(_nodes[sibling]._bounds, _nodes[leaf]._bounds);
+    _nodes[sibling]._parent = newParent;
+    _nodes[leaf]._parent = newParent;
+
+    if(oldParent == NullNode) {
+        _root = newParent;
+    }
+    else {
+        Node& parent = _nodes[oldParent];
+        (parent._left == sibling ? parent._left : parent._right) = newParent;
+    }
+
+    RefitAncestors(oldParent);
+}
+
+void DynamicBVH::RemoveLeaf(std::int32_t leaf) {
+    if(leaf == _root) {
+        _root = NullNode;
+        return;
+    }
+
+    // The parent goes away and the sibling takes its place
+    const std::int32_t parent = _nodes[leaf]._parent;
+    const std::int32_t grandParent = _nodes[parent]._parent;
+    const std::int32_t sibling = _nodes[parent]._left == leaf ? _nodes[parent]._right : _nodes[parent]._left;
+
+    _nodes[sibling]._parent = grandParent;
+    if(grandParent == NullNode) {
+        _root = sibling;
+    }
+    else {
+        Node& node = _nodes[grandParent];
+        (node._left == parent ? node._left : node._right) = sibling;
+        RefitAncestors(grandParent);
+    }
+
+    FreeNode(parent);
+    _nodes[leaf]._parent = NullNode;
+}
+
+void DynamicBVH::RefitAncestors(std::int32_t index) {
+    while(index != NullNode) {
+        Node& node = _nodes[index];
+        node._bounds = AABB::Union(_nodes[node._left]._bounds, _nodes[node._right]._bounds);
+        index = node._parent;
+    }
+}
+
+std::int32_t DynamicBVH::BuildRange(std::vector<std::int32_t>& leaves, std::size_t begin, std::size_t end) {
+    if(end - begin == 1) {
+        return leaves[begin];
+    }
+
+    AABB bounds = _nodes[leaves[begin]]._bounds;
+    AABB centroidBounds = {bounds.GetCenter(), bounds.GetCenter()};
+    for(std::size_t i = begin; i < end; i++) {
+        const AABB& leafBounds = _nodes[leaves[i]]._bounds;
+        bounds = AABB::Union(bounds, leafBounds);
+        centroidBounds = AABB::Union(centroidBounds, {leafBounds.GetCenter(), leafBounds.GetCenter()});
+    }
+
+    // Binned SAH along every axis, the split with the lowest left area * count + right area * count wins
+    int bestAxis = -1;
+    int bestBin = 0;
+    float bestCost = std::numeric_limits<float>::max();
+
+    for(int axis = 0; axis < 3; axis++) {
+        const float axisMin = centroidBounds._min[axis];
+        const float axisSize = centroidBounds._max[axis] - axisMin;
+        if(axisSize <= 0.0f) {
+            continue;
+        }
+
+        std::array<AABB, SahBinCount> binBounds;
+        std::array<std::size_t, SahBinCount> binCounts = {};
+        for(std::size_t i = begin; i < end; i++) {
+            const AABB& leafBounds = _nodes[leaves[i]]._bounds;
+            const int bin = std::min(SahBinCount - 1, static_cast<int>((leafBounds.GetCenter()[axis] - axisMin) / axisSize * SahBinCount));
+            binBounds[bin] = binCounts[bin] == 0 ? leafBounds : AABB::Union(binBounds[bin], leafBounds);
+            binCounts[bin]++;
+        }
+
+        // Sweep from the right so each split only needs one pass from the left
+        std::array<float, SahBinCount> rightCosts = {};
+        AABB rightBounds;
+        std::size_t rightCount = 0;
+        for(int bin = SahBinCount - 1; bin > 0; bin--) {
+            if(binCounts[bin] > 0) {
+                rightBounds = rightCount == 0 ? binBounds[bin] : AABB::Union(rightBounds, binBounds[bin]);
+                rightCount += binCounts[bin];
+            }
+            rightCosts[bin] = rightCount > 0 ? rightBounds.GetArea() * static_cast<float>(rightCount) : 0.0f;
+        }
+
+        AABB leftBounds;
+        std::size_t leftCount = 0;
+        for(int bin = 0; bin < SahBinCount - 1; bin++) {
+            if(binCounts[bin] > 0) {
+                leftBounds = leftCount == 0 ? binBounds[bin] : AABB::Union(leftBounds, binBounds[bin]);
+                leftCount += binCounts[bin];
+            }
+
+            if(leftCount == 0 || leftCount == end - begin) {
+                continue;
+            }
+
+            const float cost = leftBounds.GetArea() * static_cast<float>(leftCount) + rightCosts[bin + 1];
+            if(cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin = bin;
+            }
+        }
+    }
+
+    std::size_t middle = begin + (end - begin) / 2;
+    if(bestAxis >= 0) {
+        const float axisMin = centroidBounds._min[bestAxis];
+        const float axisSize = centroidBounds._max[bestAxis] - axisMin;
+        auto it = std::partition(leaves.begin() + begin, leaves.begin() + end, [&](std::int32_t leaf) {
+            const int bin = std::min(SahBinCount - 1, static_cast<int>((_nodes[leaf]._bounds.GetCenter()[bestAxis] - axisMin) / axisSize * SahBinCount));
+            return bin <= bestBin;
+        });
+        middle = static_cast<std::size_t>(it - leaves.begin());
+    }
+
+    // Every centroid in the same spot, any split is as good as another
+    if(middle == begin || middle == end) {
+        middle = begin + (end - begin) / 2;
+    }
+
+    const std::int32_t left = BuildRange(leaves, begin, middle);
+    const std::int32_t right = BuildRange(leaves, middle, end);
+
+    const std::int32_t index = AllocateNode();
+    Node& node = _nodes[index];
+    node._bounds = bounds;
+    node._left = left;
+    node._right = right;
+    _nodes[left]._parent = index;
+    _nodes[right]._parent = index;
+
+    return index;
+}
@@ -0,0 +1,41 @@
+#include "Core/FileWatcher.hpp"
+
+namespace {
+    bool GetWriteTime(const std::string& path, std::filesystem::file_time_type& writeTime) {
+        std::error_code error;
+        writeTime = std::filesystem::last_write_time(path, error);
+        return !error;
+    }
+}
+
+void FileWatcher::Watch(const std::string& path) {
+    if(_files.contains(path)) {
+        return;
+    }
+
+    std::filesystem::file_time_type writeTime {};
+    GetWriteTime(path, writeTime);
+    _files.emplace(path, writeTime);
+}
+
+void FileWatcher::Unwatch(const std::string& path) {
+    _files.erase(path);
+}
+
+std::vector<std::string> FileWatcher::Poll() {
+    std::vector<std::string> changedFiles;
+
+    for(auto& [path, lastWriteTime] : _files) {
+        std::filesystem::file_time_type writeTime;
+        if(!GetWriteTime(path, writeTime)) {
+            continue;
+        }
+
+        if(writeTime != lastWriteTime) {
+            lastWriteTime = writeTime;
+            changedFiles.push_back(path);
+        }
+    }
+
+    return changedFiles;
+}
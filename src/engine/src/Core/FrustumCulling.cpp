@@ -0,0 +1,218 @@
+#include "Core/FrustumCulling.hpp"
+#include "Components/BoundsComponent.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define FRUSTUM_CULLING_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define TARGET_AVX2
+    #else
+        #define TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+    #define FRUSTUM_CULLING_NEON 1
+    #include <arm_neon.h>
+#endif
+
+Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection) {
+    // glm is column major, row k of the matrix is (m[0][k], m[1][k], m[2][k], m[3][k])
+    const glm::mat4 m = glm::transpose(viewProjection);
+
+    Frustum frustum;
+    frustum._planes[0] = m[3] + m[0]; // Left
+    frustum._planes[1] = m[3] - m[0]; // Right
+    frustum._planes[2] = m[3] + m[1]; // Bottom
+    frustum._planes[3] = m[3] - m[1]; // Top
+    frustum._planes[4] = m[3] + m[2]; // Near
+    frustum._planes[5] = m[3] - m[2]; // Far
+
+    // Normalized so distances can be compared against radii
+    for(glm::vec4& plane : frustum._planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if(length > 0.0f) {
+            plane /= length;
+        }
+    }
+
+    return frustum;
+}
+
+void CullingBoundsSoA::Resize(std::size_t size) {
+    for(std::vector<float>* component : {&_centerX, &_centerY, &_centerZ, &_extentX, &_extentY, &_extentZ, &_radius}) {
+        component->resize(size, 0.0f);
+    }
+}
+
+namespace {
+    struct PlaneData {
+        float _normal[3];
+        float _absNormal[3];
+        float _distance;
+    };
+
+    std::array<PlaneData, 6> MakePlaneData(const Frustum& frustum) {
+        std::array<PlaneData, 6> planes;
+        for(std::size_t p = 0; p < planes.size(); p++) {
+            for(int axis = 0; axis < 3; axis++) {
+                planes[p]._normal[axis] = frustum._planes[p][axis];
+                planes[p]._absNormal[axis] = std::abs(frustum._planes[p][axis]);
+            }
+
+            planes[p]._distance = frustum._planes[p].w;
+        }
+
+        return planes;
+    }
+
+    // The reference every SIMD version has to match
+    bool CullScalar(const std::array<PlaneData, 6>& planes, const CullingBoundsSoA& b, std::size_t i) {
+        for(const PlaneData& plane : planes) {
+            const float distance = plane._normal[0] * b._centerX[i] + plane._normal[1] * b._centerY[i]
+                + plane._normal[2] * b._centerZ[i] + plane._distance;
+            const float boxRadius = plane._absNormal[0] * b._extentX[i] + plane._absNormal[1] * b._extentY[i]
+                + plane._absNormal[2] * b._extentZ[i];
+
+            if(distance + std::min(b._radius[i], boxRadius) < 0.0f) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+#if FRUSTUM_CULLING_X86
+    int CullSSE(const std::array<PlaneData, 6>& planes, const CullingBoundsSoA& b, std::size_t i) {
+        const __m128 cx = _mm_loadu_ps(&b._centerX[i]), cy = _mm_loadu_ps(&b._centerY[i]), cz = _mm_loadu_ps(&b._centerZ[i]);
+        const __m128 ex = _mm_loadu_ps(&b._extentX[i]), ey = _mm_loadu_ps(&b._extentY[i]), ez = _mm_loadu_ps(&b._extentZ[i]);
+        const __m128 radius = _mm_loadu_ps(&b._radius[i]);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for(const PlaneData& plane : planes) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane._normal[0]), cx), _mm_set1_ps(plane._distance));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane._normal[1]), cy));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane._normal[2]), cz));
+
+            __m128 boxRadius = _mm_mul_ps(_mm_set1_ps(plane._absNormal[0]), ex);
+            boxRadius = _mm_add_ps(boxRadius, _mm_mul_ps(_mm_set1_ps(plane._absNormal[1]), ey));
+            boxRadius = _mm_add_ps(boxRadius, _mm_mul_ps(_mm_set1_ps(plane._absNormal[2]), ez));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(radius, boxRadius)), zero));
+        }
+
+        return _mm_movemask_ps(inside);
+    }
+
+    TARGET_AVX2 int CullAVX2(const std::array<PlaneData, 6>& planes, const CullingBoundsSoA& b, std::size_t i) {
+        const __m256 cx = _mm256_loadu_ps(&b._centerX[i]), cy = _mm256_loadu_ps(&b._centerY[i]), cz = _mm256_loadu_ps(&b._centerZ[i]);
+        const __m256 ex = _mm256_loadu_ps(&b._extentX[i]), ey = _mm256_loadu_ps(&b._extentY[i]), ez = _mm256_loadu_ps(&b._extentZ[i]);
+        const __m256 radius = _mm256_loadu_ps(&b._radius[i]);
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 inside = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for(const PlaneData& plane : planes) {
+            __m256 distance = _mm256_fmadd_ps(_mm256_set1_ps(plane._normal[0]), cx, _mm256_set1_ps(plane._distance));
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane._normal[1]), cy, distance);
+            distance = _mm256_fmadd_ps(_mm256_set1_ps(plane._normal[2]), cz, distance);
+
+            __m256 boxRadius = _mm256_mul_ps(_mm256_set1_ps(plane._absNormal[0]), ex);
+            boxRadius = _mm256_fmadd_ps(_mm256_set1_ps(plane._absNormal[1]), ey, boxRadius);
+            boxRadius = _mm256_fmadd_ps(_mm256_set1_ps(plane._absNormal[2]), ez, boxRadius);
+
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(radius, boxRadius)), zero, _CMP_GE_OQ));
+        }
+
+        return _mm256_movemask_ps(inside);
+    }
+#endif
+
+#if FRUSTUM_CULLING_NEON
+    int CullNEON(const std::array<PlaneData, 6>& planes, const CullingBoundsSoA& b, std::size_t i) {
+        const float32x4_t cx = vld1q_f32(&b._centerX[i]), cy = vld1q_f32(&b._centerY[i]), cz = vld1q_f32(&b._centerZ[i]);
+        const float32x4_t ex = vld1q_f32(&b._extentX[i]), ey = vld1q_f32(&b._extentY[i]), ez = vld1q_f32(&b._extentZ[i]);
+        const float32x4_t radius = vld1q_f32(&b._radius[i]);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFF);
+        for(const PlaneData& plane : planes) {
+            float32x4_t distance = vmlaq_n_f32(vdupq_n_f32(plane._distance), cx, plane._normal[0]);
+            distance = vmlaq_n_f32(distance, cy, plane._normal[1]);
+            distance = vmlaq_n_f32(distance, cz, plane._normal[2]);
+
+            float32x4_t boxRadius = vmulq_n_f32(ex, plane._absNormal[0]);
+            boxRadius = vmlaq_n_f32(boxRadius, ey, plane._absNormal[1]);
+            boxRadius = vmlaq_n_f32(boxRadius, ez, plane._absNormal[2]);
+
+            inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(distance, vminq_f32(radius, boxRadius)), zero));
+        }
+
+        // No movemask on NEON, keep one bit per lane
+        const uint32x4_t bits = {1, 2, 4, 8};
+        return static_cast<int>(vaddvq_u32(vandq_u32(inside, bits)));
+    }
+#endif
+
+    void StoreMask(int mask, int lanes, std::uint8_t* visible) {
+        for(int lane = 0; lane < lanes; lane++) {
+            visible[lane] = static_cast<std::uint8_t>((mask >> lane) & 1);
+        }
+    }
+}
+
+void FrustumCulling::TransformBounds(const glm::mat4& matrix, const BoundsComponent& bounds, CullingBoundsSoA& out, std::size_t index) {
+    const glm::vec3 center = glm::vec3(matrix * glm::vec4(bounds.GetCenter(), 1.0f));
+    const glm::vec3 extents = bounds.GetExtents();
+
+    // Each world axis extent is the sum of the local extents projected on it (Arvo)
+    glm::vec3 worldExtents(0.0f);
+    for(int column = 0; column < 3; column++) {
+        worldExtents += glm::abs(glm::vec3(matrix[column])) * extents[column];
+    }
+
+    const float maxScale = std::max({glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))});
+
+    out._centerX[index] = center.x;
+    out._centerY[index] = center.y;
+    out._centerZ[index] = center.z;
+    out._extentX[index] = worldExtents.x;
+    out._extentY[index] = worldExtents.y;
+    out._extentZ[index] = worldExtents.z;
+    out._radius[index] = bounds._radius * maxScale;
+}
+
+void FrustumCulling::Cull(SimdIsa isa, const Frustum& frustum, const CullingBoundsSoA& bounds, std::size_t begin, std::size_t end, std::uint8_t* visible) {
+    if(!TransformKernels::IsSupported(isa)) {
+        assert(0 && "Instruction set not supported by this CPU");
+        isa = SimdIsa::Scalar;
+    }
+
+    const std::array<PlaneData, 6> planes = MakePlaneData(frustum);
+    std::size_t i = begin;
+
+#if FRUSTUM_CULLING_X86
+    if(isa == SimdIsa::AVX2) {
+        for(; i + 8 <= end; i += 8) {
+            StoreMask(CullAVX2(planes, bounds, i), 8, visible + (i - begin));
+        }
+    }
+
+    if(isa == SimdIsa::SSE || isa == SimdIsa::AVX2) {
+        for(; i + 4 <= end; i += 4) {
+            StoreMask(CullSSE(planes, bounds, i), 4, visible + (i - begin));
+        }
+    }
+#endif
+
+#if FRUSTUM_CULLING_NEON
+    if(isa == SimdIsa::NEON) {
+        for(; i + 4 <= end; i += 4) {
+            StoreMask(CullNEON(planes, bounds, i), 4, visible + (i - begin));
+        }
+    }
+#endif
+
+    // Tail that does not fill a whole register
+    for(; i < end; i++) {
+        visible[i - begin] = CullScalar(planes, bounds, i) ? 1 : 0;
+    }
+}
@@ -1,160 +1,730 @@
 #include "Core/GeometryLoaderSystem.hpp"
 #include "glm/ext/matrix_transform.hpp"
-#include "stb_image.h"
+#include "assimp/DefaultIOSystem.h"
 #include "assimp/Importer.hpp"
+#include "assimp/ProgressHandler.hpp"
 #include "assimp/postprocess.h"
 #include "assimp/scene.h"
+#include "Components/BoundsComponent.hpp"
 #include "Components/MeshComponent.hpp"
 #include "Components/PhongMaterialComponent.hpp"
 #include "Components/PrimitiveProxyComponent.hpp"
 #include "Components/TransformComponent.hpp"
+#include "Core/CookedMesh.hpp"
+#include "Core/ImportCache.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Meshlets.hpp"
+#include "Core/MeshOptimizer.hpp"
+#include "Core/MeshSimplifier.hpp"
 #include "Core/Scene.hpp"
 #include "Renderer/Texture2D.hpp"
+#include "Renderer/TextureRegistry.hpp"
+#include <bit>
+#include <filesystem>
+#include <unordered_map>
+
+namespace {
+    constexpr std::size_t MaxLodCount = 3;         // Levels after the full mesh
+    constexpr std::size_t MinLodTriangles = 128;   // Smaller levels are not worth another index range
+    constexpr float MaxLodErrorFraction = 0.05f;   // Of the bounding radius, coarser levels would only pop
+    constexpr float MinLodReduction = 0.8f;        // A level keeping more of the previous one's indices means it stalled
+    constexpr std::size_t MinMeshletTriangles = MeshletBuilder::MaxTriangles * 8; // Fewer are culled whole just as well
+
+    // Cache statistics after every optimization stage, summed over the primitives of a file
+    struct OptimizationReport {
+        VertexCacheStatistics _source;
+        VertexCacheStatistics _deduplicated;
+        VertexCacheStatistics _vertexCache;
+        VertexCacheStatistics _overdraw;
+        VertexCacheStatistics _meshlets;
+        VertexCacheStatistics _vertexFetch;
+
+        void Add(const OptimizationReport& other) {
+            _source.Add(other._source);
+            _deduplicated.Add(other._deduplicated);
+            _vertexCache.Add(other._vertexCache);
+            _overdraw.Add(other._overdraw);
+            _meshlets.Add(other._meshlets);
+            _vertexFetch.Add(other._vertexFetch);
+        }
+    };
+
+    /*
+     *  Dense primitives are split into meshlets, their indices are rewritten in meshlet order so the culled meshlets leave
+     * contiguous ranges to draw. Meshlets grow from the first unused triangle so they follow the overdraw order, the
+     * triangles of each one are ordered for the vertex cache again
+     */
+    void GenerateMeshlets(PrimitiveProxyComponentCPU& primitive) {
+        if(primitive._vertexData.empty() || primitive._indices.size() / 3 < MinMeshletTriangles) {
+            return;
+        }
+
+        MeshletData& data = primitive._meshlets;
+        data = MeshletBuilder::Build(&primitive._vertexData[0].position.x, primitive._vertexData.size(), sizeof(VertexData),
+            primitive._indices.data(), primitive._indices.size());
+
+        std::vector<std::uint32_t> local;
+        for(const Meshlet& meshlet : data._meshlets) {
+            const auto first = data._triangles.begin() + meshlet._triangleOffset * 3;
+            local.assign(first, first + meshlet._triangleCount * 3);
+            MeshOptimizer::OptimizeVertexCache(local.data(), local.size(), meshlet._vertexCount);
+            std::copy(local.begin(), local.end(), first);
+        }
+
+        primitive._indices = MeshletBuilder::BuildIndices(data);
+
+        // Only the ranges are used from here on, same as when the primitive is loaded from the import cache. The vertex
+        // fetch stage renumbers the vertices the local lists point to
+        data._vertices.clear();
+        data._triangles.clear();
+    }
+
+    // Assimp keeps the source order and every vertex of every face, the GPU wants shared vertices and cache friendly orders
+    void OptimizeGeometry(PrimitiveProxyComponentCPU& primitive, OptimizationReport& report) {
+        std::vector<unsigned int>& indices = primitive._indices;
+        std::vector<VertexData>& vertices = primitive._vertexData;
+        if(indices.empty() || vertices.empty()) {
+            return;
+        }
+
+        auto Analyze = [&indices, &vertices]() {
+            return MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+        };
+
+        report._source.Add(Analyze());
+
+        vertices.resize(MeshOptimizer::DeduplicateVertices(vertices.data(), vertices.size(), sizeof(VertexData), indices.data(), indices.size()));
+        report._deduplicated.Add(Analyze());
+
+        MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+        report._vertexCache.Add(Analyze());
+
+        MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), &vertices[0].position.x, vertices.size(), sizeof(VertexData));
+        report._overdraw.Add(Analyze());
+
+        // Rewrites the index order, the vertex fetch order has to follow what is uploaded
+        GenerateMeshlets(primitive);
+        report._meshlets.Add(Analyze());
+
+        vertices.resize(MeshOptimizer::OptimizeVertexFetch(vertices.data(), vertices.size(), sizeof(VertexData), indices.data(), indices.size()));
+        report._vertexFetch.Add(Analyze());
+    }
+
+    void PrintReport(const std::string& filePath, const OptimizationReport& report) {
+        const std::pair<const char*, const VertexCacheStatistics*> stages[] = {
+            {"source", &report._source},
+            {"deduplicated", &report._deduplicated},
+            {"vertex cache", &report._vertexCache},
+            {"overdraw", &report._overdraw},
+            {"meshlets", &report._meshlets},
+            {"vertex fetch", &report._vertexFetch},
+        };
+
+        for(const auto& [name, statistics] : stages) {
+            std::cout << "[Info]: " << filePath << " " << name << ": ACMR " << statistics->GetAcmr() << ", ATVR " << statistics->GetAtvr() << std::endl;
+        }
+    }
+
+    /*
+     *  Each level simplifies the previous one to about half of its triangles, the errors add up so a level's error
+     * bounds its distance to the full mesh. Wedges are matched by every attribute after the position.
+     */
+    void GenerateLods(PrimitiveProxyComponentCPU& primitive, float radius) {
+        constexpr std::size_t attributeCount = (sizeof(VertexData) - offsetof(VertexData, texCoords)) / sizeof(float);
+        if(primitive._vertexData.empty() || primitive._indices.size() / 3 < MinLodTriangles * 2) {
+            return;
+        }
+
+        const std::vector<unsigned int>* source = &primitive._indices;
+        float error = 0.0f;
+
+        while(primitive._lods.size() < MaxLodCount && source->size() / 3 >= MinLodTriangles * 2) {
+            const std::size_t targetIndexCount = source->size() / 6 * 3;
+            MeshSimplifier::Result result = MeshSimplifier::Simplify(&primitive._vertexData[0].position.x,
+                &primitive._vertexData[0].texCoords.x, attributeCount, primitive._vertexData.size(), sizeof(VertexData),
+                source->data(), source->size(), targetIndexCount, radius * MaxLodErrorFraction - error);
+
+            if(result._indices.empty() || result._indices.size() > source->size() * MinLodReduction) {
+                break;
+            }
+
+            // Same vertex buffer, only the triangle order can still be improved
+            MeshOptimizer::OptimizeVertexCache(result._indices.data(), result._indices.size(), primitive._vertexData.size());
+
+            error += result._error;
+            primitive._lods.push_back({std::move(result._indices), error});
+            source = &primitive._lods.back()._indices;
+        }
+    }
+
+    // Box from the vertex positions, the sphere is centered on the box and reaches the farthest vertex
+    BoundsComponent ComputeBounds(const std::vector<VertexData>& vertices) {
+        BoundsComponent bounds;
+        if(vertices.empty()) {
+            return bounds;
+        }
+
+        bounds._min = bounds._max = vertices[0].position;
+        for(const VertexData& vertex : vertices) {
+            bounds._min = glm::min(bounds._min, vertex.position);
+            bounds._max = glm::max(bounds._max, vertex.position);
+        }
+
+        const glm::vec3 center = bounds.GetCenter();
+        float radiusSquared = 0.0f;
+        for(const VertexData& vertex : vertices) {
+            const glm::vec3 offset = vertex.position - center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        }
+
+        bounds._radius = std::sqrt(radiusSquared);
+        return bounds;
+    }
+
+    // Everything an import produces, built off the main thread and moved into the registry by Commit
+    struct ImportedPrimitive {
+        PrimitiveProxyComponentCPU _geometry;
+        PhongMaterialComponent _material;
+        BoundsComponent _bounds;
+        TransformComponent _transform;
+    };
+
+    struct ImportedScene {
+        std::vector<TransformComponent> _nodes; // Parents before their children
+        std::vector<std::int32_t> _nodeParents; // -1 for the root
+        std::vector<ImportedPrimitive> _primitives;
+        OptimizationReport _report;
+    };
+
+    // Parsing is the first part of the progress, the geometry processing the second and the commit the rest
+    constexpr float ParseProgress = 0.3f;
+    constexpr float ProcessProgress = 0.6f;
+
+    // Entities committed between two checks of the commit deadline
+    constexpr std::size_t CommitBatchSize = 256;
+
+    constexpr unsigned int ImportFlags = aiProcess_Triangulate | aiProcess_ValidateDataStructure;
+
+    // Bumped whenever the geometry processing changes what it produces for the same settings
+    constexpr std::uint64_t ProcessingRevision = 2;
+
+    // Everything that changes what an import produces, part of every import cache key
+    std::uint64_t GetImportSettingsKey() {
+        static const std::uint64_t key = []() {
+            const std::array<std::uint64_t, 11> settings = {ImportFlags, ProcessingRevision, CookedMesh::Version, sizeof(VertexData), MaxLodCount, MinLodTriangles,
+                std::bit_cast<std::uint32_t>(MaxLodErrorFraction), std::bit_cast<std::uint32_t>(MinLodReduction), MinMeshletTriangles,
+                MeshletBuilder::MaxVertices, MeshOptimizer::CacheSize};
+            return ImportCache::HashBytes(settings.data(), sizeof(settings));
+        }();
+        return key;
+    }
+
+    // Kept encoded, TextureResidency decodes it, builds its mips and compresses it on the TextureDecoder once something using it is in view.
+    // Images already loaded by this or another import are shared
+    std::shared_ptr<Texture2D> MakeEncodedTexture(const void* encoded, std::size_t size) {
+        return TextureRegistry::Get().FindOrMakeFromEncodedData(encoded, size, Format::FORMAT_R8G8B8A8_SRGB, [](Texture2D& texture) {
+            // Diffuse maps, the only material textures so far
+            texture.SetCompression(TextureCompression::Color);
+            texture.SetGenerateMips(true);
+        });
+    }
+
+    PrimitiveProxyComponentCPU ExtractGeometry(const aiMesh* mesh) {
+        PrimitiveProxyComponentCPU primitive;
+        primitive._vertexData.reserve(mesh->mNumVertices);
+
+        for(unsigned int x = 0; x < mesh->mNumVertices; x++) {
+            VertexData vertexData {};
+            vertexData.position = {mesh->mVertices[x].x, mesh->mVertices[x].y, mesh->mVertices[x].z};
+
+            if(mesh->mNormals) {
+                vertexData.normal = {mesh->mNormals[x].x, mesh->mNormals[x].y, mesh->mNormals[x].z};
+            }
+
+            if(mesh->HasTextureCoords(0)) {
+                vertexData.texCoords = {mesh->mTextureCoords[0][x].x, 1 - mesh->mTextureCoords[0][x].y};
+            }
+
+            if(mesh->HasVertexColors(0)) {
+                vertexData.color = {mesh->mColors[0][x].r, mesh->mColors[0][x].g, mesh->mColors[0][x].b};
+            }
+
+            primitive._vertexData.push_back(vertexData);
+        }
+
+        primitive._indices.reserve(mesh->mNumFaces * 3);
+        for(unsigned int x = 0; x < mesh->mNumFaces; x++) {
+            const aiFace& face = mesh->mFaces[x];
+            primitive._indices.insert(primitive._indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+        }
+
+        return primitive;
+    }
+}
+
+// Shared by the worker importing the file and the main thread, the staging scene is handed over through _state
+struct GeometryLoaderSystem::ImportJob {
+    std::uint32_t _id = 0;
+    std::string _filePath;
+    std::atomic<ImportState> _state = ImportState::Importing;
+    std::atomic<bool> _bCancelled = false;
+    std::atomic<float> _progress = 0.0f;
+    std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+
+    std::shared_ptr<const ImportCache> _cache;
+    std::unique_ptr<ImportedScene> _scene; // Written by the worker before _state leaves Importing
+
+    // Commit cursor, main thread only
+    std::size_t _committedNodes = 0;
+    std::size_t _committedPrimitives = 0;
+    MeshComponentNew _meshGroup;
+};
+
+namespace {
+    // Lets Assimp report how far it got and stop when the import is cancelled
+    class ImportProgressHandler : public Assimp::ProgressHandler {
+    public:
+        ImportProgressHandler(std::atomic<float>& progress, const std::atomic<bool>& bCancelled)
+            : _progress(progress)
+            , _bCancelled(bCancelled) {
+        }
+
+        bool Update(float percentage) override {
+            if(percentage >= 0.0f) {
+                _progress = std::min(percentage, 1.0f) * ParseProgress;
+            }
+            return !_bCancelled;
+        }
+
+    private:
+        std::atomic<float>& _progress;
+        const std::atomic<bool>& _bCancelled;
+    };
+
+    // Records every file Assimp reads, the sidecars of a model change what it imports as much as the model itself
+    class RecordingIOSystem : public Assimp::DefaultIOSystem {
+    public:
+        explicit RecordingIOSystem(std::vector<std::string>& paths)
+            : _paths(paths) {
+        }
+
+        Assimp::IOStream* Open(const char* file, const char* mode) override {
+            Assimp::IOStream* stream = DefaultIOSystem::Open(file, mode);
+            if(stream) {
+                _paths.emplace_back(file);
+            }
+            return stream;
+        }
+
+    private:
+        std::vector<std::string>& _paths;
+    };
+}
+
+GeometryLoaderSystem::GeometryLoaderSystem()
+    : _importCache(std::make_shared<ImportCache>(ImportCache::GetDefaultDirectory(), ImportCache::DefaultMaxSize)) {
+}
+
+GeometryLoaderSystem::~GeometryLoaderSystem() {
+    // Workers own their job, they stop at the next check and drop it
+    CancelAll();
+}
 
 void GeometryLoaderSystem::Process(Scene* scene) {
-    if(!_loadQueue.empty()) {
-        std::string filePath = _loadQueue.front();
-        _loadQueue.pop();
+    const auto deadline = std::chrono::steady_clock::now() + _commitBudget;
+
+    // Oldest import first, a later one only gets what is left of the budget
+    for(const std::shared_ptr<ImportJob>& job : _jobs) {
+        if(job->_state != ImportState::Committing) {
+            continue;
+        }
+
+        if(job->_bCancelled) {
+            // The primitives committed so far stay, as a group of their own like any finished import
+            if(!job->_meshGroup._primitives.empty()) {
+                scene->GetRegistry().emplace<MeshComponentNew>(scene->GetRegistry().create(), std::move(job->_meshGroup));
+            }
+
+            job->_scene.reset();
+            job->_state = ImportState::Cancelled;
+            continue;
+        }
+
+        if(!Commit(scene, *job, deadline)) {
+            break;
+        }
+    }
+
+    std::erase_if(_jobs, [](const std::shared_ptr<ImportJob>& job) {
+        const ImportState state = job->_state;
+        return state == ImportState::Finished || state == ImportState::Cancelled || state == ImportState::Failed;
+    });
+}
+
+std::uint32_t GeometryLoaderSystem::EnqueueFileLoad(const std::string& filePath) {
+    auto job = std::make_shared<ImportJob>();
+    job->_id = _nextImportId++;
+    job->_filePath = filePath;
+    job->_cache = _importCache;
+    _jobs.push_back(job);
+
+    JobSystem::Get().Schedule([job]() {
+        Import(job);
+    });
+
+    return job->_id;
+}
+
+void GeometryLoaderSystem::Cancel(std::uint32_t importId) {
+    for(const std::shared_ptr<ImportJob>& job : _jobs) {
+        if(job->_id == importId) {
+            job->_bCancelled = true;
+        }
+    }
+}
+
+void GeometryLoaderSystem::CancelAll() {
+    for(const std::shared_ptr<ImportJob>& job : _jobs) {
+        job->_bCancelled = true;
+    }
+}
+
+std::vector<ImportProgress> GeometryLoaderSystem::GetProgress() const {
+    std::vector<ImportProgress> progress;
+    progress.reserve(_jobs.size());
+
+    for(const std::shared_ptr<ImportJob>& job : _jobs) {
+        progress.push_back({job->_id, job->_filePath, job->_state, job->_progress});
+    }
+
+    return progress;
+}
+
+void GeometryLoaderSystem::Import(const std::shared_ptr<ImportJob>& job) {
+    ImportState state = ImportState::Failed;
+
+    if(!job->_bCancelled) {
+        if(std::filesystem::path(job->_filePath).extension() == ImportCache::EntryExtension) {
+            state = ImportCooked(*job, job->_filePath);
+            if(state == ImportState::Failed) {
+                std::cerr << "[Error]: " << job->_filePath << " is missing, corrupted or from an older version" << std::endl;
+            }
+        } else {
+            // Hashing is far cheaper than importing, a hit skips Assimp entirely
+            std::optional<std::uint64_t> sourceKey;
+            std::optional<std::uint64_t> cacheKey;
+            if(job->_cache) {
+                sourceKey = ImportCache::HashFile(job->_filePath, GetImportSettingsKey());
+            }
+            if(sourceKey) {
+                cacheKey = job->_cache->FindImportKey(*sourceKey, job->_filePath);
+            }
+
+            if(cacheKey && job->_cache->Touch(*cacheKey)) {
+                state = ImportCooked(*job, job->_cache->GetEntryPath(*cacheKey));
+            }
 
-        LoadFromFile(scene, filePath);
+            if(state == ImportState::Failed) {
+                state = ImportSource(*job, sourceKey);
+            }
+        }
     }
+
+    job->_state = job->_bCancelled ? ImportState::Cancelled : state;
 }
 
-void GeometryLoaderSystem::EnqueueFileLoad(const std::string& filePath) {
-    _loadQueue.push(filePath);
+ImportState GeometryLoaderSystem::ImportCooked(ImportJob& job, const std::string& cookedPath) {
+    std::shared_ptr<const CookedMesh> cookedMesh = CookedMesh::Open(cookedPath, sizeof(VertexData));
+    if(!cookedMesh) {
+        return ImportState::Failed;
+    }
+
+    auto scene = std::make_unique<ImportedScene>();
+
+    const std::span<const CookedNode> nodes = cookedMesh->GetNodes();
+    scene->_nodes.resize(nodes.size());
+    scene->_nodeParents.resize(nodes.size());
+    for(std::size_t i = 0; i < nodes.size(); i++) {
+        TransformComponent& node = scene->_nodes[i];
+        node._matrix = nodes[i]._matrix;
+        node._isRootTransform = nodes[i]._parent < 0;
+        scene->_nodeParents[i] = nodes[i]._parent;
+
+        if(nodes[i]._parent >= 0) {
+            scene->_nodes[nodes[i]._parent]._childs.push_back(node._id);
+        }
+    }
+
+    // The geometry stays in the mapping until the upload reads it, the textures are decoded once they are in view
+    std::vector<std::shared_ptr<Texture2D>> textures(cookedMesh->GetTextureCount());
+    for(std::uint32_t i = 0; i < textures.size(); i++) {
+        const std::span<const std::uint8_t> encoded = cookedMesh->GetTexture(i);
+        textures[i] = MakeEncodedTexture(encoded.data(), encoded.size());
+    }
+
+    const std::span<const CookedPrimitive> primitives = cookedMesh->GetPrimitives();
+    scene->_primitives.resize(primitives.size());
+    for(std::size_t i = 0; i < primitives.size(); i++) {
+        const CookedPrimitive& cookedPrimitive = primitives[i];
+        ImportedPrimitive& primitive = scene->_primitives[i];
+
+        primitive._geometry._cookedMesh = cookedMesh;
+        primitive._geometry._cookedPrimitive = &cookedPrimitive;
+
+        // Only the meshlet descriptors are kept, the indices are already in meshlet order
+        const std::span<const Meshlet> meshlets = cookedMesh->GetMeshlets(cookedPrimitive);
+        primitive._geometry._meshlets._meshlets.assign(meshlets.begin(), meshlets.end());
+
+        primitive._material._shaderFeatures = cookedPrimitive._shaderFeatures & ~SF_DiffuseTexture;
+        if(cookedPrimitive._diffuseTexture >= 0 && textures[cookedPrimitive._diffuseTexture]) {
+            primitive._material._diffuseTexture = textures[cookedPrimitive._diffuseTexture];
+            primitive._material._shaderFeatures |= SF_DiffuseTexture;
+        }
+
+        primitive._bounds._min = cookedPrimitive._boundsMin;
+        primitive._bounds._max = cookedPrimitive._boundsMax;
+        primitive._bounds._radius = cookedPrimitive._boundsRadius;
+
+        primitive._transform._matrix = glm::identity<glm::mat4>();
+        scene->_nodes[cookedPrimitive._node]._childs.push_back(primitive._transform._id);
+    }
+
+    job._progress = ParseProgress + ProcessProgress;
+    job._scene = std::move(scene);
+    return ImportState::Committing;
 }
 
-void GeometryLoaderSystem::LoadFromFile(Scene* scene, const std::string& filePath) {
+ImportState GeometryLoaderSystem::ImportSource(ImportJob& job, std::optional<std::uint64_t> sourceKey) {
+    // The importer owns the handlers
+    std::vector<std::string> readFiles;
     Assimp::Importer importer;
-    const aiScene* aiScene = importer.ReadFile(filePath, aiProcess_Triangulate | aiProcess_ValidateDataStructure);
-    float unitScaleFactor = 0.0;
-//    bool failedScaleProp = aiScene->mMetaData->Get("UnitScaleFactor", unitScaleFactor);
-    
-    float factor = (1.f / 100.f) * unitScaleFactor;
-    glm::mat4 unitMatrix = glm::scale(glm::identity<glm::mat4>(), glm::vec3(factor));
-    
-    // Create a texture2D with the matcap material we want to use, this is a temporary solution until we have proper UI to assign stuff
-    auto matCapTexture = Texture2D::MakeFromPath("matcaps/matcap.png", Format::FORMAT_R8G8B8A8_SRGB);
-
-    MeshComponentNew meshGroup;
-
-    const std::function<void(aiNode*, TransformComponent*)> processNode = [&aiScene, scene, &processNode, &meshGroup, &matCapTexture](const aiNode* node, TransformComponent* parentTransform) {
-        TransformComponent nodeTransform;
+    importer.SetProgressHandler(new ImportProgressHandler(job._progress, job._bCancelled));
+    importer.SetIOHandler(new RecordingIOSystem(readFiles));
+
+    const aiScene* aiScene = importer.ReadFile(job._filePath, ImportFlags);
+    if(!aiScene || !aiScene->mRootNode) {
+        if(!job._bCancelled) {
+            std::cerr << "[Error]: Failed to import " << job._filePath << ": " << importer.GetErrorString() << std::endl;
+        }
+        return ImportState::Failed;
+    }
+
+    auto scene = std::make_unique<ImportedScene>();
+    std::vector<const aiMesh*> meshes;
+    std::vector<std::uint32_t> primitiveNodes;
+
+    // Depth first so parents come before their children, a primitive per mesh reference with its own identity transform
+    std::vector<std::pair<const aiNode*, std::int32_t>> stack = {{aiScene->mRootNode, -1}};
+    while(!stack.empty()) {
+        const auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        const auto index = static_cast<std::int32_t>(scene->_nodes.size());
+        TransformComponent& nodeTransform = scene->_nodes.emplace_back();
         std::memcpy(&nodeTransform._matrix[0], &node->mTransformation.a1, sizeof(aiMatrix4x4));
         nodeTransform._matrix = glm::transpose(nodeTransform._matrix);
-        nodeTransform._isRootTransform = parentTransform == nullptr;
-        
-        if(parentTransform) {
-            parentTransform->_childs.push_back(nodeTransform._id);
-        }
-
-        // Process child meshes
-        for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-            aiMesh* mesh = aiScene->mMeshes[node->mMeshes[i]];
-            PrimitiveProxyComponentCPU primitiveComponent;
-            //MatCapMaterialComponent materialComponent;
-            //materialComponent._matCapTexture = matCapTexture;
-            PhongMaterialComponent materialComponent;
-
-            if(aiScene->HasMaterials()) {
-                if(auto material = aiScene->mMaterials[mesh->mMaterialIndex]) {
-                    aiString path;
-                    material->GetTexture(aiTextureType::aiTextureType_DIFFUSE, 0, &path);
-
-                    if(auto textureData = aiScene->GetEmbeddedTexture(path.C_Str())) {
-                        // Check pcData comments, this data is compressed
-                        if(textureData->mHeight == 0) {
-
-                            int width, height, channels;
-                            auto data = stbi_load_from_memory(reinterpret_cast<unsigned char *>(textureData->pcData),
-                                textureData->mWidth,
-                                &width,
-                                &height,
-                                &channels,
-                                4);
-
-                            channels = 4;
-
-                            std::size_t size = width * height * channels;
-
-                            materialComponent._diffuseTexture = Texture2D::MakeFromData(width,
-                                height,
-                                Format::FORMAT_R8G8B8A8_SRGB,
-                                data,
-                                size);
-                        }
-
-
-                        /*
-                        const auto data = reinterpret_cast<void *>(textureData->pcData);
-                        std::size_t size = textureData->mWidth * textureData->mHeight * 4;
-
-
-
-                        materialComponent._diffuseTexture = Texture2D::MakeFromData(textureData->mWidth,
-                            textureData->mHeight,
-                            Format::FORMAT_R8G8B8A8_SRGB,
-                            data,
-                            size);
-*/
-                    }
-                }
-            }
-
-
-
-            // Extract vertex data
-            for(unsigned int x = 0; x < mesh->mNumVertices; x++) {
-                VertexData vertexData {};
-                vertexData.position = {mesh->mVertices[x].x, mesh->mVertices[x].y, mesh->mVertices[x].z};
-
-                if(mesh->mNormals) {
-                    vertexData.normal = {mesh->mNormals[x].x, mesh->mNormals[x].y, mesh->mNormals[x].z};
-                }
-
-                if(mesh->HasTextureCoords(0)) {
-                    vertexData.texCoords = {mesh->mTextureCoords[0][x].x, 1 - mesh->mTextureCoords[0][x].y};
-//                    std::cout << "x: " << mesh->mTextureCoords[0][x].x << " y:" << mesh->mTextureCoords[0][x].y << std::endl;
-                }
-
-                primitiveComponent._vertexData.push_back(vertexData);
-            }
-            
-            // Extract indices
-            for (unsigned int x = 0; x < mesh->mNumFaces; x++) {
-                auto face = mesh->mFaces[x];
-                for(unsigned int j = 0; j < face.mNumIndices; j++) {
-                    primitiveComponent._indices.push_back(face.mIndices[j]);
-                }
-            }
-
-            TransformComponent primitiveTransform;
-            primitiveTransform._matrix = glm::identity<glm::mat4>();
-            nodeTransform._childs.push_back(primitiveTransform._id);
-            
-            entt::entity primitiveEntity = scene->GetRegistry().create();
-            scene->GetRegistry().emplace<PrimitiveProxyComponentCPU>(primitiveEntity, primitiveComponent);
-            //scene->GetRegistry().emplace<MatCapMaterialComponent>(primitiveEntity, materialComponent);
-            scene->GetRegistry().emplace<PhongMaterialComponent>(primitiveEntity, materialComponent);
-            scene->GetRegistry().emplace<TransformComponent>(primitiveEntity, primitiveTransform);
-            
-            meshGroup._primitives.push_back(primitiveEntity);
-        }
-        
-        // Process child nodes
-        for (unsigned int i = 0; i < node->mNumChildren; i++) {
-            aiNode* childNode = node->mChildren[i];
-            processNode(childNode, &nodeTransform);
-        }
-        
-        entt::entity nodeEntity = scene->GetRegistry().create();
-        scene->GetRegistry().emplace<TransformComponent>(nodeEntity, nodeTransform);
-    };
-    
-    processNode(aiScene->mRootNode, nullptr);
-    
-    entt::entity meshGroupEntity = scene->GetRegistry().create();
-    scene->GetRegistry().emplace<MeshComponentNew>(meshGroupEntity, meshGroup);
-    
+        nodeTransform._isRootTransform = parent < 0;
+        scene->_nodeParents.push_back(parent);
+
+        if(parent >= 0) {
+            scene->_nodes[parent]._childs.push_back(nodeTransform._id);
+        }
+
+        for(unsigned int i = 0; i < node->mNumMeshes; i++) {
+            ImportedPrimitive& primitive = scene->_primitives.emplace_back();
+            primitive._transform._matrix = glm::identity<glm::mat4>();
+            nodeTransform._childs.push_back(primitive._transform._id);
+            meshes.push_back(aiScene->mMeshes[node->mMeshes[i]]);
+            primitiveNodes.push_back(static_cast<std::uint32_t>(index));
+        }
+
+        for(unsigned int i = node->mNumChildren; i-- > 0;) {
+            stack.emplace_back(node->mChildren[i], index);
+        }
+    }
+
+    // Textures are gathered first so primitives sharing one share the texture, then the geometry is processed in parallel
+    const std::size_t primitiveCount = scene->_primitives.size();
+    std::vector<const aiTexture*> embeddedTextures;
+    std::vector<std::int32_t> primitiveTextures(primitiveCount, -1);
+    std::unordered_map<std::string, std::int32_t> textureIndices;
+
+    for(std::size_t i = 0; i < primitiveCount && aiScene->HasMaterials(); i++) {
+        if(const aiMaterial* material = aiScene->mMaterials[meshes[i]->mMaterialIndex]) {
+            aiString path;
+            material->GetTexture(aiTextureType::aiTextureType_DIFFUSE, 0, &path);
+
+            // Check pcData comments, only compressed data is supported
+            const aiTexture* texture = aiScene->GetEmbeddedTexture(path.C_Str());
+            if(!texture || texture->mHeight != 0) {
+                continue;
+            }
+
+            const auto [it, bInserted] = textureIndices.emplace(path.C_Str(), static_cast<std::int32_t>(embeddedTextures.size()));
+            if(bInserted) {
+                embeddedTextures.push_back(texture);
+            }
+            primitiveTextures[i] = it->second;
+        }
+    }
+
+    std::vector<std::shared_ptr<Texture2D>> textures(embeddedTextures.size());
+    for(std::size_t i = 0; i < textures.size(); i++) {
+        textures[i] = MakeEncodedTexture(embeddedTextures[i]->pcData, embeddedTextures[i]->mWidth);
+    }
+
+    std::vector<OptimizationReport> reports(primitiveCount);
+    std::atomic<std::size_t> processed = 0;
+
+    JobSystem::Get().ParallelFor(primitiveCount, 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end && !job._bCancelled; i++) {
+            const aiMesh* mesh = meshes[i];
+            ImportedPrimitive& primitive = scene->_primitives[i];
+
+            if(primitiveTextures[i] >= 0 && textures[primitiveTextures[i]]) {
+                primitive._material._diffuseTexture = textures[primitiveTextures[i]];
+                primitive._material._shaderFeatures |= SF_DiffuseTexture;
+            }
+
+            if(mesh->HasVertexColors(0)) {
+                primitive._material._shaderFeatures |= SF_VertexColor;
+            }
+
+            primitive._geometry = ExtractGeometry(mesh);
+            OptimizeGeometry(primitive._geometry, reports[i]);
+
+            primitive._bounds = ComputeBounds(primitive._geometry._vertexData);
+            GenerateLods(primitive._geometry, primitive._bounds._radius);
+
+            const std::size_t done = ++processed;
+            job._progress = ParseProgress + ProcessProgress * static_cast<float>(done) / static_cast<float>(primitiveCount);
+        }
+    });
+
+    if(job._bCancelled) {
+        return ImportState::Cancelled;
+    }
+
+    // Summed in primitive order so the report does not depend on the scheduling
+    for(const OptimizationReport& report : reports) {
+        scene->_report.Add(report);
+    }
+
+    // The next load of this file maps the result instead of doing all of the above again
+    if(sourceKey) {
+        CookedMeshWriter writer(sizeof(VertexData));
+        for(std::size_t i = 0; i < scene->_nodes.size(); i++) {
+            writer.AddNode(scene->_nodes[i]._matrix, scene->_nodeParents[i]);
+        }
+
+        std::vector<std::int32_t> cookedTextures(textures.size(), -1);
+        for(std::size_t i = 0; i < textures.size(); i++) {
+            if(textures[i]) {
+                cookedTextures[i] = static_cast<std::int32_t>(writer.AddTexture(embeddedTextures[i]->pcData, embeddedTextures[i]->mWidth));
+            }
+        }
+
+        for(std::size_t i = 0; i < primitiveCount; i++) {
+            const ImportedPrimitive& primitive = scene->_primitives[i];
+
+            CookedPrimitiveSource source;
+            source._node = primitiveNodes[i];
+            source._diffuseTexture = primitiveTextures[i] >= 0 ? cookedTextures[primitiveTextures[i]] : -1;
+            source._shaderFeatures = primitive._material._shaderFeatures;
+            source._vertices = primitive._geometry._vertexData.data();
+            source._vertexCount = static_cast<std::uint32_t>(primitive._geometry._vertexData.size());
+            source._indices = primitive._geometry._indices;
+            for(const PrimitiveLod& lod : primitive._geometry._lods) {
+                source._lods.emplace_back(lod._indices, lod._error);
+            }
+            source._meshlets = primitive._geometry._meshlets._meshlets;
+            source._boundsMin = primitive._bounds._min;
+            source._boundsMax = primitive._bounds._max;
+            source._boundsRadius = primitive._bounds._radius;
+
+            writer.AddPrimitive(std::move(source));
+        }
+
+        if(const std::optional<std::uint64_t> cacheKey = job._cache->StoreDependencies(*sourceKey, job._filePath, readFiles)) {
+            job._cache->Store(*cacheKey, writer);
+        }
+    }
+
+    job._progress = ParseProgress + ProcessProgress;
+    job._scene = std::move(scene);
+    return ImportState::Committing;
 }
 
+bool GeometryLoaderSystem::Commit(Scene* scene, ImportJob& job, std::chrono::steady_clock::time_point deadline) {
+    entt::registry& registry = scene->GetRegistry();
+    ImportedScene& imported = *job._scene;
+    bool bFirst = true;
+
+    // Checked after every batch so a frame commits at least one
+    auto HasTime = [&bFirst, deadline]() {
+        const bool bHasTime = bFirst || std::chrono::steady_clock::now() < deadline;
+        bFirst = false;
+        return bHasTime;
+    };
+
+    // The storages grow once for the whole import instead of a few times per frame while it commits
+    if(job._committedNodes == 0 && job._committedPrimitives == 0) {
+        scene->ReserveComponents<TransformComponent>(imported._nodes.size() + imported._primitives.size());
+        scene->ReserveComponents<PrimitiveProxyComponentCPU>(imported._primitives.size());
+        scene->ReserveComponents<PhongMaterialComponent>(imported._primitives.size());
+        scene->ReserveComponents<BoundsComponent>(imported._primitives.size());
+        job._meshGroup._primitives.reserve(imported._primitives.size());
+    }
+
+    std::vector<entt::entity> entities;
+    while(job._committedNodes < imported._nodes.size()) {
+        if(!HasTime()) {
+            return false;
+        }
+
+        entities.resize(std::min(CommitBatchSize, imported._nodes.size() - job._committedNodes));
+        scene->CreateEntities(entities);
+        scene->InsertComponents<TransformComponent>(entities, std::span(imported._nodes).subspan(job._committedNodes, entities.size()));
+        job._committedNodes += entities.size();
+    }
+
+    while(job._committedPrimitives < imported._primitives.size()) {
+        if(!HasTime()) {
+            break;
+        }
+
+        entities.resize(std::min(CommitBatchSize, imported._primitives.size() - job._committedPrimitives));
+        const std::span<ImportedPrimitive> batch = std::span(imported._primitives).subspan(job._committedPrimitives, entities.size());
+
+        // Same component order as when they were emplaced one entity at a time
+        scene->CreateEntities(entities);
+        scene->InsertComponents<PrimitiveProxyComponentCPU>(entities, batch | std::views::transform(&ImportedPrimitive::_geometry));
+        scene->InsertComponents<PhongMaterialComponent>(entities, batch | std::views::transform(&ImportedPrimitive::_material));
+        scene->InsertComponents<TransformComponent>(entities, batch | std::views::transform(&ImportedPrimitive::_transform));
+        scene->InsertComponents<BoundsComponent>(entities, batch | std::views::transform(&ImportedPrimitive::_bounds));
+
+        job._meshGroup._primitives.insert(job._meshGroup._primitives.end(), entities.begin(), entities.end());
+        job._committedPrimitives += entities.size();
+    }
+
+    const std::size_t total = imported._nodes.size() + imported._primitives.size();
+    const float committed = total > 0 ? static_cast<float>(job._committedNodes + job._committedPrimitives) / static_cast<float>(total) : 1.0f;
+    job._progress = ParseProgress + ProcessProgress + (1.0f - ParseProgress - ProcessProgress) * committed;
+
+    if(job._committedPrimitives < imported._primitives.size()) {
+        return false;
+    }
+
+    registry.emplace<MeshComponentNew>(registry.create(), std::move(job._meshGroup));
+    // Cooked files were optimized when they were cooked, there is nothing to report
+    if(imported._report._source._triangles > 0) {
+        PrintReport(job._filePath, imported._report);
+    }
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - job._startTime);
+    std::cout << "[Info]: Imported " << job._filePath << " in " << duration.count() << " ms" << std::endl;
+
+    job._scene.reset();
+    job._state = ImportState::Finished;
+    return true;
+}
@@ -0,0 +1,309 @@
+#include "Core/ImportCache.hpp"
+#include "Core/CookedMesh.hpp"
+#include "Core/MappedFile.hpp"
+#include <random>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Leftovers of a writer that died mid write, a live one finishes in well under this
+    constexpr auto StaleTemporaryAge = std::chrono::hours(1);
+
+    std::uint64_t Finalize(std::uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 27;
+        hash *= 0x94D049BB133111EBull;
+        return hash ^ (hash >> 31);
+    }
+
+    // Chained in the recorded order, null when one of them cannot be read
+    std::optional<std::uint64_t> HashDependencies(std::uint64_t sourceKey, const std::filesystem::path& directory, const std::vector<std::string>& dependencies) {
+        std::uint64_t key = sourceKey;
+        for(const std::string& dependency : dependencies) {
+            const std::optional<std::uint64_t> hash = ImportCache::HashFile((directory / dependency).string(), key);
+            if(!hash) {
+                return std::nullopt;
+            }
+            key = *hash;
+        }
+
+        return key;
+    }
+
+    // Exclusive lock on a file shared between processes, released when destroyed
+    class FileLock {
+    public:
+        explicit FileLock(const std::filesystem::path& path) {
+#ifdef _WIN32
+            _file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, 0, nullptr);
+            OVERLAPPED overlapped {};
+            _bLocked = _file != INVALID_HANDLE_VALUE && LockFileEx(_file, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+            _file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            _bLocked = _file >= 0 && flock(_file, LOCK_EX) == 0;
+#endif
+        }
+
+        ~FileLock() {
+#ifdef _WIN32
+            if(_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(_file);
+            }
+#else
+            if(_file >= 0) {
+                close(_file);
+            }
+#endif
+        }
+
+        FileLock(const FileLock&) = delete;
+        FileLock& operator=(const FileLock&) = delete;
+
+        [[nodiscard]] bool IsLocked() const { return _bLocked; }
+
+    private:
+#ifdef _WIN32
+        HANDLE _file = INVALID_HANDLE_VALUE;
+#else
+        int _file = -1;
+#endif
+        bool _bLocked = false;
+    };
+}
+
+ImportCache::ImportCache(std::filesystem::path directory, std::uint64_t maxSize)
+    : _directory(std::move(directory))
+    , _maxSize(maxSize) {
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if(error) {
+        std::cerr << "[Error]: Could not create the import cache in " << _directory << ": " << error.message() << std::endl;
+    }
+}
+
+std::filesystem::path ImportCache::GetDefaultDirectory() {
+    // Per user, the temporary directory is shared by everyone on the machine
+    auto GetVariable = [](const char* name) -> std::filesystem::path {
+        const char* value = std::getenv(name);
+        return value && *value ? std::filesystem::path(value) : std::filesystem::path();
+    };
+
+#ifdef _WIN32
+    if(const std::filesystem::path localAppData = GetVariable("LOCALAPPDATA"); !localAppData.empty()) {
+        return localAppData / "Engine" / "ImportCache";
+    }
+#else
+    if(const std::filesystem::path cacheHome = GetVariable("XDG_CACHE_HOME"); cacheHome.is_absolute()) {
+        return cacheHome / "Engine" / "ImportCache";
+    }
+    if(const std::filesystem::path home = GetVariable("HOME"); !home.empty()) {
+        return home / ".cache" / "Engine" / "ImportCache";
+    }
+#endif
+
+    std::error_code error;
+    const std::filesystem::path temporary = std::filesystem::temp_directory_path(error);
+    return (error ? std::filesystem::current_path() : temporary) / "EngineImportCache";
+}
+
+std::optional<std::uint64_t> ImportCache::HashFile(const std::string& path, std::uint64_t seed) {
+    // Mapped, hashing a large model costs no allocation
+    std::shared_ptr<MappedFile> file = MappedFile::Open(path);
+    if(!file) {
+        return std::nullopt;
+    }
+
+    return HashBytes(file->GetData(), file->GetSize(), seed);
+}
+
+std::uint64_t ImportCache::HashBytes(const void* data, std::size_t size, std::uint64_t seed) {
+    // Four independent lanes over 8 byte words keep the multiplies in flight, the tail is folded in zero padded
+    constexpr std::uint64_t Prime = 0x9E3779B97F4A7C15ull;
+    std::uint64_t lanes[4] = {seed, seed + Prime, seed ^ 0x6A09E667F3BCC909ull, seed - Prime};
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    std::size_t offset = 0;
+    for(; offset + 32 <= size; offset += 32) {
+        for(std::size_t lane = 0; lane < 4; lane++) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + offset + lane * 8, 8);
+            lanes[lane] = (lanes[lane] ^ word) * Prime;
+            lanes[lane] ^= lanes[lane] >> 29;
+        }
+    }
+
+    std::uint8_t tail[32] = {};
+    if(size > offset) {
+        std::memcpy(tail, bytes + offset, size - offset);
+    }
+    for(std::size_t lane = 0; lane < 4; lane++) {
+        std::uint64_t word;
+        std::memcpy(&word, tail + lane * 8, 8);
+        lanes[lane] = (lanes[lane] ^ word) * Prime;
+    }
+
+    std::uint64_t hash = size;
+    for(std::uint64_t lane : lanes) {
+        hash = Finalize(hash ^ lane) + Prime;
+    }
+
+    return Finalize(hash);
+}
+
+std::optional<std::uint64_t> ImportCache::FindImportKey(std::uint64_t sourceKey, const std::string& sourcePath) const {
+    std::ifstream stream(GetEntryPath(sourceKey, DependencyEntryExtension));
+    if(!stream) {
+        return std::nullopt;
+    }
+
+    std::vector<std::string> dependencies;
+    for(std::string dependency; std::getline(stream, dependency);) {
+        dependencies.push_back(std::move(dependency));
+    }
+
+    // Evicted along with the import otherwise
+    Touch(sourceKey, DependencyEntryExtension);
+    return HashDependencies(sourceKey, std::filesystem::path(sourcePath).parent_path(), dependencies);
+}
+
+std::optional<std::uint64_t> ImportCache::StoreDependencies(std::uint64_t sourceKey, const std::string& sourcePath, const std::vector<std::string>& dependencies) const {
+    // Relative to the source, moving the whole directory keeps the entry
+    const std::filesystem::path directory = std::filesystem::path(sourcePath).parent_path();
+    std::vector<std::string> relativePaths;
+    for(const std::string& dependency : dependencies) {
+        std::error_code error;
+        if(std::filesystem::equivalent(dependency, sourcePath, error)) {
+            continue;
+        }
+
+        std::string relativePath = std::filesystem::proximate(dependency, directory.empty() ? "." : directory, error).generic_string();
+        if(error) {
+            relativePath = std::filesystem::path(dependency).generic_string();
+        }
+        if(std::find(relativePaths.begin(), relativePaths.end(), relativePath) == relativePaths.end()) {
+            relativePaths.push_back(std::move(relativePath));
+        }
+    }
+
+    const std::optional<std::uint64_t> key = HashDependencies(sourceKey, directory, relativePaths);
+    if(!key) {
+        return std::nullopt;
+    }
+
+    const bool bStored = Store(sourceKey, DependencyEntryExtension, [&relativePaths](std::ostream& stream) {
+        for(const std::string& relativePath : relativePaths) {
+            stream << relativePath << '\n';
+        }
+        return static_cast<bool>(stream);
+    });
+
+    return bStored ? key : std::nullopt;
+}
+
+std::string ImportCache::GetEntryPath(std::uint64_t key, const char* extension) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (_directory / (std::string(name) + extension)).string();
+}
+
+bool ImportCache::Touch(std::uint64_t key, const char* extension) const {
+    std::error_code error;
+    std::filesystem::last_write_time(GetEntryPath(key, extension), std::filesystem::file_time_type::clock::now(), error);
+    return !error;
+}
+
+bool ImportCache::Store(std::uint64_t key, const CookedMeshWriter& writer) const {
+    if(!writer.Write(GetEntryPath(key))) {
+        return false;
+    }
+
+    Trim();
+    return true;
+}
+
+bool ImportCache::Store(std::uint64_t key, const char* extension, const std::function<bool(std::ostream&)>& write) const {
+    // Written aside and renamed into place like the cooked meshes, see CookedMeshWriter::Write
+    const std::string path = GetEntryPath(key, extension);
+    const std::string temporaryPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if(!stream || !write(stream) || !stream.flush()) {
+            std::cerr << "[Error]: Could not write " << temporaryPath << std::endl;
+            stream.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if(error) {
+        std::cerr << "[Error]: Could not write " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    Trim();
+    return true;
+}
+
+void ImportCache::Trim() const {
+    FileLock lock(_directory / "lock");
+    if(!lock.IsLocked()) {
+        return;
+    }
+
+    struct Entry {
+        std::filesystem::path _path;
+        std::filesystem::file_time_type _time;
+        std::uint64_t _size = 0;
+    };
+
+    std::vector<Entry> entries;
+    std::uint64_t totalSize = 0;
+    const auto now = std::filesystem::file_time_type::clock::now();
+
+    std::error_code error;
+    for(const auto& file : std::filesystem::directory_iterator(_directory, error)) {
+        std::error_code fileError;
+        const auto time = file.last_write_time(fileError);
+        const std::uint64_t size = file.file_size(fileError);
+        if(fileError) {
+            continue;
+        }
+
+        const std::filesystem::path& path = file.path();
+        if(path.extension() == ".tmp" && now - time > StaleTemporaryAge) {
+            std::filesystem::remove(path, fileError);
+        } else if(path.extension() == EntryExtension || path.extension() == TextureEntryExtension || path.extension() == DependencyEntryExtension) {
+            entries.push_back({path, time, size});
+            totalSize += size;
+        }
+    }
+
+    if(totalSize <= _maxSize) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs._time < rhs._time;
+    });
+
+    // The most recent entry always stays, even alone over the limit it is the one about to be used
+    for(std::size_t i = 0; i + 1 < entries.size() && totalSize > _maxSize; i++) {
+        // Fails while another instance has it mapped on some systems, it is then left for a later trim
+        if(std::filesystem::remove(entries[i]._path, error)) {
+            totalSize -= entries[i]._size;
+        }
+    }
+}
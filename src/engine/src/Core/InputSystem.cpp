@@ -17,6 +17,7 @@ bool InputSystem::Process(Scene* scene) {
         // Update mouse delta
         inputComponent.m_MouseDelta = _window->GetMouseDelta();
         inputComponent.m_WheelDelta = _window->GetMouseWheelDelta();
+        inputComponent.m_MousePosition = _window->GetMousePosition();
 
         // Update key pressed states for tracked keys in the input component
         for (auto& key : inputComponent.m_Keys) {
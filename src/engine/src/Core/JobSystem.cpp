@@ -0,0 +1,127 @@
+#include "Core/JobSystem.hpp"
+
+namespace {
+    struct ParallelForState {
+        std::atomic<std::size_t> _nextChunk {0};
+        std::atomic<std::size_t> _finishedChunks {0};
+        std::size_t _chunkCount = 0;
+        std::size_t _chunkSize = 0;
+        std::size_t _count = 0;
+        JobSystem::RangeFunction _function;
+
+        std::mutex _mutex;
+        std::condition_variable _finished;
+
+        // Grabs chunks until none are left, shared by the workers and the calling thread
+        void Run() {
+            std::size_t chunk;
+            while((chunk = _nextChunk.fetch_add(1, std::memory_order_relaxed)) < _chunkCount) {
+                const std::size_t begin = chunk * _chunkSize;
+                _function(begin, std::min(begin + _chunkSize, _count));
+
+                if(_finishedChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == _chunkCount) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _finished.notify_all();
+                }
+            }
+        }
+    };
+}
+
+JobSystem& JobSystem::Get() {
+    static JobSystem instance(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return instance;
+}
+
+JobSystem::JobSystem(std::size_t workerCount) {
+    _workers.reserve(workerCount);
+    for(std::size_t i = 0; i < workerCount; i++) {
+        _workers.emplace_back(&JobSystem::WorkerLoop, this);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bStopping = true;
+    }
+
+    _wakeUp.notify_all();
+
+    for(std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::Schedule(std::function<void()> job) {
+    // Without workers jobs run inline, keeps single core targets working
+    if(_workers.empty()) {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+
+    _wakeUp.notify_one();
+}
+
+void JobSystem::ParallelFor(std::size_t count, std::size_t grainSize, const RangeFunction& function) {
+    if(count == 0) {
+        return;
+    }
+
+    grainSize = std::max<std::size_t>(grainSize, 1);
+
+    // Aim for a few chunks per thread so uneven chunks balance out, but never go below the grain size
+    const std::size_t threadCount = _workers.size() + 1;
+    std::size_t chunkSize = std::max(grainSize, count / (threadCount * 4));
+    chunkSize = (chunkSize + grainSize - 1) / grainSize * grainSize;
+
+    const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if(chunkCount == 1 || _workers.empty()) {
+        function(0, count);
+        return;
+    }
+
+    // Helpers can start after the call returned, the state is shared so it outlives them
+    auto state = std::make_shared<ParallelForState>();
+    state->_chunkCount = chunkCount;
+    state->_chunkSize = chunkSize;
+    state->_count = count;
+    state->_function = function;
+
+    const std::size_t helperCount = std::min(_workers.size(), chunkCount - 1);
+    for(std::size_t i = 0; i < helperCount; i++) {
+        Schedule([state] { state->Run(); });
+    }
+
+    state->Run();
+
+    std::unique_lock<std::mutex> lock(state->_mutex);
+    state->_finished.wait(lock, [&state] {
+        return state->_finishedChunks.load(std::memory_order_acquire) == state->_chunkCount;
+    });
+}
+
+void JobSystem::WorkerLoop() {
+    while(true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeUp.wait(lock, [this] { return _bStopping || !_jobs.empty(); });
+
+            if(_bStopping && _jobs.empty()) {
+                return;
+            }
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        job();
+    }
+}
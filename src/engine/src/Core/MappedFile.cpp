@@ -0,0 +1,80 @@
+#include "Core/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+    std::shared_ptr<MappedFile> mappedFile(new MappedFile());
+
+#ifdef _WIN32
+    mappedFile->_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(mappedFile->_file == INVALID_HANDLE_VALUE) {
+        mappedFile->_file = nullptr;
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(mappedFile->_file, &size) || size.QuadPart == 0) {
+        return nullptr;
+    }
+
+    mappedFile->_mapping = CreateFileMappingA(mappedFile->_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mappedFile->_mapping) {
+        return nullptr;
+    }
+
+    mappedFile->_data = static_cast<const std::uint8_t*>(MapViewOfFile(mappedFile->_mapping, FILE_MAP_READ, 0, 0, 0));
+    mappedFile->_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int file = open(path.c_str(), O_RDONLY);
+    if(file < 0) {
+        return nullptr;
+    }
+
+    struct stat status {};
+    if(fstat(file, &status) != 0 || status.st_size == 0) {
+        close(file);
+        return nullptr;
+    }
+
+    // The mapping keeps its own reference to the file
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED) {
+        return nullptr;
+    }
+
+    mappedFile->_data = static_cast<const std::uint8_t*>(data);
+    mappedFile->_size = static_cast<std::size_t>(status.st_size);
+#endif
+
+    return mappedFile->_data ? mappedFile : nullptr;
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if(_data) {
+        UnmapViewOfFile(_data);
+    }
+
+    if(_mapping) {
+        CloseHandle(_mapping);
+    }
+
+    if(_file) {
+        CloseHandle(_file);
+    }
+#else
+    if(_data) {
+        munmap(const_cast<std::uint8_t*>(_data), _size);
+    }
+#endif
+}
@@ -0,0 +1,367 @@
+#include "Core/MeshOptimizer.hpp"
+#include "glm/glm.hpp"
+#include <unordered_map>
+
+namespace {
+    constexpr std::uint32_t Unused = ~0u;
+
+    // FNV-1a over the vertex bytes, vertices are referenced by index so the table never copies them
+    struct VertexHash {
+        const std::uint8_t* _data;
+        std::size_t _size;
+
+        std::size_t operator()(std::uint32_t vertex) const {
+            const std::uint8_t* bytes = _data + vertex * _size;
+            std::uint32_t hash = 2166136261u;
+            for(std::size_t i = 0; i < _size; i++) {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+            return hash;
+        }
+    };
+
+    struct VertexEqual {
+        const std::uint8_t* _data;
+        std::size_t _size;
+
+        bool operator()(std::uint32_t lhs, std::uint32_t rhs) const {
+            return std::memcmp(_data + lhs * _size, _data + rhs * _size, _size) == 0;
+        }
+    };
+
+    /*
+     *  FIFO post transform cache, a vertex is in it while fewer than cacheSize misses happened since it was loaded.
+     * Moving time forward by the cache size empties it.
+     */
+    class VertexCache {
+    public:
+        VertexCache(std::size_t vertexCount, std::size_t cacheSize)
+            : _loadTime(vertexCount, 0)
+            , _cacheSize(static_cast<std::uint32_t>(cacheSize))
+            , _time(static_cast<std::uint32_t>(cacheSize) + 1) {
+        }
+
+        // 1 when the vertex had to be transformed
+        std::uint32_t Access(std::uint32_t vertex) {
+            if(_time - _loadTime[vertex] > _cacheSize) {
+                _loadTime[vertex] = _time++;
+                return 1;
+            }
+            return 0;
+        }
+
+        // Misses since the vertex was loaded, more than the cache size means it was evicted
+        [[nodiscard]] std::uint32_t GetAge(std::uint32_t vertex) const { return _time - _loadTime[vertex]; }
+
+        void Flush() { _time += _cacheSize + 1; }
+
+    private:
+        std::vector<std::uint32_t> _loadTime;
+        std::uint32_t _cacheSize;
+        std::uint32_t _time;
+    };
+
+    // Triangles of every vertex, one entry per corner
+    struct TriangleAdjacency {
+        std::vector<std::uint32_t> _offsets;
+        std::vector<std::uint32_t> _triangles;
+
+        TriangleAdjacency(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount)
+            : _offsets(vertexCount + 1, 0)
+            , _triangles(indexCount / 3 * 3) {
+            for(std::size_t i = 0; i < _triangles.size(); i++) {
+                _offsets[indices[i] + 1]++;
+            }
+
+            for(std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+                _offsets[vertex + 1] += _offsets[vertex];
+            }
+
+            std::vector<std::uint32_t> fill(_offsets.begin(), _offsets.end() - 1);
+            for(std::size_t i = 0; i < _triangles.size(); i++) {
+                _triangles[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+        }
+    };
+}
+
+std::size_t MeshOptimizer::DeduplicateVertices(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::uint32_t* indices, std::size_t indexCount) {
+    auto* data = static_cast<std::uint8_t*>(vertices);
+
+    std::vector<std::uint8_t> bReferenced(vertexCount);
+    for(std::size_t i = 0; i < indexCount; i++) {
+        bReferenced[indices[i]] = 1;
+    }
+
+    // Kept vertices are compacted while scanning, they only ever move down onto slots that were already scanned
+    std::unordered_map<std::uint32_t, std::uint32_t, VertexHash, VertexEqual> firstVertex(vertexCount, VertexHash{data, vertexSize}, VertexEqual{data, vertexSize});
+    std::vector<std::uint32_t> remap(vertexCount, Unused);
+    std::uint32_t uniqueCount = 0;
+
+    for(std::uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+        if(!bReferenced[vertex]) {
+            continue;
+        }
+
+        const auto it = firstVertex.find(vertex);
+        if(it != firstVertex.end()) {
+            remap[vertex] = it->second;
+            continue;
+        }
+
+        if(uniqueCount != vertex) {
+            std::memcpy(data + uniqueCount * vertexSize, data + vertex * vertexSize, vertexSize);
+        }
+
+        // Keyed by the new slot, which now holds the same bytes
+        firstVertex.emplace(uniqueCount, uniqueCount);
+        remap[vertex] = uniqueCount++;
+    }
+
+    for(std::size_t i = 0; i < indexCount; i++) {
+        indices[i] = remap[indices[i]];
+    }
+
+    return uniqueCount;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t cacheSize) {
+    const std::size_t triangleCount = indexCount / 3;
+    if(triangleCount == 0) {
+        return;
+    }
+
+    const TriangleAdjacency adjacency(indices, indexCount, vertexCount);
+
+    std::vector<std::uint32_t> liveTriangles(vertexCount);
+    for(std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+        liveTriangles[vertex] = adjacency._offsets[vertex + 1] - adjacency._offsets[vertex];
+    }
+
+    std::vector<std::uint8_t> bEmitted(triangleCount);
+    std::vector<std::uint32_t> deadEnds;
+    std::vector<std::uint32_t> candidates;
+    std::vector<std::uint32_t> result;
+    result.reserve(triangleCount * 3);
+
+    VertexCache cache(vertexCount, cacheSize);
+    std::size_t cursor = 0;
+
+    // Recently used vertices first, then the next vertex in input order that still has triangles
+    auto SkipDeadEnd = [&]() {
+        while(!deadEnds.empty()) {
+            const std::uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if(liveTriangles[vertex] > 0) {
+                return vertex;
+            }
+        }
+
+        for(; cursor < vertexCount; cursor++) {
+            if(liveTriangles[cursor] > 0) {
+                return static_cast<std::uint32_t>(cursor);
+            }
+        }
+
+        return Unused;
+    };
+
+    for(std::uint32_t fan = SkipDeadEnd(); fan != Unused;) {
+        candidates.clear();
+
+        for(std::uint32_t i = adjacency._offsets[fan]; i < adjacency._offsets[fan + 1]; i++) {
+            const std::uint32_t triangle = adjacency._triangles[i];
+            if(bEmitted[triangle]) {
+                continue;
+            }
+
+            bEmitted[triangle] = 1;
+            for(int corner = 0; corner < 3; corner++) {
+                const std::uint32_t vertex = indices[triangle * 3 + corner];
+                result.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                cache.Access(vertex);
+            }
+        }
+
+        // The oldest candidate that will still be in the cache once its remaining triangles are emitted
+        std::uint32_t next = Unused;
+        std::int64_t bestPriority = -1;
+        for(std::uint32_t vertex : candidates) {
+            if(liveTriangles[vertex] == 0) {
+                continue;
+            }
+
+            std::int64_t priority = 0;
+            if(cache.GetAge(vertex) + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = cache.GetAge(vertex);
+            }
+
+            if(priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        fan = next != Unused ? next : SkipDeadEnd();
+    }
+
+    std::memcpy(indices, result.data(), result.size() * sizeof(std::uint32_t));
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::uint32_t* indices, std::size_t indexCount, const float* positions, std::size_t vertexCount, std::size_t stride,
+    float threshold) {
+    const std::size_t triangleCount = indexCount / 3;
+    if(triangleCount == 0) {
+        return;
+    }
+
+    VertexCache cache(vertexCount, CacheSize);
+    auto Misses = [&](std::size_t triangle) {
+        return cache.Access(indices[triangle * 3]) + cache.Access(indices[triangle * 3 + 1]) + cache.Access(indices[triangle * 3 + 2]);
+    };
+
+    // Triangles missing all their vertices are where the cache order jumped, the order can change freely there
+    std::vector<std::uint32_t> hardStarts = {0};
+    Misses(0);
+    for(std::size_t triangle = 1; triangle < triangleCount; triangle++) {
+        if(Misses(triangle) == 3) {
+            hardStarts.push_back(static_cast<std::uint32_t>(triangle));
+        }
+    }
+    hardStarts.push_back(static_cast<std::uint32_t>(triangleCount));
+
+    // Runs inside a hard cluster are cut as soon as they are as cache friendly as the whole cluster, within the threshold
+    std::vector<std::uint32_t> clusterStarts;
+    for(std::size_t cluster = 0; cluster + 1 < hardStarts.size(); cluster++) {
+        const std::uint32_t begin = hardStarts[cluster], end = hardStarts[cluster + 1];
+
+        cache.Flush();
+        std::uint32_t clusterMisses = 0;
+        for(std::uint32_t triangle = begin; triangle < end; triangle++) {
+            clusterMisses += Misses(triangle);
+        }
+
+        const float maxAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin) * threshold;
+
+        cache.Flush();
+        std::uint32_t start = begin, misses = 0;
+        clusterStarts.push_back(begin);
+
+        for(std::uint32_t triangle = begin; triangle + 1 < end; triangle++) {
+            misses += Misses(triangle);
+            if(static_cast<float>(misses) <= maxAcmr * static_cast<float>(triangle - start + 1)) {
+                start = triangle + 1;
+                misses = 0;
+                clusterStarts.push_back(start);
+                cache.Flush();
+            }
+        }
+    }
+
+    auto GetPosition = [positions, stride](std::uint32_t vertex) {
+        const auto* position = reinterpret_cast<const float*>(reinterpret_cast<const std::uint8_t*>(positions) + vertex * stride);
+        return glm::vec3(position[0], position[1], position[2]);
+    };
+
+    // Area weighted centroids and normals, of each cluster and of the whole mesh
+    const std::size_t clusterCount = clusterStarts.size();
+    std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+    std::vector<float> areas(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for(std::size_t cluster = 0; cluster < clusterCount; cluster++) {
+        const std::size_t end = cluster + 1 < clusterCount ? clusterStarts[cluster + 1] : triangleCount;
+        for(std::size_t triangle = clusterStarts[cluster]; triangle < end; triangle++) {
+            const glm::vec3 a = GetPosition(indices[triangle * 3]);
+            const glm::vec3 b = GetPosition(indices[triangle * 3 + 1]);
+            const glm::vec3 c = GetPosition(indices[triangle * 3 + 2]);
+
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            const float area = glm::length(normal);
+            centroids[cluster] += (a + b + c) * (area / 3.0f);
+            normals[cluster] += normal;
+            areas[cluster] += area;
+        }
+
+        meshCentroid += centroids[cluster];
+        meshArea += areas[cluster];
+    }
+
+    if(meshArea > 0.0f) {
+        meshCentroid = meshCentroid * (1.0f / meshArea);
+    }
+
+    // Clusters far out along their own normal are on the outside of the mesh and likely in front of the rest
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    for(std::size_t cluster = 0; cluster < clusterCount; cluster++) {
+        const float normalLength = glm::length(normals[cluster]);
+        if(areas[cluster] > 0.0f && normalLength > 0.0f) {
+            sortKeys[cluster] = glm::dot(centroids[cluster] * (1.0f / areas[cluster]) - meshCentroid, normals[cluster] * (1.0f / normalLength));
+        }
+    }
+
+    std::vector<std::uint32_t> order(clusterCount);
+    for(std::uint32_t cluster = 0; cluster < clusterCount; cluster++) {
+        order[cluster] = cluster;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](std::uint32_t lhs, std::uint32_t rhs) {
+        return sortKeys[lhs] > sortKeys[rhs];
+    });
+
+    std::vector<std::uint32_t> result;
+    result.reserve(triangleCount * 3);
+    for(std::uint32_t cluster : order) {
+        const std::size_t end = cluster + 1 < clusterCount ? clusterStarts[cluster + 1] : triangleCount;
+        result.insert(result.end(), indices + clusterStarts[cluster] * 3, indices + end * 3);
+    }
+
+    std::memcpy(indices, result.data(), result.size() * sizeof(std::uint32_t));
+}
+
+std::size_t MeshOptimizer::OptimizeVertexFetch(void* vertices, std::size_t vertexCount, std::size_t vertexSize, std::uint32_t* indices, std::size_t indexCount) {
+    std::vector<std::uint32_t> remap(vertexCount, Unused);
+    std::uint32_t nextVertex = 0;
+
+    for(std::size_t i = 0; i < indexCount; i++) {
+        std::uint32_t& vertex = remap[indices[i]];
+        if(vertex == Unused) {
+            vertex = nextVertex++;
+        }
+        indices[i] = vertex;
+    }
+
+    const auto* data = static_cast<const std::uint8_t*>(vertices);
+    std::vector<std::uint8_t> reordered(nextVertex * vertexSize);
+    for(std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+        if(remap[vertex] != Unused) {
+            std::memcpy(reordered.data() + remap[vertex] * vertexSize, data + vertex * vertexSize, vertexSize);
+        }
+    }
+
+    std::memcpy(vertices, reordered.data(), reordered.size());
+    return nextVertex;
+}
+
+VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, std::size_t cacheSize) {
+    VertexCacheStatistics statistics;
+    statistics._triangles = indexCount / 3;
+
+    VertexCache cache(vertexCount, cacheSize);
+    std::vector<std::uint8_t> bReferenced(vertexCount);
+
+    for(std::size_t i = 0; i < statistics._triangles * 3; i++) {
+        statistics._misses += cache.Access(indices[i]);
+        if(!bReferenced[indices[i]]) {
+            bReferenced[indices[i]] = 1;
+            statistics._vertices++;
+        }
+    }
+
+    return statistics;
+}
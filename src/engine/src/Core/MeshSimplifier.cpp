@@ -0,0 +1,682 @@
+#include "Core/MeshSimplifier.hpp"
+#include "glm/glm.hpp"
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+
+namespace {
+    // Borders and seams are held in place by planes along them, weighted against the area weighted faces
+    constexpr double ConstraintWeight = 10.0;
+
+    enum class VertexKind : std::uint8_t {
+        Interior,
+        Border, // On an open edge, only slides along it
+        Seam,   // Between wedges with different attributes, only slides along the seam
+        Locked
+    };
+
+    // Sum of squared distances to planes, evaluated as the weighted mean so errors read as distances squared
+    struct Quadric {
+        double _a00 = 0.0, _a01 = 0.0, _a02 = 0.0, _a11 = 0.0, _a12 = 0.0, _a22 = 0.0;
+        double _b0 = 0.0, _b1 = 0.0, _b2 = 0.0;
+        double _c = 0.0;
+        double _weight = 0.0;
+
+        static Quadric FromPlane(const glm::vec3& normal, const glm::vec3& point, double weight) {
+            Quadric quadric;
+            const double length = glm::length(normal);
+            if(length <= 0.0 || weight <= 0.0) {
+                return quadric;
+            }
+
+            const double x = normal.x / length, y = normal.y / length, z = normal.z / length;
+            const double d = -(x * point.x + y * point.y + z * point.z);
+
+            quadric._a00 = x * x * weight;
+            quadric._a01 = x * y * weight;
+            quadric._a02 = x * z * weight;
+            quadric._a11 = y * y * weight;
+            quadric._a12 = y * z * weight;
+            quadric._a22 = z * z * weight;
+            quadric._b0 = x * d * weight;
+            quadric._b1 = y * d * weight;
+            quadric._b2 = z * d * weight;
+            quadric._c = d * d * weight;
+            quadric._weight = weight;
+            return quadric;
+        }
+
+        void Add(const Quadric& other) {
+            _a00 += other._a00; _a01 += other._a01; _a02 += other._a02;
+            _a11 += other._a11; _a12 += other._a12; _a22 += other._a22;
+            _b0 += other._b0; _b1 += other._b1; _b2 += other._b2;
+            _c += other._c;
+            _weight += other._weight;
+        }
+
+        [[nodiscard]] double Evaluate(const glm::vec3& point) const {
+            if(_weight <= 0.0) {
+                return 0.0;
+            }
+
+            const double x = point.x, y = point.y, z = point.z;
+            const double error = _a00 * x * x + _a11 * y * y + _a22 * z * z
+                + 2.0 * (_a01 * x * y + _a02 * x * z + _a12 * y * z)
+                + 2.0 * (_b0 * x + _b1 * y + _b2 * z) + _c;
+
+            return std::max(error, 0.0) / _weight;
+        }
+    };
+
+    // Squared distance from a point to the closest point of a triangle (Ericson, Real-Time Collision Detection 5.1.5)
+    double GetDistanceSquared(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        const glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        const float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if(d1 <= 0.0f && d2 <= 0.0f) {
+            return glm::dot(ap, ap);
+        }
+
+        const glm::vec3 bp = p - b;
+        const float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if(d3 >= 0.0f && d4 <= d3) {
+            return glm::dot(bp, bp);
+        }
+
+        const glm::vec3 cp = p - c;
+        const float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if(d6 >= 0.0f && d5 <= d6) {
+            return glm::dot(cp, cp);
+        }
+
+        glm::vec3 closest;
+        const float vc = d1 * d4 - d3 * d2, vb = d5 * d2 - d1 * d6, va = d3 * d6 - d5 * d4;
+        if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            closest = a + ab * (d1 / (d1 - d3));
+        }
+        else if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            closest = a + ac * (d2 / (d2 - d6));
+        }
+        else if(va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+            closest = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+        else {
+            const float denominator = 1.0f / (va + vb + vc);
+            closest = a + ab * (vb * denominator) + ac * (vc * denominator);
+        }
+
+        const glm::vec3 offset = p - closest;
+        return glm::dot(offset, offset);
+    }
+
+    // To the closest of a list of triangles, 3 corners each
+    double GetDistanceSquared(const glm::vec3& point, const std::vector<glm::vec3>& triangles) {
+        double distance = std::numeric_limits<double>::max();
+        for(std::size_t corner = 0; corner + 2 < triangles.size(); corner += 3) {
+            distance = std::min(distance, GetDistanceSquared(point, triangles[corner], triangles[corner + 1], triangles[corner + 2]));
+        }
+
+        return distance;
+    }
+
+    struct PositionHash {
+        std::size_t operator()(const glm::vec3& position) const {
+            std::uint32_t bits[3];
+            std::memcpy(bits, &position.x, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+
+    struct PositionEqual {
+        bool operator()(const glm::vec3& lhs, const glm::vec3& rhs) const {
+            return std::memcmp(&lhs.x, &rhs.x, sizeof(float) * 3) == 0;
+        }
+    };
+
+    struct Edge {
+        std::uint32_t _from; // Welded vertices, _from < _to
+        std::uint32_t _to;
+        std::uint32_t _fromCorner; // Unwelded vertices of one triangle using the edge
+        std::uint32_t _toCorner;
+    };
+
+    struct Collapse {
+        std::uint32_t _from;
+        std::uint32_t _to;
+        double _error;
+    };
+
+    class Simplifier {
+    public:
+        Simplifier(const float* positions, const float* attributes, std::size_t attributeCount, std::size_t vertexCount, std::size_t stride)
+            : _positionsData(reinterpret_cast<const std::uint8_t*>(positions))
+            , _attributesData(reinterpret_cast<const std::uint8_t*>(attributes))
+            , _attributeCount(attributeCount)
+            , _stride(stride) {
+            Weld(vertexCount);
+        }
+
+        MeshSimplifier::Result Run(const std::uint32_t* indices, std::size_t indexCount, std::size_t targetIndexCount, float maxError) {
+            BuildTriangles(indices, indexCount);
+            ClassifyVertices();
+            BuildQuadrics();
+
+            const std::size_t targetTriangles = targetIndexCount / 3;
+            const double maxCollapseError = static_cast<double>(maxError) * maxError;
+
+            std::vector<Collapse> collapses;
+            std::vector<std::uint8_t> touched(_positions.size());
+
+            while(_liveTriangles > targetTriangles) {
+                CollectCollapses(collapses);
+                if(collapses.empty()) {
+                    break;
+                }
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+                    return lhs._error < rhs._error || (lhs._error == rhs._error && (lhs._from < rhs._from || (lhs._from == rhs._from && lhs._to < rhs._to)));
+                });
+
+                // Most collapses remove two triangles, only take the cheapest ones the goal needs so errors stay low. Never
+                // less than a fraction of the candidates, close to the target the passes would get too small
+                const std::size_t goal = std::max((_liveTriangles - targetTriangles) / 2, collapses.size() / 6 + 1);
+                const double passLimit = std::min(collapses[std::min(goal, collapses.size()) - 1]._error, maxCollapseError);
+
+                std::fill(touched.begin(), touched.end(), 0);
+                std::size_t collapsed = 0;
+
+                for(const Collapse& collapse : collapses) {
+                    if(collapse._error > passLimit || _liveTriangles <= targetTriangles) {
+                        break;
+                    }
+
+                    if(touched[collapse._from] || touched[collapse._to] || !CanCollapse(collapse._from, collapse._to)) {
+                        continue;
+                    }
+
+                    // The quadric only ranks the collapses, it averages over the planes and is no bound on the distance
+                    const double error = GetCollapseError(collapse._from, collapse._to, maxCollapseError);
+                    if(error > maxCollapseError) {
+                        continue;
+                    }
+
+                    DoCollapse(collapse._from, collapse._to);
+                    touched[collapse._from] = touched[collapse._to] = 1;
+                    collapsed++;
+                }
+
+                if(collapsed == 0) {
+                    break;
+                }
+            }
+
+            MeshSimplifier::Result result;
+            result._error = static_cast<float>(std::sqrt(MeasureError()));
+            result._indices.reserve(_liveTriangles * 3);
+
+            for(std::size_t triangle = 0; triangle < _alive.size(); triangle++) {
+                if(_alive[triangle]) {
+                    result._indices.insert(result._indices.end(), &_corners[triangle * 3], &_corners[triangle * 3] + 3);
+                }
+            }
+
+            return result;
+        }
+
+    private:
+        glm::vec3 GetPosition(std::uint32_t vertex) const {
+            const auto* position = reinterpret_cast<const float*>(_positionsData + vertex * _stride);
+            return {position[0], position[1], position[2]};
+        }
+
+        float GetAttributeDistance(std::uint32_t lhs, std::uint32_t rhs) const {
+            const auto* a = reinterpret_cast<const float*>(_attributesData + lhs * _stride);
+            const auto* b = reinterpret_cast<const float*>(_attributesData + rhs * _stride);
+
+            float distance = 0.0f;
+            for(std::size_t i = 0; i < _attributeCount; i++) {
+                distance += (a[i] - b[i]) * (a[i] - b[i]);
+            }
+            return distance;
+        }
+
+        // Every vertex points to the first one with the same position, wedges of a position form a ring
+        void Weld(std::size_t vertexCount) {
+            std::unordered_map<glm::vec3, std::uint32_t, PositionHash, PositionEqual> firstVertex;
+            firstVertex.reserve(vertexCount);
+
+            _remap.resize(vertexCount);
+            _nextWedge.resize(vertexCount);
+            _positions.resize(vertexCount);
+
+            for(std::uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+                _positions[vertex] = GetPosition(vertex);
+
+                auto [it, bInserted] = firstVertex.emplace(_positions[vertex], vertex);
+                _remap[vertex] = it->second;
+
+                if(bInserted) {
+                    _nextWedge[vertex] = vertex;
+                }
+                else {
+                    _nextWedge[vertex] = _nextWedge[it->second];
+                    _nextWedge[it->second] = vertex;
+                }
+            }
+        }
+
+        void BuildTriangles(const std::uint32_t* indices, std::size_t indexCount) {
+            _vertexTriangles.assign(_positions.size(), {});
+            _corners.clear();
+            _corners.reserve(indexCount);
+
+            for(std::size_t i = 0; i + 2 < indexCount; i += 3) {
+                const std::uint32_t a = _remap[indices[i]], b = _remap[indices[i + 1]], c = _remap[indices[i + 2]];
+
+                // Already degenerate once welded
+                if(a == b || b == c || a == c) {
+                    continue;
+                }
+
+                const std::uint32_t triangle = static_cast<std::uint32_t>(_corners.size() / 3);
+                _corners.insert(_corners.end(), {indices[i], indices[i + 1], indices[i + 2]});
+                _vertexTriangles[a].push_back(triangle);
+                _vertexTriangles[b].push_back(triangle);
+                _vertexTriangles[c].push_back(triangle);
+            }
+
+            _alive.assign(_corners.size() / 3, 1);
+            _liveTriangles = _alive.size();
+            _collapsed.assign(_positions.size(), {});
+        }
+
+        // Calls fn(from, to, count, bSeam) once for every edge between two welded vertices, with from < to, the number of
+        // live triangles using it and whether they use different wedges. Edges are gathered around their lower vertex so
+        // the grouping only sorts a handful of them at a time
+        template<typename Fn>
+        void ForEachEdge(Fn&& fn) {
+            for(std::uint32_t vertex = 0; vertex < _vertexTriangles.size(); vertex++) {
+                _edges.clear();
+
+                for(std::uint32_t triangle : _vertexTriangles[vertex]) {
+                    if(!_alive[triangle]) {
+                        continue;
+                    }
+
+                    for(int corner = 0; corner < 3; corner++) {
+                        const std::uint32_t fromCorner = _corners[triangle * 3 + corner];
+                        if(_remap[fromCorner] != vertex) {
+                            continue;
+                        }
+
+                        for(int step : {1, 2}) {
+                            const std::uint32_t toCorner = _corners[triangle * 3 + (corner + step) % 3];
+                            if(_remap[toCorner] > vertex) {
+                                _edges.push_back({vertex, _remap[toCorner], fromCorner, toCorner});
+                            }
+                        }
+                    }
+                }
+
+                std::sort(_edges.begin(), _edges.end(), [](const Edge& lhs, const Edge& rhs) {
+                    return lhs._to < rhs._to;
+                });
+
+                for(std::size_t first = 0; first < _edges.size();) {
+                    std::size_t last = first + 1;
+                    bool bSeam = false;
+
+                    while(last < _edges.size() && _edges[last]._to == _edges[first]._to) {
+                        bSeam |= _edges[last]._fromCorner != _edges[first]._fromCorner || _edges[last]._toCorner != _edges[first]._toCorner;
+                        last++;
+                    }
+
+                    fn(vertex, _edges[first]._to, last - first, bSeam);
+                    first = last;
+                }
+            }
+        }
+
+        void ClassifyVertices() {
+            std::vector<std::uint8_t> borderEdges(_positions.size()), seamEdges(_positions.size()), bNonManifold(_positions.size());
+            ForEachEdge([&](std::uint32_t from, std::uint32_t to, std::size_t count, bool bSeam) {
+                if(count > 2) {
+                    bNonManifold[from] = bNonManifold[to] = 1;
+                }
+                else if(count == 1) {
+                    borderEdges[from] = static_cast<std::uint8_t>(std::min(borderEdges[from] + 1, 255));
+                    borderEdges[to] = static_cast<std::uint8_t>(std::min(borderEdges[to] + 1, 255));
+                }
+                else if(bSeam) {
+                    seamEdges[from] = static_cast<std::uint8_t>(std::min(seamEdges[from] + 1, 255));
+                    seamEdges[to] = static_cast<std::uint8_t>(std::min(seamEdges[to] + 1, 255));
+                }
+            });
+
+            _kinds.assign(_positions.size(), VertexKind::Interior);
+            for(std::size_t vertex = 0; vertex < _positions.size(); vertex++) {
+                // Corners where borders or seams meet stay, only plain runs of them can slide
+                if(bNonManifold[vertex] || (borderEdges[vertex] && seamEdges[vertex])) {
+                    _kinds[vertex] = VertexKind::Locked;
+                }
+                else if(borderEdges[vertex]) {
+                    _kinds[vertex] = borderEdges[vertex] == 2 ? VertexKind::Border : VertexKind::Locked;
+                }
+                else if(seamEdges[vertex]) {
+                    _kinds[vertex] = seamEdges[vertex] == 2 ? VertexKind::Seam : VertexKind::Locked;
+                }
+            }
+
+            // Constraint planes keep the borders and seams from drifting, they are found again here with their face
+            _quadrics.assign(_positions.size(), {});
+            ForEachEdge([&](std::uint32_t from, std::uint32_t to, std::size_t count, bool bSeam) {
+                if(count != 1 && !bSeam) {
+                    return;
+                }
+
+                const glm::vec3 edge = _positions[to] - _positions[from];
+                const double weight = static_cast<double>(glm::dot(edge, edge)) * ConstraintWeight;
+
+                for(std::uint32_t triangle : _vertexTriangles[from]) {
+                    if(!ContainsVertex(triangle, to)) {
+                        continue;
+                    }
+
+                    const glm::vec3 planeNormal = glm::cross(edge, GetTriangleNormal(triangle));
+                    const Quadric constraint = Quadric::FromPlane(planeNormal, _positions[from], weight);
+                    _quadrics[from].Add(constraint);
+                    _quadrics[to].Add(constraint);
+                }
+            });
+        }
+
+        void BuildQuadrics() {
+            for(std::size_t triangle = 0; triangle < _alive.size(); triangle++) {
+                const glm::vec3 normal = GetTriangleNormal(static_cast<std::uint32_t>(triangle));
+                const Quadric plane = Quadric::FromPlane(normal, _positions[_remap[_corners[triangle * 3]]], glm::length(normal) * 0.5);
+
+                for(int corner = 0; corner < 3; corner++) {
+                    _quadrics[_remap[_corners[triangle * 3 + corner]]].Add(plane);
+                }
+            }
+        }
+
+        void CollectCollapses(std::vector<Collapse>& collapses) {
+            collapses.clear();
+
+            ForEachEdge([&](std::uint32_t a, std::uint32_t b, std::size_t count, bool bSeam) {
+                auto IsAllowed = [&](std::uint32_t from) {
+                    switch(_kinds[from]) {
+                        case VertexKind::Interior: return count == 2;
+                        case VertexKind::Border: return count == 1;
+                        case VertexKind::Seam: return count == 2 && bSeam;
+                        default: return false;
+                    }
+                };
+
+                Quadric quadric = _quadrics[a];
+                quadric.Add(_quadrics[b]);
+
+                // Only the cheaper direction, both keep one of the original positions
+                std::optional<Collapse> best;
+                if(IsAllowed(a)) {
+                    best = Collapse{a, b, quadric.Evaluate(_positions[b])};
+                }
+
+                if(IsAllowed(b)) {
+                    const double error = quadric.Evaluate(_positions[a]);
+                    if(!best || error < best->_error) {
+                        best = Collapse{b, a, error};
+                    }
+                }
+
+                if(best) {
+                    collapses.push_back(best.value());
+                }
+            });
+        }
+
+        bool ContainsVertex(std::uint32_t triangle, std::uint32_t vertex) const {
+            return _remap[_corners[triangle * 3]] == vertex || _remap[_corners[triangle * 3 + 1]] == vertex || _remap[_corners[triangle * 3 + 2]] == vertex;
+        }
+
+        glm::vec3 GetTriangleNormal(std::uint32_t triangle, std::uint32_t moved = ~0u, const glm::vec3& movedTo = {}) const {
+            glm::vec3 corners[3];
+            for(int corner = 0; corner < 3; corner++) {
+                const std::uint32_t vertex = _remap[_corners[triangle * 3 + corner]];
+                corners[corner] = vertex == moved ? movedTo : _positions[vertex];
+            }
+
+            return glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+        }
+
+        // The current topology has to survive the collapse, costs were computed at the start of the pass
+        bool CanCollapse(std::uint32_t from, std::uint32_t to) {
+            // Link condition, the only vertices both ends share are the ones opposite to the edge
+            _neighbours.clear();
+            std::size_t sharedTriangles = 0;
+
+            for(std::uint32_t triangle : _vertexTriangles[from]) {
+                if(!_alive[triangle]) {
+                    continue;
+                }
+
+                if(ContainsVertex(triangle, to)) {
+                    sharedTriangles++;
+                    continue;
+                }
+
+                for(int corner = 0; corner < 3; corner++) {
+                    _neighbours.push_back(_remap[_corners[triangle * 3 + corner]]);
+                }
+
+                // Reject collapses that fold a triangle over
+                const glm::vec3 before = GetTriangleNormal(triangle);
+                const glm::vec3 after = GetTriangleNormal(triangle, from, _positions[to]);
+                if(glm::dot(before, after) <= 0.0f) {
+                    return false;
+                }
+            }
+
+            std::sort(_neighbours.begin(), _neighbours.end());
+            _neighbours.erase(std::unique(_neighbours.begin(), _neighbours.end()), _neighbours.end());
+
+            std::size_t sharedNeighbours = 0;
+            _visited.clear();
+            for(std::uint32_t triangle : _vertexTriangles[to]) {
+                if(!_alive[triangle] || ContainsVertex(triangle, from)) {
+                    continue;
+                }
+
+                for(int corner = 0; corner < 3; corner++) {
+                    const std::uint32_t vertex = _remap[_corners[triangle * 3 + corner]];
+                    if(vertex != to && std::binary_search(_neighbours.begin(), _neighbours.end(), vertex)) {
+                        _visited.push_back(vertex);
+                    }
+                }
+            }
+
+            std::sort(_visited.begin(), _visited.end());
+            sharedNeighbours = std::unique(_visited.begin(), _visited.end()) - _visited.begin();
+
+            // Each triangle on the edge has one opposite vertex which is also in the ring of both ends
+            return sharedTriangles > 0 && sharedNeighbours <= sharedTriangles;
+        }
+
+        // Appends the corners of the live triangles of vertex as they will be once from moved onto to
+        void GatherRing(std::uint32_t vertex, std::uint32_t from, std::uint32_t to) {
+            for(std::uint32_t triangle : _vertexTriangles[vertex]) {
+                if(!_alive[triangle] || (ContainsVertex(triangle, from) && ContainsVertex(triangle, to))) {
+                    continue;
+                }
+
+                for(int corner = 0; corner < 3; corner++) {
+                    const std::uint32_t cornerVertex = _remap[_corners[triangle * 3 + corner]];
+                    _ring.push_back(_positions[cornerVertex == from ? to : cornerVertex]);
+                }
+            }
+        }
+
+        /**
+         * Largest squared distance from a vertex collapsed so far to the surface once from moved onto to, stops early past
+         * limit. Collapsed vertices are measured against the triangles around the vertex they went into, the collapse
+         * changes the triangles of to and of its neighbours so all of those are measured again
+         */
+        double GetCollapseError(std::uint32_t from, std::uint32_t to, double limit) {
+            _affected.clear();
+            for(std::uint32_t vertex : {from, to}) {
+                for(std::uint32_t triangle : _vertexTriangles[vertex]) {
+                    if(!_alive[triangle]) {
+                        continue;
+                    }
+
+                    for(int corner = 0; corner < 3; corner++) {
+                        const std::uint32_t neighbour = _remap[_corners[triangle * 3 + corner]];
+                        if(neighbour != from) {
+                            _affected.push_back(neighbour);
+                        }
+                    }
+                }
+            }
+
+            std::sort(_affected.begin(), _affected.end());
+            _affected.erase(std::unique(_affected.begin(), _affected.end()), _affected.end());
+
+            double error = 0.0;
+            for(std::uint32_t vertex : _affected) {
+                // to takes over from and what was collapsed into it
+                _points.assign(_collapsed[vertex].begin(), _collapsed[vertex].end());
+                if(vertex == to) {
+                    _points.push_back(from);
+                    _points.insert(_points.end(), _collapsed[from].begin(), _collapsed[from].end());
+                }
+
+                if(_points.empty()) {
+                    continue;
+                }
+
+                // Triangles around the vertex after the collapse, the ones on the edge go away
+                _ring.clear();
+                GatherRing(vertex, from, to);
+                if(vertex == to) {
+                    GatherRing(from, from, to);
+                }
+
+                // Nothing left to measure against, the collapse would remove a part of the surface
+                if(_ring.empty()) {
+                    return std::numeric_limits<double>::max();
+                }
+
+                for(std::uint32_t point : _points) {
+                    error = std::max(error, GetDistanceSquared(_positions[point], _ring));
+                    if(error > limit) {
+                        return error;
+                    }
+                }
+            }
+
+            return error;
+        }
+
+        // Largest squared distance from a collapsed vertex to the triangles around the vertex it went into, as they are now
+        double MeasureError() {
+            double error = 0.0;
+            for(std::uint32_t vertex = 0; vertex < _collapsed.size(); vertex++) {
+                if(_collapsed[vertex].empty()) {
+                    continue;
+                }
+
+                _ring.clear();
+                GatherRing(vertex, ~0u, ~0u);
+                for(std::uint32_t point : _collapsed[vertex]) {
+                    error = std::max(error, GetDistanceSquared(_positions[point], _ring));
+                }
+            }
+
+            return error;
+        }
+
+        void DoCollapse(std::uint32_t from, std::uint32_t to) {
+            for(std::uint32_t triangle : _vertexTriangles[from]) {
+                if(!_alive[triangle]) {
+                    continue;
+                }
+
+                if(ContainsVertex(triangle, to)) {
+                    _alive[triangle] = 0;
+                    _liveTriangles--;
+                    continue;
+                }
+
+                for(int corner = 0; corner < 3; corner++) {
+                    std::uint32_t& vertex = _corners[triangle * 3 + corner];
+                    if(_remap[vertex] == from) {
+                        vertex = FindClosestWedge(vertex, to);
+                    }
+                }
+
+                _vertexTriangles[to].push_back(triangle);
+            }
+
+            _vertexTriangles[from].clear();
+            _quadrics[to].Add(_quadrics[from]);
+
+            _collapsed[to].push_back(from);
+            _collapsed[to].insert(_collapsed[to].end(), _collapsed[from].begin(), _collapsed[from].end());
+            _collapsed[from].clear();
+        }
+
+        // Wedge of the kept position whose attributes are closest to the wedge that goes away
+        std::uint32_t FindClosestWedge(std::uint32_t wedge, std::uint32_t to) const {
+            if(!_attributesData) {
+                return to;
+            }
+
+            std::uint32_t best = to;
+            float bestDistance = GetAttributeDistance(wedge, to);
+
+            for(std::uint32_t candidate = _nextWedge[to]; candidate != to; candidate = _nextWedge[candidate]) {
+                const float distance = GetAttributeDistance(wedge, candidate);
+                if(distance < bestDistance) {
+                    best = candidate;
+                    bestDistance = distance;
+                }
+            }
+
+            return best;
+        }
+
+    private:
+        const std::uint8_t* _positionsData;
+        const std::uint8_t* _attributesData;
+        std::size_t _attributeCount;
+        std::size_t _stride;
+
+        // Indexed by vertex, only the welded ones (_remap[v] == v) are used past the weld
+        std::vector<glm::vec3> _positions;
+        std::vector<std::uint32_t> _remap;
+        std::vector<std::uint32_t> _nextWedge;
+        std::vector<VertexKind> _kinds;
+        std::vector<Quadric> _quadrics;
+        std::vector<std::vector<std::uint32_t>> _vertexTriangles; // Dead triangles are skipped, not removed
+        std::vector<std::vector<std::uint32_t>> _collapsed; // Welded vertices that went into each vertex, see GetCollapseError
+
+        std::vector<std::uint32_t> _corners; // Unwelded vertices, 3 per triangle
+        std::vector<std::uint8_t> _alive;
+        std::size_t _liveTriangles = 0;
+
+        // Scratch
+        std::vector<Edge> _edges;
+        std::vector<std::uint32_t> _neighbours;
+        std::vector<std::uint32_t> _visited;
+        std::vector<std::uint32_t> _affected;
+        std::vector<std::uint32_t> _points;
+        std::vector<glm::vec3> _ring;
+    };
+}
+
+MeshSimplifier::Result MeshSimplifier::Simplify(const float* positions, const float* attributes, std::size_t attributeCount, std::size_t vertexCount, std::size_t stride,
+    const std::uint32_t* indices, std::size_t indexCount, std::size_t targetIndexCount, float maxError) {
+    Simplifier simplifier(positions, attributes, attributeCount, vertexCount, stride);
+    return simplifier.Run(indices, indexCount, targetIndexCount, maxError);
+}
@@ -0,0 +1,295 @@
+#include "Core/Meshlets.hpp"
+#include <cmath>
+
+namespace {
+    class Builder {
+    public:
+        Builder(const float* positions, std::size_t vertexCount, std::size_t stride, const std::uint32_t* indices, std::size_t indexCount,
+            std::size_t maxVertices, std::size_t maxTriangles)
+            : _positionsData(reinterpret_cast<const std::uint8_t*>(positions))
+            , _stride(stride)
+            , _indices(indices)
+            , _triangleCount(indexCount / 3)
+            , _maxVertices(maxVertices)
+            , _maxTriangles(maxTriangles) {
+            BuildAdjacency(vertexCount);
+            _localVertex.assign(vertexCount, Unused);
+            _used.assign(_triangleCount, 0);
+            _bCandidate.assign(_triangleCount, 0);
+        }
+
+        MeshletData Run() {
+            std::size_t seed = 0;
+            while(true) {
+                while(seed < _triangleCount && _used[seed]) {
+                    seed++;
+                }
+
+                if(seed == _triangleCount) {
+                    break;
+                }
+
+                AddTriangle(static_cast<std::uint32_t>(seed));
+                while(_meshlet._triangleCount < _maxTriangles) {
+                    const std::uint32_t next = PickNeighbour();
+                    if(next == Unused) {
+                        break;
+                    }
+
+                    AddTriangle(next);
+                }
+
+                Flush();
+            }
+
+            return std::move(_data);
+        }
+
+    private:
+        static constexpr std::uint32_t Unused = ~0u;
+
+        glm::vec3 GetPosition(std::uint32_t vertex) const {
+            const auto* position = reinterpret_cast<const float*>(_positionsData + vertex * _stride);
+            return {position[0], position[1], position[2]};
+        }
+
+        // Triangles of every vertex, flattened
+        void BuildAdjacency(std::size_t vertexCount) {
+            _adjacencyOffsets.assign(vertexCount + 1, 0);
+            for(std::size_t i = 0; i < _triangleCount * 3; i++) {
+                _adjacencyOffsets[_indices[i] + 1]++;
+            }
+
+            for(std::size_t vertex = 0; vertex < vertexCount; vertex++) {
+                _adjacencyOffsets[vertex + 1] += _adjacencyOffsets[vertex];
+            }
+
+            _adjacency.resize(_triangleCount * 3);
+            std::vector<std::uint32_t> fill(_adjacencyOffsets.begin(), _adjacencyOffsets.end() - 1);
+            for(std::size_t i = 0; i < _triangleCount * 3; i++) {
+                _adjacency[fill[_indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+            }
+        }
+
+        std::size_t CountNewVertices(std::uint32_t triangle) const {
+            std::size_t count = 0;
+            for(int corner = 0; corner < 3; corner++) {
+                count += _localVertex[_indices[triangle * 3 + corner]] == Unused ? 1 : 0;
+            }
+            return count;
+        }
+
+        // Unused triangle next to the meshlet that adds the fewest vertices and still fits, Unused when there is none
+        std::uint32_t PickNeighbour() {
+            std::uint32_t best = Unused;
+            std::size_t bestNewVertices = 4;
+
+            std::size_t live = 0;
+            for(std::uint32_t triangle : _candidates) {
+                if(_used[triangle]) {
+                    _bCandidate[triangle] = 0;
+                    continue;
+                }
+
+                _candidates[live++] = triangle;
+
+                const std::size_t newVertices = CountNewVertices(triangle);
+                if(_meshlet._vertexCount + newVertices <= _maxVertices && newVertices < bestNewVertices) {
+                    best = triangle;
+                    bestNewVertices = newVertices;
+                }
+            }
+
+            _candidates.resize(live);
+            return best;
+        }
+
+        void AddTriangle(std::uint32_t triangle) {
+            _used[triangle] = 1;
+            _meshlet._triangleCount++;
+
+            for(int corner = 0; corner < 3; corner++) {
+                const std::uint32_t vertex = _indices[triangle * 3 + corner];
+                if(_localVertex[vertex] == Unused) {
+                    _localVertex[vertex] = _meshlet._vertexCount++;
+                    _data._vertices.push_back(vertex);
+                }
+
+                _data._triangles.push_back(static_cast<std::uint8_t>(_localVertex[vertex]));
+
+                for(std::uint32_t i = _adjacencyOffsets[vertex]; i < _adjacencyOffsets[vertex + 1]; i++) {
+                    const std::uint32_t neighbour = _adjacency[i];
+                    if(!_used[neighbour] && !_bCandidate[neighbour]) {
+                        _bCandidate[neighbour] = 1;
+                        _candidates.push_back(neighbour);
+                    }
+                }
+            }
+        }
+
+        void Flush() {
+            if(_meshlet._triangleCount == 0) {
+                return;
+            }
+
+            ComputeBounds(_meshlet);
+            _data._meshlets.push_back(_meshlet);
+
+            for(std::uint32_t i = 0; i < _meshlet._vertexCount; i++) {
+                _localVertex[_data._vertices[_meshlet._vertexOffset + i]] = Unused;
+            }
+
+            _meshlet = {};
+            _meshlet._vertexOffset = static_cast<std::uint32_t>(_data._vertices.size());
+            _meshlet._triangleOffset = static_cast<std::uint32_t>(_data._triangles.size() / 3);
+
+            for(std::uint32_t triangle : _candidates) {
+                _bCandidate[triangle] = 0;
+            }
+            _candidates.clear();
+        }
+
+        // Sphere around the vertex average, cone around the average triangle normal
+        void ComputeBounds(Meshlet& meshlet) {
+            glm::vec3 center(0.0f);
+            for(std::uint32_t i = 0; i < meshlet._vertexCount; i++) {
+                center += GetPosition(_data._vertices[meshlet._vertexOffset + i]);
+            }
+            center /= static_cast<float>(meshlet._vertexCount);
+
+            float radiusSquared = 0.0f;
+            for(std::uint32_t i = 0; i < meshlet._vertexCount; i++) {
+                const glm::vec3 offset = GetPosition(_data._vertices[meshlet._vertexOffset + i]) - center;
+                radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+            }
+
+            meshlet._center = center;
+            meshlet._radius = std::sqrt(radiusSquared);
+
+            // Degenerate triangles have no facing, they do not widen the cone
+            _normals.clear();
+            glm::vec3 axis(0.0f);
+
+            for(std::uint32_t triangle = 0; triangle < meshlet._triangleCount; triangle++) {
+                const std::uint8_t* local = &_data._triangles[(meshlet._triangleOffset + triangle) * 3];
+                const glm::vec3 a = GetPosition(_data._vertices[meshlet._vertexOffset + local[0]]);
+                const glm::vec3 b = GetPosition(_data._vertices[meshlet._vertexOffset + local[1]]);
+                const glm::vec3 c = GetPosition(_data._vertices[meshlet._vertexOffset + local[2]]);
+
+                const glm::vec3 normal = glm::cross(b - a, c - a);
+                const float length = glm::length(normal);
+                if(length > 0.0f) {
+                    _normals.push_back(normal / length);
+                    axis += _normals.back();
+                }
+            }
+
+            const float axisLength = glm::length(axis);
+            if(_normals.empty() || axisLength <= 0.0f) {
+                return;
+            }
+
+            meshlet._coneAxis = axis / axisLength;
+
+            float minDot = 1.0f;
+            for(const glm::vec3& normal : _normals) {
+                minDot = std::min(minDot, glm::dot(normal, meshlet._coneAxis));
+            }
+
+            // A cone wider than a half space always has a triangle facing the camera
+            meshlet._coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+        }
+
+    private:
+        const std::uint8_t* _positionsData;
+        std::size_t _stride;
+        const std::uint32_t* _indices;
+        std::size_t _triangleCount;
+        std::size_t _maxVertices;
+        std::size_t _maxTriangles;
+
+        std::vector<std::uint32_t> _adjacencyOffsets;
+        std::vector<std::uint32_t> _adjacency;
+        std::vector<std::uint32_t> _localVertex; // Index in the current meshlet, Unused when not in it
+        std::vector<std::uint8_t> _used;
+        std::vector<std::uint32_t> _candidates; // Triangles next to the current meshlet, used ones are dropped lazily
+        std::vector<std::uint8_t> _bCandidate;
+        std::vector<glm::vec3> _normals;
+
+        MeshletData _data;
+        Meshlet _meshlet;
+    };
+}
+
+MeshletData MeshletBuilder::Build(const float* positions, std::size_t vertexCount, std::size_t stride, const std::uint32_t* indices,
+    std::size_t indexCount, std::size_t maxVertices, std::size_t maxTriangles) {
+    // Local triangle indices are bytes
+    if(maxVertices < 3 || maxVertices > 256 || maxTriangles == 0) {
+        assert(0 && "Meshlets need between 3 and 256 vertices and at least one triangle");
+        return {};
+    }
+
+    Builder builder(positions, vertexCount, stride, indices, indexCount, maxVertices, maxTriangles);
+    return builder.Run();
+}
+
+std::vector<std::uint32_t> MeshletBuilder::BuildIndices(const MeshletData& data) {
+    std::vector<std::uint32_t> indices;
+    indices.reserve(data._triangles.size());
+
+    for(const Meshlet& meshlet : data._meshlets) {
+        for(std::uint32_t i = 0; i < meshlet._triangleCount * 3; i++) {
+            indices.push_back(data._vertices[meshlet._vertexOffset + data._triangles[meshlet._triangleOffset * 3 + i]]);
+        }
+    }
+
+    return indices;
+}
+
+bool MeshletCulling::IsBackfacing(const Meshlet& meshlet, const glm::vec3& cameraPosition) {
+    if(meshlet._coneCutoff >= 1.0f) {
+        return false;
+    }
+
+    // Every point of the sphere is seen within the cone's complement, so every normal points away from the camera
+    const glm::vec3 offset = meshlet._center - cameraPosition;
+    return glm::dot(offset, meshlet._coneAxis) >= meshlet._coneCutoff * glm::length(offset) + meshlet._radius;
+}
+
+std::size_t MeshletCulling::Cull(SimdIsa isa, const MeshletData& data, const glm::mat4& clipMatrix, const glm::vec3& cameraPosition, bool bBackfaceCulling,
+    std::vector<IndexRange>& ranges) {
+    ranges.clear();
+
+    // Boxes as large as the spheres, the plane test then only uses the radius
+    const std::size_t count = data._meshlets.size();
+    _bounds.Resize(count);
+    for(std::size_t i = 0; i < count; i++) {
+        const Meshlet& meshlet = data._meshlets[i];
+        _bounds._centerX[i] = meshlet._center.x;
+        _bounds._centerY[i] = meshlet._center.y;
+        _bounds._centerZ[i] = meshlet._center.z;
+        _bounds._extentX[i] = _bounds._extentY[i] = _bounds._extentZ[i] = _bounds._radius[i] = meshlet._radius;
+    }
+
+    _visible.resize(count);
+    FrustumCulling::Cull(isa, Frustum::FromViewProjection(clipMatrix), _bounds, 0, count, _visible.data());
+
+    std::size_t culledTriangles = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        const Meshlet& meshlet = data._meshlets[i];
+        if(!_visible[i] || (bBackfaceCulling && IsBackfacing(meshlet, cameraPosition))) {
+            culledTriangles += meshlet._triangleCount;
+            continue;
+        }
+
+        const std::uint32_t firstIndex = meshlet._triangleOffset * 3;
+        if(!ranges.empty() && ranges.back()._firstIndex + ranges.back()._indexCount == firstIndex) {
+            ranges.back()._indexCount += meshlet._triangleCount * 3;
+        }
+        else {
+            ranges.push_back({firstIndex, meshlet._triangleCount * 3});
+        }
+    }
+
+    return culledTriangles;
+}
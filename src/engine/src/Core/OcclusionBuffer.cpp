@@ -0,0 +1,416 @@
+#include "Core/OcclusionBuffer.hpp"
+#include <bit>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define OCCLUSION_BUFFER_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define TARGET_AVX2
+    #else
+        #define TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+    #define OCCLUSION_BUFFER_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace {
+    // Rows are walked in blocks of this many texels, the widest register
+    constexpr std::uint32_t BlockWidth = 8;
+
+    // Edge functions and the 1/w plane of a triangle in texel units, edge i is the one opposite to vertex i. The
+    // constants are moved so the value at a texel center is the one at its worst corner, the least inside and the farthest
+    struct TriangleSetup {
+        float _edgeA[3], _edgeB[3], _edgeC[3];
+        float _depthA, _depthB, _depthC;
+        std::uint32_t _minX, _maxX, _minY, _maxY; // Max is exclusive, the x range is aligned to BlockWidth
+    };
+
+    // Every version evaluates the planes with a multiply and add in this order so they match bit for bit, the file is
+    // built without floating point contraction (see CMakeLists.txt), an fma would round differently
+    inline float Evaluate(float a, float b, float c, float px, float py) {
+        return (a * px + b * py) + c;
+    }
+
+    // The reference every SIMD version has to match
+    void RasterizeScalar(const TriangleSetup& t, float* depth, std::uint32_t width) {
+        for(std::uint32_t y = t._minY; y < t._maxY; y++) {
+            const float py = static_cast<float>(y) + 0.5f;
+            float* row = depth + static_cast<std::size_t>(y) * width;
+
+            for(std::uint32_t x = t._minX; x < t._maxX; x++) {
+                const float px = static_cast<float>(x) + 0.5f;
+                const float e0 = Evaluate(t._edgeA[0], t._edgeB[0], t._edgeC[0], px, py);
+                const float e1 = Evaluate(t._edgeA[1], t._edgeB[1], t._edgeC[1], px, py);
+                const float e2 = Evaluate(t._edgeA[2], t._edgeB[2], t._edgeC[2], px, py);
+                const float z = Evaluate(t._depthA, t._depthB, t._depthC, px, py);
+
+                if(e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f && z > row[x]) {
+                    row[x] = z;
+                }
+            }
+        }
+    }
+
+#if OCCLUSION_BUFFER_X86
+    void RasterizeSSE(const TriangleSetup& t, float* depth, std::uint32_t width) {
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+
+        for(std::uint32_t y = t._minY; y < t._maxY; y++) {
+            const __m128 py = _mm_set1_ps(static_cast<float>(y) + 0.5f);
+            float* row = depth + static_cast<std::size_t>(y) * width;
+
+            __m128 rowTerms[4], constants[4], slopes[4];
+            for(int i = 0; i < 3; i++) {
+                rowTerms[i] = _mm_mul_ps(_mm_set1_ps(t._edgeB[i]), py);
+                constants[i] = _mm_set1_ps(t._edgeC[i]);
+                slopes[i] = _mm_set1_ps(t._edgeA[i]);
+            }
+            rowTerms[3] = _mm_mul_ps(_mm_set1_ps(t._depthB), py);
+            constants[3] = _mm_set1_ps(t._depthC);
+            slopes[3] = _mm_set1_ps(t._depthA);
+
+            for(std::uint32_t x = t._minX; x < t._maxX; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                __m128 values[4];
+                for(int i = 0; i < 4; i++) {
+                    values[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(slopes[i], px), rowTerms[i]), constants[i]);
+                }
+
+                const __m128 current = _mm_loadu_ps(row + x);
+                __m128 mask = _mm_and_ps(_mm_cmpge_ps(values[0], zero), _mm_cmpge_ps(values[1], zero));
+                mask = _mm_and_ps(mask, _mm_cmpge_ps(values[2], zero));
+                mask = _mm_and_ps(mask, _mm_cmpgt_ps(values[3], current));
+
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, values[3]), _mm_andnot_ps(mask, current)));
+            }
+        }
+    }
+
+    TARGET_AVX2 void RasterizeAVX2(const TriangleSetup& t, float* depth, std::uint32_t width) {
+        const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        for(std::uint32_t y = t._minY; y < t._maxY; y++) {
+            const __m256 py = _mm256_set1_ps(static_cast<float>(y) + 0.5f);
+            float* row = depth + static_cast<std::size_t>(y) * width;
+
+            __m256 rowTerms[4], constants[4], slopes[4];
+            for(int i = 0; i < 3; i++) {
+                rowTerms[i] = _mm256_mul_ps(_mm256_set1_ps(t._edgeB[i]), py);
+                constants[i] = _mm256_set1_ps(t._edgeC[i]);
+                slopes[i] = _mm256_set1_ps(t._edgeA[i]);
+            }
+            rowTerms[3] = _mm256_mul_ps(_mm256_set1_ps(t._depthB), py);
+            constants[3] = _mm256_set1_ps(t._depthC);
+            slopes[3] = _mm256_set1_ps(t._depthA);
+
+            for(std::uint32_t x = t._minX; x < t._maxX; x += 8) {
+                const __m256 px = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                __m256 values[4];
+                for(int i = 0; i < 4; i++) {
+                    values[i] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(slopes[i], px), rowTerms[i]), constants[i]);
+                }
+
+                const __m256 current = _mm256_loadu_ps(row + x);
+                __m256 mask = _mm256_and_ps(_mm256_cmp_ps(values[0], zero, _CMP_GE_OQ), _mm256_cmp_ps(values[1], zero, _CMP_GE_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(values[2], zero, _CMP_GE_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(values[3], current, _CMP_GT_OQ));
+
+                _mm256_storeu_ps(row + x, _mm256_blendv_ps(current, values[3], mask));
+            }
+        }
+    }
+#endif
+
+#if OCCLUSION_BUFFER_NEON
+    void RasterizeNEON(const TriangleSetup& t, float* depth, std::uint32_t width) {
+        const float32x4_t laneOffsets = {0.5f, 1.5f, 2.5f, 3.5f};
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+
+        for(std::uint32_t y = t._minY; y < t._maxY; y++) {
+            const float py = static_cast<float>(y) + 0.5f;
+            float* row = depth + static_cast<std::size_t>(y) * width;
+
+            float32x4_t rowTerms[4], constants[4];
+            for(int i = 0; i < 3; i++) {
+                rowTerms[i] = vdupq_n_f32(t._edgeB[i] * py);
+                constants[i] = vdupq_n_f32(t._edgeC[i]);
+            }
+            rowTerms[3] = vdupq_n_f32(t._depthB * py);
+            constants[3] = vdupq_n_f32(t._depthC);
+            const float slopes[4] = {t._edgeA[0], t._edgeA[1], t._edgeA[2], t._depthA};
+
+            for(std::uint32_t x = t._minX; x < t._maxX; x += 4) {
+                const float32x4_t px = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), laneOffsets);
+
+                float32x4_t values[4];
+                for(int i = 0; i < 4; i++) {
+                    values[i] = vaddq_f32(vaddq_f32(vmulq_n_f32(px, slopes[i]), rowTerms[i]), constants[i]);
+                }
+
+                const float32x4_t current = vld1q_f32(row + x);
+                uint32x4_t mask = vandq_u32(vcgeq_f32(values[0], zero), vcgeq_f32(values[1], zero));
+                mask = vandq_u32(mask, vcgeq_f32(values[2], zero));
+                mask = vandq_u32(mask, vcgtq_f32(values[3], current));
+
+                vst1q_f32(row + x, vbslq_f32(mask, values[3], current));
+            }
+        }
+    }
+#endif
+
+    // Distance to the near plane in clip space, same plane as Frustum (z >= -w)
+    inline float NearDistance(const glm::vec4& clip) {
+        return clip.z + clip.w;
+    }
+}
+
+void OcclusionBuffer::Resize(std::uint32_t width, std::uint32_t height) {
+    _width = std::bit_ceil(std::max(width, BlockWidth));
+    _height = std::bit_ceil(std::max(height, 1u));
+
+    const std::uint32_t levelCount = std::bit_width(std::max(_width, _height));
+    _levels.resize(levelCount);
+    for(std::uint32_t level = 0; level < levelCount; level++) {
+        _levels[level].assign(static_cast<std::size_t>(GetLevelWidth(level)) * GetLevelHeight(level), 0.0f);
+    }
+}
+
+void OcclusionBuffer::Clear() {
+    for(std::vector<float>& level : _levels) {
+        std::fill(level.begin(), level.end(), 0.0f);
+    }
+}
+
+void OcclusionBuffer::RasterizeTriangles(SimdIsa isa, const glm::mat4& clipMatrix, const float* positions, std::size_t stride, const std::uint32_t* indices, std::size_t indexCount) {
+    if(_levels.empty()) {
+        assert(0 && "OcclusionBuffer::RasterizeTriangles() - Resize was not called");
+        return;
+    }
+
+    if(!TransformKernels::IsSupported(isa)) {
+        assert(0 && "Instruction set not supported by this CPU");
+        isa = SimdIsa::Scalar;
+    }
+
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(positions);
+    auto ToClip = [&](std::uint32_t index) {
+        const auto* position = reinterpret_cast<const float*>(bytes + index * stride);
+        return clipMatrix * glm::vec4(position[0], position[1], position[2], 1.0f);
+    };
+
+    for(std::size_t i = 0; i + 2 < indexCount; i += 3) {
+        const glm::vec4 clip[3] = {ToClip(indices[i]), ToClip(indices[i + 1]), ToClip(indices[i + 2])};
+
+        // Sutherland-Hodgman against the near plane, the other planes are handled by the texel bounds
+        glm::vec4 polygon[4];
+        int count = 0;
+        for(int v = 0; v < 3; v++) {
+            const glm::vec4& current = clip[v];
+            const glm::vec4& next = clip[(v + 1) % 3];
+            const float currentDistance = NearDistance(current);
+            const float nextDistance = NearDistance(next);
+
+            if(currentDistance >= 0.0f) {
+                polygon[count++] = current;
+            }
+
+            if((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+                const float t = currentDistance / (currentDistance - nextDistance);
+                polygon[count++] = current + (next - current) * t;
+            }
+        }
+
+        for(int v = 1; v + 1 < count; v++) {
+            RasterizeTriangle(isa, polygon[0], polygon[v], polygon[v + 1]);
+        }
+    }
+}
+
+void OcclusionBuffer::RasterizeTriangle(SimdIsa isa, const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2) {
+    const glm::vec4* clip[3] = {&v0, &v1, &v2};
+    float sx[3], sy[3], invW[3];
+
+    for(int v = 0; v < 3; v++) {
+        // Only an orthographic projection with a bad matrix gets here, a perspective one has w >= near
+        if(clip[v]->w <= 0.0f) {
+            return;
+        }
+
+        invW[v] = 1.0f / clip[v]->w;
+        sx[v] = (clip[v]->x * invW[v] * 0.5f + 0.5f) * static_cast<float>(_width);
+        sy[v] = (clip[v]->y * invW[v] * 0.5f + 0.5f) * static_cast<float>(_height);
+    }
+
+    TriangleSetup setup;
+    for(int e = 0; e < 3; e++) {
+        const int a = (e + 1) % 3;
+        const int b = (e + 2) % 3;
+        setup._edgeA[e] = sy[a] - sy[b];
+        setup._edgeB[e] = sx[b] - sx[a];
+        setup._edgeC[e] = sx[a] * sy[b] - sy[a] * sx[b];
+    }
+
+    // Twice the signed area, edge 0 evaluated at vertex 0
+    float area = setup._edgeA[0] * sx[0] + setup._edgeB[0] * sy[0] + setup._edgeC[0];
+    if(std::abs(area) < 1e-8f) {
+        return;
+    }
+
+    // Double sided, flip back facing triangles so inside is always positive
+    if(area < 0.0f) {
+        for(int e = 0; e < 3; e++) {
+            setup._edgeA[e] = -setup._edgeA[e];
+            setup._edgeB[e] = -setup._edgeB[e];
+            setup._edgeC[e] = -setup._edgeC[e];
+        }
+        area = -area;
+    }
+
+    // Barycentric weights are edge / area
+    setup._depthA = (setup._edgeA[0] * invW[0] + setup._edgeA[1] * invW[1] + setup._edgeA[2] * invW[2]) / area;
+    setup._depthB = (setup._edgeB[0] * invW[0] + setup._edgeB[1] * invW[1] + setup._edgeB[2] * invW[2]) / area;
+    setup._depthC = (setup._edgeC[0] * invW[0] + setup._edgeC[1] * invW[1] + setup._edgeC[2] * invW[2]) / area;
+
+    // Conservative, a texel is only written when its four corners are inside and gets the depth of its farthest one.
+    // The planes are linear, the worst corner is half a texel away along each axis in the direction they decrease
+    for(int e = 0; e < 3; e++) {
+        setup._edgeC[e] -= 0.5f * (std::abs(setup._edgeA[e]) + std::abs(setup._edgeB[e]));
+    }
+    setup._depthC -= 0.5f * (std::abs(setup._depthA) + std::abs(setup._depthB));
+
+    const float width = static_cast<float>(_width);
+    const float height = static_cast<float>(_height);
+    const float minX = std::clamp(std::min({sx[0], sx[1], sx[2]}), 0.0f, width);
+    const float maxX = std::clamp(std::max({sx[0], sx[1], sx[2]}) + 1.0f, 0.0f, width);
+    const float minY = std::clamp(std::min({sy[0], sy[1], sy[2]}), 0.0f, height);
+    const float maxY = std::clamp(std::max({sy[0], sy[1], sy[2]}) + 1.0f, 0.0f, height);
+
+    // Every version walks the same aligned blocks, texels past the triangle fail the edge tests
+    setup._minX = static_cast<std::uint32_t>(minX) & ~(BlockWidth - 1);
+    setup._maxX = (static_cast<std::uint32_t>(maxX) + BlockWidth - 1) & ~(BlockWidth - 1);
+    setup._minY = static_cast<std::uint32_t>(minY);
+    setup._maxY = static_cast<std::uint32_t>(maxY);
+
+    if(setup._minX >= setup._maxX || setup._minY >= setup._maxY) {
+        return;
+    }
+
+    float* depth = _levels[0].data();
+
+#if OCCLUSION_BUFFER_X86
+    if(isa == SimdIsa::AVX2) {
+        RasterizeAVX2(setup, depth, _width);
+        return;
+    }
+
+    if(isa == SimdIsa::SSE) {
+        RasterizeSSE(setup, depth, _width);
+        return;
+    }
+#endif
+
+#if OCCLUSION_BUFFER_NEON
+    if(isa == SimdIsa::NEON) {
+        RasterizeNEON(setup, depth, _width);
+        return;
+    }
+#endif
+
+    RasterizeScalar(setup, depth, _width);
+}
+
+void OcclusionBuffer::BuildPyramid() {
+    for(std::uint32_t level = 1; level < _levels.size(); level++) {
+        const std::vector<float>& source = _levels[level - 1];
+        const std::uint32_t sourceWidth = GetLevelWidth(level - 1);
+        const std::uint32_t sourceHeight = GetLevelHeight(level - 1);
+        const std::uint32_t levelWidth = GetLevelWidth(level);
+        const std::uint32_t levelHeight = GetLevelHeight(level);
+        std::vector<float>& destination = _levels[level];
+
+        for(std::uint32_t y = 0; y < levelHeight; y++) {
+            // Once a side is down to one texel it stops halving
+            const std::uint32_t y0 = std::min(y * 2, sourceHeight - 1);
+            const std::uint32_t y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+            for(std::uint32_t x = 0; x < levelWidth; x++) {
+                const std::uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+                const std::uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+                // Smallest 1/w is the farthest occluder
+                destination[y * levelWidth + x] = std::min({source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1],
+                    source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]});
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::IsOccluded(const glm::mat4& viewProjection, const AABB& box) const {
+    if(_levels.empty()) {
+        return false;
+    }
+
+    float minX = std::numeric_limits<float>::max(), minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest(), maxY = std::numeric_limits<float>::lowest();
+    float nearestInvW = 0.0f;
+
+    for(int corner = 0; corner < 8; corner++) {
+        const glm::vec3 position((corner & 1) ? box._max.x : box._min.x, (corner & 2) ? box._max.y : box._min.y, (corner & 4) ? box._max.z : box._min.z);
+        const glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+
+        // The camera is inside or right next to it
+        if(NearDistance(clip) < 0.0f || clip.w <= 0.0f) {
+            return false;
+        }
+
+        const float invW = 1.0f / clip.w;
+        const float sx = (clip.x * invW * 0.5f + 0.5f) * static_cast<float>(_width);
+        const float sy = (clip.y * invW * 0.5f + 0.5f) * static_cast<float>(_height);
+
+        minX = std::min(minX, sx);
+        maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy);
+        maxY = std::max(maxY, sy);
+        nearestInvW = std::max(nearestInvW, invW);
+    }
+
+    // Off screen is the frustum test's business
+    if(maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(_width) || minY >= static_cast<float>(_height)) {
+        return false;
+    }
+
+    const std::uint32_t x0 = static_cast<std::uint32_t>(std::clamp(minX, 0.0f, static_cast<float>(_width - 1)));
+    const std::uint32_t x1 = static_cast<std::uint32_t>(std::clamp(maxX, 0.0f, static_cast<float>(_width - 1)));
+    const std::uint32_t y0 = static_cast<std::uint32_t>(std::clamp(minY, 0.0f, static_cast<float>(_height - 1)));
+    const std::uint32_t y1 = static_cast<std::uint32_t>(std::clamp(maxY, 0.0f, static_cast<float>(_height - 1)));
+
+    // Coarsest level where the rect spans at most 2x2 texels
+    std::uint32_t level = 0;
+    while(level + 1 < _levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    const std::uint32_t levelWidth = GetLevelWidth(level);
+    const std::uint32_t levelHeight = GetLevelHeight(level);
+    const std::vector<float>& depth = _levels[level];
+
+    for(std::uint32_t y = std::min(y0 >> level, levelHeight - 1); y <= std::min(y1 >> level, levelHeight - 1); y++) {
+        for(std::uint32_t x = std::min(x0 >> level, levelWidth - 1); x <= std::min(x1 >> level, levelWidth - 1); x++) {
+            if(depth[y * levelWidth + x] <= nearestInvW) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+float OcclusionBuffer::GetDepth(std::uint32_t x, std::uint32_t y, std::uint32_t level) const {
+    return _levels[level][y * GetLevelWidth(level) + x];
+}
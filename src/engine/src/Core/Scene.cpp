@@ -1,9 +1,22 @@
 #include "Core/Scene.hpp"
 #include "Core/Camera.hpp"
 #include "Core/Light.hpp"
+#include "Components/CameraComponent.hpp"
+
+Scene::Scene() {
+    _transformHierarchy.Attach(_registry);
+    _spatialIndex.Attach(_registry);
+    _visibilitySet.Attach(_registry);
+}
 
 void Scene::SetActiveCamera(const Camera& camera) {
     _activeCamera = camera.GetEntity();
+
+    // The systems look the camera up through the flag, only one camera is active at a time
+    const auto cameraView = _registry.view<CameraComponent>();
+    for(entt::entity cameraEntity : cameraView) {
+        cameraView.get<CameraComponent>(cameraEntity)._isActive = cameraEntity == _activeCamera;
+    }
 }
 
 bool Scene::GetActiveCamera(Camera& camera) {
@@ -26,3 +39,19 @@ Light* Scene::GetLight() {
     
     return nullptr;
 }
+
+entt::entity Scene::GetActiveCameraEntity() {
+    const auto cameraView = _registry.view<CameraComponent>();
+    for(entt::entity cameraEntity : cameraView) {
+        if(cameraView.get<CameraComponent>(cameraEntity)._isActive) {
+            return cameraEntity;
+        }
+    }
+
+    return entt::null;
+}
+
+CameraComponent* Scene::GetActiveCameraComponent() {
+    const entt::entity cameraEntity = GetActiveCameraEntity();
+    return cameraEntity != entt::null ? &_registry.get<CameraComponent>(cameraEntity) : nullptr;
+}
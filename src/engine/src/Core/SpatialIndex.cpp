@@ -0,0 +1,110 @@
+#include "Core/SpatialIndex.hpp"
+#include "Core/TransformHierarchy.hpp"
+#include "Components/BoundsComponent.hpp"
+#include "Components/TransformComponent.hpp"
+
+namespace {
+    constexpr std::size_t BulkInsertMin = 1024;
+}
+
+void SpatialIndex::Attach(entt::registry& registry) {
+    registry.on_construct<BoundsComponent>().connect<&SpatialIndex::OnBoundsConstructed>(this);
+    registry.on_destroy<BoundsComponent>().connect<&SpatialIndex::OnBoundsDestroyed>(this);
+}
+
+void SpatialIndex::OnBoundsConstructed(entt::registry& registry, entt::entity entity) {
+    // The world matrix might not be computed yet, the next update inserts it
+    _pendingEntities.push_back(entity);
+}
+
+void SpatialIndex::OnBoundsDestroyed(entt::registry& registry, entt::entity entity) {
+    auto it = _proxies.find(entity);
+    if(it == _proxies.end()) {
+        return;
+    }
+
+    _tree.Remove(it->second);
+    _proxies.erase(it);
+}
+
+void SpatialIndex::Update(entt::registry& registry, const TransformHierarchy& hierarchy) {
+    // A big import is cheaper to build top down once than to insert leaf by leaf
+    const bool bBulkInsert = _pendingEntities.size() >= BulkInsertMin && _pendingEntities.size() >= _tree.GetLeafCount();
+
+    for(entt::entity entity : _pendingEntities) {
+        InsertOrMove(registry, entity, bBulkInsert);
+    }
+    _pendingEntities.clear();
+
+    for(entt::entity entity : hierarchy.GetUpdatedEntities()) {
+        InsertOrMove(registry, entity, bBulkInsert);
+    }
+
+    if(bBulkInsert) {
+        _tree.Rebuild();
+    }
+}
+
+void SpatialIndex::InsertOrMove(entt::registry& registry, entt::entity entity, bool bDeferred) {
+    if(!registry.valid(entity)) {
+        return;
+    }
+
+    const BoundsComponent* bounds = registry.try_get<BoundsComponent>(entity);
+    const TransformComponent* transform = registry.try_get<TransformComponent>(entity);
+    if(!bounds || !transform || !transform->_computedMatrix) {
+        return;
+    }
+
+    const AABB worldBounds = AABB::Transform(transform->_computedMatrix.value(), {bounds->_min, bounds->_max});
+
+    std::int32_t proxy;
+    if(auto it = _proxies.find(entity); it != _proxies.end()) {
+        proxy = it->second;
+        _tree.Move(proxy, worldBounds);
+    }
+    else {
+        proxy = bDeferred ? _tree.InsertDeferred(worldBounds, entity) : _tree.Insert(worldBounds, entity);
+        _proxies[entity] = proxy;
+    }
+
+    if(proxy >= static_cast<std::int32_t>(_worldBounds.size())) {
+        _worldBounds.resize(proxy + 1);
+    }
+
+    _worldBounds[proxy] = worldBounds;
+}
+
+void SpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<entt::entity>& entities, std::vector<std::uint8_t>* bFullyInside) const {
+    _tree.QueryFrustum(frustum, [&](entt::entity entity, std::int32_t proxy, bool bInside) {
+        entities.push_back(entity);
+
+        if(bFullyInside) {
+            bFullyInside->push_back(bInside ? 1 : 0);
+        }
+    });
+}
+
+void SpatialIndex::QueryAABB(const AABB& box, std::vector<entt::entity>& entities) const {
+    _tree.QueryAABB(box, [&](entt::entity entity, std::int32_t proxy) {
+        if(box.Overlaps(_worldBounds[proxy])) {
+            entities.push_back(entity);
+        }
+    });
+}
+
+std::optional<RaycastHit> SpatialIndex::Raycast(const Ray& ray, float maxDistance) const {
+    std::optional<RaycastHit> hit;
+
+    _tree.Raycast(ray, maxDistance, [&](entt::entity entity, std::int32_t proxy, float currentMax) {
+        float distance = 0.0f;
+        if(!ray.Intersects(_worldBounds[proxy], currentMax, distance)) {
+            return currentMax;
+        }
+
+        hit = RaycastHit{entity, distance};
+        return distance;
+    });
+
+    return hit;
+}
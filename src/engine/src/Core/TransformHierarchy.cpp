@@ -0,0 +1,305 @@
+#include "Core/TransformHierarchy.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Core/JobSystem.hpp"
+#include <array>
+#include <numeric>
+
+namespace {
+    // Below this many nodes scheduling costs more than the matrix work
+    constexpr std::uint32_t ParallelUpdateThreshold = 4096;
+
+    // A node writes one float to each local transform array and a whole 64 byte matrix, 16 nodes keep a chunk's float
+    // writes on lines of their own so workers don't false share them
+    constexpr std::size_t NodeGrainSize = 16;
+
+    // Products handed to the matrix kernels at once, the pointers fit on the stack
+    constexpr std::size_t MultiplyBatchSize = 64;
+}
+
+void TransformHierarchy::Attach(entt::registry& registry) {
+    registry.on_construct<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(this);
+    registry.on_destroy<TransformComponent>().connect<&TransformHierarchy::OnStructureChanged>(this);
+    registry.on_update<TransformComponent>().connect<&TransformHierarchy::OnTransformUpdated>(this);
+}
+
+void TransformHierarchy::MarkDirty(entt::entity entity) {
+    // A pending rebuild recomputes everything anyway, the indices are stale until then
+    if(_bStructureDirty) {
+        return;
+    }
+
+    auto it = _indices.find(entity);
+    if(it == _indices.end()) {
+        return;
+    }
+
+    const std::uint32_t index = it->second;
+    if(!_dirtyFlags[index]) {
+        _dirtyFlags[index] = 1;
+        _dirtyNodes.push_back(index);
+    }
+}
+
+void TransformHierarchy::OnStructureChanged(entt::registry& registry, entt::entity entity) {
+    _bStructureDirty = true;
+}
+
+void TransformHierarchy::OnTransformUpdated(entt::registry& registry, entt::entity entity) {
+    MarkDirty(entity);
+}
+
+void TransformHierarchy::Update(entt::registry& registry) {
+    _updatedEntities.clear();
+
+    if(_bStructureDirty) {
+        Rebuild(registry);
+        UpdateRange(0, static_cast<std::uint32_t>(_entities.size()));
+
+        std::fill(_dirtyFlags.begin(), _dirtyFlags.end(), 0);
+        _dirtyNodes.clear();
+        _bStructureDirty = false;
+        return;
+    }
+
+    if(_dirtyNodes.empty()) {
+        return;
+    }
+
+    // Sorted nodes let us skip the ones that sit inside a subtree we already recomputed
+    std::sort(_dirtyNodes.begin(), _dirtyNodes.end());
+
+    std::uint32_t processedEnd = 0;
+    for(std::uint32_t index : _dirtyNodes) {
+        _dirtyFlags[index] = 0;
+
+        if(index < processedEnd) {
+            continue;
+        }
+
+        processedEnd = index + _subtreeSizes[index];
+        UpdateRange(index, processedEnd);
+    }
+
+    _dirtyNodes.clear();
+}
+
+void TransformHierarchy::Rebuild(entt::registry& registry) {
+    _entities.clear();
+    _components.clear();
+    _parents.clear();
+    _depths.clear();
+    _subtreeSizes.clear();
+    _indices.clear();
+
+    auto view = registry.view<TransformComponent>();
+
+    // Children are referenced by component id, resolve them to entities once
+    std::unordered_map<std::uint32_t, entt::entity> entitiesById;
+    entitiesById.reserve(view.size());
+    for(entt::entity entity : view) {
+        entitiesById[view.get<TransformComponent>(entity)._id] = entity;
+    }
+
+    std::unordered_set<entt::entity> hasParent;
+    for(entt::entity entity : view) {
+        for(std::uint32_t child : view.get<TransformComponent>(entity)._childs) {
+            if(auto it = entitiesById.find(child); it != entitiesById.end()) {
+                hasParent.insert(it->second);
+            }
+        }
+    }
+
+    _entities.reserve(view.size());
+    _components.reserve(view.size());
+    _parents.reserve(view.size());
+    _depths.reserve(view.size());
+    _subtreeSizes.reserve(view.size());
+
+    // Iterative depth first traversal, transforms without a parent are roots even when not flagged as such
+    std::vector<std::pair<entt::entity, std::int32_t>> stack;
+    auto visit = [&](entt::entity root) {
+        stack.emplace_back(root, -1);
+        while(!stack.empty()) {
+            const auto [entity, parent] = stack.back();
+            stack.pop_back();
+
+            // Guards against malformed hierarchies where a transform is listed by more than one parent
+            if(_indices.contains(entity)) {
+                continue;
+            }
+
+            const auto index = static_cast<std::uint32_t>(_entities.size());
+            TransformComponent* component = &view.get<TransformComponent>(entity);
+
+            _indices[entity] = index;
+            _entities.push_back(entity);
+            _components.push_back(component);
+            _parents.push_back(parent);
+            _depths.push_back(parent >= 0 ? _depths[parent] + 1 : 0);
+            _subtreeSizes.push_back(1);
+
+            // Reversed so children keep their declaration order once popped
+            for(auto it = component->_childs.rbegin(); it != component->_childs.rend(); ++it) {
+                if(auto child = entitiesById.find(*it); child != entitiesById.end()) {
+                    stack.emplace_back(child->second, static_cast<std::int32_t>(index));
+                }
+            }
+        }
+    };
+
+    for(entt::entity root : view) {
+        if(!hasParent.contains(root)) {
+            visit(root);
+        }
+    }
+
+    // Transforms in a cycle have no root to be reached from, the cycle is broken where it is first found so they are
+    // still updated
+    if(_entities.size() != view.size()) {
+        std::cerr << "Transform hierarchy: " << view.size() - _entities.size() << " transforms are part of a parent cycle" << std::endl;
+        assert(0 && "Transform hierarchy has a parent cycle");
+
+        for(entt::entity entity : view) {
+            if(!_indices.contains(entity)) {
+                visit(entity);
+            }
+        }
+    }
+
+    // Children come after their parents, walking backwards accumulates the subtree sizes bottom up
+    for(std::size_t i = _entities.size(); i-- > 0;) {
+        if(_parents[i] >= 0) {
+            _subtreeSizes[_parents[i]] += _subtreeSizes[i];
+        }
+    }
+
+    _worldMatrices.resize(_entities.size());
+    _localMatrices.resize(_entities.size());
+    _localTransforms.Resize(_entities.size());
+    _dirtyFlags.assign(_entities.size(), 0);
+}
+
+void TransformHierarchy::UpdateRange(std::uint32_t begin, std::uint32_t end) {
+    if(begin >= end) {
+        return;
+    }
+
+    _updatedEntities.insert(_updatedEntities.end(), _entities.begin() + begin, _entities.begin() + end);
+
+    const std::uint32_t count = end - begin;
+    if(count < ParallelUpdateThreshold) {
+        ComposeLocalMatrices(begin, end);
+
+        // Parents sit before their children, so by the time a node is reached its parent world matrix is final
+        _levelNodes.resize(count);
+        std::iota(_levelNodes.begin(), _levelNodes.end(), begin);
+        ComposeWorldMatrices(_levelNodes.data(), count);
+
+        return;
+    }
+
+    JobSystem& jobSystem = JobSystem::Get();
+
+    // Local matrices do not depend on each other
+    jobSystem.ParallelFor(count, NodeGrainSize, [this, begin](std::size_t chunkBegin, std::size_t chunkEnd) {
+        ComposeLocalMatrices(begin + static_cast<std::uint32_t>(chunkBegin), begin + static_cast<std::uint32_t>(chunkEnd));
+    });
+
+    // Counting sort by depth, stable so the nodes of a level keep their memory order
+    std::uint32_t minDepth = _depths[begin];
+    std::uint32_t maxDepth = _depths[begin];
+    for(std::uint32_t i = begin; i < end; i++) {
+        minDepth = std::min(minDepth, _depths[i]);
+        maxDepth = std::max(maxDepth, _depths[i]);
+    }
+
+    const std::uint32_t levelCount = maxDepth - minDepth + 1;
+    _levelOffsets.assign(levelCount + 1, 0);
+    for(std::uint32_t i = begin; i < end; i++) {
+        _levelOffsets[_depths[i] - minDepth + 1]++;
+    }
+
+    for(std::uint32_t level = 0; level < levelCount; level++) {
+        _levelOffsets[level + 1] += _levelOffsets[level];
+    }
+
+    _levelNodes.resize(count);
+    std::vector<std::uint32_t> cursor(_levelOffsets.begin(), _levelOffsets.end() - 1);
+    for(std::uint32_t i = begin; i < end; i++) {
+        _levelNodes[cursor[_depths[i] - minDepth]++] = i;
+    }
+
+    // Level k only reads the world matrices of level k - 1, which are final once the previous ParallelFor returned
+    for(std::uint32_t level = 0; level < levelCount; level++) {
+        const std::uint32_t levelBegin = _levelOffsets[level];
+        const std::uint32_t levelSize = _levelOffsets[level + 1] - levelBegin;
+
+        jobSystem.ParallelFor(levelSize, NodeGrainSize, [this, levelBegin](std::size_t chunkBegin, std::size_t chunkEnd) {
+            ComposeWorldMatrices(&_levelNodes[levelBegin + chunkBegin], chunkEnd - chunkBegin);
+        });
+    }
+}
+
+void TransformHierarchy::ComposeLocalMatrices(std::uint32_t begin, std::uint32_t end) {
+    for(std::uint32_t i = begin; i < end; i++) {
+        const TransformComponent* component = _components[i];
+        _localTransforms._positionX[i] = component->m_Position.x;
+        _localTransforms._positionY[i] = component->m_Position.y;
+        _localTransforms._positionZ[i] = component->m_Position.z;
+        _localTransforms._rotationX[i] = component->m_Rotation.x;
+        _localTransforms._rotationY[i] = component->m_Rotation.y;
+        _localTransforms._rotationZ[i] = component->m_Rotation.z;
+        _localTransforms._rotationW[i] = component->m_Rotation.w;
+        _localTransforms._scaleX[i] = component->m_Scale.x;
+        _localTransforms._scaleY[i] = component->m_Scale.y;
+        _localTransforms._scaleZ[i] = component->m_Scale.z;
+    }
+
+    // Translate * rotate * scale for the whole range, every entry is independent
+    TransformKernels::ComposeLocal(_isa, _localTransforms, begin, end, &_localMatrices[begin][0][0]);
+
+    // The imported matrix is applied on top of the editable transform
+    std::array<const float*, MultiplyBatchSize> importedMatrices;
+    std::array<float*, MultiplyBatchSize> localMatrices;
+    for(std::uint32_t batchBegin = begin; batchBegin < end; batchBegin += MultiplyBatchSize) {
+        const std::uint32_t batchSize = std::min<std::uint32_t>(MultiplyBatchSize, end - batchBegin);
+        for(std::uint32_t i = 0; i < batchSize; i++) {
+            importedMatrices[i] = &_components[batchBegin + i]->_matrix[0][0];
+            localMatrices[i] = &_localMatrices[batchBegin + i][0][0];
+        }
+
+        TransformKernels::MultiplyMatrices(_isa, importedMatrices.data(), localMatrices.data(), localMatrices.data(), batchSize);
+    }
+}
+
+void TransformHierarchy::ComposeWorldMatrices(const std::uint32_t* nodes, std::size_t count) {
+    std::array<const float*, MultiplyBatchSize> parentMatrices;
+    std::array<const float*, MultiplyBatchSize> localMatrices;
+    std::array<float*, MultiplyBatchSize> worldMatrices;
+    std::size_t batchSize = 0;
+
+    // Roots are copied right away, no pending product writes them. A child queued after its parent reads the parent
+    // once the batch ran it, the products run in order
+    for(std::size_t i = 0; i < count; i++) {
+        const std::uint32_t index = nodes[i];
+        const std::int32_t parent = _parents[index];
+        if(parent < 0) {
+            _worldMatrices[index] = _localMatrices[index];
+            continue;
+        }
+
+        parentMatrices[batchSize] = &_worldMatrices[parent][0][0];
+        localMatrices[batchSize] = &_localMatrices[index][0][0];
+        worldMatrices[batchSize] = &_worldMatrices[index][0][0];
+        if(++batchSize == MultiplyBatchSize) {
+            TransformKernels::MultiplyMatrices(_isa, parentMatrices.data(), localMatrices.data(), worldMatrices.data(), batchSize);
+            batchSize = 0;
+        }
+    }
+
+    TransformKernels::MultiplyMatrices(_isa, parentMatrices.data(), localMatrices.data(), worldMatrices.data(), batchSize);
+
+    for(std::size_t i = 0; i < count; i++) {
+        _components[nodes[i]]->_computedMatrix = _worldMatrices[nodes[i]];
+    }
+}
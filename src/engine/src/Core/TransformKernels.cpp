@@ -0,0 +1,404 @@
+#include "Core/TransformKernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define TRANSFORM_KERNELS_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define TARGET_AVX2
+    #else
+        #define TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+    #define TRANSFORM_KERNELS_NEON 1
+    #include <arm_neon.h>
+#endif
+
+void TransformSoA::Resize(std::size_t size) {
+    for(std::vector<float>* component : {&_positionX, &_positionY, &_positionZ, &_rotationX, &_rotationY, &_rotationZ, &_scaleX, &_scaleY, &_scaleZ}) {
+        component->resize(size, 0.0f);
+    }
+
+    _rotationW.resize(size, 1.0f);
+}
+
+namespace {
+    // Column major T * R * S for a single transform, the reference every SIMD version has to match
+    void ComposeScalar(const TransformSoA& t, std::size_t i, float* m) {
+        const float x = t._rotationX[i], y = t._rotationY[i], z = t._rotationZ[i], w = t._rotationW[i];
+        const float xx = x * x, yy = y * y, zz = z * z;
+        const float xy = x * y, xz = x * z, yz = y * z;
+        const float wx = w * x, wy = w * y, wz = w * z;
+
+        m[0] = (1.0f - 2.0f * (yy + zz)) * t._scaleX[i];
+        m[1] = 2.0f * (xy + wz) * t._scaleX[i];
+        m[2] = 2.0f * (xz - wy) * t._scaleX[i];
+        m[3] = 0.0f;
+
+        m[4] = 2.0f * (xy - wz) * t._scaleY[i];
+        m[5] = (1.0f - 2.0f * (xx + zz)) * t._scaleY[i];
+        m[6] = 2.0f * (yz + wx) * t._scaleY[i];
+        m[7] = 0.0f;
+
+        m[8] = 2.0f * (xz + wy) * t._scaleZ[i];
+        m[9] = 2.0f * (yz - wx) * t._scaleZ[i];
+        m[10] = (1.0f - 2.0f * (xx + yy)) * t._scaleZ[i];
+        m[11] = 0.0f;
+
+        m[12] = t._positionX[i];
+        m[13] = t._positionY[i];
+        m[14] = t._positionZ[i];
+        m[15] = 1.0f;
+    }
+
+    void MultiplyScalar(const float* lhs, const float* rhs, float* out) {
+        float result[16];
+        for(int column = 0; column < 4; column++) {
+            for(int row = 0; row < 4; row++) {
+                result[column * 4 + row] = lhs[row] * rhs[column * 4] + lhs[4 + row] * rhs[column * 4 + 1]
+                    + lhs[8 + row] * rhs[column * 4 + 2] + lhs[12 + row] * rhs[column * 4 + 3];
+            }
+        }
+
+        std::memcpy(out, result, sizeof(result));
+    }
+
+    // The single product kernels inline into the loop, AVX2 has its own since it needs the target attribute
+    template<void (*Multiply)(const float*, const float*, float*)>
+    void MultiplyBatch(const float* const* lhs, const float* const* rhs, float* const* out, std::size_t count) {
+        for(std::size_t i = 0; i < count; i++) {
+            Multiply(lhs[i], rhs[i], out[i]);
+        }
+    }
+
+#if TRANSFORM_KERNELS_X86
+    // The SIMD versions hold matrix entry k of every lane in one register, a 4x4 transpose of the entries of one column
+    // turns them into that column for each lane
+    void StoreColumnsSSE(__m128 r0, __m128 r1, __m128 r2, __m128 r3, int column, float* matrices) {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(matrices + column * 4, r0);
+        _mm_storeu_ps(matrices + 16 + column * 4, r1);
+        _mm_storeu_ps(matrices + 32 + column * 4, r2);
+        _mm_storeu_ps(matrices + 48 + column * 4, r3);
+    }
+
+    void ComposeSSE(const TransformSoA& t, std::size_t i, float* matrices) {
+        const __m128 x = _mm_loadu_ps(&t._rotationX[i]), y = _mm_loadu_ps(&t._rotationY[i]);
+        const __m128 z = _mm_loadu_ps(&t._rotationZ[i]), w = _mm_loadu_ps(&t._rotationW[i]);
+        const __m128 sx = _mm_loadu_ps(&t._scaleX[i]), sy = _mm_loadu_ps(&t._scaleY[i]), sz = _mm_loadu_ps(&t._scaleZ[i]);
+        const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+
+        const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        StoreColumnsSSE(_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+                        zero, 0, matrices);
+        StoreColumnsSSE(_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+                        zero, 1, matrices);
+        StoreColumnsSSE(_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+                        _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+                        _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+                        zero, 2, matrices);
+        StoreColumnsSSE(_mm_loadu_ps(&t._positionX[i]), _mm_loadu_ps(&t._positionY[i]), _mm_loadu_ps(&t._positionZ[i]), one, 3, matrices);
+    }
+
+    void MultiplySSE(const float* lhs, const float* rhs, float* out) {
+        const __m128 c0 = _mm_loadu_ps(lhs), c1 = _mm_loadu_ps(lhs + 4), c2 = _mm_loadu_ps(lhs + 8), c3 = _mm_loadu_ps(lhs + 12);
+
+        __m128 result[4];
+        for(int column = 0; column < 4; column++) {
+            const float* r = rhs + column * 4;
+            __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(r[0]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(r[1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(r[2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_set1_ps(r[3])));
+            result[column] = sum;
+        }
+
+        for(int column = 0; column < 4; column++) {
+            _mm_storeu_ps(out + column * 4, result[column]);
+        }
+    }
+
+    // Unpack and shuffle work inside each 128 bit half, the low half transposes lanes 0-3 and the high half lanes 4-7
+    TARGET_AVX2 void StoreColumnsAVX2(__m256 r0, __m256 r1, __m256 r2, __m256 r3, int column, float* matrices) {
+        const __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+        const __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+
+        const __m256 columns[4] = {
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+            _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+        };
+
+        for(int lane = 0; lane < 4; lane++) {
+            _mm_storeu_ps(matrices + lane * 16 + column * 4, _mm256_castps256_ps128(columns[lane]));
+            _mm_storeu_ps(matrices + (lane + 4) * 16 + column * 4, _mm256_extractf128_ps(columns[lane], 1));
+        }
+    }
+
+    TARGET_AVX2 void ComposeAVX2(const TransformSoA& t, std::size_t i, float* matrices) {
+        const __m256 x = _mm256_loadu_ps(&t._rotationX[i]), y = _mm256_loadu_ps(&t._rotationY[i]);
+        const __m256 z = _mm256_loadu_ps(&t._rotationZ[i]), w = _mm256_loadu_ps(&t._rotationW[i]);
+        const __m256 sx = _mm256_loadu_ps(&t._scaleX[i]), sy = _mm256_loadu_ps(&t._scaleY[i]), sz = _mm256_loadu_ps(&t._scaleZ[i]);
+        const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), minusTwo = _mm256_set1_ps(-2.0f);
+
+        const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        StoreColumnsAVX2(_mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(yy, zz), one), sx),
+                         _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                         _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                         zero, 0, matrices);
+        StoreColumnsAVX2(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                         _mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(xx, zz), one), sy),
+                         _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                         zero, 1, matrices);
+        StoreColumnsAVX2(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                         _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                         _mm256_mul_ps(_mm256_fmadd_ps(minusTwo, _mm256_add_ps(xx, yy), one), sz),
+                         zero, 2, matrices);
+        StoreColumnsAVX2(_mm256_loadu_ps(&t._positionX[i]), _mm256_loadu_ps(&t._positionY[i]), _mm256_loadu_ps(&t._positionZ[i]), one, 3, matrices);
+    }
+
+    // Two result columns per 256 bit register
+    TARGET_AVX2 void MultiplyAVX2(const float* lhs, const float* rhs, float* out) {
+        const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs));
+        const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 4));
+        const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 8));
+        const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(lhs + 12));
+
+        __m256 result[2];
+        for(int pair = 0; pair < 2; pair++) {
+            const float* r0 = rhs + pair * 8;
+            const float* r1 = r0 + 4;
+
+            __m256 sum = _mm256_mul_ps(c0, _mm256_setr_m128(_mm_set1_ps(r0[0]), _mm_set1_ps(r1[0])));
+            sum = _mm256_fmadd_ps(c1, _mm256_setr_m128(_mm_set1_ps(r0[1]), _mm_set1_ps(r1[1])), sum);
+            sum = _mm256_fmadd_ps(c2, _mm256_setr_m128(_mm_set1_ps(r0[2]), _mm_set1_ps(r1[2])), sum);
+            sum = _mm256_fmadd_ps(c3, _mm256_setr_m128(_mm_set1_ps(r0[3]), _mm_set1_ps(r1[3])), sum);
+            result[pair] = sum;
+        }
+
+        _mm256_storeu_ps(out, result[0]);
+        _mm256_storeu_ps(out + 8, result[1]);
+    }
+
+    TARGET_AVX2 void MultiplyBatchAVX2(const float* const* lhs, const float* const* rhs, float* const* out, std::size_t count) {
+        for(std::size_t i = 0; i < count; i++) {
+            MultiplyAVX2(lhs[i], rhs[i], out[i]);
+        }
+    }
+
+    bool CpuSupportsAVX2() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if(info[0] < 7) {
+            return false;
+        }
+
+        __cpuid(info, 1);
+        const bool bHasFMA = (info[2] & (1 << 12)) != 0;
+        const bool bHasOSXSave = (info[2] & (1 << 27)) != 0;
+        if(!bHasFMA || !bHasOSXSave || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #endif
+    }
+#endif
+
+#if TRANSFORM_KERNELS_NEON
+    void StoreColumnsNEON(float32x4_t r0, float32x4_t r1, float32x4_t r2, float32x4_t r3, int column, float* matrices) {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+
+        vst1q_f32(matrices + column * 4, vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])));
+        vst1q_f32(matrices + 16 + column * 4, vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])));
+        vst1q_f32(matrices + 32 + column * 4, vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])));
+        vst1q_f32(matrices + 48 + column * 4, vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])));
+    }
+
+    void ComposeNEON(const TransformSoA& t, std::size_t i, float* matrices) {
+        const float32x4_t x = vld1q_f32(&t._rotationX[i]), y = vld1q_f32(&t._rotationY[i]);
+        const float32x4_t z = vld1q_f32(&t._rotationZ[i]), w = vld1q_f32(&t._rotationW[i]);
+        const float32x4_t sx = vld1q_f32(&t._scaleX[i]), sy = vld1q_f32(&t._scaleY[i]), sz = vld1q_f32(&t._scaleZ[i]);
+        const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f);
+
+        const float32x4_t xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+        const float32x4_t xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+        const float32x4_t wx = vmulq_f32(w, x), wy = vmulq_f32(w, y), wz = vmulq_f32(w, z);
+
+        StoreColumnsNEON(vmulq_f32(vmlsq_n_f32(one, vaddq_f32(yy, zz), 2.0f), sx),
+                         vmulq_f32(vmulq_n_f32(vaddq_f32(xy, wz), 2.0f), sx),
+                         vmulq_f32(vmulq_n_f32(vsubq_f32(xz, wy), 2.0f), sx),
+                         zero, 0, matrices);
+        StoreColumnsNEON(vmulq_f32(vmulq_n_f32(vsubq_f32(xy, wz), 2.0f), sy),
+                         vmulq_f32(vmlsq_n_f32(one, vaddq_f32(xx, zz), 2.0f), sy),
+                         vmulq_f32(vmulq_n_f32(vaddq_f32(yz, wx), 2.0f), sy),
+                         zero, 1, matrices);
+        StoreColumnsNEON(vmulq_f32(vmulq_n_f32(vaddq_f32(xz, wy), 2.0f), sz),
+                         vmulq_f32(vmulq_n_f32(vsubq_f32(yz, wx), 2.0f), sz),
+                         vmulq_f32(vmlsq_n_f32(one, vaddq_f32(xx, yy), 2.0f), sz),
+                         zero, 2, matrices);
+        StoreColumnsNEON(vld1q_f32(&t._positionX[i]), vld1q_f32(&t._positionY[i]), vld1q_f32(&t._positionZ[i]), one, 3, matrices);
+    }
+
+    void MultiplyNEON(const float* lhs, const float* rhs, float* out) {
+        const float32x4_t c0 = vld1q_f32(lhs), c1 = vld1q_f32(lhs + 4), c2 = vld1q_f32(lhs + 8), c3 = vld1q_f32(lhs + 12);
+
+        float32x4_t result[4];
+        for(int column = 0; column < 4; column++) {
+            const float32x4_t r = vld1q_f32(rhs + column * 4);
+            float32x4_t sum = vmulq_laneq_f32(c0, r, 0);
+            sum = vfmaq_laneq_f32(sum, c1, r, 1);
+            sum = vfmaq_laneq_f32(sum, c2, r, 2);
+            sum = vfmaq_laneq_f32(sum, c3, r, 3);
+            result[column] = sum;
+        }
+
+        for(int column = 0; column < 4; column++) {
+            vst1q_f32(out + column * 4, result[column]);
+        }
+    }
+#endif
+}
+
+bool TransformKernels::IsSupported(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Scalar:
+            return true;
+#if TRANSFORM_KERNELS_X86
+        case SimdIsa::SSE:
+            return true;
+        case SimdIsa::AVX2: {
+            static const bool bSupportsAVX2 = CpuSupportsAVX2();
+            return bSupportsAVX2;
+        }
+#endif
+#if TRANSFORM_KERNELS_NEON
+        case SimdIsa::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+SimdIsa TransformKernels::GetBestIsa() {
+    static const SimdIsa bestIsa = [] {
+        for(SimdIsa isa : {SimdIsa::AVX2, SimdIsa::NEON, SimdIsa::SSE}) {
+            if(IsSupported(isa)) {
+                return isa;
+            }
+        }
+
+        return SimdIsa::Scalar;
+    }();
+
+    return bestIsa;
+}
+
+const char* TransformKernels::GetIsaName(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::SSE:
+            return "SSE";
+        case SimdIsa::AVX2:
+            return "AVX2";
+        case SimdIsa::NEON:
+            return "NEON";
+        default:
+            return "Scalar";
+    }
+}
+
+void TransformKernels::ComposeLocal(SimdIsa isa, const TransformSoA& transforms, std::size_t begin, std::size_t end, float* matrices) {
+    if(!IsSupported(isa)) {
+        assert(0 && "Instruction set not supported by this CPU");
+        isa = SimdIsa::Scalar;
+    }
+
+    std::size_t i = begin;
+
+#if TRANSFORM_KERNELS_X86
+    if(isa == SimdIsa::AVX2) {
+        for(; i + 8 <= end; i += 8) {
+            ComposeAVX2(transforms, i, matrices + (i - begin) * 16);
+        }
+    }
+
+    if(isa == SimdIsa::SSE || isa == SimdIsa::AVX2) {
+        for(; i + 4 <= end; i += 4) {
+            ComposeSSE(transforms, i, matrices + (i - begin) * 16);
+        }
+    }
+#endif
+
+#if TRANSFORM_KERNELS_NEON
+    if(isa == SimdIsa::NEON) {
+        for(; i + 4 <= end; i += 4) {
+            ComposeNEON(transforms, i, matrices + (i - begin) * 16);
+        }
+    }
+#endif
+
+    // Tail that does not fill a whole register
+    for(; i < end; i++) {
+        ComposeScalar(transforms, i, matrices + (i - begin) * 16);
+    }
+}
+
+void TransformKernels::MultiplyMatrix(SimdIsa isa, const float* lhs, const float* rhs, float* out) {
+    switch (isa) {
+#if TRANSFORM_KERNELS_X86
+        case SimdIsa::AVX2:
+            MultiplyAVX2(lhs, rhs, out);
+            return;
+        case SimdIsa::SSE:
+            MultiplySSE(lhs, rhs, out);
+            return;
+#endif
+#if TRANSFORM_KERNELS_NEON
+        case SimdIsa::NEON:
+            MultiplyNEON(lhs, rhs, out);
+            return;
+#endif
+        default:
+            MultiplyScalar(lhs, rhs, out);
+            return;
+    }
+}
+
+void TransformKernels::MultiplyMatrices(SimdIsa isa, const float* const* lhs, const float* const* rhs, float* const* out, std::size_t count) {
+    switch (isa) {
+#if TRANSFORM_KERNELS_X86
+        case SimdIsa::AVX2:
+            MultiplyBatchAVX2(lhs, rhs, out, count);
+            return;
+        case SimdIsa::SSE:
+            MultiplyBatch<MultiplySSE>(lhs, rhs, out, count);
+            return;
+#endif
+#if TRANSFORM_KERNELS_NEON
+        case SimdIsa::NEON:
+            MultiplyBatch<MultiplyNEON>(lhs, rhs, out, count);
+            return;
+#endif
+        default:
+            MultiplyBatch<MultiplyScalar>(lhs, rhs, out, count);
+            return;
+    }
+}
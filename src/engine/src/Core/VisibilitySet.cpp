@@ -0,0 +1,213 @@
+#include "Core/VisibilitySet.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/SpatialIndex.hpp"
+#include "Components/BoundsComponent.hpp"
+#include "Components/PrimitiveProxyComponent.hpp"
+#include "Components/TransformComponent.hpp"
+
+namespace {
+    // Below this many primitives scheduling costs more than the plane tests
+    constexpr std::size_t ParallelCullThreshold = 4096;
+
+    // The culling jobs write one byte flag per primitive, 64 of them keep each chunk's flags on a cache line of its own
+    constexpr std::size_t BoundsGrainSize = 64;
+
+    // Low resolution is enough, only big occluders are drawn and the pyramid is tested conservatively
+    constexpr std::uint32_t OcclusionBufferWidth = 256;
+    constexpr std::uint32_t OcclusionBufferHeight = 128;
+
+    // Occluders must cover at least this much of the view (bounding sphere radius over distance)
+    constexpr float MinOccluderSize = 0.1f;
+    constexpr std::size_t MaxOccluders = 32;
+    constexpr std::size_t MaxOccluderTriangles = 32768; // Summed over every occluder
+}
+
+void VisibilitySet::Attach(entt::registry& registry) {
+    registry.on_construct<PrimitiveProxyComponent>().connect<&VisibilitySet::OnPrimitiveConstructed>(this);
+    registry.on_destroy<PrimitiveProxyComponent>().connect<&VisibilitySet::OnPrimitiveDestroyed>(this);
+    registry.on_construct<BoundsComponent>().connect<&VisibilitySet::OnBoundsConstructed>(this);
+    registry.on_destroy<BoundsComponent>().connect<&VisibilitySet::OnBoundsDestroyed>(this);
+}
+
+void VisibilitySet::OnPrimitiveConstructed(entt::registry& registry, entt::entity entity) {
+    if(!registry.all_of<BoundsComponent>(entity)) {
+        _unboundedPrimitives.insert(entity);
+    }
+}
+
+void VisibilitySet::OnPrimitiveDestroyed(entt::registry& registry, entt::entity entity) {
+    _unboundedPrimitives.erase(entity);
+}
+
+void VisibilitySet::OnBoundsConstructed(entt::registry& registry, entt::entity entity) {
+    _unboundedPrimitives.erase(entity);
+}
+
+void VisibilitySet::OnBoundsDestroyed(entt::registry& registry, entt::entity entity) {
+    if(registry.all_of<PrimitiveProxyComponent>(entity)) {
+        _unboundedPrimitives.insert(entity);
+    }
+}
+
+void VisibilitySet::Update(entt::registry& registry, const SpatialIndex& spatialIndex, const std::optional<glm::mat4>& viewProjection) {
+    _visibleEntities.clear();
+
+    if(!viewProjection) {
+        for(entt::entity entity : registry.view<PrimitiveProxyComponent>()) {
+            _visibleEntities.push_back(entity);
+        }
+        return;
+    }
+
+    const Frustum frustum = Frustum::FromViewProjection(viewProjection.value());
+
+    _queryEntities.clear();
+    _queryFullyInside.clear();
+    spatialIndex.QueryFrustum(frustum, _queryEntities, &_queryFullyInside);
+
+    _candidates.clear();
+    _transforms.clear();
+    _localBounds.clear();
+
+    for(std::size_t i = 0; i < _queryEntities.size(); i++) {
+        const entt::entity entity = _queryEntities[i];
+
+        // The index also holds bounds that are not drawn, or not uploaded yet
+        if(!registry.all_of<PrimitiveProxyComponent>(entity)) {
+            continue;
+        }
+
+        if(_queryFullyInside[i]) {
+            _visibleEntities.push_back(entity);
+            continue;
+        }
+
+        _candidates.push_back(entity);
+        _transforms.push_back(&registry.get<TransformComponent>(entity));
+        _localBounds.push_back(&registry.get<BoundsComponent>(entity));
+    }
+
+    _visibleEntities.insert(_visibleEntities.end(), _unboundedPrimitives.begin(), _unboundedPrimitives.end());
+
+    const std::size_t count = _candidates.size();
+    if(count > 0) {
+        _worldBounds.Resize(count);
+        _visibleFlags.resize(count);
+
+        if(count < ParallelCullThreshold) {
+            CullRange(frustum, 0, count);
+        }
+        else {
+            JobSystem::Get().ParallelFor(count, BoundsGrainSize, [this, &frustum](std::size_t begin, std::size_t end) {
+                CullRange(frustum, begin, end);
+            });
+        }
+
+        for(std::size_t i = 0; i < count; i++) {
+            if(_visibleFlags[i]) {
+                _visibleEntities.push_back(_candidates[i]);
+            }
+        }
+    }
+
+    if(_bOcclusionCulling) {
+        CullOccluded(registry, viewProjection.value());
+    }
+}
+
+void VisibilitySet::CullRange(const Frustum& frustum, std::size_t begin, std::size_t end) {
+    for(std::size_t i = begin; i < end; i++) {
+        FrustumCulling::TransformBounds(_transforms[i]->_computedMatrix.value(), *_localBounds[i], _worldBounds, i);
+    }
+
+    FrustumCulling::Cull(_isa, frustum, _worldBounds, begin, end, &_visibleFlags[begin]);
+}
+
+void VisibilitySet::CullOccluded(entt::registry& registry, const glm::mat4& viewProjection) {
+    _occluders.clear();
+    _occlusionCandidates.clear();
+    _occlusionBounds.clear();
+
+    for(entt::entity entity : _visibleEntities) {
+        const BoundsComponent* bounds = registry.try_get<BoundsComponent>(entity);
+        if(!bounds) {
+            continue;
+        }
+
+        const glm::mat4& matrix = registry.get<TransformComponent>(entity)._computedMatrix.value();
+        _occlusionCandidates.push_back(entity);
+        _occlusionBounds.push_back(AABB::Transform(matrix, {bounds->_min, bounds->_max}));
+
+        // Rough screen size, a primitive around the camera is the best occluder there is
+        const AABB& worldBounds = _occlusionBounds.back();
+        const glm::vec4 center = viewProjection * glm::vec4(worldBounds.GetCenter(), 1.0f);
+        const float size = glm::length(worldBounds.GetExtents()) / std::max(std::abs(center.w), 0.01f);
+        if(size >= MinOccluderSize && registry.all_of<PrimitiveProxyComponentCPU>(entity)) {
+            _occluders.emplace_back(size, entity);
+        }
+    }
+
+    if(_occluders.empty()) {
+        return;
+    }
+
+    std::sort(_occluders.begin(), _occluders.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    if(_occlusionBuffer.GetWidth() == 0) {
+        _occlusionBuffer.Resize(OcclusionBufferWidth, OcclusionBufferHeight);
+    }
+
+    _occlusionBuffer.Clear();
+
+    std::size_t triangles = 0;
+    for(std::size_t i = 0; i < _occluders.size() && i < MaxOccluders; i++) {
+        const entt::entity entity = _occluders[i].second;
+        const auto& geometry = registry.get<PrimitiveProxyComponentCPU>(entity);
+        const std::span<const VertexData> vertices = geometry.GetVertexData();
+        const std::span<const unsigned int> indices = geometry.GetIndices();
+        if(vertices.empty() || triangles + indices.size() / 3 > MaxOccluderTriangles) {
+            continue;
+        }
+
+        triangles += indices.size() / 3;
+
+        const glm::mat4 clipMatrix = viewProjection * registry.get<TransformComponent>(entity)._computedMatrix.value();
+        _occlusionBuffer.RasterizeTriangles(_isa, clipMatrix, &vertices[0].position.x, sizeof(VertexData), indices.data(), indices.size());
+    }
+
+    _occlusionBuffer.BuildPyramid();
+
+    // Only reads the pyramid, the candidates can be tested in any order
+    const std::size_t count = _occlusionCandidates.size();
+    _occludedFlags.resize(count);
+
+    auto TestRange = [this, &viewProjection](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; i++) {
+            _occludedFlags[i] = _occlusionBuffer.IsOccluded(viewProjection, _occlusionBounds[i]) ? 1 : 0;
+        }
+    };
+
+    if(count < ParallelCullThreshold) {
+        TestRange(0, count);
+    }
+    else {
+        JobSystem::Get().ParallelFor(count, BoundsGrainSize, TestRange);
+    }
+
+    // The candidates are the visible list minus the unbounded primitives, in the same order
+    std::size_t candidate = 0;
+    std::size_t visibleCount = 0;
+    for(entt::entity entity : _visibleEntities) {
+        if(candidate < count && _occlusionCandidates[candidate] == entity) {
+            if(_occludedFlags[candidate++]) {
+                continue;
+            }
+        }
+
+        _visibleEntities[visibleCount++] = entity;
+    }
+
+    _visibleEntities.resize(visibleCount);
+}
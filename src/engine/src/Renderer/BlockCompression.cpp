@@ -0,0 +1,502 @@
+#include "Renderer/BlockCompression.hpp"
+#include <cmath>
+#include <limits>
+
+namespace {
+    template<std::size_t Channels>
+    using Point = std::array<float, Channels>;
+
+    using Block = std::array<Point<4>, 16>;
+
+    // BC7 interpolation weights for 4 bit indices, out of 64
+    constexpr std::array<int, 16> Bc7Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Texels past the right and bottom edges repeat the last column and row
+    void FetchBlock(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint32_t blockX, std::uint32_t blockY, Block& texels) {
+        for(std::uint32_t y = 0; y < 4; y++) {
+            const std::uint32_t row = std::min(blockY * 4 + y, height - 1);
+            for(std::uint32_t x = 0; x < 4; x++) {
+                const std::uint32_t column = std::min(blockX * 4 + x, width - 1);
+                const std::uint8_t* texel = rgba + (static_cast<std::size_t>(row) * width + column) * 4;
+                for(std::size_t channel = 0; channel < 4; channel++) {
+                    texels[y * 4 + x][channel] = texel[channel];
+                }
+            }
+        }
+    }
+
+    template<std::size_t Channels>
+    float GetDistance(const Point<4>& texel, const Point<Channels>& color) {
+        float distance = 0.0f;
+        for(std::size_t channel = 0; channel < Channels; channel++) {
+            const float delta = texel[channel] - color[channel];
+            distance += delta * delta;
+        }
+        return distance;
+    }
+
+    // The texels at both ends of the direction the first Channels components vary the most along
+    template<std::size_t Channels>
+    void FitEndpoints(const Block& texels, Point<Channels>& e0, Point<Channels>& e1) {
+        Point<Channels> mean {};
+        for(const Point<4>& texel : texels) {
+            for(std::size_t channel = 0; channel < Channels; channel++) {
+                mean[channel] += texel[channel] / 16.0f;
+            }
+        }
+
+        float covariance[Channels][Channels] = {};
+        for(const Point<4>& texel : texels) {
+            for(std::size_t i = 0; i < Channels; i++) {
+                for(std::size_t j = 0; j < Channels; j++) {
+                    covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+                }
+            }
+        }
+
+        // Power iteration, started from the row of the channel with the largest variance so it is never orthogonal
+        // to the answer
+        std::size_t widest = 0;
+        for(std::size_t channel = 1; channel < Channels; channel++) {
+            if(covariance[channel][channel] > covariance[widest][widest]) {
+                widest = channel;
+            }
+        }
+
+        Point<Channels> axis;
+        for(std::size_t channel = 0; channel < Channels; channel++) {
+            axis[channel] = covariance[widest][channel];
+        }
+
+        for(int iteration = 0; iteration < 8; iteration++) {
+            Point<Channels> next {};
+            float length = 0.0f;
+            for(std::size_t i = 0; i < Channels; i++) {
+                for(std::size_t j = 0; j < Channels; j++) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+                length = std::max(length, std::abs(next[i]));
+            }
+
+            // Flat block, any texel is both ends
+            if(length < 1e-6f) {
+                break;
+            }
+
+            for(std::size_t channel = 0; channel < Channels; channel++) {
+                axis[channel] = next[channel] / length;
+            }
+        }
+
+        float minimum = std::numeric_limits<float>::max();
+        float maximum = std::numeric_limits<float>::lowest();
+        for(const Point<4>& texel : texels) {
+            float projection = 0.0f;
+            for(std::size_t channel = 0; channel < Channels; channel++) {
+                projection += texel[channel] * axis[channel];
+            }
+
+            if(projection < minimum) {
+                minimum = projection;
+                std::copy_n(texel.begin(), Channels, e0.begin());
+            }
+            if(projection > maximum) {
+                maximum = projection;
+                std::copy_n(texel.begin(), Channels, e1.begin());
+            }
+        }
+    }
+
+    /**
+     *  Endpoints with the least squared error for fixed interpolation weights (0 is all e0, 1 all e1), the refinement
+     * step after the indices were picked. False when every texel uses the same weight and there is no single answer
+     */
+    template<std::size_t Channels>
+    bool SolveEndpoints(const Block& texels, const std::array<float, 16>& weights, Point<Channels>& e0, Point<Channels>& e1) {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        Point<Channels> x0 {}, x1 {};
+        for(std::size_t i = 0; i < 16; i++) {
+            const float t = weights[i];
+            const float s = 1.0f - t;
+            a += s * s;
+            b += s * t;
+            c += t * t;
+            for(std::size_t channel = 0; channel < Channels; channel++) {
+                x0[channel] += s * texels[i][channel];
+                x1[channel] += t * texels[i][channel];
+            }
+        }
+
+        const float determinant = a * c - b * b;
+        if(std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        for(std::size_t channel = 0; channel < Channels; channel++) {
+            e0[channel] = std::clamp((c * x0[channel] - b * x1[channel]) / determinant, 0.0f, 255.0f);
+            e1[channel] = std::clamp((a * x1[channel] - b * x0[channel]) / determinant, 0.0f, 255.0f);
+        }
+
+        return true;
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(std::uint8_t* block)
+            : _block(block) {
+        }
+
+        void Write(std::uint32_t value, std::uint32_t count) {
+            for(std::uint32_t i = 0; i < count; i++, _bit++) {
+                _block[_bit / 8] |= static_cast<std::uint8_t>(((value >> i) & 1) << (_bit % 8));
+            }
+        }
+
+    private:
+        std::uint8_t* _block;
+        std::size_t _bit = 0;
+    };
+
+    std::uint16_t Quantize565(const Point<3>& color) {
+        const auto r = static_cast<std::uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+        const auto g = static_cast<std::uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+        const auto b = static_cast<std::uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+        return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    Point<3> Expand565(std::uint16_t color) {
+        const int r = color >> 11;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        return {static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2)};
+    }
+
+    // Writes the BC1 color block for two endpoints, returns its squared error
+    float EncodeColorEndpoints(const Block& texels, std::uint16_t c0, std::uint16_t c1, std::uint8_t* block) {
+        // c0 > c1 selects the 4 color mode, equal endpoints would be 3 colors plus transparent black so only index 0 is used
+        if(c0 < c1) {
+            std::swap(c0, c1);
+        }
+
+        const Point<3> p0 = Expand565(c0);
+        const Point<3> p1 = Expand565(c1);
+        std::array<Point<3>, 4> palette = {p0, p1};
+        for(std::size_t channel = 0; channel < 3; channel++) {
+            palette[2][channel] = std::floor((2.0f * p0[channel] + p1[channel]) / 3.0f);
+            palette[3][channel] = std::floor((p0[channel] + 2.0f * p1[channel]) / 3.0f);
+        }
+
+        const std::size_t paletteSize = c0 == c1 ? 1 : 4;
+        std::uint32_t indices = 0;
+        float error = 0.0f;
+        for(std::size_t i = 0; i < 16; i++) {
+            std::uint32_t best = 0;
+            float bestDistance = GetDistance<3>(texels[i], palette[0]);
+            for(std::uint32_t index = 1; index < paletteSize; index++) {
+                const float distance = GetDistance<3>(texels[i], palette[index]);
+                if(distance < bestDistance) {
+                    bestDistance = distance;
+                    best = index;
+                }
+            }
+
+            indices |= best << (i * 2);
+            error += bestDistance;
+        }
+
+        std::memcpy(block, &c0, 2);
+        std::memcpy(block + 2, &c1, 2);
+        std::memcpy(block + 4, &indices, 4);
+        return error;
+    }
+
+    void EncodeBc1Block(const Block& texels, std::uint8_t* block) {
+        Point<3> e0, e1;
+        FitEndpoints<3>(texels, e0, e1);
+        float error = EncodeColorEndpoints(texels, Quantize565(e0), Quantize565(e1), block);
+
+        // Weight toward the second endpoint of each index
+        constexpr std::array<float, 4> IndexWeights = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        for(int iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+            std::uint32_t indices;
+            std::memcpy(&indices, block + 4, 4);
+
+            std::array<float, 16> weights;
+            for(std::size_t i = 0; i < 16; i++) {
+                weights[i] = IndexWeights[(indices >> (i * 2)) & 3];
+            }
+
+            if(!SolveEndpoints<3>(texels, weights, e0, e1)) {
+                break;
+            }
+
+            std::uint8_t candidate[8];
+            const float candidateError = EncodeColorEndpoints(texels, Quantize565(e0), Quantize565(e1), candidate);
+            if(candidateError >= error) {
+                break;
+            }
+
+            std::memcpy(block, candidate, sizeof(candidate));
+            error = candidateError;
+        }
+    }
+
+    // One channel between its extremes in 8 levels, the alpha of BC3 and both channels of BC5
+    void EncodeBc4Block(const Block& texels, std::size_t channel, std::uint8_t* block) {
+        int minimum = 255;
+        int maximum = 0;
+        for(const Point<4>& texel : texels) {
+            minimum = std::min(minimum, static_cast<int>(texel[channel]));
+            maximum = std::max(maximum, static_cast<int>(texel[channel]));
+        }
+
+        block[0] = static_cast<std::uint8_t>(maximum);
+        block[1] = static_cast<std::uint8_t>(minimum);
+
+        std::uint64_t indices = 0;
+        if(maximum > minimum) {
+            std::array<int, 8> palette = {maximum, minimum};
+            for(int index = 2; index < 8; index++) {
+                palette[index] = ((8 - index) * maximum + (index - 1) * minimum) / 7;
+            }
+
+            for(std::size_t i = 0; i < 16; i++) {
+                const int value = static_cast<int>(texels[i][channel]);
+                std::uint64_t best = 0;
+                for(std::uint64_t index = 1; index < 8; index++) {
+                    if(std::abs(palette[index] - value) < std::abs(palette[best] - value)) {
+                        best = index;
+                    }
+                }
+                indices |= best << (i * 3);
+            }
+        }
+
+        for(std::size_t byte = 0; byte < 6; byte++) {
+            block[2 + byte] = static_cast<std::uint8_t>(indices >> (byte * 8));
+        }
+    }
+
+    // 7 bits per channel plus a shared lowest bit, whichever of the two lands closer
+    void QuantizeBc7Endpoint(const Point<4>& endpoint, std::array<int, 4>& color, int& pbit) {
+        float bestError = std::numeric_limits<float>::max();
+        for(int p = 0; p < 2; p++) {
+            std::array<int, 4> candidate;
+            float error = 0.0f;
+            for(std::size_t channel = 0; channel < 4; channel++) {
+                candidate[channel] = std::clamp(static_cast<int>(std::lround((endpoint[channel] - static_cast<float>(p)) / 2.0f)), 0, 127);
+                const float delta = static_cast<float>(candidate[channel] << 1 | p) - endpoint[channel];
+                error += delta * delta;
+            }
+
+            if(error < bestError) {
+                bestError = error;
+                color = candidate;
+                pbit = p;
+            }
+        }
+    }
+
+    // Writes a mode 6 block for two endpoints, returns its squared error
+    float EncodeBc7Endpoints(const Block& texels, const Point<4>& e0, const Point<4>& e1, std::uint8_t* block, std::array<std::uint8_t, 16>& indices) {
+        std::array<std::array<int, 4>, 2> colors;
+        std::array<int, 2> pbits;
+        QuantizeBc7Endpoint(e0, colors[0], pbits[0]);
+        QuantizeBc7Endpoint(e1, colors[1], pbits[1]);
+
+        std::array<Point<4>, 16> palette;
+        for(std::size_t index = 0; index < 16; index++) {
+            for(std::size_t channel = 0; channel < 4; channel++) {
+                const int a = colors[0][channel] << 1 | pbits[0];
+                const int b = colors[1][channel] << 1 | pbits[1];
+                palette[index][channel] = static_cast<float>(((64 - Bc7Weights[index]) * a + Bc7Weights[index] * b + 32) >> 6);
+            }
+        }
+
+        float error = 0.0f;
+        for(std::size_t i = 0; i < 16; i++) {
+            std::uint8_t best = 0;
+            float bestDistance = GetDistance<4>(texels[i], palette[0]);
+            for(std::uint8_t index = 1; index < 16; index++) {
+                const float distance = GetDistance<4>(texels[i], palette[index]);
+                if(distance < bestDistance) {
+                    bestDistance = distance;
+                    best = index;
+                }
+            }
+
+            indices[i] = best;
+            error += bestDistance;
+        }
+
+        // The first index is stored without its top bit, swapping the endpoints makes it 0
+        if(indices[0] & 8) {
+            std::swap(colors[0], colors[1]);
+            std::swap(pbits[0], pbits[1]);
+            for(std::uint8_t& index : indices) {
+                index = static_cast<std::uint8_t>(15 - index);
+            }
+        }
+
+        std::memset(block, 0, 16);
+        BitWriter writer(block);
+        writer.Write(1 << 6, 7); // Mode 6
+        for(std::size_t channel = 0; channel < 4; channel++) {
+            writer.Write(static_cast<std::uint32_t>(colors[0][channel]), 7);
+            writer.Write(static_cast<std::uint32_t>(colors[1][channel]), 7);
+        }
+        writer.Write(static_cast<std::uint32_t>(pbits[0]), 1);
+        writer.Write(static_cast<std::uint32_t>(pbits[1]), 1);
+        writer.Write(indices[0], 3);
+        for(std::size_t i = 1; i < 16; i++) {
+            writer.Write(indices[i], 4);
+        }
+
+        return error;
+    }
+
+    void EncodeBc7Block(const Block& texels, std::uint8_t* block) {
+        Point<4> e0, e1;
+        FitEndpoints<4>(texels, e0, e1);
+
+        std::array<std::uint8_t, 16> indices;
+        float error = EncodeBc7Endpoints(texels, e0, e1, block, indices);
+
+        for(int iteration = 0; iteration < 2 && error > 0.0f; iteration++) {
+            std::array<float, 16> weights;
+            for(std::size_t i = 0; i < 16; i++) {
+                weights[i] = static_cast<float>(Bc7Weights[indices[i]]) / 64.0f;
+            }
+
+            if(!SolveEndpoints<4>(texels, weights, e0, e1)) {
+                break;
+            }
+
+            std::uint8_t candidate[16];
+            std::array<std::uint8_t, 16> candidateIndices;
+            const float candidateError = EncodeBc7Endpoints(texels, e0, e1, candidate, candidateIndices);
+            if(candidateError >= error) {
+                break;
+            }
+
+            std::memcpy(block, candidate, sizeof(candidate));
+            indices = candidateIndices;
+            error = candidateError;
+        }
+    }
+}
+
+bool BlockCompression::IsCompressed(Format format) {
+    return GetBlockSize(format) > 0;
+}
+
+std::size_t BlockCompression::GetBlockSize(Format format) {
+    switch(format) {
+        case Format::FORMAT_BC1_RGBA_SRGB:
+            return 8;
+        case Format::FORMAT_BC3_SRGB:
+        case Format::FORMAT_BC5_UNORM:
+        case Format::FORMAT_BC7_SRGB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+std::size_t BlockCompression::GetTexelSize(Format format) {
+    switch(format) {
+        case Format::FORMAT_B8G8R8A8_SRGB:
+        case Format::FORMAT_B8G8R8A8_UNORM:
+        case Format::FORMAT_R8G8B8A8_SRGB:
+        case Format::FORMAT_D32_SFLOAT:
+            return 4;
+        case Format::FORMAT_R8G8B8_SRGB:
+        case Format::FORMAT_R8G8B8_SNORM:
+            return 3;
+        case Format::FORMAT_R8G8_SNORM:
+            return 2;
+        case Format::FORMAT_R32G32_UNORM:
+        case Format::FORMAT_R32G32_SFLOAT:
+            return 8;
+        case Format::FORMAT_R32G32B32_SFLOAT:
+            return 12;
+        default:
+            return 0;
+    }
+}
+
+std::size_t BlockCompression::GetRowPitch(Format format, std::uint32_t width) {
+    if(const std::size_t blockSize = GetBlockSize(format)) {
+        return (width + BlockExtent - 1) / BlockExtent * blockSize;
+    }
+
+    return static_cast<std::size_t>(width) * GetTexelSize(format);
+}
+
+std::uint32_t BlockCompression::GetRowCount(Format format, std::uint32_t height) {
+    return IsCompressed(format) ? (height + BlockExtent - 1) / BlockExtent : height;
+}
+
+std::size_t BlockCompression::GetImageDataSize(Format format, std::uint32_t width, std::uint32_t height) {
+    return GetRowPitch(format, width) * GetRowCount(format, height);
+}
+
+Format BlockCompression::ChooseFormat(TextureCompression compression, const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height) {
+    switch(compression) {
+        case TextureCompression::Color: {
+            const std::size_t texelCount = static_cast<std::size_t>(width) * height;
+            for(std::size_t i = 0; i < texelCount; i++) {
+                if(rgba[i * 4 + 3] != 255) {
+                    return Format::FORMAT_BC3_SRGB;
+                }
+            }
+            return Format::FORMAT_BC1_RGBA_SRGB;
+        }
+        case TextureCompression::ColorHighQuality:
+            return Format::FORMAT_BC7_SRGB;
+        case TextureCompression::TwoChannel:
+            return Format::FORMAT_BC5_UNORM;
+        case TextureCompression::None:
+            break;
+    }
+
+    return Format::FORMAT_R8G8B8A8_SRGB;
+}
+
+void BlockCompression::Compress(Format format, const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint8_t* blocks) {
+    const std::size_t blockSize = GetBlockSize(format);
+    if(blockSize == 0 || width == 0 || height == 0) {
+        assert(0 && "BlockCompression::Compress() - Not a block compressed format or an empty image");
+        return;
+    }
+
+    const std::uint32_t blocksX = (width + BlockExtent - 1) / BlockExtent;
+    const std::uint32_t blocksY = (height + BlockExtent - 1) / BlockExtent;
+
+    Block texels;
+    for(std::uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for(std::uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            FetchBlock(rgba, width, height, blockX, blockY, texels);
+            std::uint8_t* block = blocks + (static_cast<std::size_t>(blockY) * blocksX + blockX) * blockSize;
+
+            switch(format) {
+                case Format::FORMAT_BC1_RGBA_SRGB:
+                    EncodeBc1Block(texels, block);
+                    break;
+                case Format::FORMAT_BC3_SRGB:
+                    EncodeBc4Block(texels, 3, block);
+                    EncodeBc1Block(texels, block + 8);
+                    break;
+                case Format::FORMAT_BC5_UNORM:
+                    EncodeBc4Block(texels, 0, block);
+                    EncodeBc4Block(texels, 1, block + 8);
+                    break;
+                case Format::FORMAT_BC7_SRGB:
+                    EncodeBc7Block(texels, block);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
@@ -14,13 +14,8 @@ GraphBuilder::GraphBuilder(GraphicsContext* graphicsContext)
 void GraphBuilder::AddRasterPass(Scene *scene, RenderPass *renderPass, const RasterRenderFunction &callback) {
     renderPass->Initialize(_graphicsContext);
 
-    // TODO this load textures is happening too soon? Right now we need to assume that we want to load every texture
-    // but the correct thing is to only load if the meshes are going to be used.. not everything needs to be drawn if its not in view
-    // I guess we still need a prestep to decide what resources to load based on visibility, this GetTextureResources could only
-    // return resources that are in the frustrum and are going to be drawn.
-    
-    // New idea, we need a custom compute pass that will identify what entities will be visible, we then load the textures based on that
-    // so this code should be move to that logic and not here, for now it works
+    // Passes only return what the visible primitives sample (see TextureResidency), whatever is not loaded yet is
+    // loaded here and uploaded by the implicit blit before the pass runs
     auto textures = renderPass->GetTextureResources(scene);
 //    auto buffers = renderPass->GetBufferResources(scene);
     
@@ -32,7 +27,7 @@ void GraphBuilder::AddRasterPass(Scene *scene, RenderPass *renderPass, const Ras
     std::ranges::copy(textures, passResourceReads._textures.begin());
 //    std::ranges::copy(buffers, passResourceReads._buffersResources.begin());
     
-    // Load from disk all textures necessary for this pass. TODO: Make it parallel
+    // Uploads the textures of this pass, material textures were decoded in parallel by TextureResidency already
     for (const std::shared_ptr<Texture2D>& texture : passResourceReads._textures) {
         if(texture) {
             texture->Initialize(_graphicsContext->GetDevice());
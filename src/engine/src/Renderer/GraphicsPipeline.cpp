@@ -3,6 +3,7 @@
 #include "Core/GenericFactory.hpp"
 #include "Core/Cache/Cache.hpp"
 #include "Renderer/Shader.hpp"
+#include "Renderer/Texture2D.hpp"
 
 #ifdef VULKAN_BACKEND
 #include "Renderer/Vendor/Vulkan/VKGraphicsPipeline.hpp"
@@ -12,7 +13,159 @@ using ResourceType = VKGraphicsPipeline;
 using ResourceType = WebGPUGraphicsPipeline;
 #endif
 
-static Core::Cache<std::size_t, ResourceType> _cache;
+// Pipelines that were not requested by any pass for a while get dropped from the cache,
+// passes that still hold a reference keep them alive until they release it.
+static constexpr std::size_t MaxCachedPipelines = 64;
+static Core::Cache<std::size_t, ResourceType, Core::CacheLRUPolicy<std::size_t, MaxCachedPipelines>> _cache;
+
+namespace {
+    void HashShaderParams(std::size_t& seed, const ShaderParams& shaderParams) {
+        hash_combine(seed, hash_value(shaderParams._shaderPath));
+        
+        for(const std::string& define : shaderParams._defines) {
+            hash_combine(seed, hash_value(define));
+        }
+        
+        // Unordered map iteration order is not stable, sort the bindings so equal layouts produce the same hash
+        std::vector<const ShaderInputBindings::value_type*> inputBindings;
+        inputBindings.reserve(shaderParams._shaderInputBindings.size());
+        for(const auto& inputBinding : shaderParams._shaderInputBindings) {
+            inputBindings.push_back(&inputBinding);
+        }
+        
+        std::sort(inputBindings.begin(), inputBindings.end(), [](const auto* lhs, const auto* rhs) {
+            return lhs->first < rhs->first;
+        });
+        
+        for(const auto* inputBinding : inputBindings) {
+            hash_combine(seed, inputBinding->first._binding);
+            hash_combine(seed, inputBinding->first._stride);
+            
+            for(const ShaderInputLocation& location : inputBinding->second) {
+                hash_combine(seed, location._format);
+                hash_combine(seed, location._offset);
+            }
+        }
+        
+        // Only the layout of the data streams matters, the bound values change every frame
+        for(const ShaderDataStream& dataStream : shaderParams._shaderDataStreams) {
+            hash_combine(seed, dataStream._usage);
+            hash_combine(seed, dataStream._binding);
+            
+            for(const ShaderDataBlock& dataBlock : dataStream._dataBlocks) {
+                hash_combine(seed, dataBlock._type);
+                hash_combine(seed, dataBlock._size);
+                hash_combine(seed, dataBlock._usage);
+                hash_combine(seed, dataBlock._stage);
+            }
+        }
+    }
+    
+    std::size_t HashPipelineParams(const GraphicsPipelineParams& params) {
+        std::size_t seed = hash_value(params._rasterization);
+        
+        const ColorAttachmentBinding& colorAttachment = params._renderAttachments._colorAttachmentBinding;
+        hash_combine(seed, colorAttachment._texture ? colorAttachment._texture->GetPixelFormat() : Format::FORMAT_UNDEFINED);
+        hash_combine(seed, colorAttachment._blending);
+        hash_combine(seed, colorAttachment._loadAction);
+        
+        const std::optional<DepthStencilAttachmentBinding>& depthAttachment = params._renderAttachments._depthStencilAttachmentBinding;
+        hash_combine(seed, depthAttachment.has_value());
+        if(depthAttachment.has_value()) {
+            hash_combine(seed, depthAttachment->_texture ? depthAttachment->_texture->GetPixelFormat() : Format::FORMAT_UNDEFINED);
+            hash_combine(seed, depthAttachment->_depthLoadAction);
+            hash_combine(seed, depthAttachment->_stencilLoadAction);
+            hash_combine(seed, depthAttachment->_stencilStoreAction);
+        }
+        
+        HashShaderParams(seed, params._vsParams);
+        HashShaderParams(seed, params._fsParams);
+        
+        return seed;
+    }
+    
+    // Same fields as HashShaderParams
+    bool IsSameShaderParams(const ShaderParams& lhs, const ShaderParams& rhs) {
+        if(lhs._shaderPath != rhs._shaderPath || lhs._defines != rhs._defines) {
+            return false;
+        }
+        
+        if(lhs._shaderInputBindings.size() != rhs._shaderInputBindings.size()) {
+            return false;
+        }
+        
+        for(const auto& [binding, locations] : lhs._shaderInputBindings) {
+            auto it = rhs._shaderInputBindings.find(binding);
+            if(it == rhs._shaderInputBindings.end() || it->second.size() != locations.size()) {
+                return false;
+            }
+            
+            for(std::size_t i = 0; i < locations.size(); i++) {
+                if(locations[i]._format != it->second[i]._format || locations[i]._offset != it->second[i]._offset) {
+                    return false;
+                }
+            }
+        }
+        
+        if(lhs._shaderDataStreams.size() != rhs._shaderDataStreams.size()) {
+            return false;
+        }
+        
+        for(std::size_t i = 0; i < lhs._shaderDataStreams.size(); i++) {
+            const ShaderDataStream& lhsStream = lhs._shaderDataStreams[i];
+            const ShaderDataStream& rhsStream = rhs._shaderDataStreams[i];
+            if(lhsStream._usage != rhsStream._usage || lhsStream._binding != rhsStream._binding || lhsStream._dataBlocks.size() != rhsStream._dataBlocks.size()) {
+                return false;
+            }
+            
+            for(std::size_t j = 0; j < lhsStream._dataBlocks.size(); j++) {
+                const ShaderDataBlock& lhsBlock = lhsStream._dataBlocks[j];
+                const ShaderDataBlock& rhsBlock = rhsStream._dataBlocks[j];
+                if(lhsBlock._type != rhsBlock._type || lhsBlock._size != rhsBlock._size || lhsBlock._usage != rhsBlock._usage || lhsBlock._stage != rhsBlock._stage) {
+                    return false;
+                }
+            }
+        }
+        
+        return true;
+    }
+    
+    Format GetAttachmentFormat(const std::shared_ptr<Texture2D>& texture) {
+        return texture ? texture->GetPixelFormat() : Format::FORMAT_UNDEFINED;
+    }
+    
+    // Same fields as HashPipelineParams, a hash collision must not hand out the pipeline of different params
+    bool IsSamePipelineParams(const GraphicsPipelineParams& lhs, const GraphicsPipelineParams& rhs) {
+        const RasterizationConfiguration& lhsRasterization = lhs._rasterization;
+        const RasterizationConfiguration& rhsRasterization = rhs._rasterization;
+        if(lhsRasterization._depthBias != rhsRasterization._depthBias || lhsRasterization._depthBiasSlope != rhsRasterization._depthBiasSlope ||
+           lhsRasterization._depthBiasClamp != rhsRasterization._depthBiasClamp || lhsRasterization._depthCompareOP != rhsRasterization._depthCompareOP ||
+           lhsRasterization._triangleCullMode != rhsRasterization._triangleCullMode || lhsRasterization._triangleWindingOrder != rhsRasterization._triangleWindingOrder) {
+            return false;
+        }
+        
+        const ColorAttachmentBinding& lhsColor = lhs._renderAttachments._colorAttachmentBinding;
+        const ColorAttachmentBinding& rhsColor = rhs._renderAttachments._colorAttachmentBinding;
+        if(GetAttachmentFormat(lhsColor._texture) != GetAttachmentFormat(rhsColor._texture) || lhsColor._loadAction != rhsColor._loadAction ||
+           lhsColor._blending._colorBlending != rhsColor._blending._colorBlending || lhsColor._blending._alphaBlending != rhsColor._blending._alphaBlending ||
+           lhsColor._blending._colorBlendingFactor != rhsColor._blending._colorBlendingFactor || lhsColor._blending._alphaBlendingFactor != rhsColor._blending._alphaBlendingFactor) {
+            return false;
+        }
+        
+        const std::optional<DepthStencilAttachmentBinding>& lhsDepth = lhs._renderAttachments._depthStencilAttachmentBinding;
+        const std::optional<DepthStencilAttachmentBinding>& rhsDepth = rhs._renderAttachments._depthStencilAttachmentBinding;
+        if(lhsDepth.has_value() != rhsDepth.has_value()) {
+            return false;
+        }
+        
+        if(lhsDepth.has_value() && (GetAttachmentFormat(lhsDepth->_texture) != GetAttachmentFormat(rhsDepth->_texture) || lhsDepth->_depthLoadAction != rhsDepth->_depthLoadAction ||
+           lhsDepth->_stencilLoadAction != rhsDepth->_stencilLoadAction || lhsDepth->_stencilStoreAction != rhsDepth->_stencilStoreAction)) {
+            return false;
+        }
+        
+        return IsSameShaderParams(lhs._vsParams, rhs._vsParams) && IsSameShaderParams(lhs._fsParams, rhs._fsParams);
+    }
+}
 
 GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineParams& params)
     : _params(params) {
@@ -21,10 +174,77 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineParams& params)
 GraphicsPipeline::~GraphicsPipeline() {};
 
 std::shared_ptr<GraphicsPipeline> GraphicsPipeline::Create(const GraphicsPipelineParams& params) {
-    std::size_t hash = hash_value(params._rasterization, params._fsParams._shaderPath, params._vsParams._shaderPath);
+    const std::size_t hash = HashPipelineParams(params);
+    
+    std::shared_ptr<ResourceType> pipeline;
+    if(_cache.TryGet(hash, pipeline)) {
+        if(IsSamePipelineParams(pipeline->_params, params)) {
+            return pipeline;
+        }
+        
+        // Left out of the cache, the cached pipeline stays for the params that hash the same
+        std::cerr << "Pipeline cache hash collision for " << params._vsParams._shaderPath << ", " << params._fsParams._shaderPath << std::endl;
+        pipeline = std::make_shared<ResourceType>(params);
+        pipeline->_cacheKey = hash;
+        return pipeline;
+    }
+    
+    pipeline = std::make_shared<ResourceType>(params);
+    pipeline->_cacheKey = hash;
+    _cache.Put(hash, pipeline);
+    
+    return pipeline;
+}
+
+std::vector<std::shared_ptr<GraphicsPipeline>> GraphicsPipeline::GetPipelinesUsingShader(const std::string& shaderPath) {
+    std::vector<std::shared_ptr<GraphicsPipeline>> pipelines;
     
-    _cache.Put(hash, std::make_shared<ResourceType>(params));
-    return _cache.Get(hash);
+    _cache.ForEach([&](std::size_t, const std::shared_ptr<ResourceType>& pipeline) {
+        if(pipeline->_params._vsParams._shaderPath == shaderPath || pipeline->_params._fsParams._shaderPath == shaderPath) {
+            pipelines.push_back(pipeline);
+        }
+    });
+    
+    return pipelines;
+}
+
+std::vector<std::string> GraphicsPipeline::GetCachedShaderPaths() {
+    std::vector<std::string> shaders;
+    
+    _cache.ForEach([&](std::size_t, const std::shared_ptr<ResourceType>& pipeline) {
+        shaders.push_back(pipeline->_params._vsParams._shaderPath);
+        shaders.push_back(pipeline->_params._fsParams._shaderPath);
+    });
+    
+    std::sort(shaders.begin(), shaders.end());
+    shaders.erase(std::unique(shaders.begin(), shaders.end()), shaders.end());
+    
+    return shaders;
+}
+
+std::shared_ptr<GraphicsPipeline> GraphicsPipeline::Rebuild(const GraphicsPipelineParams& params) {
+    std::shared_ptr<ResourceType> pipeline = std::make_shared<ResourceType>(params);
+    pipeline->_cacheKey = HashPipelineParams(params);
+    pipeline->Compile();
+    
+    return pipeline;
+}
+
+void GraphicsPipeline::Replace(const std::shared_ptr<GraphicsPipeline>& pipeline, const std::shared_ptr<GraphicsPipeline>& replacement) {
+    if(!pipeline || !replacement || pipeline->_cacheKey != replacement->_cacheKey) {
+        assert(0 && "Replacement pipeline was built with different params");
+        return;
+    }
+    
+    _cache.Put(pipeline->_cacheKey, std::static_pointer_cast<ResourceType>(replacement), true);
+}
+
+std::size_t GraphicsPipeline::GetCacheHitCount() {
+    return _cache.GetHitCount();
+}
+
+std::size_t GraphicsPipeline::GetCacheMissCount() {
+    return _cache.GetMissCount();
 }
 
 Shader* GraphicsPipeline::GetVertexShader() {
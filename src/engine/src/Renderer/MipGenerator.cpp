@@ -0,0 +1,91 @@
+#include "Renderer/MipGenerator.hpp"
+#include "Renderer/BlockCompression.hpp"
+#include <bit>
+#include <cmath>
+
+namespace {
+    // sRGB to linear in 16 bits and back, the 16 bit side keeps the dark end apart that 8 bits would merge
+    struct SrgbTables {
+        std::array<std::uint16_t, 256> _toLinear {};
+        std::array<std::uint8_t, 65536> _fromLinear {};
+    };
+
+    const SrgbTables& GetSrgbTables() {
+        static const SrgbTables tables = []() {
+            SrgbTables result;
+            for(std::size_t i = 0; i < result._toLinear.size(); i++) {
+                const double srgb = static_cast<double>(i) / 255.0;
+                const double linear = srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+                result._toLinear[i] = static_cast<std::uint16_t>(std::lround(linear * 65535.0));
+            }
+            for(std::size_t i = 0; i < result._fromLinear.size(); i++) {
+                const double linear = static_cast<double>(i) / 65535.0;
+                const double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                result._fromLinear[i] = static_cast<std::uint8_t>(std::lround(srgb * 255.0));
+            }
+            return result;
+        }();
+        return tables;
+    }
+}
+
+std::uint32_t MipGenerator::GetLevelCount(std::uint32_t width, std::uint32_t height) {
+    return std::max<std::uint32_t>(1, static_cast<std::uint32_t>(std::bit_width(std::max(width, height))));
+}
+
+std::uint32_t MipGenerator::GetLevelExtent(std::uint32_t extent, std::uint32_t level) {
+    return std::max<std::uint32_t>(1, extent >> level);
+}
+
+std::size_t MipGenerator::GetLevelOffset(Format format, std::uint32_t width, std::uint32_t height, std::uint32_t level) {
+    return GetChainSize(format, width, height, level);
+}
+
+std::size_t MipGenerator::GetChainSize(Format format, std::uint32_t width, std::uint32_t height, std::uint32_t levelCount) {
+    std::size_t size = 0;
+    for(std::uint32_t level = 0; level < levelCount; level++) {
+        size += BlockCompression::GetImageDataSize(format, GetLevelExtent(width, level), GetLevelExtent(height, level));
+    }
+    return size;
+}
+
+void MipGenerator::Downsample(const std::uint8_t* src, std::uint32_t width, std::uint32_t height, std::uint8_t* dst, bool bSrgb) {
+    const SrgbTables& tables = GetSrgbTables();
+    const std::uint32_t dstWidth = GetLevelExtent(width, 1);
+    const std::uint32_t dstHeight = GetLevelExtent(height, 1);
+    const std::size_t srcPitch = static_cast<std::size_t>(width) * 4;
+
+    for(std::uint32_t y = 0; y < dstHeight; y++) {
+        const std::uint8_t* rows[2] = {src + std::min(y * 2, height - 1) * srcPitch, src + std::min(y * 2 + 1, height - 1) * srcPitch};
+        std::uint8_t* out = dst + static_cast<std::size_t>(y) * dstWidth * 4;
+
+        for(std::uint32_t x = 0; x < dstWidth; x++) {
+            const std::size_t left = static_cast<std::size_t>(std::min(x * 2, width - 1)) * 4;
+            const std::size_t right = static_cast<std::size_t>(std::min(x * 2 + 1, width - 1)) * 4;
+
+            for(std::size_t channel = 0; channel < 4; channel++) {
+                const std::uint8_t a = rows[0][left + channel];
+                const std::uint8_t b = rows[0][right + channel];
+                const std::uint8_t c = rows[1][left + channel];
+                const std::uint8_t d = rows[1][right + channel];
+
+                if(bSrgb && channel < 3) {
+                    const std::uint32_t sum = tables._toLinear[a] + tables._toLinear[b] + tables._toLinear[c] + tables._toLinear[d];
+                    out[x * 4 + channel] = tables._fromLinear[(sum + 2) / 4];
+                } else {
+                    out[x * 4 + channel] = static_cast<std::uint8_t>((a + b + c + d + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+void MipGenerator::GenerateChain(std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint32_t levelCount, bool bSrgb) {
+    // Every level is built from the previous one, the whole chain costs about a third of a pass over the first level
+    const std::uint8_t* src = rgba;
+    for(std::uint32_t level = 1; level < levelCount; level++) {
+        std::uint8_t* dst = rgba + GetLevelOffset(Format::FORMAT_R8G8B8A8_SRGB, width, height, level);
+        Downsample(src, GetLevelExtent(width, level - 1), GetLevelExtent(height, level - 1), dst, bSrgb);
+        src = dst;
+    }
+}
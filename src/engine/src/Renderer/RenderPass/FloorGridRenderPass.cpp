@@ -107,16 +107,13 @@ std::vector<ShaderDataStream> FloorGridRenderPass::GetPopulatedShaderDataStreams
         glm::mat4 projMatrix;
     } data;
     
-    const auto cameraView = scene->GetRegistry().view<CameraComponent>();
-    for(auto cameraEntity : cameraView) {
+    if(const CameraComponent* cameraComponent = scene->GetActiveCameraComponent()) {
         // We should have a viewport abstraction that would know this type of information
         int width = graphicsContext->GetGBufferTexture()._colorTexture->GetWidth();
         int height = graphicsContext->GetGBufferTexture()._colorTexture->GetHeight();
         
-        auto cameraComponent = cameraView.get<CameraComponent>(cameraEntity);
-        data.viewMatrix = cameraComponent.m_ViewMatrix;
-        data.projMatrix = glm::perspective(cameraComponent.m_Fov, ((float)width / (float)height), 0.01f, 1000.f);
-        break;
+        data.viewMatrix = cameraComponent->m_ViewMatrix;
+        data.projMatrix = glm::perspective(cameraComponent->m_Fov, ((float)width / (float)height), 0.01f, 1000.f);
     }
 
     auto dataStreams = CollectShaderDataStreams();
@@ -187,16 +184,13 @@ void FloorGridRenderPass::BindPushConstants(GraphicsContext *graphicsContext, Gr
         glm::mat4 projMatrix;
     } data;
 
-    const auto cameraView = scene->GetRegistry().view<CameraComponent>();
-    for(auto cameraEntity : cameraView) {
+    if(const CameraComponent* cameraComponent = scene->GetActiveCameraComponent()) {
         // We should have a viewport abstraction that would know this type of information
         int width = graphicsContext->GetGBufferTexture()._colorTexture->GetWidth();
         int height = graphicsContext->GetGBufferTexture()._colorTexture->GetHeight();
         
-        auto cameraComponent = cameraView.get<CameraComponent>(cameraEntity);
-        data.viewMatrix = cameraComponent.m_ViewMatrix;
-        data.projMatrix = glm::perspective(cameraComponent.m_Fov, ((float)width / (float)height), 0.01f, 1000.f);
-        break;
+        data.viewMatrix = cameraComponent->m_ViewMatrix;
+        data.projMatrix = glm::perspective(cameraComponent->m_Fov, ((float)width / (float)height), 0.01f, 1000.f);
     }
     
     auto dataStreams = CollectShaderDataStreams();
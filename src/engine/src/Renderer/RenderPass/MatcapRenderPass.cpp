@@ -121,13 +121,9 @@ void MatcapRenderPass::BindPushConstants(GraphicsContext* graphicsContext, Graph
     glm::mat4 viewMatrix;
     glm::mat4 projMatrix;
     
-    const auto cameraView = scene->GetRegistry().view<TransformComponent, CameraComponent>();
-    for(auto cameraEntity : cameraView) {
-        auto [transformComponent, cameraComponent] = cameraView.get<TransformComponent, CameraComponent>(cameraEntity);
-        viewMatrix = cameraComponent.m_ViewMatrix;
-        projMatrix = glm::perspective(cameraComponent.m_Fov, ((float)width / (float)height), 0.1f, 300.f);
-        
-        break;
+    if(const CameraComponent* cameraComponent = scene->GetActiveCameraComponent()) {
+        viewMatrix = cameraComponent->m_ViewMatrix;
+        projMatrix = glm::perspective(cameraComponent->m_Fov, ((float)width / (float)height), cameraComponent->_nearPlane, cameraComponent->_farPlane);
     }
     
     auto view = scene->GetRegistry().view<TransformComponent, MatCapMaterialComponent>();
@@ -220,7 +216,11 @@ void MatcapRenderPass::Process(GraphicsContext* graphicsContext, Encoders encode
     }
 
     unsigned int idx = 0;
-    for(entt::entity entity : view) {
+    for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+        if(!view.contains(entity)) {
+            continue;
+        }
+        
         BindPushConstants(encoders._renderEncoder->GetGraphicsContext(), pipeline, encoders._renderEncoder, scene, entity, idx);
         
         const auto& proxy= view.template get<PrimitiveProxyComponent>(entity);
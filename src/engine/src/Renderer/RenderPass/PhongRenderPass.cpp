@@ -79,8 +79,13 @@ ShaderInputBindings PhongRenderPass::CollectShaderInputBindings() {
     texCoords._format = Format::FORMAT_R32G32_SFLOAT;
     texCoords._offset = offsetof(VertexData, texCoords);
 
+    // Only read by the HAS_VERTEX_COLOR permutation
+    ShaderInputLocation colors = {};
+    colors._format = Format::FORMAT_R32G32B32_SFLOAT;
+    colors._offset = offsetof(VertexData, color);
+
     ShaderInputBindings inputBindings;
-    inputBindings[vertexDataBinding] = {positions, normals, texCoords};
+    inputBindings[vertexDataBinding] = {positions, normals, texCoords, colors};
     return inputBindings;
 }
 
@@ -148,14 +153,51 @@ void PhongRenderPass::Process(GraphicsContext* graphicsContext, Encoders encoder
         }
     }
     
+    // Group the draws by permutation so each pipeline is bound once, idx keeps addressing the per model buffer slot
+    struct Draw {
+        ShaderFeatureKey _features;
+        entt::entity _entity;
+        unsigned int _idx;
+    };
+    
+    std::vector<Draw> draws;
+    draws.reserve(view.handle().size());
+    
+    // Only what survived culling this frame, the visible list holds every primitive so filter to the ones this pass draws
     unsigned int idx = 0;
-    for(entt::entity entity : view) {
-        BindPushConstants(encoders._renderEncoder->GetGraphicsContext(), pipeline, encoders._renderEncoder, scene, entity, idx);
+    for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+        if(!view.contains(entity)) {
+            continue;
+        }
         
-        const auto& proxy= view.template get<PrimitiveProxyComponent>(entity);
-        encoders._renderEncoder->DrawPrimitiveIndexed(proxy);
+        const auto& material = view.template get<PhongMaterialComponent>(entity);
         
-        idx++;
+        // Only ask for what is actually bound, a material without a texture gets the variant without the fetch. A
+        // texture still loading keeps the fetch, it samples the placeholder meanwhile
+        ShaderFeatureKey features = material._shaderFeatures & (SF_DiffuseTexture | SF_VertexColor);
+        if(!material._diffuseTexture) {
+            features &= ~SF_DiffuseTexture;
+        }
+        
+        draws.push_back({features, entity, idx++});
+    }
+    
+    std::stable_sort(draws.begin(), draws.end(), [](const Draw& lhs, const Draw& rhs) {
+        return lhs._features < rhs._features;
+    });
+    
+    GraphicsPipeline* boundPipeline = pipeline;
+    for(const Draw& draw : draws) {
+        GraphicsPipeline* variant = GetPipelineVariant(draw._features);
+        if(variant != boundPipeline) {
+            encoders._renderEncoder->BindPipeline(variant);
+            boundPipeline = variant;
+        }
+        
+        BindPushConstants(encoders._renderEncoder->GetGraphicsContext(), variant, encoders._renderEncoder, scene, draw._entity, draw._idx);
+        
+        const auto& proxy= view.template get<PrimitiveProxyComponent>(draw._entity);
+        encoders._renderEncoder->DrawPrimitiveIndexed(proxy);
     }
 }
 
@@ -174,16 +216,16 @@ void PhongRenderPass::BindPushConstants(GraphicsContext *graphicsContext, Graphi
     glm::vec3 cameraPosition;
     
     // Camera data
-    const auto cameraView = scene->GetRegistry().view<TransformComponent, CameraComponent>();
-    for(auto cameraEntity : cameraView) {
-        auto [transformComponent, cameraComponent] = cameraView.get<TransformComponent, CameraComponent>(cameraEntity);
+    const entt::entity cameraEntity = scene->GetActiveCameraEntity();
+    if(cameraEntity != entt::null) {
+        const auto& cameraComponent = scene->GetRegistry().get<CameraComponent>(cameraEntity);
         viewMatrix = cameraComponent.m_ViewMatrix;
         projMatrix = glm::perspective(cameraComponent.m_Fov, (static_cast<float>(width) / static_cast<float>(height)),
-            0.1f, 300.f);
+            cameraComponent._nearPlane, cameraComponent._farPlane);
         
-        cameraPosition = transformComponent.m_Position;
-        
-        break;
+        if(const auto* transformComponent = scene->GetRegistry().try_get<TransformComponent>(cameraEntity)) {
+            cameraPosition = transformComponent->m_Position;
+        }
     }
     
     // MVP matrix
@@ -242,7 +284,10 @@ void PhongRenderPass::BindPushConstants(GraphicsContext *graphicsContext, Graphi
             }
             if(block._identifier == DIFFUSE_TEXTURE_BLOCK) {
                 ShaderTextureResource shaderTextureResource;
-                shaderTextureResource._texture = scene->GetRegistry().get<PhongMaterialComponent>(entity)._diffuseTexture;
+                shaderTextureResource._texture = scene->GetTextureResidency().Resolve(scene->GetRegistry().get<PhongMaterialComponent>(entity)._diffuseTexture);
+                // Trilinear when minified, decoded material textures come with their mips
+                shaderTextureResource._sampler._minFilter = TextureFilter::LINEAR;
+                shaderTextureResource._sampler._mipMapFilter = TextureFilter::LINEAR;
                 block._data = shaderTextureResource;
             }
         }
@@ -309,10 +354,19 @@ std::string PhongRenderPass::GetVertexShaderPath() {
 
 std::set<std::shared_ptr<Texture2D>> PhongRenderPass::GetTextureResources(Scene* scene) {
     std::set<std::shared_ptr<Texture2D>> textures;
-
-    for(const auto view = scene->GetRegistry().view<PhongMaterialComponent>(); const auto entity : view) {
+    TextureResidency& residency = scene->GetTextureResidency();
+    
+    // Only what a visible primitive samples, the rest loads the first time it comes into view
+    const auto view = scene->GetRegistry().view<PhongMaterialComponent>();
+    for(entt::entity entity : scene->GetVisibilitySet().GetVisibleEntities()) {
+        if(!view.contains(entity)) {
+            continue;
+        }
+        
         const auto& materialComponent = view.get<PhongMaterialComponent>(entity);
-        textures.insert(materialComponent._diffuseTexture);
+        if(materialComponent._diffuseTexture) {
+            textures.insert(residency.Request(materialComponent._diffuseTexture));
+        }
     }
 
     return textures;
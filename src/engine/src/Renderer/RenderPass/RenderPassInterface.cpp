@@ -5,7 +5,7 @@
 #include "Core/Scene.hpp"
 
 namespace {
-    std::pair<ShaderParams, ShaderParams> MakeShaderSet(RenderPass* renderPass) {
+    std::pair<ShaderParams, ShaderParams> MakeShaderSet(RenderPass* renderPass, ShaderFeatureKey features) {
         if(!renderPass) {
             return {};
         }
@@ -16,27 +16,55 @@ namespace {
         vsParams._shaderPath = renderPass->GetVertexShaderPath();
         vsParams._shaderInputBindings = renderPass->CollectShaderInputBindings();
         vsParams._shaderDataStreams = dataStreams;
+        vsParams._defines = ShaderPermutation::GetDefines(features);
         
         ShaderParams fsParams;
         fsParams._shaderPath = renderPass->GetFragmentShaderPath();
         fsParams._shaderDataStreams = dataStreams;
+        fsParams._defines = vsParams._defines;
                 
         return {vsParams, fsParams};
     }
 }
 
 void RenderPass::Initialize(GraphicsContext* graphicsContext) {
+    _pipeline = GraphicsPipeline::Create(MakePipelineParams(graphicsContext, SF_None));
+    _pipeline->Compile();
+    
+    // Variants come from the pipeline cache, dropping them every frame picks up hot reloaded pipelines
+    _pipelineVariants.clear();
+    _pipelineVariants[SF_None] = _pipeline;
+    
+    _graphicsContext = graphicsContext;
+}
+
+GraphicsPipeline* RenderPass::GetPipelineVariant(ShaderFeatureKey features) {
+    auto it = _pipelineVariants.find(features);
+    if(it != _pipelineVariants.end()) {
+        return it->second.get();
+    }
+    
+    std::shared_ptr<GraphicsPipeline> pipeline = GraphicsPipeline::Create(MakePipelineParams(_graphicsContext, features));
+    pipeline->Compile();
+    
+    // A permutation that does not compile falls back to the pass pipeline instead of breaking the whole pass
+    if(!pipeline->IsCompiled()) {
+        pipeline = _pipeline;
+    }
+    
+    _pipelineVariants[features] = pipeline;
+    return pipeline.get();
+}
+
+GraphicsPipelineParams RenderPass::MakePipelineParams(GraphicsContext* graphicsContext, ShaderFeatureKey features) {
     GraphicsPipelineParams params = GetPipelineParams();
     params._renderAttachments = GetRenderAttachments(graphicsContext);
     params._device = graphicsContext->GetDevice();
     params._renderPass = this;
         
-    std::tie(params._vsParams, params._fsParams) = MakeShaderSet(this);
-    
-    _pipeline = GraphicsPipeline::Create(params);
-    _pipeline->Compile();
+    std::tie(params._vsParams, params._fsParams) = MakeShaderSet(this, features);
     
-    _graphicsContext = graphicsContext;
+    return params;
 }
 
 void RenderPass::EnqueueRendering(GraphBuilder* graphBuilder, Scene* scene) {
@@ -2,15 +2,26 @@
 #include "Renderer/RenderPass/RenderPassRegistration.inl"
 #include "Renderer/RenderPass/RenderPassInterface.hpp"
 #include "Renderer/Processors/TransformProcessor.hpp"
+#include "Renderer/Processors/VisibilityProcessor.hpp"
+#include "Renderer/Processors/LodProcessor.hpp"
+#include "Renderer/Processors/MeshletProcessor.hpp"
+#include "Renderer/Processors/TextureStreamingProcessor.hpp"
 #include "Renderer/Processors/GeometryProcessors.hpp"
 #include "Renderer/CommandEncoders/BlitCommandEncoder.hpp"
 #include "Renderer/GraphicsContext.hpp"
+#include "Renderer/Device.hpp"
+#include "Renderer/Texture2D.hpp"
 #include "Core/Scene.hpp"
 #include "window.hpp"
 
 bool RenderSystemV2::Initialize(Window* window) {
     _windowsContexts[window] = 0;
     
+    // Polls the shader files from a worker thread, only wanted while iterating on shaders
+#if defined(VULKAN_BACKEND) && defined(SHADER_HOT_RELOAD)
+    _shaderHotReloader.Start();
+#endif
+    
     return true;
 }
 
@@ -43,6 +54,15 @@ void RenderSystemV2::BeginFrame(GraphicsContext* graphicsContext, Scene* scene)
         return;
     }
     
+    // Pipelines rebuilt after a shader edit are swapped in here, before any pass asks for its pipeline
+    Swapchain* swapchain = graphicsContext->GetDevice()->GetSwapchain();
+    const std::size_t framesInFlight = swapchain ? swapchain->GetImageCount() : 1;
+    _shaderHotReloader.ProcessPendingSwaps(framesInFlight);
+    
+    // Textures not seen for a while are freed before the passes request this frame's ones
+    scene->GetTextureResidency().SetBlockCompression(graphicsContext->GetDevice()->SupportsBlockCompression());
+    scene->GetTextureResidency().BeginFrame(framesInFlight);
+    
     // Create a new graph builder per frame, this as no cost
     _graphBuilder = GraphBuilder(graphicsContext);
     
@@ -63,6 +83,21 @@ void RenderSystemV2::BeginFrame(GraphicsContext* graphicsContext, Scene* scene)
     // Updates all transforms in the scene to be used when rendering
     TransformProcessor::Process(scene);
     
+    // Builds the visible primitive list the passes iterate
+    std::shared_ptr<Texture2D> colorTexture = graphicsContext->GetSwapChainColorTexture();
+    const float aspectRatio = colorTexture && colorTexture->GetHeight() > 0 ? static_cast<float>(colorTexture->GetWidth()) / static_cast<float>(colorTexture->GetHeight()) : 1.0f;
+    VisibilityProcessor::Process(scene, aspectRatio);
+    
+    // Only the visible primitives get a level of detail picked
+    const float viewportHeight = colorTexture ? static_cast<float>(colorTexture->GetHeight()) : 0.0f;
+    LodProcessor::Process(scene, viewportHeight);
+
+    // Texture levels are picked from the same screen sizes, before the passes request the textures
+    TextureStreamingProcessor::Process(scene, viewportHeight);
+    
+    // Primitives drawing their full mesh only keep the meshlets in view and facing the camera
+    MeshletProcessor::Process(scene, aspectRatio);
+    
     graphicsContext->BeginFrame();
 }
 
@@ -0,0 +1,100 @@
+#include "Renderer/ShaderDataPacking.hpp"
+
+namespace {
+    std::uint32_t AlignUp(std::uint32_t value, std::uint32_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+std::pair<std::uint32_t, std::uint32_t> ShaderDataPackingPlan::GetBlockLayout(const ShaderDataBlock& dataBlock) {
+    switch (dataBlock._type) {
+        case PCDT_Float:
+            return {4, 4};
+        case PCDT_Vec3:
+            return {16, 12};
+        case PCDT_Vec4:
+            return {16, 16};
+        case PCDT_Mat4:
+            return {16, 64};
+        case PCDT_ContiguosMemory:
+            // Treated as a struct, std430 aligns it to its largest member, we assume vec4
+            return {16, static_cast<std::uint32_t>(dataBlock._size)};
+        default:
+            return {4, static_cast<std::uint32_t>(dataBlock._size)};
+    }
+}
+
+ShaderDataPackingPlan ShaderDataPackingPlan::Build(const std::vector<ShaderDataStream>& dataStreams, bool bSupportsPushConstants, std::uint32_t maxPushConstantsSize) {
+    ShaderDataPackingPlan plan;
+
+    const std::uint32_t pushConstantsLimit = bSupportsPushConstants ? std::min(maxPushConstantsSize, MaxPushConstantsSize) : 0;
+    bool bSpilling = pushConstantsLimit == 0;
+
+    for(const ShaderDataStream& dataStream : dataStreams) {
+        if(dataStream._usage != ShaderDataStreamUsage::PUSH_CONSTANT) {
+            continue;
+        }
+
+        for(const ShaderDataBlock& dataBlock : dataStream._dataBlocks) {
+            const auto [alignment, size] = GetBlockLayout(dataBlock);
+
+            ShaderDataBlockPlacement placement;
+            placement._size = size;
+            placement._stage = dataBlock._stage;
+
+            // Once one block spills every block after it spills too, this keeps the declaration order on both sides
+            if(!bSpilling) {
+                const std::uint32_t offset = AlignUp(plan._pushConstantsSize, alignment);
+                if(offset + size <= pushConstantsLimit) {
+                    placement._offset = offset;
+                    plan._pushConstantsSize = offset + size;
+                    plan._placements.push_back(placement);
+                    continue;
+                }
+
+                bSpilling = true;
+            }
+
+            placement._offset = AlignUp(plan._spillSize, alignment);
+            placement._bSpilled = true;
+            plan._spillSize = placement._offset + size;
+            plan._spillStages = (ShaderStage)(plan._spillStages | dataBlock._stage);
+            plan._placements.push_back(placement);
+        }
+    }
+
+    // Uniform blocks are sized in multiples of vec4
+    plan._spillSize = AlignUp(plan._spillSize, 16);
+
+    return plan;
+}
+
+void ShaderDataPackingPlan::Pack(const std::vector<ShaderDataStream>& dataStreams, std::byte* pushConstantData, std::byte* spillData) const {
+    std::size_t placementIdx = 0;
+
+    for(const ShaderDataStream& dataStream : dataStreams) {
+        if(dataStream._usage != ShaderDataStreamUsage::PUSH_CONSTANT) {
+            continue;
+        }
+
+        for(const ShaderDataBlock& dataBlock : dataStream._dataBlocks) {
+            if(placementIdx >= _placements.size()) {
+                assert(0 && "Data streams do not match the packing plan");
+                return;
+            }
+
+            const ShaderDataBlockPlacement& placement = _placements[placementIdx++];
+            std::byte* destination = placement._bSpilled ? spillData : pushConstantData;
+            if(!destination) {
+                continue;
+            }
+
+            std::visit([&](const auto& value) {
+                using ValueType = std::decay_t<decltype(value)>;
+                if constexpr (std::is_trivially_copyable_v<ValueType>) {
+                    std::memcpy(destination + placement._offset, &value, std::min<std::size_t>(sizeof(ValueType), placement._size));
+                }
+            }, dataBlock._data);
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "Renderer/ShaderHotReloader.hpp"
+#include "Renderer/GraphicsPipeline.hpp"
+
+#ifdef VULKAN_BACKEND
+#include "Renderer/Vendor/Vulkan/ShaderCompiler.hpp"
+#endif
+
+ShaderHotReloader::~ShaderHotReloader() {
+    Stop();
+}
+
+void ShaderHotReloader::Start(std::chrono::milliseconds pollInterval) {
+    if(_worker.joinable()) {
+        return;
+    }
+
+    _pollInterval = pollInterval;
+    _bRunning = true;
+    _worker = std::thread(&ShaderHotReloader::Run, this);
+}
+
+void ShaderHotReloader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _bRunning = false;
+    }
+
+    _wakeUp.notify_all();
+
+    if(_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+void ShaderHotReloader::ProcessPendingSwaps(std::size_t framesInFlight) {
+    _frame++;
+
+    // A pipeline swapped out at frame N can still be referenced by command buffers of the previous framesInFlight frames
+    std::erase_if(_retiredPipelines, [this, framesInFlight](const RetiredPipeline& retired) {
+        return _frame - retired._frame > framesInFlight;
+    });
+
+    std::vector<PendingSwap> pendingSwaps;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pendingSwaps.swap(_pendingSwaps);
+    }
+
+    for(PendingSwap& swap : pendingSwaps) {
+        GraphicsPipeline::Replace(swap._pipeline, swap._replacement);
+        _retiredPipelines.push_back({ std::move(swap._pipeline), _frame });
+    }
+}
+
+void ShaderHotReloader::Run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while(_bRunning) {
+        _wakeUp.wait_for(lock, _pollInterval, [this] { return !_bRunning; });
+        if(!_bRunning) {
+            break;
+        }
+
+        lock.unlock();
+
+        // New pipelines show up while the application runs, keep the watched set in sync with the cache
+        for(const std::string& path : GraphicsPipeline::GetCachedShaderPaths()) {
+            _watcher.Watch(path);
+        }
+
+        const std::vector<std::string> changedShaders = _watcher.Poll();
+        if(!changedShaders.empty()) {
+            Reload(changedShaders);
+        }
+
+        lock.lock();
+    }
+}
+
+void ShaderHotReloader::Reload(const std::vector<std::string>& changedShaders) {
+    for(const std::string& shaderPath : changedShaders) {
+#ifdef VULKAN_BACKEND
+        // Refresh the compiled binaries first, a pipeline rebuilt from a broken shader would fail anyway
+        if(!ShaderCompiler::Get().Recompile(shaderPath)) {
+            std::cerr << "Shader " << shaderPath << " failed to compile, keeping the last good pipelines" << std::endl;
+            continue;
+        }
+#endif
+
+        std::vector<PendingSwap> swaps;
+        for(const std::shared_ptr<GraphicsPipeline>& pipeline : GraphicsPipeline::GetPipelinesUsingShader(shaderPath)) {
+            std::shared_ptr<GraphicsPipeline> replacement = GraphicsPipeline::Rebuild(pipeline->_params);
+            if(!replacement->IsCompiled()) {
+                std::cerr << "Failed to rebuild pipeline for shader " << shaderPath << ", keeping the last good pipeline" << std::endl;
+                continue;
+            }
+
+            swaps.push_back({ pipeline, std::move(replacement) });
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for(PendingSwap& swap : swaps) {
+            _pendingSwaps.push_back(std::move(swap));
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "Renderer/ShaderPermutation.hpp"
+
+const char* ShaderPermutation::GetDefine(ShaderFeature feature) {
+    switch (feature) {
+        case SF_DiffuseTexture:
+            return "HAS_DIFFUSE_TEXTURE";
+        case SF_VertexColor:
+            return "HAS_VERTEX_COLOR";
+        default:
+            return nullptr;
+    }
+}
+
+std::vector<std::string> ShaderPermutation::GetDefines(ShaderFeatureKey features) {
+    std::vector<std::string> defines;
+
+    for(ShaderFeatureKey bit = 0; bit < SF_Count; bit++) {
+        const auto feature = static_cast<ShaderFeature>(1u << bit);
+        if((features & feature) == 0) {
+            continue;
+        }
+
+        if(const char* define = GetDefine(feature)) {
+            defines.emplace_back(define);
+        }
+    }
+
+    return defines;
+}
+
+std::string ShaderPermutation::InjectDefines(const std::string& source, const std::vector<std::string>& defines) {
+    if(defines.empty()) {
+        return source;
+    }
+
+    std::string defineLines;
+    for(const std::string& define : defines) {
+        defineLines += "#define " + define + "\n";
+    }
+
+    // GLSL requires #version to be the first directive, defines go on the line after it
+    std::size_t insertPosition = 0;
+    const std::size_t versionPosition = source.find("#version");
+    if(versionPosition != std::string::npos) {
+        const std::size_t lineEnd = source.find('\n', versionPosition);
+        if(lineEnd == std::string::npos) {
+            return source + "\n" + defineLines;
+        }
+
+        insertPosition = lineEnd + 1;
+    }
+
+    std::string result = source;
+    result.insert(insertPosition, defineLines);
+    return result;
+}
@@ -0,0 +1,439 @@
+#include "Renderer/ShaderReflection.hpp"
+
+// Minimal SPIR-V parser, only what we need to build pipeline layouts.
+// Reference https://registry.khronos.org/SPIR-V/specs/unified1/SPIRV.html
+
+namespace {
+    constexpr std::uint32_t SpvMagicNumber = 0x07230203;
+    constexpr std::uint32_t SpvHeaderWords = 5;
+    constexpr std::uint32_t SpvInvalidValue = ~0u;
+
+    enum SpvOp : std::uint32_t {
+        SpvOpName = 5,
+        SpvOpTypeBool = 20,
+        SpvOpTypeInt = 21,
+        SpvOpTypeFloat = 22,
+        SpvOpTypeVector = 23,
+        SpvOpTypeMatrix = 24,
+        SpvOpTypeImage = 25,
+        SpvOpTypeSampler = 26,
+        SpvOpTypeSampledImage = 27,
+        SpvOpTypeArray = 28,
+        SpvOpTypeRuntimeArray = 29,
+        SpvOpTypeStruct = 30,
+        SpvOpTypePointer = 32,
+        SpvOpConstant = 43,
+        SpvOpVariable = 59,
+        SpvOpDecorate = 71,
+        SpvOpMemberDecorate = 72
+    };
+
+    enum SpvDecoration : std::uint32_t {
+        SpvDecorationBlock = 2,
+        SpvDecorationBufferBlock = 3,
+        SpvDecorationArrayStride = 6,
+        SpvDecorationMatrixStride = 7,
+        SpvDecorationBinding = 33,
+        SpvDecorationDescriptorSet = 34,
+        SpvDecorationOffset = 35
+    };
+
+    enum SpvStorageClass : std::uint32_t {
+        SpvStorageClassUniformConstant = 0,
+        SpvStorageClassUniform = 2,
+        SpvStorageClassPushConstant = 9,
+        SpvStorageClassStorageBuffer = 12
+    };
+
+    struct SpvMember {
+        std::uint32_t _offset = 0;
+        std::uint32_t _matrixStride = 0;
+    };
+
+    struct SpvId {
+        std::uint32_t _opcode = 0;
+        std::vector<std::uint32_t> _operands; // Type operands, words after the result id
+        std::string _name;
+
+        std::uint32_t _set = SpvInvalidValue;
+        std::uint32_t _binding = SpvInvalidValue;
+        std::uint32_t _arrayStride = 0;
+        bool _bBlock = false;
+        bool _bBufferBlock = false;
+        std::vector<SpvMember> _members;
+
+        // Variables and pointers
+        std::uint32_t _storageClass = SpvInvalidValue;
+        std::uint32_t _typeId = 0;
+
+        // Constants
+        std::uint32_t _value = 0;
+    };
+
+    std::string ReadString(const std::uint32_t* words, std::size_t wordCount) {
+        std::string result;
+        for(std::size_t i = 0; i < wordCount; i++) {
+            for(std::size_t byte = 0; byte < 4; byte++) {
+                const char c = static_cast<char>((words[i] >> (byte * 8)) & 0xFF);
+                if(c == '\0') {
+                    return result;
+                }
+
+                result.push_back(c);
+            }
+        }
+
+        return result;
+    }
+
+    SpvMember& GetMember(SpvId& id, std::uint32_t member) {
+        if(id._members.size() <= member) {
+            id._members.resize(member + 1);
+        }
+
+        return id._members[member];
+    }
+
+    std::uint32_t GetTypeSize(const std::vector<SpvId>& ids, std::uint32_t typeId, std::uint32_t matrixStride = 0, unsigned int depth = 0) {
+        if(typeId >= ids.size() || depth > 32) {
+            return 0;
+        }
+
+        const SpvId& type = ids[typeId];
+        switch (type._opcode) {
+            case SpvOpTypeBool:
+                return 4;
+            case SpvOpTypeInt:
+            case SpvOpTypeFloat:
+                return type._operands.empty() ? 0 : type._operands[0] / 8;
+            case SpvOpTypeVector:
+                return type._operands.size() < 2 ? 0 : GetTypeSize(ids, type._operands[0], 0, depth + 1) * type._operands[1];
+            case SpvOpTypeMatrix: {
+                if(type._operands.size() < 2) {
+                    return 0;
+                }
+
+                const std::uint32_t columnSize = matrixStride > 0 ? matrixStride : GetTypeSize(ids, type._operands[0], 0, depth + 1);
+                return columnSize * type._operands[1];
+            }
+            case SpvOpTypeArray: {
+                if(type._operands.size() < 2 || type._operands[1] >= ids.size()) {
+                    return 0;
+                }
+
+                const std::uint32_t length = ids[type._operands[1]]._value;
+                const std::uint32_t stride = type._arrayStride > 0 ? type._arrayStride : GetTypeSize(ids, type._operands[0], matrixStride, depth + 1);
+                return length * stride;
+            }
+            case SpvOpTypeStruct: {
+                std::uint32_t size = 0;
+                for(std::size_t i = 0; i < type._operands.size(); i++) {
+                    const SpvMember member = i < type._members.size() ? type._members[i] : SpvMember{};
+                    size = std::max(size, member._offset + GetTypeSize(ids, type._operands[i], member._matrixStride, depth + 1));
+                }
+
+                return size;
+            }
+            default:
+                // Runtime arrays and opaque types have no size
+                return 0;
+        }
+    }
+}
+
+bool ShaderReflection::Reflect(const std::vector<unsigned int>& spirv, ShaderStage stage, ShaderReflection& reflection) {
+    if(spirv.size() < SpvHeaderWords || spirv[0] != SpvMagicNumber) {
+        return false;
+    }
+
+    const std::uint32_t bound = spirv[3];
+    std::vector<SpvId> ids(bound);
+    std::vector<std::uint32_t> variables;
+
+    std::size_t offset = SpvHeaderWords;
+    while(offset < spirv.size()) {
+        const std::uint32_t opcode = spirv[offset] & 0xFFFF;
+        const std::uint32_t wordCount = spirv[offset] >> 16;
+
+        if(wordCount == 0 || offset + wordCount > spirv.size()) {
+            return false;
+        }
+
+        const std::uint32_t* operands = spirv.data() + offset + 1;
+        const std::uint32_t operandCount = wordCount - 1;
+        offset += wordCount;
+
+        switch (opcode) {
+            case SpvOpName:
+                if(operandCount >= 2 && operands[0] < bound) {
+                    ids[operands[0]]._name = ReadString(operands + 1, operandCount - 1);
+                }
+                break;
+            case SpvOpDecorate: {
+                if(operandCount < 2 || operands[0] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[0]];
+                const std::uint32_t literal = operandCount >= 3 ? operands[2] : 0;
+
+                switch (operands[1]) {
+                    case SpvDecorationBlock: id._bBlock = true; break;
+                    case SpvDecorationBufferBlock: id._bBufferBlock = true; break;
+                    case SpvDecorationArrayStride: id._arrayStride = literal; break;
+                    case SpvDecorationBinding: id._binding = literal; break;
+                    case SpvDecorationDescriptorSet: id._set = literal; break;
+                    default: break;
+                }
+                break;
+            }
+            case SpvOpMemberDecorate: {
+                if(operandCount < 4 || operands[0] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[0]];
+                if(operands[2] == SpvDecorationOffset) {
+                    GetMember(id, operands[1])._offset = operands[3];
+                }
+
+                if(operands[2] == SpvDecorationMatrixStride) {
+                    GetMember(id, operands[1])._matrixStride = operands[3];
+                }
+                break;
+            }
+            case SpvOpTypeBool:
+            case SpvOpTypeInt:
+            case SpvOpTypeFloat:
+            case SpvOpTypeVector:
+            case SpvOpTypeMatrix:
+            case SpvOpTypeImage:
+            case SpvOpTypeSampler:
+            case SpvOpTypeSampledImage:
+            case SpvOpTypeArray:
+            case SpvOpTypeRuntimeArray:
+            case SpvOpTypeStruct: {
+                if(operandCount < 1 || operands[0] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[0]];
+                id._opcode = opcode;
+                id._operands.assign(operands + 1, operands + operandCount);
+                break;
+            }
+            case SpvOpTypePointer: {
+                if(operandCount < 3 || operands[0] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[0]];
+                id._opcode = opcode;
+                id._storageClass = operands[1];
+                id._typeId = operands[2];
+                break;
+            }
+            case SpvOpConstant: {
+                if(operandCount < 3 || operands[1] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[1]];
+                id._opcode = opcode;
+                id._typeId = operands[0];
+                id._value = operands[2];
+                break;
+            }
+            case SpvOpVariable: {
+                if(operandCount < 3 || operands[1] >= bound) {
+                    break;
+                }
+
+                SpvId& id = ids[operands[1]];
+                id._opcode = opcode;
+                id._typeId = operands[0];
+                id._storageClass = operands[2];
+                variables.push_back(operands[1]);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    for(std::uint32_t variableId : variables) {
+        const SpvId& variable = ids[variableId];
+        if(variable._typeId >= bound || ids[variable._typeId]._opcode != SpvOpTypePointer) {
+            continue;
+        }
+
+        std::uint32_t typeId = ids[variable._typeId]._typeId;
+        if(typeId >= bound) {
+            continue;
+        }
+
+        if(variable._storageClass == SpvStorageClassPushConstant) {
+            const SpvId& type = ids[typeId];
+            if(type._opcode != SpvOpTypeStruct || type._members.empty()) {
+                continue;
+            }
+
+            std::uint32_t firstOffset = SpvInvalidValue;
+            for(const SpvMember& member : type._members) {
+                firstOffset = std::min(firstOffset, member._offset);
+            }
+
+            ShaderPushConstantRange range;
+            range._offset = firstOffset;
+            range._size = GetTypeSize(ids, typeId) - firstOffset;
+            range._stage = stage;
+            reflection._pushConstants.push_back(range);
+            continue;
+        }
+
+        if(variable._storageClass != SpvStorageClassUniform && variable._storageClass != SpvStorageClassUniformConstant && variable._storageClass != SpvStorageClassStorageBuffer) {
+            continue;
+        }
+
+        ShaderResourceBinding binding;
+        binding._set = variable._set == SpvInvalidValue ? 0 : variable._set;
+        binding._binding = variable._binding == SpvInvalidValue ? 0 : variable._binding;
+        binding._stage = stage;
+
+        // Arrays of resources take multiple descriptors
+        if(ids[typeId]._opcode == SpvOpTypeArray) {
+            const SpvId& arrayType = ids[typeId];
+            if(arrayType._operands.size() < 2 || arrayType._operands[1] >= bound) {
+                continue;
+            }
+
+            binding._count = ids[arrayType._operands[1]]._value;
+            typeId = arrayType._operands[0];
+        }
+
+        const SpvId& type = ids[typeId];
+        binding._identifier = !variable._name.empty() ? variable._name : type._name;
+
+        // Before SPIR-V 1.3 storage buffers are uniform buffer blocks decorated with BufferBlock
+        const bool bStorageBuffer = type._opcode == SpvOpTypeStruct && ((variable._storageClass == SpvStorageClassUniform && type._bBufferBlock) || (variable._storageClass == SpvStorageClassStorageBuffer && type._bBlock));
+
+        if(variable._storageClass == SpvStorageClassUniform && type._opcode == SpvOpTypeStruct && type._bBlock) {
+            binding._usage = ShaderDataBlockUsage::UNIFORM_BUFFER;
+            binding._size = GetTypeSize(ids, typeId);
+        } else if(bStorageBuffer) {
+            binding._usage = ShaderDataBlockUsage::STORAGE_BUFFER;
+            binding._size = GetTypeSize(ids, typeId);
+        } else if(type._opcode == SpvOpTypeSampledImage) {
+            binding._usage = ShaderDataBlockUsage::TEXTURE;
+        } else if(type._opcode == SpvOpTypeSampler) {
+            binding._usage = ShaderDataBlockUsage::SAMPLER;
+        } else {
+            // A resource missing from the layout fails later on binding, the shader is rejected here instead
+            std::cerr << "Shader reflection: unsupported resource type for " << binding._identifier << " (set " << binding._set << ", binding " << binding._binding << ")" << std::endl;
+            return false;
+        }
+
+        reflection._bindings.push_back(binding);
+    }
+
+    std::sort(reflection._bindings.begin(), reflection._bindings.end(), [](const ShaderResourceBinding& lhs, const ShaderResourceBinding& rhs) {
+        return std::tie(lhs._set, lhs._binding) < std::tie(rhs._set, rhs._binding);
+    });
+
+    return true;
+}
+
+ShaderReflection ShaderReflection::Merge(const ShaderReflection& lhs, const ShaderReflection& rhs) {
+    ShaderReflection result = lhs;
+
+    for(const ShaderResourceBinding& binding : rhs._bindings) {
+        auto it = std::find_if(result._bindings.begin(), result._bindings.end(), [&binding](const ShaderResourceBinding& other) {
+            return other._set == binding._set && other._binding == binding._binding;
+        });
+
+        if(it == result._bindings.end()) {
+            result._bindings.push_back(binding);
+            continue;
+        }
+
+        if(it->_usage != binding._usage) {
+            std::cerr << "Shader reflection: stages disagree on the resource type of set " << binding._set << ", binding " << binding._binding << std::endl;
+            assert(0);
+        }
+
+        it->_stage = (ShaderStage)(it->_stage | binding._stage);
+        it->_size = std::max(it->_size, binding._size);
+        it->_count = std::max(it->_count, binding._count);
+    }
+
+    std::sort(result._bindings.begin(), result._bindings.end(), [](const ShaderResourceBinding& lhs, const ShaderResourceBinding& rhs) {
+        return std::tie(lhs._set, lhs._binding) < std::tie(rhs._set, rhs._binding);
+    });
+
+    // Stages that push the exact same range share it, otherwise each stage keeps its own range
+    for(const ShaderPushConstantRange& range : rhs._pushConstants) {
+        auto it = std::find_if(result._pushConstants.begin(), result._pushConstants.end(), [&range](const ShaderPushConstantRange& other) {
+            return other._offset == range._offset && other._size == range._size;
+        });
+
+        if(it == result._pushConstants.end()) {
+            result._pushConstants.push_back(range);
+            continue;
+        }
+
+        it->_stage = (ShaderStage)(it->_stage | range._stage);
+    }
+
+    return result;
+}
+
+const ShaderResourceBinding* ShaderReflection::FindBinding(std::uint32_t set, std::uint32_t binding) const {
+    for(const ShaderResourceBinding& resourceBinding : _bindings) {
+        if(resourceBinding._set == set && resourceBinding._binding == binding) {
+            return &resourceBinding;
+        }
+    }
+
+    return nullptr;
+}
+
+std::uint32_t ShaderReflection::GetSetCount() const {
+    return _bindings.empty() ? 0 : _bindings.back()._set + 1;
+}
+
+bool ShaderReflection::ValidateDataStreams(const std::vector<ShaderDataStream>& dataStreams) const {
+    std::vector<const ShaderDataStream*> sets;
+    for(const ShaderDataStream& dataStream : dataStreams) {
+        if(dataStream._usage == ShaderDataStreamUsage::DATA) {
+            sets.push_back(&dataStream);
+        }
+    }
+
+    bool bValid = true;
+    for(const ShaderResourceBinding& binding : _bindings) {
+        if(binding._set >= sets.size()) {
+            continue;
+        }
+
+        const std::vector<ShaderDataBlock>& blocks = sets[binding._set]->_dataBlocks;
+        if(binding._binding >= blocks.size()) {
+            std::cerr << "Shader reflection: " << binding._identifier << " (set " << binding._set << ", binding " << binding._binding << ") has no data block" << std::endl;
+            bValid = false;
+            continue;
+        }
+
+        const ShaderDataBlock& block = blocks[binding._binding];
+        if(block._usage != binding._usage) {
+            std::cerr << "Shader reflection: data block " << block._identifier << " does not match the resource type of " << binding._identifier << " (set " << binding._set << ", binding " << binding._binding << ")" << std::endl;
+            bValid = false;
+            continue;
+        }
+
+        if(block._size < binding._size) {
+            std::cerr << "Shader reflection: data block " << block._identifier << " is " << block._size << " bytes but " << binding._identifier << " needs " << binding._size << std::endl;
+            bValid = false;
+        }
+    }
+
+    return bValid;
+}
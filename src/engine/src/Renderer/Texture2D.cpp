@@ -14,7 +14,7 @@ Texture2D::~Texture2D() {
     }
 
     if(_loadFlags ==  TexLoad_Data && _data) {
-        delete _data;
+        delete[] _data;
         _data = nullptr;
     }
 }
@@ -23,6 +23,7 @@ std::shared_ptr<Texture2D> Texture2D::MakeFromPath(const char* path, Format pixe
     auto texture2D = std::make_shared<Texture2D>();
     texture2D->_path = path;
     texture2D->_pixelFormat = pixelFormat;
+    texture2D->_uncompressedFormat = pixelFormat;
     texture2D->_flags = static_cast<TextureFlags>(TextureFlags::Tex_SAMPLED_OP | TextureFlags::Tex_TRANSFER_DEST_OP);
     texture2D->_loadFlags = TexLoad_Path;
 
@@ -45,6 +46,25 @@ std::shared_ptr<Texture2D> Texture2D::MakeFromData(std::uint32_t width, std::uin
     return texture2D;
 }
 
+std::shared_ptr<Texture2D> Texture2D::MakeFromEncodedData(std::shared_ptr<const std::vector<std::uint8_t>> encoded, Format pixelFormat) {
+    std::uint32_t width, height;
+    if(!encoded || !TextureDecoder::GetImageInfo(encoded->data(), encoded->size(), width, height)) {
+        return nullptr;
+    }
+
+    auto texture2D = std::make_shared<Texture2D>();
+    texture2D->_width = width;
+    texture2D->_height = height;
+    texture2D->_pixelFormat = pixelFormat;
+    texture2D->_uncompressedFormat = pixelFormat;
+    texture2D->_flags = static_cast<TextureFlags>(TextureFlags::Tex_SAMPLED_OP | TextureFlags::Tex_TRANSFER_DEST_OP);
+    texture2D->_loadFlags = TexLoad_EncodedData;
+    texture2D->_dataSize = static_cast<std::size_t>(width) * height * 4;
+    texture2D->_encodedData = std::move(encoded);
+
+    return texture2D;
+}
+
 std::shared_ptr<Texture2D> Texture2D::MakeFromExternalResource(std::uint32_t width, std::uint32_t height, Format pixelFormat, TextureFlags flags, unsigned int levels) {
     auto texture2D = std::make_shared<Texture2D>();
     texture2D->_width = width;
@@ -118,7 +138,7 @@ bool Texture2D::Initialize(Device* device) {
 }
 
 TextureView* Texture2D::MakeTextureView() {
-    return MakeTextureView(GetPixelFormat(), Range(0, 1));
+    return MakeTextureView(GetPixelFormat(), Range(0, _mipLevels));
 }
 
 TextureView* Texture2D::MakeTextureView(Format format, const Range &levels) {
@@ -159,11 +179,31 @@ void Texture2D::FreeResource() {
         _textureView.reset();
     }
     
+    // The cached views keep the old resource alive and would point at it after a reload
+    _textureViews.clear();
+    
     if(_textureResource) {
         _textureResource.reset();
     }
 }
 
+std::shared_ptr<void> Texture2D::DetachResource() {
+    struct Detached {
+        std::shared_ptr<TextureResource> _resource;
+        std::shared_ptr<TextureView> _view;
+        std::unordered_map<std::size_t, std::shared_ptr<TextureView>> _views;
+    };
+
+    std::shared_ptr<Detached> detached = std::make_shared<Detached>();
+    detached->_resource = std::move(_textureResource);
+    detached->_view = std::move(_textureView);
+    detached->_views = std::move(_textureViews);
+    _textureResource.reset();
+    _textureView.reset();
+    _textureViews.clear();
+    return detached;
+}
+
 std::shared_ptr<TextureResource> Texture2D::GetResource() {
     return _textureResource;
 }
@@ -214,6 +254,11 @@ void Texture2D::Reload(bool bIsDeepReload) {
         HandleFromDataReload();
         return;
     }
+
+    if(_loadFlags == TexLoad_EncodedData) {
+        HandleFromEncodedDataReload();
+        return;
+    }
 }
 
 void Texture2D::MakeDirty() const {
@@ -236,49 +281,105 @@ bool Texture2D::IsDirty() const {
     return _textureResource->IsDirty();
 }
 
+bool Texture2D::NeedsDecode() const {
+    return (_loadFlags == TexLoad_Path || _loadFlags == TexLoad_EncodedData) && !_decodedImage._pixels;
+}
+
+std::shared_ptr<TextureDecodeRequest> Texture2D::RequestDecode(float priority, bool bAllowCompression) const {
+    if(!NeedsDecode()) {
+        return nullptr;
+    }
+
+    if(_loadFlags == TexLoad_Path) {
+        return _path ? TextureDecoder::Get().DecodeFile(_path, priority, GetDecodeSettings(bAllowCompression)) : nullptr;
+    }
+
+    return TextureDecoder::Get().DecodeMemory(_encodedData, priority, GetDecodeSettings(bAllowCompression));
+}
+
+TextureDecodeSettings Texture2D::GetDecodeSettings(bool bAllowCompression) const {
+    TextureDecodeSettings settings;
+    settings._compression = bAllowCompression ? _compression : TextureCompression::None;
+    settings._bGenerateMips = _bGenerateMips;
+    // Two channel textures hold data, not colors
+    settings._bSrgb = _uncompressedFormat == Format::FORMAT_R8G8B8A8_SRGB && _compression != TextureCompression::TwoChannel;
+    return settings;
+}
+
+void Texture2D::SetDecodedImage(DecodedImage image) {
+    _decodedImage = std::move(image);
+}
+
 void Texture2D::HandleDynamicDataReload() {
-    _dataSize = _width * _height * 4; // TODO create method to get the correct value based on format
+    _dataSize = BlockCompression::GetImageDataSize(_pixelFormat, _width, _height);
     FreeResource();
     CreateResource(nullptr);
 
 }
 
 void Texture2D::HandleFromPathReload() {
-    if(strlen(_path) == 0) {
+    if(!_path || strlen(_path) == 0) {
         assert(0 && "Texture2D::HandleFromPathReload() - No path was set for the texture");
         return;
     }
 
-    if(_data) {
-        stbi_image_free(reinterpret_cast<void*>(_data));
+    // Textures going through TextureResidency were decoded on the TextureDecoder already, the others decode here
+    if(!_decodedImage._pixels) {
+        _decodedImage = TextureDecoder::DecodeFileNow(_path);
+        if(_bGenerateMips) {
+            _decodedImage = TextureDecoder::GenerateMips(std::move(_decodedImage), GetDecodeSettings(false)._bSrgb);
+        }
     }
 
-    int x,y,n;
-    void* data = stbi_load(_path, &x, &y, &n, STBI_rgb_alpha);
-
-    if(data == nullptr) {
+    if(!_decodedImage._pixels) {
         assert(0 && "Texture2D::Reload() - Failed to load image from file");
         return;
     }
 
-    _width = x;
-    _height = y;
+    UploadDecodedImage();
+}
+
+void Texture2D::HandleFromEncodedDataReload() {
+    if(!_decodedImage._pixels) {
+        _decodedImage = TextureDecoder::DecodeMemoryNow(_encodedData->data(), _encodedData->size());
+        if(_bGenerateMips) {
+            _decodedImage = TextureDecoder::GenerateMips(std::move(_decodedImage), GetDecodeSettings(false)._bSrgb);
+        }
+    }
 
-    /*
-     * A note about the 4, this is the number of channels we are reading the image from,
-     * a current limitation of stb is that the 'n' will always be the number that it would
-     * have been if you said 0, this is not ideal with jpg and png. We need a better way to
-     * get the number of the channels based on the image type. and this also needs to match
-     * the current texture format we are using
-     */
-    _dataSize = x * y * 4;
+    if(!_decodedImage._pixels) {
+        assert(0 && "Texture2D::HandleFromEncodedDataReload() - Failed to decode image data");
+        return;
+    }
+
+    UploadDecodedImage();
+}
+
+void Texture2D::UploadDecodedImage() {
+    // Levels are stored largest first, skipping the finest ones leaves the tail of the chain
+    const std::uint32_t levelCount = _decodedImage._levelCount;
+    const std::uint32_t keptLevels = _maxMipLevels > 0 ? std::min(_maxMipLevels, levelCount) : levelCount;
+    const std::uint32_t firstLevel = levelCount - keptLevels;
+    const std::size_t offset = MipGenerator::GetLevelOffset(_decodedImage._format, _decodedImage._width, _decodedImage._height, firstLevel);
+
+    _width = MipGenerator::GetLevelExtent(_decodedImage._width, firstLevel);
+    _height = MipGenerator::GetLevelExtent(_decodedImage._height, firstLevel);
+
+    // Compressed images carry their format, the others are always decoded to 4 channels which has to match the format
+    // the texture was created with. A texture evicted and decoded again may go from one to the other
+    _pixelFormat = BlockCompression::IsCompressed(_decodedImage._format) ? _decodedImage._format : _uncompressedFormat;
+    _mipLevels = keptLevels;
+    _dataSize = _decodedImage.GetSize() - offset;
 
     FreeResource();
     CreateResource(nullptr);
 
     void* buffer = _textureResource->Lock();
-    std::memcpy(buffer, data, _dataSize);
+    std::memcpy(buffer, _decodedImage._pixels.get() + offset, _dataSize);
     _textureResource->Unlock();
+
+    // The pixels live in the staging memory now, decoding again is cheaper than keeping every evicted texture around
+    _decodedImage = {};
 }
 
 void Texture2D::HandleFromDataReload() {
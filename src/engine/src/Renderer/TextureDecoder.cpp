@@ -0,0 +1,429 @@
+#include "Renderer/TextureDecoder.hpp"
+#include "Core/ImportCache.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/MappedFile.hpp"
+#include "stb_image.h"
+
+namespace {
+    // Header of a compressed texture in the import cache, the blocks follow it
+    struct CompressedTextureHeader {
+        static constexpr std::uint32_t Magic = 0x58455443; // "CTEX"
+
+        std::uint32_t _magic = Magic;
+        std::uint32_t _version = BlockCompression::Version;
+        std::uint32_t _format = 0;
+        std::uint32_t _width = 0;
+        std::uint32_t _height = 0;
+        std::uint32_t _levelCount = 0;
+        std::uint64_t _dataSize = 0;
+    };
+
+    // Reserved for a request until it is decoded, before compression
+    std::size_t GetDecodedSize(std::uint32_t width, std::uint32_t height, const TextureDecodeSettings& settings) {
+        const std::uint32_t levelCount = settings._bGenerateMips ? MipGenerator::GetLevelCount(width, height) : 1;
+        return MipGenerator::GetChainSize(Format::FORMAT_R8G8B8A8_SRGB, width, height, levelCount);
+    }
+
+    std::optional<std::uint64_t> GetCacheKey(const std::string& path, const std::vector<std::uint8_t>* encoded, const TextureDecodeSettings& decodeSettings) {
+        // The decode settings and the encoder version are part of the key, changing any makes new entries
+        const std::array<std::uint32_t, 5> settings = {CompressedTextureHeader::Magic, BlockCompression::Version, static_cast<std::uint32_t>(decodeSettings._compression),
+            decodeSettings._bGenerateMips, decodeSettings._bSrgb};
+        const std::uint64_t seed = ImportCache::HashBytes(settings.data(), sizeof(settings));
+
+        if(encoded) {
+            return ImportCache::HashBytes(encoded->data(), encoded->size(), seed);
+        }
+
+        return ImportCache::HashFile(path, seed);
+    }
+
+    // Empty when there is no entry or it is not valid
+    DecodedImage LoadCompressed(const ImportCache& cache, std::uint64_t key) {
+        std::shared_ptr<MappedFile> file = MappedFile::Open(cache.GetEntryPath(key, ImportCache::TextureEntryExtension));
+        if(!file || file->GetSize() < sizeof(CompressedTextureHeader)) {
+            return {};
+        }
+
+        CompressedTextureHeader header;
+        std::memcpy(&header, file->GetData(), sizeof(header));
+
+        const auto format = static_cast<Format>(header._format);
+        if(header._magic != CompressedTextureHeader::Magic || header._version != BlockCompression::Version || !BlockCompression::IsCompressed(format) ||
+           header._levelCount == 0 || header._levelCount > MipGenerator::GetLevelCount(header._width, header._height) ||
+           header._dataSize != MipGenerator::GetChainSize(format, header._width, header._height, header._levelCount) ||
+           file->GetSize() != sizeof(header) + header._dataSize) {
+            return {};
+        }
+
+        // Not copied, the upload reads the blocks straight from the mapping into staging memory
+        DecodedImage image;
+        image._pixels = std::unique_ptr<std::uint8_t[], DecodedImage::PixelsDeleter>(const_cast<std::uint8_t*>(file->GetData() + sizeof(header)), {false, file});
+        image._width = header._width;
+        image._height = header._height;
+        image._levelCount = header._levelCount;
+        image._format = format;
+
+        cache.Touch(key, ImportCache::TextureEntryExtension);
+        return image;
+    }
+
+    void StoreCompressed(const ImportCache& cache, std::uint64_t key, const DecodedImage& image) {
+        CompressedTextureHeader header;
+        header._format = static_cast<std::uint32_t>(image._format);
+        header._width = image._width;
+        header._height = image._height;
+        header._levelCount = image._levelCount;
+        header._dataSize = image.GetSize();
+
+        cache.Store(key, ImportCache::TextureEntryExtension, [&](std::ostream& stream) {
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(image._pixels.get()), static_cast<std::streamsize>(header._dataSize));
+            return stream.good();
+        });
+    }
+}
+
+void DecodedPixelsDeleter::operator()(std::uint8_t* pixels) const {
+    // The mapping goes with the deleter
+    if(_mapping) {
+        return;
+    }
+
+    if(_bStbAllocated) {
+        stbi_image_free(pixels);
+    } else {
+        delete[] pixels;
+    }
+}
+
+TextureDecodeRequest::~TextureDecodeRequest() {
+    // Nothing else references it anymore, reading without the lock is safe. Queued requests skip the lock entirely,
+    // they can be destroyed by the decoder itself while it holds it
+    if(_decoder && _reservedBytes > 0) {
+        _decoder->Release(*this);
+    }
+}
+
+DecodedImage TextureDecodeRequest::TakeImage() {
+    if(_state != State::Decoded) {
+        assert(0 && "TextureDecodeRequest::TakeImage() - Nothing was decoded");
+        return {};
+    }
+
+    DecodedImage image = std::move(_image);
+    _state = State::Failed; // Taken, there is nothing left to hand out
+    _decoder->Release(*this);
+    return image;
+}
+
+TextureDecoder& TextureDecoder::Get() {
+    static TextureDecoder& instance = []() -> TextureDecoder& {
+        static TextureDecoder decoder(256ull * 1024 * 1024, std::max<std::size_t>(1, JobSystem::Get().GetWorkerCount()));
+        decoder.SetCache(std::make_shared<ImportCache>(ImportCache::GetDefaultDirectory(), ImportCache::DefaultMaxSize));
+        return decoder;
+    }();
+    return instance;
+}
+
+TextureDecoder::TextureDecoder(std::size_t maxInFlightBytes, std::size_t maxConcurrentDecodes)
+    : _maxInFlightBytes(maxInFlightBytes)
+    , _maxConcurrentDecodes(std::max<std::size_t>(1, maxConcurrentDecodes)) {
+}
+
+TextureDecoder::~TextureDecoder() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _queue.clear();
+    _idle.wait(lock, [this] { return _activeDecodes == 0; });
+}
+
+std::shared_ptr<TextureDecodeRequest> TextureDecoder::DecodeFile(const std::string& path, float priority, const TextureDecodeSettings& settings) {
+    int width, height, channels;
+    if(!stbi_info(path.c_str(), &width, &height, &channels)) {
+        return nullptr;
+    }
+
+    auto request = std::make_shared<TextureDecodeRequest>();
+    request->_path = path;
+    request->_size = GetDecodedSize(static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), settings);
+    request->_settings = settings;
+    Enqueue(request, priority);
+
+    return request;
+}
+
+std::shared_ptr<TextureDecodeRequest> TextureDecoder::DecodeMemory(std::shared_ptr<const std::vector<std::uint8_t>> encoded, float priority,
+    const TextureDecodeSettings& settings) {
+    std::uint32_t width, height;
+    if(!encoded || !GetImageInfo(encoded->data(), encoded->size(), width, height)) {
+        return nullptr;
+    }
+
+    auto request = std::make_shared<TextureDecodeRequest>();
+    request->_encoded = std::move(encoded);
+    request->_size = GetDecodedSize(width, height, settings);
+    request->_settings = settings;
+    Enqueue(request, priority);
+
+    return request;
+}
+
+bool TextureDecoder::GetImageInfo(const void* encoded, std::size_t size, std::uint32_t& width, std::uint32_t& height) {
+    int x, y, channels;
+    if(!stbi_info_from_memory(static_cast<const stbi_uc*>(encoded), static_cast<int>(size), &x, &y, &channels)) {
+        return false;
+    }
+
+    width = static_cast<std::uint32_t>(x);
+    height = static_cast<std::uint32_t>(y);
+    return true;
+}
+
+DecodedImage TextureDecoder::DecodeFileNow(const std::string& path) {
+    int width, height, channels;
+    DecodedImage image;
+    image._pixels.reset(stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha));
+    if(image._pixels) {
+        image._width = static_cast<std::uint32_t>(width);
+        image._height = static_cast<std::uint32_t>(height);
+    }
+
+    return image;
+}
+
+DecodedImage TextureDecoder::DecodeMemoryNow(const void* encoded, std::size_t size) {
+    int width, height, channels;
+    DecodedImage image;
+    image._pixels.reset(stbi_load_from_memory(static_cast<const stbi_uc*>(encoded), static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha));
+    if(image._pixels) {
+        image._width = static_cast<std::uint32_t>(width);
+        image._height = static_cast<std::uint32_t>(height);
+    }
+
+    return image;
+}
+
+DecodedImage TextureDecoder::GenerateMips(DecodedImage image, bool bSrgb) {
+    const std::uint32_t levelCount = MipGenerator::GetLevelCount(image._width, image._height);
+    if(!image._pixels || image._levelCount == levelCount || BlockCompression::IsCompressed(image._format)) {
+        return image;
+    }
+
+    // stb allocated the first level alone, the chain needs one allocation for all of them
+    DecodedImage chain;
+    chain._width = image._width;
+    chain._height = image._height;
+    chain._levelCount = levelCount;
+    chain._format = image._format;
+    chain._pixels = std::unique_ptr<std::uint8_t[], DecodedImage::PixelsDeleter>(new std::uint8_t[chain.GetSize()], {false});
+    std::memcpy(chain._pixels.get(), image._pixels.get(), BlockCompression::GetImageDataSize(image._format, image._width, image._height));
+    MipGenerator::GenerateChain(chain._pixels.get(), chain._width, chain._height, levelCount, bSrgb);
+
+    return chain;
+}
+
+DecodedImage TextureDecoder::Compress(DecodedImage image, TextureCompression compression) {
+    if(!image._pixels || compression == TextureCompression::None) {
+        return image;
+    }
+
+    // Picked from the first level, the others are averages of it and can not gain transparency
+    const Format format = BlockCompression::ChooseFormat(compression, image._pixels.get(), image._width, image._height);
+
+    DecodedImage compressed;
+    compressed._width = image._width;
+    compressed._height = image._height;
+    compressed._levelCount = image._levelCount;
+    compressed._format = format;
+    compressed._pixels = std::unique_ptr<std::uint8_t[], DecodedImage::PixelsDeleter>(new std::uint8_t[compressed.GetSize()], {false});
+
+    for(std::uint32_t level = 0; level < image._levelCount; level++) {
+        const std::uint8_t* rgba = image._pixels.get() + MipGenerator::GetLevelOffset(image._format, image._width, image._height, level);
+        std::uint8_t* blocks = compressed._pixels.get() + MipGenerator::GetLevelOffset(format, image._width, image._height, level);
+        BlockCompression::Compress(format, rgba, MipGenerator::GetLevelExtent(image._width, level), MipGenerator::GetLevelExtent(image._height, level), blocks);
+    }
+
+    return compressed;
+}
+
+void TextureDecoder::SetCache(std::shared_ptr<const ImportCache> cache) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cache = std::move(cache);
+}
+
+void TextureDecoder::SetMaxInFlightBytes(std::size_t bytes) {
+    std::vector<std::shared_ptr<TextureDecodeRequest>> startable;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxInFlightBytes = bytes;
+        startable = PopStartable();
+    }
+
+    Start(std::move(startable));
+}
+
+std::size_t TextureDecoder::GetInFlightBytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _inFlightBytes;
+}
+
+std::size_t TextureDecoder::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::count_if(_queue.begin(), _queue.end(), [](const std::weak_ptr<TextureDecodeRequest>& request) {
+        return !request.expired();
+    });
+}
+
+void TextureDecoder::Enqueue(const std::shared_ptr<TextureDecodeRequest>& request, float priority) {
+    request->_decoder = this;
+    request->_priority = priority;
+
+    std::vector<std::shared_ptr<TextureDecodeRequest>> startable;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request->_sequence = _nextSequence++;
+        _queue.push_back(request);
+        startable = PopStartable();
+    }
+
+    Start(std::move(startable));
+}
+
+std::vector<std::shared_ptr<TextureDecodeRequest>> TextureDecoder::PopStartable() {
+    std::vector<std::shared_ptr<TextureDecodeRequest>> startable;
+
+    while(_activeDecodes < _maxConcurrentDecodes) {
+        // Highest priority, oldest first on ties. Queues stay small, a scan is cheaper than keeping a heap in order
+        // while the priorities change under it
+        std::shared_ptr<TextureDecodeRequest> best;
+        std::size_t bestIndex = 0;
+        for(std::size_t i = 0; i < _queue.size();) {
+            std::shared_ptr<TextureDecodeRequest> request = _queue[i].lock();
+            if(!request) {
+                _queue[i] = std::move(_queue.back());
+                _queue.pop_back();
+                continue;
+            }
+
+            if(!best || request->_priority > best->_priority || (request->_priority == best->_priority && request->_sequence < best->_sequence)) {
+                best = std::move(request);
+                bestIndex = i;
+            }
+            i++;
+        }
+
+        // Strictly in priority order, a smaller image does not jump ahead of one waiting for memory
+        if(!best || (_inFlightBytes > 0 && _inFlightBytes + best->_size > _maxInFlightBytes)) {
+            break;
+        }
+
+        _queue[bestIndex] = std::move(_queue.back());
+        _queue.pop_back();
+
+        best->_reservedBytes = best->_size;
+        best->_state = TextureDecodeRequest::State::Decoding;
+        _inFlightBytes += best->_size;
+        _activeDecodes++;
+        startable.push_back(std::move(best));
+    }
+
+    return startable;
+}
+
+void TextureDecoder::Start(std::vector<std::shared_ptr<TextureDecodeRequest>> requests) {
+    for(std::shared_ptr<TextureDecodeRequest>& request : requests) {
+        JobSystem::Get().Schedule([this, request = std::move(request)]() {
+            Run(request);
+        });
+    }
+}
+
+void TextureDecoder::Run(const std::shared_ptr<TextureDecodeRequest>& request) {
+    std::shared_ptr<const ImportCache> cache;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        cache = _cache;
+    }
+
+    // Dropped since it started, compressing a large image is worth skipping
+    DecodedImage image = request.use_count() > 1 ? Decode(*request, cache.get()) : DecodedImage {};
+    const bool bDecoded = image._pixels != nullptr;
+
+    std::vector<std::shared_ptr<TextureDecodeRequest>> startable;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Whatever was decoded counts from here on, the header can lie and compressed images are smaller
+        _inFlightBytes -= request->_reservedBytes;
+        request->_reservedBytes = bDecoded ? image.GetSize() : 0;
+        _inFlightBytes += request->_reservedBytes;
+
+        request->_image = std::move(image);
+        request->_state = bDecoded ? TextureDecodeRequest::State::Decoded : TextureDecodeRequest::State::Failed;
+
+        // Nobody wants it anymore, released here so the request does not outlive a decoder being destroyed
+        if(request.use_count() == 1) {
+            _inFlightBytes -= request->_reservedBytes;
+            request->_reservedBytes = 0;
+            request->_image = {};
+        }
+
+        _activeDecodes--;
+        startable = PopStartable();
+
+        // Still under the lock, the decoder may be destroyed as soon as it is released when nothing else started
+        _idle.notify_all();
+    }
+
+    Start(std::move(startable));
+}
+
+DecodedImage TextureDecoder::Decode(const TextureDecodeRequest& request, const ImportCache* cache) {
+    const TextureDecodeSettings& settings = request._settings;
+    std::optional<std::uint64_t> key;
+    if(cache && settings._compression != TextureCompression::None) {
+        key = GetCacheKey(request._path, request._encoded.get(), settings);
+    }
+
+    if(key) {
+        if(DecodedImage image = LoadCompressed(*cache, *key); image._pixels) {
+            return image;
+        }
+    }
+
+    DecodedImage image = request._encoded ? DecodeMemoryNow(request._encoded->data(), request._encoded->size()) : DecodeFileNow(request._path);
+    if(!image._pixels) {
+        return image;
+    }
+
+    if(settings._bGenerateMips) {
+        image = GenerateMips(std::move(image), settings._bSrgb);
+    }
+
+    if(settings._compression == TextureCompression::None) {
+        return image;
+    }
+
+    // For a moment both the pixels and the blocks are alive, a bit over what was reserved
+    image = Compress(std::move(image), settings._compression);
+    if(key) {
+        StoreCompressed(*cache, *key, image);
+    }
+
+    return image;
+}
+
+void TextureDecoder::Release(TextureDecodeRequest& request) {
+    std::vector<std::shared_ptr<TextureDecodeRequest>> startable;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if(request._reservedBytes == 0) {
+            return;
+        }
+
+        _inFlightBytes -= request._reservedBytes;
+        request._reservedBytes = 0;
+        startable = PopStartable();
+    }
+
+    Start(std::move(startable));
+}
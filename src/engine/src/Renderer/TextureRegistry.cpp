@@ -0,0 +1,73 @@
+#include "Renderer/TextureRegistry.hpp"
+#include "Renderer/Texture2D.hpp"
+#include "Core/ImportCache.hpp"
+
+TextureRegistry& TextureRegistry::Get() {
+    static TextureRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<Texture2D> TextureRegistry::FindOrMakeFromPath(const char* path, Format pixelFormat, const Initializer& initialize) {
+    if(!path) {
+        return nullptr;
+    }
+
+    const std::size_t length = std::strlen(path);
+    const Key key = {ImportCache::HashBytes(path, length), length, 0, 0, pixelFormat, Source::Path};
+    return FindOrMake(key, [&]() { return Texture2D::MakeFromPath(path, pixelFormat); }, initialize);
+}
+
+std::shared_ptr<Texture2D> TextureRegistry::FindOrMakeFromData(std::uint32_t width, std::uint32_t height, Format pixelFormat, const void* data,
+    std::size_t size, const Initializer& initialize) {
+    // The same bytes make a different texture with another shape
+    const Key key = {ImportCache::HashBytes(data, size), size, width, height, pixelFormat, Source::Data};
+    return FindOrMake(key, [&]() { return Texture2D::MakeFromData(width, height, pixelFormat, data, size); }, initialize);
+}
+
+std::shared_ptr<Texture2D> TextureRegistry::FindOrMakeFromEncodedData(const void* encoded, std::size_t size, Format pixelFormat, const Initializer& initialize) {
+    const Key key = {ImportCache::HashBytes(encoded, size), size, 0, 0, pixelFormat, Source::EncodedData};
+    return FindOrMake(key, [&]() {
+        const auto* bytes = static_cast<const std::uint8_t*>(encoded);
+        return Texture2D::MakeFromEncodedData(std::make_shared<const std::vector<std::uint8_t>>(bytes, bytes + size), pixelFormat);
+    }, initialize);
+}
+
+std::size_t TextureRegistry::GetTextureCount() {
+    std::lock_guard lock(_mutex);
+    return static_cast<std::size_t>(std::ranges::count_if(_textures, [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+std::uint64_t TextureRegistry::GetHitCount() {
+    std::lock_guard lock(_mutex);
+    return _hitCount;
+}
+
+std::shared_ptr<Texture2D> TextureRegistry::FindOrMake(const Key& key, const std::function<std::shared_ptr<Texture2D>()>& make, const Initializer& initialize) {
+    // Made under the lock too, two imports of the same image must not both make one. Making a texture only copies bytes
+    std::lock_guard lock(_mutex);
+
+    std::weak_ptr<Texture2D>& entry = _textures[key];
+    if(std::shared_ptr<Texture2D> texture = entry.lock()) {
+        _hitCount++;
+        return texture;
+    }
+
+    std::shared_ptr<Texture2D> texture = make();
+    if(!texture) {
+        _textures.erase(key);
+        return nullptr;
+    }
+
+    if(initialize) {
+        initialize(*texture);
+    }
+    entry = texture;
+
+    // Amortized, the map is swept once it doubled since the last sweep
+    if(_textures.size() > _pruneSize) {
+        std::erase_if(_textures, [](const auto& other) { return other.second.expired(); });
+        _pruneSize = std::max<std::size_t>(64, _textures.size() * 2);
+    }
+
+    return texture;
+}
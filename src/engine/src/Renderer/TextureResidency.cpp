@@ -0,0 +1,292 @@
+#include "Renderer/TextureResidency.hpp"
+#include "Renderer/Texture2D.hpp"
+#include "Renderer/TextureDecoder.hpp"
+#include "Renderer/TextureRegistry.hpp"
+#include <cmath>
+
+namespace {
+    // Added to the priority of textures still showing the placeholder, they decode before any level is streamed in
+    constexpr float UnloadedPriority = 1000.0f;
+
+    // How far past a power of two, in levels, a footprint has to grow before a finer level is streamed in. About 19%
+    // larger, a user hovering around the threshold does not decode the texture again every few frames
+    constexpr float FinerLevelMargin = 0.25f;
+
+    // Size of the smallest levels of a chain
+    std::size_t GetLevelsSize(Format format, std::uint32_t width, std::uint32_t height, std::uint32_t levelCount, std::uint32_t levels) {
+        return MipGenerator::GetChainSize(format, width, height, levelCount) - MipGenerator::GetLevelOffset(format, width, height, levelCount - levels);
+    }
+}
+
+void TextureResidency::BeginFrame(std::size_t framesInFlight) {
+    _frame++;
+    _loadsThisFrame = 0;
+
+    // The frames that could still sample the replaced resources are done by now
+    std::erase_if(_retired, [this, framesInFlight](const std::pair<std::uint64_t, std::shared_ptr<void>>& retired) {
+        return retired.first + framesInFlight < _frame;
+    });
+
+    struct Candidate {
+        const Texture2D* _key;
+        std::uint64_t _lastRequestedFrame;
+        std::size_t _size;
+    };
+
+    std::vector<Candidate> candidates;
+    const std::uint64_t delay = std::max<std::uint64_t>(_evictionDelay, framesInFlight);
+
+    _residentBytes = 0;
+    _requestedBytes = 0;
+    _residentCount = 0;
+    _decodingCount = 0;
+    _streamingCount = 0;
+    for(auto it = _entries.begin(); it != _entries.end();) {
+        std::shared_ptr<Texture2D> texture = it->second._texture.lock();
+        if(!texture) {
+            it = _entries.erase(it);
+            continue;
+        }
+
+        Entry& entry = it->second;
+
+        // Out of view before its decode finished, dropping the request cancels it and frees its pixels
+        if(entry._decode) {
+            if(entry._lastRequestedFrame + 1 < _frame) {
+                entry._decode.reset();
+            } else if(entry._bResident) {
+                _streamingCount++;
+            } else {
+                _decodingCount++;
+            }
+        }
+
+        if(entry._lastRequestedFrame + 1 == _frame && entry._levelCount > 0) {
+            _requestedBytes += GetLevelsSize(entry._format, entry._width, entry._height, entry._levelCount, entry._wantedLevels);
+        }
+
+        if(entry._bResident) {
+            // The size is only known once the texture was loaded
+            const std::size_t size = texture->GetImageDataSize();
+            _residentBytes += size;
+            _residentCount++;
+
+            if(entry._lastRequestedFrame + delay < _frame) {
+                candidates.push_back({it->first, entry._lastRequestedFrame, size});
+            }
+        }
+
+        ++it;
+    }
+
+    // Fed back from what the visible textures asked for. One level less of bias is about four times the memory, so it
+    // only goes down once that would fit and does not flip every frame
+    if(_requestedBytes > _budget && _mipBias < MaxMipBias) {
+        _mipBias++;
+    } else if(_mipBias > 0 && _requestedBytes * 4 <= _budget) {
+        _mipBias--;
+    }
+
+    if(_residentBytes <= _budget) {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) {
+        return lhs._lastRequestedFrame < rhs._lastRequestedFrame;
+    });
+
+    for(const Candidate& candidate : candidates) {
+        if(_residentBytes <= _budget) {
+            break;
+        }
+
+        Entry& entry = _entries[candidate._key];
+        if(std::shared_ptr<Texture2D> texture = entry._texture.lock()) {
+            texture->FreeResource();
+        }
+
+        entry._bResident = false;
+        entry._residentLevels = 0;
+        _residentBytes -= candidate._size;
+        _residentCount--;
+    }
+}
+
+void TextureResidency::ReportFootprint(const std::shared_ptr<Texture2D>& texture, float pixels) {
+    if(!texture) {
+        return;
+    }
+
+    Entry& entry = GetEntry(texture);
+    if(entry._footprintFrame != _frame) {
+        entry._footprintFrame = _frame;
+        entry._footprint = 0.0f;
+    }
+    entry._footprint = std::max(entry._footprint, pixels);
+}
+
+std::shared_ptr<Texture2D> TextureResidency::Request(const std::shared_ptr<Texture2D>& texture) {
+    if(!texture) {
+        return GetPlaceholder();
+    }
+
+    Entry& entry = GetEntry(texture);
+    if(entry._lastRequestedFrame != _frame) {
+        entry._lastRequestedFrame = _frame;
+        entry._requestCount = 0;
+    }
+    entry._requestCount++;
+    entry._wantedLevels = GetWantedLevels(entry);
+
+    if(entry._bResident) {
+        Stream(entry, *texture);
+        return texture;
+    }
+
+    // Decoded off the main thread first, the more visible primitives use a texture the sooner it decodes
+    const float priority = UnloadedPriority + static_cast<float>(entry._requestCount);
+    if(!entry._decode && texture->NeedsDecode()) {
+        entry._decode = texture->RequestDecode(priority, _bBlockCompression);
+    }
+
+    if(entry._decode) {
+        entry._decode->SetPriority(priority);
+        if(!entry._decode->IsFinished()) {
+            return GetPlaceholder();
+        }
+    }
+
+    // Whoever is not admitted now asks again next frame while it stays visible. A finished decode keeps its pixels in the
+    // request meanwhile, still counted by the decoder, and BeginFrame drops them once the texture is out of view
+    if(_loadsThisFrame >= _maxLoadsPerFrame) {
+        return GetPlaceholder();
+    }
+
+    if(entry._decode) {
+        // A failed decode is admitted anyway, the reload reports it
+        if(entry._decode->GetState() == TextureDecodeRequest::State::Decoded) {
+            TakeDecodedImage(entry, *texture);
+        }
+        entry._decode.reset();
+    }
+
+    // The chain may only be known since the decode finished
+    entry._wantedLevels = GetWantedLevels(entry);
+    entry._residentLevels = entry._wantedLevels;
+    texture->SetMaxMipLevels(entry._residentLevels);
+
+    _loadsThisFrame++;
+    entry._bResident = true;
+    return texture;
+}
+
+std::shared_ptr<Texture2D> TextureResidency::Resolve(const std::shared_ptr<Texture2D>& texture) const {
+    if(texture) {
+        auto it = _entries.find(texture.get());
+        if(it != _entries.end() && it->second._bResident && it->second._texture.lock() == texture) {
+            return texture;
+        }
+    }
+
+    return _placeholder;
+}
+
+const std::shared_ptr<Texture2D>& TextureResidency::GetPlaceholder() {
+    if(!_placeholder) {
+        const std::uint32_t white = 0xFFFFFFFF;
+        _placeholder = TextureRegistry::Get().FindOrMakeFromData(1, 1, Format::FORMAT_R8G8B8A8_SRGB, &white, sizeof(white));
+    }
+
+    return _placeholder;
+}
+
+TextureResidency::Entry& TextureResidency::GetEntry(const std::shared_ptr<Texture2D>& texture) {
+    // A texture freed and made again at the same address before the next BeginFrame must not inherit the old state
+    Entry& entry = _entries[texture.get()];
+    if(entry._texture.lock() != texture) {
+        entry = {};
+        entry._texture = texture;
+    }
+
+    return entry;
+}
+
+std::uint32_t TextureResidency::GetWantedLevels(const Entry& entry) const {
+    // 0 uploads whatever was decoded
+    if(entry._levelCount == 0) {
+        return 0;
+    }
+
+    // The level with about one texel per pixel, a texture is assumed to span its user once
+    float level = 0.0f;
+    if(entry._footprintFrame == _frame) {
+        const float texels = static_cast<float>(std::max(entry._width, entry._height));
+        if(entry._footprint < texels) {
+            level = std::log2(texels / std::max(entry._footprint, 1.0f));
+        }
+    }
+
+    level += static_cast<float>(_mipBias);
+    std::uint32_t firstLevel = static_cast<std::uint32_t>(level);
+
+    // Finer than what is resident only once well past the threshold
+    if(entry._bResident && entry._residentLevels > 0) {
+        const std::uint32_t residentFirstLevel = entry._levelCount - std::min(entry._residentLevels, entry._levelCount);
+        if(firstLevel < residentFirstLevel) {
+            firstLevel = std::min(residentFirstLevel, static_cast<std::uint32_t>(level + FinerLevelMargin));
+        }
+    }
+
+    firstLevel = std::min(firstLevel, entry._levelCount - 1);
+    return entry._levelCount - firstLevel;
+}
+
+void TextureResidency::TakeDecodedImage(Entry& entry, Texture2D& texture) {
+    DecodedImage image = entry._decode->TakeImage();
+    entry._width = image._width;
+    entry._height = image._height;
+    entry._levelCount = image._levelCount;
+    entry._format = image._format;
+    texture.SetDecodedImage(std::move(image));
+}
+
+void TextureResidency::Stream(Entry& entry, Texture2D& texture) {
+    // Without a known chain there is nothing to pick levels from, textures without mips included
+    if(entry._levelCount <= 1) {
+        return;
+    }
+
+    // Finer levels whenever they are needed, coarser ones only give memory back once over the budget
+    const bool bFiner = entry._wantedLevels > entry._residentLevels;
+    const bool bCoarser = entry._wantedLevels < entry._residentLevels && _residentBytes > _budget;
+
+    if(!entry._decode) {
+        if(!bFiner && !bCoarser) {
+            return;
+        }
+
+        entry._decode = texture.RequestDecode(0.0f, _bBlockCompression);
+        if(!entry._decode) {
+            return;
+        }
+    }
+
+    // The more levels missing the sooner, dropping levels after anything that is missing some
+    entry._decode->SetPriority(bFiner ? static_cast<float>(entry._wantedLevels - entry._residentLevels) : 0.0f);
+    if(!entry._decode->IsFinished() || _loadsThisFrame >= _maxLoadsPerFrame) {
+        return;
+    }
+
+    // The whole chain was decoded, the levels are picked now in case they changed meanwhile
+    if(entry._decode->GetState() == TextureDecodeRequest::State::Decoded && (bFiner || bCoarser)) {
+        TakeDecodedImage(entry, texture);
+
+        // Frames in flight may still sample the current resource, it is kept until they are done
+        _retired.emplace_back(_frame, texture.DetachResource());
+        texture.SetMaxMipLevels(entry._wantedLevels);
+        entry._residentLevels = entry._wantedLevels;
+        _loadsThisFrame++;
+    }
+
+    entry._decode.reset();
+}
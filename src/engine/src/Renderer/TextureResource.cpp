@@ -36,7 +36,6 @@ void TextureResource::ClearDirty() {
 
 bool TextureResource::IsDirty() {
     if(!_buffer) {
-        assert(0);
         return false;
     }
     
@@ -0,0 +1,50 @@
+#include "Renderer/UniformFrameAllocator.hpp"
+#include "Renderer/Buffer.hpp"
+
+UniformFrameAllocator::~UniformFrameAllocator() {
+    if(_buffer && _mappedData) {
+        _buffer->UnlockBuffer();
+    }
+}
+
+bool UniformFrameAllocator::Initialize(Device* device, std::size_t size, std::size_t alignment) {
+    _buffer = Buffer::Create(device);
+    if(!_buffer) {
+        return false;
+    }
+    
+    _buffer->Initialize(EBufferType::BT_HOST, EBufferUsage::BU_Uniform, size);
+    
+    // Memory is host coherent, keep it mapped for the lifetime of the allocator
+    _mappedData = static_cast<std::byte*>(_buffer->LockBuffer());
+    _alignment = std::max<std::size_t>(alignment, 1);
+    _head = 0;
+    
+    return _mappedData != nullptr;
+}
+
+UniformFrameAllocator::Allocation UniformFrameAllocator::Allocate(std::size_t size) {
+    Allocation allocation;
+    
+    if(!_mappedData) {
+        return allocation;
+    }
+    
+    const std::size_t offset = (_head + _alignment - 1) / _alignment * _alignment;
+    if(offset + size > _buffer->GetSize()) {
+        std::cerr << "Uniform frame allocator is full, increase its size" << std::endl;
+        return allocation;
+    }
+    
+    _head = offset + size;
+    
+    allocation._buffer = _buffer;
+    allocation._offset = offset;
+    allocation._data = _mappedData + offset;
+    
+    return allocation;
+}
+
+void UniformFrameAllocator::Reset() {
+    _head = 0;
+}
@@ -1,9 +1,8 @@
 #include "Renderer/Vendor/Vulkan/ShaderCompiler.hpp"
+#include "Renderer/ShaderPermutation.hpp"
 #include "glslang/Include/glslang_c_interface.h"
 #include "vulkan/vulkan.hpp"
 
-// TODO https://github.com/KhronosGroup/SPIRV-Reflect to extract shader metadata so we dont need to be explicit when creating shaders..
-
 namespace {
     static glslang_resource_s InitResources() {
         glslang_resource_s Resources;
@@ -145,8 +144,90 @@ std::vector<char> ShaderCompiler::CompileStatic(const char* path, ShaderStage sh
     return std::vector<char>(shaderCode.begin(), shaderCode.end());
 }
 
+namespace {
+    std::size_t HashBinary(const std::string& path, ShaderStage shaderStage, const std::vector<std::string>& defines) {
+        std::size_t seed = hash_value(path, shaderStage);
+        for(const std::string& define : defines) {
+            hash_combine(seed, hash_value(define));
+        }
+        
+        return seed;
+    }
+}
+
+std::vector<unsigned int> ShaderCompiler::Compile(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines) {
+    std::shared_ptr<ShaderBinary> binary = CompileBinary(path, shaderStage, defines);
+    if(!binary) {
+        return {};
+    }
+    
+    return binary->_spirv;
+}
+
+std::shared_ptr<ShaderBinary> ShaderCompiler::CompileBinary(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines) {
+    const std::size_t hash = HashBinary(path, shaderStage, defines);
+    
+    std::shared_ptr<ShaderBinary> binary;
+    if(_binaries.TryGet(hash, binary)) {
+        return binary;
+    }
+    
+    binary = CompileAndReflect(path, shaderStage, defines);
+    if(!binary) {
+        return nullptr;
+    }
+    
+    _binaries.Put(hash, binary);
+    return binary;
+}
+
+bool ShaderCompiler::Recompile(const std::string& path) {
+    std::vector<std::shared_ptr<ShaderBinary>> permutations;
+    _binaries.ForEach([&](std::size_t, const std::shared_ptr<ShaderBinary>& binary) {
+        if(binary->_path == path) {
+            permutations.push_back(binary);
+        }
+    });
+    
+    // Compile everything before touching the cache, a broken permutation keeps all of them on the previous version
+    std::vector<std::shared_ptr<ShaderBinary>> recompiled;
+    for(const std::shared_ptr<ShaderBinary>& permutation : permutations) {
+        std::shared_ptr<ShaderBinary> binary = CompileAndReflect(path.c_str(), permutation->_stage, permutation->_defines);
+        if(!binary) {
+            return false;
+        }
+        
+        recompiled.push_back(std::move(binary));
+    }
+    
+    for(const std::shared_ptr<ShaderBinary>& binary : recompiled) {
+        _binaries.Put(HashBinary(binary->_path, binary->_stage, binary->_defines), binary, true);
+    }
+    
+    return true;
+}
+
+std::shared_ptr<ShaderBinary> ShaderCompiler::CompileAndReflect(const char* path, ShaderStage shaderStage, const std::vector<std::string>& defines) {
+    std::shared_ptr<ShaderBinary> binary = std::make_shared<ShaderBinary>();
+    binary->_path = path;
+    binary->_stage = shaderStage;
+    binary->_defines = defines;
+    binary->_spirv = CompileSPIRV(path, shaderStage, defines);
+    
+    if(binary->_spirv.empty()) {
+        return nullptr;
+    }
+    
+    if(!ShaderReflection::Reflect(binary->_spirv, shaderStage, binary->_reflection)) {
+        std::cerr << "Failed to reflect shader " << path << std::endl;
+        return nullptr;
+    }
+    
+    return binary;
+}
+
 // TODO try without using gslang use a precompiled shader
-std::vector<unsigned int> ShaderCompiler::Compile(const char *path, ShaderStage shaderStage) {
+std::vector<unsigned int> ShaderCompiler::CompileSPIRV(const char *path, ShaderStage shaderStage, const std::vector<std::string>& defines) {
     std::ifstream shader_file;
     shader_file.open(path, std::ios::binary);
 
@@ -157,7 +238,7 @@ std::vector<unsigned int> ShaderCompiler::Compile(const char *path, ShaderStage
     std::stringstream shader_buffer;
     shader_buffer << shader_file.rdbuf();
 
-    const std::string shaderCode = shader_buffer.str();
+    const std::string shaderCode = ShaderPermutation::InjectDefines(shader_buffer.str(), defines);
 
     glslang_resource_s resources = InitResources();
 
@@ -177,6 +258,7 @@ std::vector<unsigned int> ShaderCompiler::Compile(const char *path, ShaderStage
         .resource = reinterpret_cast<const glslang_resource_t*>(&resources),
     };
     
+    std::lock_guard<std::mutex> lock(_glslangMutex);
     glslang_initialize_process();
     
     glslang_shader_t* shader = glslang_shader_create(&input);
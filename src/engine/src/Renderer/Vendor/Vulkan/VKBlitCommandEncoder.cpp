@@ -3,6 +3,7 @@
 #include "Renderer/Texture2D.hpp"
 #include "Renderer/Vendor/Vulkan/VKCommandBuffer.hpp"
 #include "Renderer/Vendor/Vulkan/VKBuffer.hpp"
+#include "Renderer/Vendor/Vulkan/VKGraphicsContext.hpp"
 #include "Renderer/Vendor/Vulkan/VkTextureResource.hpp"
 
 void VKBlitCommandEncoder::UploadBuffer(std::shared_ptr<Buffer> buffer) {
@@ -30,35 +31,40 @@ void VKBlitCommandEncoder::UploadImageBuffer(std::shared_ptr<Texture2D> texture)
     VkBuffer hostBuffer = buffer ? buffer->GetHostBuffer() : VK_NULL_HANDLE;
         
     if(buffer && image && hostBuffer) {
-        VkBufferCopy copyRegion {};
-        copyRegion.size = buffer->GetSize();
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        
-        VkImageSubresourceLayers subResource {};
-        subResource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        subResource.layerCount = 1;
-        subResource.mipLevel = 0;
-        subResource.baseArrayLayer = 0;
-        
-        VkExtent3D extent;
-        extent.width = texture->GetWidth();
-        extent.height = texture->GetHeight();
-        extent.depth = 1;
-        
-        VkBufferImageCopy imageCopy {};
-        imageCopy.bufferImageHeight = 0;
-        imageCopy.bufferOffset = 0;
-        imageCopy.bufferRowLength = 0;
-        imageCopy.imageExtent = extent;
-        imageCopy.imageSubresource = subResource;
-        imageCopy.imageOffset = {0 , 0, 0};
+        // One copy per mip level, they are packed one after the other in the host buffer
+        std::vector<VkBufferImageCopy> imageCopies(texture->GetMipLevels());
+        for(std::uint32_t level = 0; level < texture->GetMipLevels(); level++) {
+            VkImageSubresourceLayers subResource {};
+            subResource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            subResource.layerCount = 1;
+            subResource.mipLevel = level;
+            subResource.baseArrayLayer = 0;
+            
+            VkExtent3D extent;
+            extent.width = MipGenerator::GetLevelExtent(texture->GetWidth(), level);
+            extent.height = MipGenerator::GetLevelExtent(texture->GetHeight(), level);
+            extent.depth = 1;
+            
+            VkBufferImageCopy& imageCopy = imageCopies[level];
+            imageCopy.bufferImageHeight = 0;
+            imageCopy.bufferOffset = MipGenerator::GetLevelOffset(texture->GetPixelFormat(), texture->GetWidth(), texture->GetHeight(), level);
+            imageCopy.bufferRowLength = 0;
+            imageCopy.imageExtent = extent;
+            imageCopy.imageSubresource = subResource;
+            imageCopy.imageOffset = {0 , 0, 0};
+        }
         
         VkCommandBuffer commandBuffer = dynamic_cast<VKCommandBuffer *>(_commandBuffer)->GetVkCommandBuffer();
-        VkFunc::vkCmdCopyBufferToImage(commandBuffer, hostBuffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+        VkFunc::vkCmdCopyBufferToImage(commandBuffer, hostBuffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<std::uint32_t>(imageCopies.size()), imageCopies.data());
         
         // Texture is now on the gpu, lets clear the dirty flag
         buffer->ClearDirty();
+
+        // The context keeps the staging until the copy ran, the texture keeps no CPU side copy of its pixels
+        if(texture->HasTransientStaging()) {
+            static_cast<VKGraphicsContext*>(_graphicsContext)->Retire(buffer->DetachStaging());
+        }
     }
 }
 
@@ -2,6 +2,39 @@
 #include "Renderer/Vendor/Vulkan/VKDevice.hpp"
 #include "Renderer/Vendor/Vulkan/VkTextureResource.hpp"
 
+namespace {
+    void DestroyBuffer(VkDevice device, VkBuffer buffer, VkDeviceMemory memory) {
+        if(buffer != VK_NULL_HANDLE) {
+            VkFunc::vkDestroyBuffer(device, buffer, nullptr);
+        }
+        if(memory != VK_NULL_HANDLE) {
+            VkFunc::vkFreeMemory(device, memory, nullptr);
+        }
+    }
+
+    // Owns a buffer handed over by Detach
+    struct DetachedBuffer {
+        VkDevice _device = VK_NULL_HANDLE;
+        VkBuffer _buffer = VK_NULL_HANDLE;
+        VkDeviceMemory _memory = VK_NULL_HANDLE;
+
+        ~DetachedBuffer() {
+            DestroyBuffer(_device, _buffer, _memory);
+        }
+    };
+}
+
+VKBuffer::~VKBuffer() {
+    VKDevice* device = dynamic_cast<VKDevice*>(_device);
+    if(!device) {
+        return;
+    }
+
+    // Image buffers only have the memory of their image as local memory, the image is retired along with it
+    device->Retire(Detach(_stagingBuffer, _stagingBufferMemory));
+    device->Retire(Detach(_localBuffer, _localBufferMemory));
+}
+
 void VKBuffer::Initialize(EBufferType type, EBufferUsage usage, size_t allocSize) {
     if(type == EBufferType::BT_HOST && usage == EBufferUsage::BU_Uniform) {
         type = (EBufferType)(type | EBufferType::BT_LOCAL);
@@ -46,7 +79,6 @@ void VKBuffer::Initialize(EBufferType type, EBufferUsage usage, size_t allocSize
         std::tie(_localBuffer, _localBufferMemory) = MakeBuffer(vkBufferUsage, (VkMemoryPropertyFlagBits) VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     }
     
-    // TODO unmapp and destroy buffers on destructor
 //    VkFunc::vkMapMemory(_renderContext->GetLogicalDeviceHandle(), _stagingBufferMemory, 0, _size, 0, &_cpuData);
 }
 
@@ -66,6 +98,26 @@ void VKBuffer::UnlockBuffer() {
     }
 };
 
+std::shared_ptr<void> VKBuffer::DetachStaging() {
+    return Detach(_stagingBuffer, _stagingBufferMemory);
+}
+
+std::shared_ptr<void> VKBuffer::Detach(VkBuffer& buffer, VkDeviceMemory& memory) const {
+    VKDevice* device = dynamic_cast<VKDevice*>(_device);
+    if(!device || (buffer == VK_NULL_HANDLE && memory == VK_NULL_HANDLE)) {
+        return nullptr;
+    }
+
+    auto detached = std::make_shared<DetachedBuffer>();
+    detached->_device = device->GetLogicalDeviceHandle();
+    detached->_buffer = buffer;
+    detached->_memory = memory;
+
+    buffer = VK_NULL_HANDLE;
+    memory = VK_NULL_HANDLE;
+    return detached;
+}
+
 std::pair<VkBuffer, VkDeviceMemory> VKBuffer::MakeBuffer(VkBufferUsageFlags usage, VkMemoryPropertyFlagBits memoryFlags) const {
         VkBufferCreateInfo bufferCreateInfo {};
         bufferCreateInfo.flags = 0;
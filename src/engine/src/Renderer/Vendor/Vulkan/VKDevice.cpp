@@ -1,4 +1,5 @@
 #include "Renderer/Vendor/Vulkan/VKDevice.hpp"
+#include "Renderer/Vendor/Vulkan/VKGraphicsContext.hpp"
 #include "window.hpp"
 
 #if defined(__APPLE__)
@@ -39,6 +40,12 @@ void VKDevice::Shutdown() {
     VkFunc::vkDeviceWaitIdle(logical_device_);
 }
 
+void VKDevice::Retire(std::shared_ptr<void> resource) {
+    if(VKGraphicsContext* context = _recordingContext.load()) {
+        context->Retire(std::move(resource));
+    }
+}
+
 bool VKDevice::CreateVulkanInstance() { 
     if (VkFunc::vkEnumerateInstanceVersion(&loader_version_) != VK_SUCCESS)
     {
@@ -4,6 +4,7 @@
 #include "Renderer/Vendor/Vulkan/VKDescriptorSetsManager.hpp"
 #include "Renderer/Vendor/Vulkan/VKSamplerManager.hpp"
 #include "Renderer/Texture2D.hpp"
+#include "Renderer/UniformFrameAllocator.hpp"
 #include "Renderer/Swapchain.hpp"
 #include "Renderer/Fence.hpp"
 #include "Renderer/Event.hpp"
@@ -20,7 +21,12 @@ VKGraphicsContext::VKGraphicsContext(Device* device)
     _device = device;
 }
 
-VKGraphicsContext::~VKGraphicsContext() {}
+VKGraphicsContext::~VKGraphicsContext() {
+    // Whatever is released later has nothing left in flight, the device waited for idle before the contexts go
+    if(VKDevice* device = static_cast<VKDevice*>(_device); device && device->GetRecordingContext() == this) {
+        device->SetRecordingContext(nullptr);
+    }
+}
 
 bool VKGraphicsContext::Initialize() {
     GraphicsContext::Initialize();
@@ -46,6 +52,12 @@ bool VKGraphicsContext::Initialize() {
     
     _descriptorsManager = std::make_unique<VKDescriptorManager>();
     
+    constexpr std::size_t uniformFrameAllocatorSize = 1024 * 1024;
+    _uniformFrameAllocator = std::make_unique<UniformFrameAllocator>();
+    if(!_uniformFrameAllocator->Initialize(_device, uniformFrameAllocatorSize, _device->GetMinUniformBufferOffsetAlignment())) {
+        return false;
+    }
+    
     return true;
 }
 
@@ -53,9 +65,27 @@ void VKGraphicsContext::BeginFrame() {
     // Make sure that we only record new data into the command buffer, once it already submited previous work
     _fence->Wait();
     
+    // The gpu is done with the previous frame of this context, its uniform slices can be reused and what it retired freed.
+    // Swapped out first, releasing a resource may retire the ones it holds
+    _uniformFrameAllocator->Reset();
+    std::vector<std::shared_ptr<void>> retired;
+    {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        retired.swap(_retired);
+    }
+    retired.clear();
+    static_cast<VKDevice*>(_device)->SetRecordingContext(this);
+    
     _commandBuffer->BeginRecording();
 }
 
+void VKGraphicsContext::Retire(std::shared_ptr<void> resource) {
+    if(resource) {
+        std::lock_guard<std::mutex> lock(_retiredMutex);
+        _retired.push_back(std::move(resource));
+    }
+}
+
 void VKGraphicsContext::EndFrame() {
     if(_device->GetSwapchain()) {
         if(!_device->GetSwapchain()->PrepareNextImage()) {
@@ -12,29 +12,104 @@
 
 #include "glm/ext.hpp"
 
+namespace {
+    // Owns the objects of a destroyed pipeline until the frames in flight that may still bind it are done
+    struct RetiredPipeline {
+        VkDevice _device = VK_NULL_HANDLE;
+        std::vector<VkFramebuffer> _frameBuffers;
+        VkPipeline _pipeline = VK_NULL_HANDLE;
+        VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+        VkRenderPass _renderPass = VK_NULL_HANDLE;
+        std::vector<VkDescriptorSetLayout> _descriptorSetLayouts;
+
+        ~RetiredPipeline() {
+            for(VkFramebuffer frameBuffer : _frameBuffers) {
+                VkFunc::vkDestroyFramebuffer(_device, frameBuffer, nullptr);
+            }
+            
+            if(_pipeline != VK_NULL_HANDLE) {
+                VkFunc::vkDestroyPipeline(_device, _pipeline, nullptr);
+            }
+            
+            if(_pipelineLayout != VK_NULL_HANDLE) {
+                VkFunc::vkDestroyPipelineLayout(_device, _pipelineLayout, nullptr);
+            }
+            
+            if(_renderPass != VK_NULL_HANDLE) {
+                VkFunc::vkDestroyRenderPass(_device, _renderPass, nullptr);
+            }
+            
+            for(VkDescriptorSetLayout descriptorSetLayout : _descriptorSetLayouts) {
+                VkFunc::vkDestroyDescriptorSetLayout(_device, descriptorSetLayout, nullptr);
+            }
+        }
+    };
+}
+
+VKGraphicsPipeline::~VKGraphicsPipeline() {
+    VKDevice* device = (VKDevice*)_params._device;
+    
+    // Evicted from the cache or replaced by a hot reload, recorded frames may still use it
+    auto retired = std::make_shared<RetiredPipeline>();
+    retired->_device = device->GetLogicalDeviceHandle();
+    for(auto [hash, frameBuffer] : _frameBuffers) {
+        retired->_frameBuffers.push_back(frameBuffer);
+    }
+    retired->_pipeline = _pipeline;
+    retired->_pipelineLayout = _pipelineLayout;
+    retired->_renderPass = _renderPass;
+    retired->_descriptorSetLayouts = std::move(_descriptorSetLayouts);
+    _frameBuffers.clear();
+    
+    device->Retire(std::move(retired));
+}
+
 void VKGraphicsPipeline::Compile() {
     if(_bWasCompiled)
         return;
     
-    CompileShaders();
+    // Shader errors are not fatal, hot reload keeps the previous pipeline when the new one fails to compile
+    if(!CompileShaders()) {
+        std::cerr << "Failed to compile shaders " << _params._vsParams._shaderPath << ", " << _params._fsParams._shaderPath << std::endl;
+        return;
+    }
     
     VKShader* vShader = (VKShader*)(_vertexShader.get());
     VKShader* fShader = (VKShader*)(_fragmentShader.get());
+    
+    if(!vShader || !fShader) {
+        assert(0);
+        return;
+    }
+    
+    // The layout is derived from what the shaders actually declare, not from the pass data streams
+    _reflection = ShaderReflection::Merge(vShader->GetReflection(), fShader->GetReflection());
+    
+    // Passes still describe their data streams by hand, one out of sync with its shaders is rejected like a shader error
+    if(!_reflection.ValidateDataStreams(_params._vsParams._shaderDataStreams)) {
+        std::cerr << "Data streams do not match the layout of " << _params._vsParams._shaderPath << ", " << _params._fsParams._shaderPath << std::endl;
+        return;
+    }
+    
+    // Drawing with spilled uniforms that are never bound would read garbage, rejected like a shader error as well
+    if(!BuildDataPackingPlan()) {
+        return;
+    }
             
     VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
     pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
     pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
 
-    VkPushConstantRange constantRange = BuildPushConstants();
-    if(constantRange.size > 0) {
-        pipelineLayoutCreateInfo.pPushConstantRanges = &constantRange;
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    std::vector<VkPushConstantRange> constantRanges = BuildPushConstants();
+    if(!constantRanges.empty()) {
+        pipelineLayoutCreateInfo.pPushConstantRanges = constantRanges.data();
+        pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<unsigned int>(constantRanges.size());
     }
     
-    std::vector<VkDescriptorSetLayout> descriptorLayouts = BuildDescriptorSetLayouts();
-    pipelineLayoutCreateInfo.pSetLayouts = descriptorLayouts.data();
-    pipelineLayoutCreateInfo.setLayoutCount = static_cast<unsigned int>(descriptorLayouts.size());
+    _descriptorSetLayouts = BuildDescriptorSetLayouts();
+    pipelineLayoutCreateInfo.pSetLayouts = _descriptorSetLayouts.data();
+    pipelineLayoutCreateInfo.setLayoutCount = static_cast<unsigned int>(_descriptorSetLayouts.size());
     pipelineLayoutCreateInfo.pNext = nullptr;
     pipelineLayoutCreateInfo.flags = 0;
     
@@ -462,77 +537,113 @@ VKGraphicsPipeline::VertexStateData VKGraphicsPipeline::BuildVertexStateData() {
     return std::make_pair(inputBindingDescriptors, inputAttributesDescriptors);
 }
 
-VkPushConstantRange VKGraphicsPipeline::BuildPushConstants() {
-    VkPushConstantRange constantRange;
-    constantRange.size = 0;
-    constantRange.offset = 0;
-    constantRange.stageFlags = 0;
+std::vector<VkPushConstantRange> VKGraphicsPipeline::BuildPushConstants() {
+    std::vector<VkPushConstantRange> constantRanges;
+    
+    for(const ShaderPushConstantRange& pushConstant : _reflection._pushConstants) {
+        VkPushConstantRange constantRange {};
+        constantRange.offset = pushConstant._offset;
+        constantRange.size = pushConstant._size;
+        constantRange.stageFlags = TranslateShaderStage(pushConstant._stage);
+        constantRanges.push_back(constantRange);
+    }
+
+    return constantRanges;
+}
+
+bool VKGraphicsPipeline::BuildDataPackingPlan() {
+    const std::vector<ShaderDataStream>& dataStreams = _params._vsParams._shaderDataStreams;
+    
+    _dataPackingPlan = ShaderDataPackingPlan::Build(dataStreams, _params._device->SupportsPushConstants(), _params._device->GetMaxPushConstantsSize());
+    _spillSet = static_cast<std::uint32_t>(std::count_if(dataStreams.begin(), dataStreams.end(), [](const ShaderDataStream& dataStream) {
+        return dataStream._usage == ShaderDataStreamUsage::DATA;
+    }));
     
-    const std::vector<ShaderDataStream>& dataStreams = _params._renderPass->CollectShaderDataStreams();
-    for(const ShaderDataStream& dataStream : dataStreams) {
-        if(dataStream._usage != ShaderDataStreamUsage::PUSH_CONSTANT) {
+    if(_dataPackingPlan.HasSpill()) {
+        const ShaderResourceBinding* spillBinding = _reflection.FindBinding(_spillSet, 0);
+        if(!spillBinding || spillBinding->_usage != ShaderDataBlockUsage::UNIFORM_BUFFER) {
+            std::cerr << "Push constants exceed the device limits but the shaders do not declare a uniform block at set " << _spillSet << ", binding 0: "
+                      << _params._vsParams._shaderPath << ", " << _params._fsParams._shaderPath << std::endl;
+            return false;
+        }
+    }
+    
+    // Split the push constant bytes on every range boundary, each piece is pushed with the stages of the ranges covering it
+    std::vector<std::uint32_t> boundaries = {0, _dataPackingPlan.GetPushConstantsSize()};
+    for(const ShaderPushConstantRange& range : _reflection._pushConstants) {
+        boundaries.push_back(std::min(range._offset, _dataPackingPlan.GetPushConstantsSize()));
+        boundaries.push_back(std::min(range._offset + range._size, _dataPackingPlan.GetPushConstantsSize()));
+    }
+    
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+    
+    _pushConstantUpdates.clear();
+    for(std::size_t i = 0; i + 1 < boundaries.size(); i++) {
+        const std::uint32_t begin = boundaries[i];
+        const std::uint32_t end = boundaries[i + 1];
+        
+        VkShaderStageFlags stageFlags = 0;
+        for(const ShaderPushConstantRange& range : _reflection._pushConstants) {
+            if(range._offset <= begin && range._offset + range._size >= end) {
+                stageFlags |= TranslateShaderStage(range._stage);
+            }
+        }
+        
+        // Bytes no shader reads
+        if(stageFlags == 0) {
             continue;
         }
         
-        for(const ShaderDataBlock& dataBlock : dataStream._dataBlocks) {
-            constantRange.size += dataBlock._size;
-            constantRange.stageFlags |= TranslateShaderStage(dataBlock._stage);
+        if(!_pushConstantUpdates.empty() && _pushConstantUpdates.back()._stageFlags == stageFlags && _pushConstantUpdates.back()._offset + _pushConstantUpdates.back()._size == begin) {
+            _pushConstantUpdates.back()._size += end - begin;
+            continue;
         }
+        
+        _pushConstantUpdates.push_back({begin, end - begin, stageFlags});
     }
-
-    return constantRange;
+    
+    return true;
 }
 
 std::vector<VkDescriptorSetLayout> VKGraphicsPipeline::BuildDescriptorSetLayouts() {
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
 
-    const std::vector<ShaderDataStream>& dataStreams = _params._renderPass->CollectShaderDataStreams();
-    for(const ShaderDataStream& dataStream : dataStreams) {
-        if(dataStream._usage != ShaderDataStreamUsage::DATA) {
-            continue;
-        }
-
+    // Sets that the shaders skip still need a (empty) layout so set indices stay stable
+    for(std::uint32_t set = 0; set < _reflection.GetSetCount(); set++) {
         std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
 
-        unsigned int binding = 0;
-        for(const ShaderDataBlock& dataBlock : dataStream._dataBlocks) {
-            VkDescriptorSetLayoutBinding descriptorSetLayoutBinding {};
-            descriptorSetLayoutBinding.binding = binding;
-            descriptorSetLayoutBinding.descriptorCount = 1;
-            descriptorSetLayoutBinding.stageFlags = TranslateShaderStage(dataBlock._stage);
-
-            if(dataBlock._usage == ShaderDataBlockUsage::UNIFORM_BUFFER) {
-                descriptorSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        for(const ShaderResourceBinding& resourceBinding : _reflection._bindings) {
+            if(resourceBinding._set != set) {
+                continue;
             }
             
-            if(dataBlock._usage == ShaderDataBlockUsage::TEXTURE) {
-                descriptorSetLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
-            }
+            VkDescriptorSetLayoutBinding descriptorSetLayoutBinding {};
+            descriptorSetLayoutBinding.binding = resourceBinding._binding;
+            descriptorSetLayoutBinding.descriptorCount = resourceBinding._count;
+            descriptorSetLayoutBinding.descriptorType = TranslateShaderBlockUsage(resourceBinding._usage);
+            descriptorSetLayoutBinding.stageFlags = TranslateShaderStage(resourceBinding._stage);
+            descriptorSetLayoutBinding.pImmutableSamplers = nullptr;
             
             layoutBindings.push_back(descriptorSetLayoutBinding);
-            
-            binding++;
         }
         
-        if(!layoutBindings.empty()) {
-            VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo {};
-            descriptorSetLayoutInfo.bindingCount = layoutBindings.size();
-            descriptorSetLayoutInfo.flags = 0;
-            descriptorSetLayoutInfo.pBindings = layoutBindings.data();
-            descriptorSetLayoutInfo.pNext = nullptr;
-            descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-            
-            VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
-            VkResult result = VkFunc::vkCreateDescriptorSetLayout(((VKDevice*)_params._device)->GetLogicalDeviceHandle(), &descriptorSetLayoutInfo, nullptr, &descriptorSetLayout);
-            
-            if (result != VK_SUCCESS) {
-                assert(0);
-                return {};
-            }
-            
-            descriptorSetLayouts.push_back(descriptorSetLayout);
+        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutInfo {};
+        descriptorSetLayoutInfo.bindingCount = static_cast<unsigned int>(layoutBindings.size());
+        descriptorSetLayoutInfo.flags = 0;
+        descriptorSetLayoutInfo.pBindings = layoutBindings.data();
+        descriptorSetLayoutInfo.pNext = nullptr;
+        descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        VkResult result = VkFunc::vkCreateDescriptorSetLayout(((VKDevice*)_params._device)->GetLogicalDeviceHandle(), &descriptorSetLayoutInfo, nullptr, &descriptorSetLayout);
+        
+        if (result != VK_SUCCESS) {
+            assert(0);
+            return {};
         }
+        
+        descriptorSetLayouts.push_back(descriptorSetLayout);
     }
     
     return descriptorSetLayouts;
@@ -12,6 +12,7 @@
 #include "Renderer/Vendor/Vulkan/VKDevice.hpp"
 #include "Renderer/Vendor/Vulkan/VKSamplerManager.hpp"
 #include "Renderer/Vendor/Vulkan/VKTextureView.hpp"
+#include "Renderer/UniformFrameAllocator.hpp"
 
 void VKRenderCommandEncoder::BeginRenderPass(GraphicsPipeline* pipeline, const RenderAttachments& attachments) {
     auto* vkPipeline = dynamic_cast<VKGraphicsPipeline*>(pipeline);
@@ -73,6 +74,17 @@ void VKRenderCommandEncoder::EndRenderPass() {
     VkFunc::vkCmdEndRenderPass(commandBuffer);
 }
 
+void VKRenderCommandEncoder::BindPipeline(GraphicsPipeline* pipeline) {
+    auto* vkPipeline = dynamic_cast<VKGraphicsPipeline*>(pipeline);
+    if(!vkPipeline || !vkPipeline->IsCompiled()) {
+        assert(0);
+        return;
+    }
+    
+    VkCommandBuffer commandBuffer = ((VKCommandBuffer*)_commandBuffer)->GetVkCommandBuffer();
+    VkFunc::vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vkPipeline->GetVKPipeline());
+}
+
 void VKRenderCommandEncoder::SetViewport(const glm::vec2& viewportSize) {
     VkViewport viewport;
     viewport.height = viewportSize.y;
@@ -98,96 +110,30 @@ void VKRenderCommandEncoder::SetScissor(const glm::vec2& extent, const glm::vec2
 void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipeline, const std::vector<ShaderDataStream> dataStreams) {
     VKGraphicsPipeline* pipeline = (VKGraphicsPipeline*)graphicsPipeline;
     
-    bool bBackendSupportsPushConstants = true;
-    if(bBackendSupportsPushConstants) {
-        VkShaderStageFlags stageFlags {};
-
-        std::vector<const ShaderDataBlock*> vertexBlocks;
-        std::vector<const ShaderDataBlock*> fragmentBlocks;
-        
-        // Compute necessary size for the push constant allocation and isolate data blocks
-        std::size_t allocationSize = 0;
-        for (const auto& dataStream : dataStreams) {
-            if (dataStream._usage != ShaderDataStreamUsage::PUSH_CONSTANT) {
-                continue;
-            }
-            
-            for (const auto& block : dataStream._dataBlocks) {
-                allocationSize += block._size;
-                stageFlags |= TranslateShaderStage(block._stage);
-                
-                std::vector<const ShaderDataBlock*>& blockVectors = block._stage == ShaderStage::STAGE_VERTEX ? vertexBlocks : fragmentBlocks;
-                blockVectors.push_back(&block);
-            }
-        }
-        
-        // Sort data streams, this sort will be vertex and then fragment (stable sort to preserve insertion order)
-      /*  std::stable_sort(streams.begin(), streams.end(), [](const ShaderDataStream& a, const ShaderDataStream& b) {
-            return (unsigned int)a._stage < (unsigned int)b._stage;
-        });*/
-        
-        // Allocate buffer based on calculated sizes
-        std::byte buffer[allocationSize];
-
-        // Track current offset within each buffer
-        std::size_t bytesCopied = 0;
-        std::size_t fragmentDataStart = 0;
-
-        // Copy the vertex data blocks
-        for(const auto* block : vertexBlocks) {
-            std::memcpy(buffer + bytesCopied, &block->_data, block->_size);
-            bytesCopied += block->_size;
-        }
-
-        fragmentDataStart = bytesCopied;
-        
-        for(const auto* block : fragmentBlocks) {
-            std::memcpy(buffer + bytesCopied, &block->_data, block->_size);
-            bytesCopied += block->_size;
-        }
-        
-        // Copy the data to our buffer
-        /*for (const auto& dataStream : dataStreams) {
-            
-            if(dataStream._usage != ShaderDataStreamUsage::PUSH_CONSTANT) {
-                continue;
-            }
-            
-            if(dataStream._stage == ShaderStage::STAGE_FRAGMENT) {
-                fragmentDataStart = bytesCopied;
-            }
-            
-            if (dataStream._usage == ShaderDataStreamUsage::PUSH_CONSTANT) {
-                for (const auto& block : dataStream._dataBlocks) {
-                    std::memcpy(buffer + bytesCopied, &block._data, block._size);
-                    bytesCopied += block._size;
-                }
-            }
-        }
-         */
-        
-        VkCommandBuffer commandBuffer = ((VKCommandBuffer*)_commandBuffer)->GetVkCommandBuffer();
-        
-        if(stageFlags & VK_SHADER_STAGE_VERTEX_BIT) {
-            const auto dataSize = fragmentDataStart > 0 ? fragmentDataStart : allocationSize;
-
-            VkFunc::vkCmdPushConstants(commandBuffer, pipeline->GetVKPipelineLayout(), stageFlags, 0, dataSize, buffer);
-        }
-        
-        if(stageFlags & VK_SHADER_STAGE_FRAGMENT_BIT) {
-            const auto dataSize = fragmentDataStart > 0 ? allocationSize - fragmentDataStart : allocationSize;
-            const auto bufferPtr = fragmentDataStart > 0 ? buffer + fragmentDataStart : buffer;
-            
-            VkFunc::vkCmdPushConstants(commandBuffer, pipeline->GetVKPipelineLayout(), stageFlags, fragmentDataStart, dataSize, bufferPtr);
-        }
-    }
-    
     auto* context = dynamic_cast<VKGraphicsContext *>(_graphicsContext);
     if(!context) {
         assert(0);
         return;
     }
-
+    
+    VkCommandBuffer commandBuffer = ((VKCommandBuffer*)_commandBuffer)->GetVkCommandBuffer();
+    
+    // The layout was planned when the pipeline compiled, here we only copy the values and push them
+    const ShaderDataPackingPlan& packingPlan = pipeline->GetDataPackingPlan();
+    UniformFrameAllocator::Allocation spillAllocation;
+    
+    if(packingPlan.HasSpill()) {
+        spillAllocation = context->GetUniformFrameAllocator()->Allocate(packingPlan.GetSpillSize());
+    }
+    
+    if(packingPlan.GetPushConstantsSize() > 0 || spillAllocation._data) {
+        packingPlan.Pack(dataStreams, _pushConstantsStaging.data(), spillAllocation._data);
+    }
+    
+    for(const VKGraphicsPipeline::PushConstantUpdate& update : pipeline->GetPushConstantUpdates()) {
+        VkFunc::vkCmdPushConstants(commandBuffer, pipeline->GetVKPipelineLayout(), update._stageFlags, update._offset, update._size, _pushConstantsStaging.data() + update._offset);
+    }
+    
     VKDescriptorManager* descriptorManager = context->GetDescriptorManager();
     if(!descriptorManager) {
         assert(0);
@@ -201,13 +147,20 @@ void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipel
     }
     
     std::vector<VkDescriptorSet> sets;
+    const ShaderReflection& reflection = pipeline->GetReflection();
     
+    // Data streams map to descriptor sets in declaration order, the layout itself comes from the shader reflection
     for(const auto& dataStream : dataStreams) {
         if(dataStream._usage == ShaderDataStreamUsage::PUSH_CONSTANT) {
             continue;
         }
         
-        VkDescriptorSet descriptorSet = descriptorManager->AcquireDescriptorSet(_graphicsContext, dataStream);
+        const std::uint32_t set = static_cast<std::uint32_t>(sets.size());
+        if(set >= reflection.GetSetCount()) {
+            break;
+        }
+        
+        VkDescriptorSet descriptorSet = descriptorManager->AcquireDescriptorSet(_graphicsContext, pipeline->GetVKDescriptorSetLayout(set));
 
         if(descriptorSet == VK_NULL_HANDLE) {
             assert(0);
@@ -218,15 +171,28 @@ void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipel
         
         std::vector<VkWriteDescriptorSet> writes;
         
-        unsigned int binding = 0;
+        // Write infos are referenced by pointer until the update, keep them alive for the whole set
+        std::vector<VkDescriptorBufferInfo> bufferInfos;
+        std::vector<VkDescriptorImageInfo> imageInfos;
+        bufferInfos.reserve(dataStream._dataBlocks.size());
+        imageInfos.reserve(dataStream._dataBlocks.size());
+        
+        unsigned int nextBinding = 0;
         for(const auto& block : dataStream._dataBlocks) {
+            const unsigned int binding = nextBinding++;
+            
+            // Blocks the shaders do not use have no binding in the layout
+            if(!reflection.FindBinding(set, binding)) {
+                continue;
+            }
+            
             VkWriteDescriptorSet writeDescriptor {};
             writeDescriptor.dstSet = descriptorSet;
             writeDescriptor.dstBinding = binding;
             writeDescriptor.descriptorCount = 1;
             writeDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 
-            if(block._usage == ShaderDataBlockUsage::UNIFORM_BUFFER) {
+            if(block._usage == ShaderDataBlockUsage::UNIFORM_BUFFER || block._usage == ShaderDataBlockUsage::STORAGE_BUFFER) {
                 if(!std::holds_alternative<ShaderBufferResource>(block._data)) {
                     assert(0);
                     continue;
@@ -238,12 +204,12 @@ void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipel
                     continue;
                 }
                 
-                VkDescriptorBufferInfo bufferInfo {};
+                VkDescriptorBufferInfo& bufferInfo = bufferInfos.emplace_back();
                 bufferInfo.offset = std::get<ShaderBufferResource>(block._data)._offset;
                 bufferInfo.range = vkBuffer->GetSize() - bufferInfo.offset;
                 bufferInfo.buffer = vkBuffer->GetHostBuffer();
                 
-                writeDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                writeDescriptor.descriptorType = TranslateShaderBlockUsage(block._usage);
                 writeDescriptor.pBufferInfo = &bufferInfo;
                 
                 vkBuffer->ClearDirty();
@@ -276,7 +242,7 @@ void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipel
                     continue;
                 }
 
-                VkDescriptorImageInfo imageInfo {};
+                VkDescriptorImageInfo& imageInfo = imageInfos.emplace_back();
                 imageInfo.imageView = textureView->GetImageView();
                 imageInfo.imageLayout = TranslateImageLayout(texture2D->GetCurrentLayout());
                 imageInfo.sampler = sampler;
@@ -291,8 +257,37 @@ void VKRenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsPipel
         VkFunc::vkUpdateDescriptorSets(((VKDevice*)_graphicsContext->GetDevice())->GetLogicalDeviceHandle(), writes.size(), writes.data(), 0, VK_NULL_HANDLE);
     }
     
+    // Spilled push constants live in the set right after the data streams, the pipeline only compiles when the shaders
+    // declare it
+    if(spillAllocation._data) {
+        if(sets.size() != pipeline->GetSpillSet() || !reflection.FindBinding(pipeline->GetSpillSet(), 0)) {
+            assert(0 && "Spilled push constants have no uniform block to be bound to");
+            return;
+        }
+        
+        VkDescriptorSet descriptorSet = descriptorManager->AcquireDescriptorSet(_graphicsContext, pipeline->GetVKDescriptorSetLayout(pipeline->GetSpillSet()));
+        VKBuffer* vkBuffer = (VKBuffer*)spillAllocation._buffer.get();
+        
+        if(descriptorSet != VK_NULL_HANDLE && vkBuffer) {
+            VkDescriptorBufferInfo bufferInfo {};
+            bufferInfo.buffer = vkBuffer->GetHostBuffer();
+            bufferInfo.offset = spillAllocation._offset;
+            bufferInfo.range = packingPlan.GetSpillSize();
+            
+            VkWriteDescriptorSet writeDescriptor {};
+            writeDescriptor.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptor.dstSet = descriptorSet;
+            writeDescriptor.dstBinding = 0;
+            writeDescriptor.descriptorCount = 1;
+            writeDescriptor.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            writeDescriptor.pBufferInfo = &bufferInfo;
+            
+            VkFunc::vkUpdateDescriptorSets(((VKDevice*)_graphicsContext->GetDevice())->GetLogicalDeviceHandle(), 1, &writeDescriptor, 0, VK_NULL_HANDLE);
+            sets.push_back(descriptorSet);
+        }
+    }
+    
     if(!sets.empty()) {
-        VkCommandBuffer commandBuffer = ((VKCommandBuffer*)_commandBuffer)->GetVkCommandBuffer();
         VkPipelineLayout layout = ((VKGraphicsPipeline*)pipeline)->GetVKPipelineLayout();
         VkFunc::vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, sets.size(), sets.data(), 0, nullptr);
     }
@@ -314,6 +309,15 @@ void VKRenderCommandEncoder::DrawPrimitiveIndexed(const PrimitiveProxyComponent&
     VkCommandBuffer commandBuffer = ((VKCommandBuffer*)_commandBuffer)->GetVkCommandBuffer();
     VkFunc::vkCmdBindIndexBuffer(commandBuffer, gpuBuffer, indicesOffset, VK_INDEX_TYPE_UINT32);
     VkFunc::vkCmdBindVertexBuffers(commandBuffer ,0, 1, &gpuBuffer, offsets.data());
+    
+    // Only the meshlets that survived culling, one draw per run of them
+    if(proxy._bDrawRanges) {
+        for(const IndexRange& range : proxy._drawRanges) {
+            VkFunc::vkCmdDrawIndexed(commandBuffer, range._indexCount, 1, range._firstIndex, 0, 0);
+        }
+        return;
+    }
+    
     VkFunc::vkCmdDrawIndexed(commandBuffer, proxy._indicesCount, 1, 0, 0, 0);
 }
 
@@ -335,7 +339,7 @@ void VKRenderCommandEncoder::MakeImageBarrier(Texture2D *texture2D, ImageLayout
     VkImageSubresourceRange subresource;
     subresource.aspectMask = bIsDepth ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
     subresource.baseMipLevel = 0;
-    subresource.levelCount = 1;
+    subresource.levelCount = texture2D->GetMipLevels();
     subresource.baseArrayLayer = 0;
     subresource.layerCount = 1;
 
@@ -390,34 +394,39 @@ void VKRenderCommandEncoder::UploadImageBuffer(std::shared_ptr<Texture2D> textur
     VkBuffer hostBuffer = buffer ? buffer->GetHostBuffer() : VK_NULL_HANDLE;
         
     if(buffer && image && hostBuffer) {
-        VkBufferCopy copyRegion {};
-        copyRegion.size = buffer->GetSize();
-        copyRegion.srcOffset = 0;
-        copyRegion.dstOffset = 0;
-        
-        VkImageSubresourceLayers subResource {};
-        subResource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        subResource.layerCount = 1;
-        subResource.mipLevel = 0;
-        subResource.baseArrayLayer = 0;
-        
-        VkExtent3D extent;
-        extent.width = texture->GetWidth();
-        extent.height = texture->GetHeight();
-        extent.depth = 1;
-        
-        VkBufferImageCopy imageCopy {};
-        imageCopy.bufferImageHeight = 0;
-        imageCopy.bufferOffset = 0;
-        imageCopy.bufferRowLength = 0;
-        imageCopy.imageExtent = extent;
-        imageCopy.imageSubresource = subResource;
-        imageCopy.imageOffset = {0 , 0, 0};
+        // One copy per mip level, they are packed one after the other in the host buffer
+        std::vector<VkBufferImageCopy> imageCopies(texture->GetMipLevels());
+        for(std::uint32_t level = 0; level < texture->GetMipLevels(); level++) {
+            VkImageSubresourceLayers subResource {};
+            subResource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            subResource.layerCount = 1;
+            subResource.mipLevel = level;
+            subResource.baseArrayLayer = 0;
+            
+            VkExtent3D extent;
+            extent.width = MipGenerator::GetLevelExtent(texture->GetWidth(), level);
+            extent.height = MipGenerator::GetLevelExtent(texture->GetHeight(), level);
+            extent.depth = 1;
+            
+            VkBufferImageCopy& imageCopy = imageCopies[level];
+            imageCopy.bufferImageHeight = 0;
+            imageCopy.bufferOffset = MipGenerator::GetLevelOffset(texture->GetPixelFormat(), texture->GetWidth(), texture->GetHeight(), level);
+            imageCopy.bufferRowLength = 0;
+            imageCopy.imageExtent = extent;
+            imageCopy.imageSubresource = subResource;
+            imageCopy.imageOffset = {0 , 0, 0};
+        }
         
         VkCommandBuffer commandBuffer = dynamic_cast<VKCommandBuffer *>(_commandBuffer)->GetVkCommandBuffer();
-        VkFunc::vkCmdCopyBufferToImage(commandBuffer, hostBuffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+        VkFunc::vkCmdCopyBufferToImage(commandBuffer, hostBuffer, image, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<std::uint32_t>(imageCopies.size()), imageCopies.data());
         
         // Texture is now on the gpu, lets clear the dirty flag
         buffer->ClearDirty();
+
+        // The context keeps the staging until the copy ran, the texture keeps no CPU side copy of its pixels
+        if(texture->HasTransientStaging()) {
+            static_cast<VKGraphicsContext*>(_graphicsContext)->Retire(buffer->DetachStaging());
+        }
     }
 }
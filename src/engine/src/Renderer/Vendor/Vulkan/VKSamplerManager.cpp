@@ -27,6 +27,8 @@ VkSampler VKSamplerManager::AcquireSampler(GraphicsContext *graphicsContext, con
     createInfo.addressModeW = TranslateWrapMode(sampler._wrapW);
     createInfo.magFilter = TranslateFilter(sampler._magFilter);
     createInfo.minFilter = TranslateFilter(sampler._minFilter);
+    createInfo.mipmapMode = TranslateMipmapMode(sampler._mipMapFilter);
+    createInfo.maxLod = VK_LOD_CLAMP_NONE; // Every level the view has, left at 0 only the first one is ever sampled
     createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     
     VkSampler vkSampler = VK_NULL_HANDLE;
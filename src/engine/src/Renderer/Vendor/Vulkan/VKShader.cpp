@@ -4,17 +4,26 @@
 #include "Renderer/Vendor/Vulkan/VulkanTranslator.hpp"
 #include "Renderer/Vendor/Vulkan/ShaderCompiler.hpp"
 
+VKShader::~VKShader() {
+    // Pipelines keep their own copy of the code, the module is only needed to create them
+    if(_shaderStageInfo.module != VK_NULL_HANDLE) {
+        VkFunc::vkDestroyShaderModule(((VKDevice*)_device)->GetLogicalDeviceHandle(), _shaderStageInfo.module, nullptr);
+    }
+}
+
 bool VKShader::Compile() {
     if(_bWasCompiled)
         return true;
     
     _path = _params._shaderPath;
     
-    std::vector<unsigned int> shaderCode = std::move(ShaderCompiler::Get().Compile(_path.c_str(), _stage));
+    std::shared_ptr<ShaderBinary> binary = ShaderCompiler::Get().CompileBinary(_path.c_str(), _stage, _params._defines);
     
-    if(shaderCode.size() == 0)
+    if(!binary || binary->_spirv.size() == 0)
         return false;
     
+    const std::vector<unsigned int>& shaderCode = binary->_spirv;
+    
     VkShaderModuleCreateInfo moduleCreateInfo {};
     moduleCreateInfo.flags = 0;
     moduleCreateInfo.codeSize = shaderCode.size() * sizeof(unsigned int);
@@ -37,6 +46,7 @@ bool VKShader::Compile() {
     _shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     _shaderStageInfo.pSpecializationInfo = nullptr;
 
+    _reflection = binary->_reflection;
     _bWasCompiled = true;
     
     return true;
@@ -4,6 +4,18 @@
 #include "Renderer/Buffer.hpp"
 #include "Renderer/Texture2D.hpp"
 
+namespace {
+    // Owns an image handed over by FreeResource
+    struct RetiredImage {
+        VkDevice _device = VK_NULL_HANDLE;
+        VkImage _image = VK_NULL_HANDLE;
+
+        ~RetiredImage() {
+            VkFunc::vkDestroyImage(_device, _image, nullptr);
+        }
+    };
+}
+
 void VkTextureResource::CreateResource() {
     if(_texture) {
         // We do not need to create a buffer because this resource is externally managed
@@ -36,10 +48,15 @@ void VkTextureResource::SetExternalResource(void* handle) {
 }
 
 void VkTextureResource::FreeResource() {
-    _buffer.reset();
+    // Frames in flight may still sample the image, it is retired along with the buffer owning its memory
     if(_device && _image && !_bIsExternalResource) {
-        VkFunc::vkDestroyImage(((VKDevice*)_device)->GetLogicalDeviceHandle(), _image, nullptr);
+        auto image = std::make_shared<RetiredImage>();
+        image->_device = ((VKDevice*)_device)->GetLogicalDeviceHandle();
+        image->_image = _image;
+        ((VKDevice*)_device)->Retire(std::move(image));
     }
+    _image = VK_NULL_HANDLE;
+    _buffer.reset();
 }
 
 bool VkTextureResource::HasValidResource() {
@@ -70,7 +87,7 @@ VkImage VkTextureResource::GetImage() {
         createInfo.arrayLayers = 1;
         createInfo.imageType = VK_IMAGE_TYPE_2D;
         createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        createInfo.mipLevels = 1;
+        createInfo.mipLevels = _texture->GetMipLevels();
         createInfo.pNext = nullptr;
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -74,23 +74,42 @@ void WebGPUBlitCommandEncoder::UploadImageBuffer(std::shared_ptr<Texture2D> text
             return;
         }
         
-        WGPUImageCopyBuffer imageCopyBuffer {};
-        imageCopyBuffer.buffer = hostBuffer;
-        imageCopyBuffer.layout.bytesPerRow = texture->GetWidth() * sizeof(float);
-        imageCopyBuffer.layout.rowsPerImage = texture->GetWidth();
-        imageCopyBuffer.layout.offset = 0;
-        
-        WGPUImageCopyTexture imageCopyTexture {};
-        imageCopyTexture.texture = textureResource->GetWGPUTexture();
-        
-        WGPUExtent3D extent {};
-        extent.width = texture->GetWidth();
-        extent.height = texture->GetHeight();
-        extent.depthOrArrayLayers = 1;
-        
-        wgpuCommandEncoderCopyBufferToTexture(_encoder, &imageCopyBuffer, &imageCopyTexture, &extent);
+        // One copy per mip level, laid out in the host buffer by the resource
+        for(std::uint32_t level = 0; level < textureResource->GetMipLevelCount(); level++) {
+            std::uint32_t width = MipGenerator::GetLevelExtent(texture->GetWidth(), level);
+            std::uint32_t height = MipGenerator::GetLevelExtent(texture->GetHeight(), level);
+
+            // Compressed levels are copied in whole blocks, the smallest ones included
+            if(BlockCompression::IsCompressed(texture->GetPixelFormat())) {
+                width = (width + BlockCompression::BlockExtent - 1) / BlockCompression::BlockExtent * BlockCompression::BlockExtent;
+                height = (height + BlockCompression::BlockExtent - 1) / BlockCompression::BlockExtent * BlockCompression::BlockExtent;
+            }
+
+            const WebGPUTextureResource::LevelLayout& layout = textureResource->GetLevelLayout(level);
+            WGPUImageCopyBuffer imageCopyBuffer {};
+            imageCopyBuffer.buffer = hostBuffer;
+            imageCopyBuffer.layout.bytesPerRow = layout._bytesPerRow;
+            imageCopyBuffer.layout.rowsPerImage = layout._rowCount;
+            imageCopyBuffer.layout.offset = layout._offset;
+            
+            WGPUImageCopyTexture imageCopyTexture {};
+            imageCopyTexture.texture = textureResource->GetWGPUTexture();
+            imageCopyTexture.mipLevel = level;
+            
+            WGPUExtent3D extent {};
+            extent.width = width;
+            extent.height = height;
+            extent.depthOrArrayLayers = 1;
+            
+            wgpuCommandEncoderCopyBufferToTexture(_encoder, &imageCopyBuffer, &imageCopyTexture, &extent);
+        }
         // std::cout << "wgpuCommandEncoderCopyBufferToTexture (BLIT)" << std::endl;
         texture->ClearDirty();
+
+        // The encoder holds on to the host buffer until the copy ran, the texture keeps no CPU side copy of its pixels
+        if(texture->HasTransientStaging()) {
+            textureResource->ReleaseStaging();
+        }
         return;
     }
     
@@ -178,3 +178,17 @@ void WebGPUBuffer::UnlockBuffer() {
         _bIsMapped = false;
     }
 }
+
+void WebGPUBuffer::ReleaseBuffers() {
+    if(_staginBuffer) {
+        wgpuBufferRelease(_staginBuffer);
+        _staginBuffer = nullptr;
+        _mappedMemory = nullptr;
+        _bIsMapped = false;
+    }
+
+    if(_localBuffer) {
+        wgpuBufferRelease(_localBuffer);
+        _localBuffer = nullptr;
+    }
+}
@@ -157,6 +157,10 @@ void WebGPUGraphicsPipeline::Compile() {
                 bindingLayout.buffer.type = WGPUBufferBindingType_Uniform;
                 bindingLayout.buffer.minBindingSize = dataBlock._size;
             }
+            else if (dataBlock._usage == ShaderDataBlockUsage::STORAGE_BUFFER) {
+                bindingLayout.buffer.type = WGPUBufferBindingType_ReadOnlyStorage;
+                bindingLayout.buffer.minBindingSize = dataBlock._size;
+            }
             else if (dataBlock._usage == ShaderDataBlockUsage::TEXTURE) {
                 // Handle Textures
                 bindingLayout.texture.sampleType = WGPUTextureSampleType_Float; // Or other types as needed
@@ -113,6 +113,16 @@ void WebGPURenderCommandEncoder::BeginRenderPass(GraphicsPipeline *pipeline, con
         // std::cout << "wgpuRenderPassEncoderSetPipeline (RENDER)" << std::endl;
 }
 
+void WebGPURenderCommandEncoder::BindPipeline(GraphicsPipeline *pipeline) {
+    WebGPUGraphicsPipeline* wgpuPipeline = (WebGPUGraphicsPipeline*)(pipeline);
+    if(!wgpuPipeline || !_encoderPass) {
+        assert(0);
+        return;
+    }
+
+    wgpuRenderPassEncoderSetPipeline(_encoderPass, wgpuPipeline->GetWebGPUPipeline());
+}
+
 void WebGPURenderCommandEncoder::EndRenderPass() {
     
     wgpuRenderPassEncoderEnd(_encoderPass);
@@ -177,7 +187,7 @@ void WebGPURenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsP
             bindGroupEntry.offset = 0;
             bindGroupEntry.binding = binding;
 
-            if(dataBlock._usage == ShaderDataBlockUsage::UNIFORM_BUFFER) {
+            if(dataBlock._usage == ShaderDataBlockUsage::UNIFORM_BUFFER || dataBlock._usage == ShaderDataBlockUsage::STORAGE_BUFFER) {
                 if(!std::holds_alternative<ShaderBufferResource>(dataBlock._data)) {
                     assert(false);
                     continue;
@@ -230,6 +240,9 @@ void WebGPURenderCommandEncoder::DispatchDataStreams(GraphicsPipeline* graphicsP
                 samplerDescriptor.addressModeW = TranslateWrapMode(tr._sampler._wrapW);
                 samplerDescriptor.magFilter = TranslateTextureFilter(tr._sampler._magFilter);
                 samplerDescriptor.minFilter = TranslateTextureFilter(tr._sampler._minFilter);
+                samplerDescriptor.mipmapFilter = TranslateMipmapFilter(tr._sampler._mipMapFilter);
+                samplerDescriptor.lodMinClamp = 0.0f;
+                samplerDescriptor.lodMaxClamp = 32.0f;
                 samplerDescriptor.maxAnisotropy = 1;
                 
                 // TODO avoid creating samplers all the time, can we do the same as vulkan?
@@ -284,6 +297,13 @@ void WebGPURenderCommandEncoder::DrawPrimitiveIndexed(const PrimitiveProxyCompon
         wgpuRenderPassEncoderSetVertexBuffer(_encoderPass, 0, wgpuBuffer->GetLocalBuffer(), proxy._vertexOffset, WGPU_WHOLE_SIZE);
         // std::cout << "wgpuRenderPassEncoderSetVertexBuffer (RENDER)" << std::endl;
 
+        if(proxy._bDrawRanges) {
+            for(const IndexRange& range : proxy._drawRanges) {
+                wgpuRenderPassEncoderDrawIndexed(_encoderPass, range._indexCount, 1, range._firstIndex, 0, 0);
+            }
+            return;
+        }
+
         wgpuRenderPassEncoderDrawIndexed(_encoderPass, proxy._indicesCount, 1, 0, 0, 0);
         // std::cout << "wgpuRenderPassEncoderDrawIndexed (RENDER)" << std::endl;
     }
@@ -354,23 +374,42 @@ void WebGPURenderCommandEncoder::UploadImageBuffer(std::shared_ptr<Texture2D> te
             return;
         }
         
-        WGPUImageCopyBuffer imageCopyBuffer {};
-        imageCopyBuffer.buffer = hostBuffer;
-        imageCopyBuffer.layout.bytesPerRow = texture->GetWidth() * sizeof(float);
-        imageCopyBuffer.layout.rowsPerImage = texture->GetWidth();
-        imageCopyBuffer.layout.offset = 0;
-        
-        WGPUImageCopyTexture imageCopyTexture {};
-        imageCopyTexture.texture = textureResource->GetWGPUTexture();
-        
-        WGPUExtent3D extent {};
-        extent.width = texture->GetWidth();
-        extent.height = texture->GetHeight();
-        extent.depthOrArrayLayers = 1;
-        
-        wgpuCommandEncoderCopyBufferToTexture(_encoder, &imageCopyBuffer, &imageCopyTexture, &extent);
+        // One copy per mip level, laid out in the host buffer by the resource
+        for(std::uint32_t level = 0; level < textureResource->GetMipLevelCount(); level++) {
+            std::uint32_t width = MipGenerator::GetLevelExtent(texture->GetWidth(), level);
+            std::uint32_t height = MipGenerator::GetLevelExtent(texture->GetHeight(), level);
+
+            // Compressed levels are copied in whole blocks, the smallest ones included
+            if(BlockCompression::IsCompressed(texture->GetPixelFormat())) {
+                width = (width + BlockCompression::BlockExtent - 1) / BlockCompression::BlockExtent * BlockCompression::BlockExtent;
+                height = (height + BlockCompression::BlockExtent - 1) / BlockCompression::BlockExtent * BlockCompression::BlockExtent;
+            }
+
+            const WebGPUTextureResource::LevelLayout& layout = textureResource->GetLevelLayout(level);
+            WGPUImageCopyBuffer imageCopyBuffer {};
+            imageCopyBuffer.buffer = hostBuffer;
+            imageCopyBuffer.layout.bytesPerRow = layout._bytesPerRow;
+            imageCopyBuffer.layout.rowsPerImage = layout._rowCount;
+            imageCopyBuffer.layout.offset = layout._offset;
+            
+            WGPUImageCopyTexture imageCopyTexture {};
+            imageCopyTexture.texture = textureResource->GetWGPUTexture();
+            imageCopyTexture.mipLevel = level;
+            
+            WGPUExtent3D extent {};
+            extent.width = width;
+            extent.height = height;
+            extent.depthOrArrayLayers = 1;
+            
+            wgpuCommandEncoderCopyBufferToTexture(_encoder, &imageCopyBuffer, &imageCopyTexture, &extent);
+        }
         // std::cout << "wgpuCommandEncoderCopyBufferToTexture (RENDER)" << std::endl;
         texture->ClearDirty();
+
+        // The encoder holds on to the host buffer until the copy ran, the texture keeps no CPU side copy of its pixels
+        if(texture->HasTransientStaging()) {
+            textureResource->ReleaseStaging();
+        }
         return;
     }
     
@@ -22,6 +22,22 @@ void WebGPUTextureResource::CreateResource() {
         return;
     }
     
+    // Every level is staged with its rows padded for the copy, each level then starts at a multiple of CopyRowAlignment too
+    const Format format = _texture->GetPixelFormat();
+    _mipLevelCount = std::max<std::uint32_t>(_texture->GetMipLevels(), 1);
+    _levelLayouts.resize(_mipLevelCount);
+
+    std::uint64_t stagingSize = 0;
+    for(std::uint32_t level = 0; level < _mipLevelCount; level++) {
+        const std::size_t rowPitch = BlockCompression::GetRowPitch(format, MipGenerator::GetLevelExtent(_texture->GetWidth(), level));
+
+        LevelLayout& layout = _levelLayouts[level];
+        layout._offset = stagingSize;
+        layout._bytesPerRow = static_cast<std::uint32_t>((rowPitch + CopyRowAlignment - 1) / CopyRowAlignment * CopyRowAlignment);
+        layout._rowCount = BlockCompression::GetRowCount(format, MipGenerator::GetLevelExtent(_texture->GetHeight(), level));
+        stagingSize += static_cast<std::uint64_t>(layout._bytesPerRow) * layout._rowCount;
+    }
+    
     std::array<WGPUTextureFormat, 1> viewFormats = {TranslateFormat(_texture->GetPixelFormat())};
         
     WGPUTextureDescriptor textureDescriptor {};
@@ -29,7 +45,7 @@ void WebGPUTextureResource::CreateResource() {
     textureDescriptor.size = {_texture->GetWidth(), _texture->GetHeight(), 1};
     textureDescriptor.format = TranslateFormat(_texture->GetPixelFormat());
     textureDescriptor.label = "give a label..";
-    textureDescriptor.mipLevelCount = 1;
+    textureDescriptor.mipLevelCount = _mipLevelCount;
     textureDescriptor.sampleCount = 1;
     textureDescriptor.usage = TranslateTextureUsageFlags(_texture->GetTextureFlags());
     textureDescriptor.viewFormats = viewFormats.data();
@@ -46,7 +62,7 @@ void WebGPUTextureResource::CreateResource() {
         _buffer = Buffer::Create(_device, _texture->GetResource());
         
         if(_buffer) {
-            _buffer->Initialize(EBufferType::BT_HOST, EBufferUsage::BU_Texture, _texture->GetImageDataSize());
+            _buffer->Initialize(EBufferType::BT_HOST, EBufferUsage::BU_Texture, stagingSize);
         }
     }
 }
@@ -75,7 +91,8 @@ void* WebGPUTextureResource::Lock() {
         return nullptr;
     }
     
-    return _buffer->LockBuffer();
+    _lockedData = _buffer->LockBuffer();
+    return _lockedData;
 }
 
 void WebGPUTextureResource::Unlock() {
@@ -83,6 +100,22 @@ void WebGPUTextureResource::Unlock() {
         assert(0);
         return;
     }
-    
+
+    // Every padded row is at or past its packed place, moving them from the last one down never overwrites a row that
+    // was not moved yet
+    if(auto* data = static_cast<std::uint8_t*>(_lockedData)) {
+        const Format format = _texture->GetPixelFormat();
+        for(std::uint32_t level = _mipLevelCount; level-- > 0;) {
+            const LevelLayout& layout = _levelLayouts[level];
+            const std::size_t rowPitch = BlockCompression::GetRowPitch(format, MipGenerator::GetLevelExtent(_texture->GetWidth(), level));
+            const std::size_t packedOffset = MipGenerator::GetLevelOffset(format, _texture->GetWidth(), _texture->GetHeight(), level);
+
+            for(std::uint32_t row = layout._rowCount; row-- > 0;) {
+                std::memmove(data + layout._offset + static_cast<std::size_t>(row) * layout._bytesPerRow, data + packedOffset + row * rowPitch, rowPitch);
+            }
+        }
+        _lockedData = nullptr;
+    }
+
     _buffer->UnlockBuffer();
 }
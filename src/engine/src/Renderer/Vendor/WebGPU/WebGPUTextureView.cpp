@@ -17,7 +17,7 @@ void WebGPUTextureView::CreateView(Format format, const Range &levels, TextureTy
     viewDescriptor.format = TranslateFormat(format);
     viewDescriptor.dimension = WGPUTextureViewDimension_2D;
     viewDescriptor.baseMipLevel = 0;
-    viewDescriptor.mipLevelCount = 1;
+    viewDescriptor.mipLevelCount = std::min(levels.count(), textureResource->GetMipLevelCount());
     viewDescriptor.baseArrayLayer = 0;
     viewDescriptor.arrayLayerCount = 1;
     viewDescriptor.aspect = WGPUTextureAspect_All;
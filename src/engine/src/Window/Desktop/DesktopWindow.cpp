@@ -82,6 +82,13 @@ glm::i32vec2 DesktopWindow::GetWindowSurfaceSize() const {
     return size;
 }
 
+glm::i32vec2 DesktopWindow::GetWindowSize() const {
+    glm::i32vec2 size;
+    glfwGetWindowSize(_window, &size.x, &size.y);
+
+    return size;
+}
+
 std::tuple<std::uint32_t, const char **> DesktopWindow::GetRequiredExtensions() {
     uint32_t glfwExtensionCount = 0;
     const char** extensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
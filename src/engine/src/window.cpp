@@ -74,6 +74,10 @@ glm::i32vec2 Window::GetWindowSurfaceSize() const {
     return {};
 }
 
+glm::i32vec2 Window::GetWindowSize() const {
+    return GetWindowSurfaceSize();
+}
+
 void Window::HideCursor() const {
     //assert(0);
 }
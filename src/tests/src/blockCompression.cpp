@@ -0,0 +1,172 @@
+#include "gtest/gtest.h"
+#include "Renderer/BlockCompression.hpp"
+#include <cmath>
+
+namespace {
+    using Texel = std::array<int, 4>;
+
+    // Diagonal gradient between two colors with some noise, what a block of a material texture mostly looks like
+    std::vector<std::uint8_t> MakeImage(std::uint32_t width, std::uint32_t height, bool bOpaque) {
+        std::vector<std::uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+        std::uint32_t noise = 1;
+        for(std::uint32_t y = 0; y < height; y++) {
+            for(std::uint32_t x = 0; x < width; x++) {
+                noise = noise * 1664525u + 1013904223u;
+                const std::uint32_t t = (x * 3 + y * 5) % 256;
+                std::uint8_t* texel = &rgba[(static_cast<std::size_t>(y) * width + x) * 4];
+                texel[0] = static_cast<std::uint8_t>(t);
+                texel[1] = static_cast<std::uint8_t>(255 - t / 2);
+                texel[2] = static_cast<std::uint8_t>(64 + t / 4 + (noise >> 29));
+                texel[3] = bOpaque ? 255 : static_cast<std::uint8_t>(255 - t);
+            }
+        }
+        return rgba;
+    }
+
+    Texel Expand565(std::uint16_t color) {
+        const int r = color >> 11;
+        const int g = (color >> 5) & 63;
+        const int b = color & 31;
+        return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2, 255};
+    }
+
+    // Reference decoders, straight from the format descriptions
+    void DecodeBc1(const std::uint8_t* block, std::array<Texel, 16>& texels) {
+        std::uint16_t c0, c1;
+        std::uint32_t indices;
+        std::memcpy(&c0, block, 2);
+        std::memcpy(&c1, block + 2, 2);
+        std::memcpy(&indices, block + 4, 4);
+
+        std::array<Texel, 4> palette = {Expand565(c0), Expand565(c1)};
+        for(std::size_t channel = 0; channel < 3; channel++) {
+            const int a = palette[0][channel];
+            const int b = palette[1][channel];
+            palette[2][channel] = c0 > c1 ? (2 * a + b) / 3 : (a + b) / 2;
+            palette[3][channel] = c0 > c1 ? (a + 2 * b) / 3 : 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = c0 > c1 ? 255 : 0;
+
+        for(std::size_t i = 0; i < 16; i++) {
+            texels[i] = palette[(indices >> (i * 2)) & 3];
+        }
+    }
+
+    void DecodeBc4(const std::uint8_t* block, std::size_t channel, std::array<Texel, 16>& texels) {
+        const int a0 = block[0];
+        const int a1 = block[1];
+        std::array<int, 8> palette = {a0, a1};
+        for(int index = 2; index < 8; index++) {
+            palette[index] = a0 > a1 ? ((8 - index) * a0 + (index - 1) * a1) / 7 : index < 6 ? ((6 - index) * a0 + (index - 1) * a1) / 5 : (index == 6 ? 0 : 255);
+        }
+
+        std::uint64_t indices = 0;
+        for(std::size_t byte = 0; byte < 6; byte++) {
+            indices |= static_cast<std::uint64_t>(block[2 + byte]) << (byte * 8);
+        }
+        for(std::size_t i = 0; i < 16; i++) {
+            texels[i][channel] = palette[(indices >> (i * 3)) & 7];
+        }
+    }
+
+    void DecodeBc7Mode6(const std::uint8_t* block, std::array<Texel, 16>& texels) {
+        std::size_t bit = 0;
+        auto Read = [&](std::size_t count) {
+            std::uint32_t value = 0;
+            for(std::size_t i = 0; i < count; i++, bit++) {
+                value |= static_cast<std::uint32_t>((block[bit / 8] >> (bit % 8)) & 1) << i;
+            }
+            return value;
+        };
+
+        ASSERT_EQ(Read(7), 1u << 6);
+        std::array<Texel, 2> endpoints;
+        for(std::size_t channel = 0; channel < 4; channel++) {
+            endpoints[0][channel] = static_cast<int>(Read(7));
+            endpoints[1][channel] = static_cast<int>(Read(7));
+        }
+        for(Texel& endpoint : endpoints) {
+            const int pbit = static_cast<int>(Read(1));
+            for(int& value : endpoint) {
+                value = value << 1 | pbit;
+            }
+        }
+
+        constexpr std::array<int, 16> Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+        for(std::size_t i = 0; i < 16; i++) {
+            const std::uint32_t index = Read(i == 0 ? 3 : 4);
+            for(std::size_t channel = 0; channel < 4; channel++) {
+                texels[i][channel] = ((64 - Weights[index]) * endpoints[0][channel] + Weights[index] * endpoints[1][channel] + 32) >> 6;
+            }
+        }
+    }
+
+    // Root mean square error of the given channels over the image, decoding the blocks back
+    float GetError(Format format, const std::vector<std::uint8_t>& rgba, std::uint32_t width, std::uint32_t height, const std::vector<std::size_t>& channels) {
+        std::vector<std::uint8_t> blocks(BlockCompression::GetImageDataSize(format, width, height));
+        BlockCompression::Compress(format, rgba.data(), width, height, blocks.data());
+
+        const std::uint32_t blocksX = (width + 3) / 4;
+        double sum = 0.0;
+        for(std::uint32_t y = 0; y < height; y++) {
+            for(std::uint32_t x = 0; x < width; x++) {
+                const std::uint8_t* block = &blocks[((y / 4) * blocksX + x / 4) * BlockCompression::GetBlockSize(format)];
+                std::array<Texel, 16> texels {};
+                switch(format) {
+                    case Format::FORMAT_BC1_RGBA_SRGB: DecodeBc1(block, texels); break;
+                    case Format::FORMAT_BC3_SRGB: DecodeBc1(block + 8, texels); DecodeBc4(block, 3, texels); break;
+                    case Format::FORMAT_BC5_UNORM: DecodeBc4(block, 0, texels); DecodeBc4(block + 8, 1, texels); break;
+                    case Format::FORMAT_BC7_SRGB: DecodeBc7Mode6(block, texels); break;
+                    default: break;
+                }
+
+                const Texel& texel = texels[(y % 4) * 4 + x % 4];
+                for(std::size_t channel : channels) {
+                    const double delta = texel[channel] - rgba[(static_cast<std::size_t>(y) * width + x) * 4 + channel];
+                    sum += delta * delta;
+                }
+            }
+        }
+
+        return static_cast<float>(std::sqrt(sum / (static_cast<double>(width) * height * channels.size())));
+    }
+}
+
+TEST(BlockCompression, RoundTripsWithinErrorBounds) {
+    const std::uint32_t width = 37;
+    const std::uint32_t height = 22;
+    const std::vector<std::uint8_t> opaque = MakeImage(width, height, true);
+    const std::vector<std::uint8_t> transparent = MakeImage(width, height, false);
+
+    EXPECT_EQ(BlockCompression::GetImageDataSize(Format::FORMAT_BC1_RGBA_SRGB, width, height), 10 * 6 * 8);
+    EXPECT_EQ(BlockCompression::GetImageDataSize(Format::FORMAT_BC7_SRGB, width, height), 10 * 6 * 16);
+    EXPECT_EQ(BlockCompression::GetImageDataSize(Format::FORMAT_R8G8B8A8_SRGB, width, height), width * height * 4);
+
+    const float bc1Error = GetError(Format::FORMAT_BC1_RGBA_SRGB, opaque, width, height, {0, 1, 2});
+    EXPECT_LT(bc1Error, 3.0f);
+    EXPECT_LT(GetError(Format::FORMAT_BC3_SRGB, transparent, width, height, {0, 1, 2}), 3.0f);
+    EXPECT_LT(GetError(Format::FORMAT_BC3_SRGB, transparent, width, height, {3}), 1.5f);
+    EXPECT_LT(GetError(Format::FORMAT_BC5_UNORM, opaque, width, height, {0, 1}), 1.5f);
+    EXPECT_LT(GetError(Format::FORMAT_BC7_SRGB, transparent, width, height, {0, 1, 2, 3}), 2.0f);
+    EXPECT_LT(GetError(Format::FORMAT_BC7_SRGB, opaque, width, height, {0, 1, 2}), bc1Error * 0.75f);
+}
+
+TEST(BlockCompression, ChoosesFormatFromContent) {
+    const std::vector<std::uint8_t> opaque = MakeImage(8, 8, true);
+    std::vector<std::uint8_t> transparent = opaque;
+    transparent.back() = 254;
+
+    EXPECT_EQ(BlockCompression::ChooseFormat(TextureCompression::Color, opaque.data(), 8, 8), Format::FORMAT_BC1_RGBA_SRGB);
+    EXPECT_EQ(BlockCompression::ChooseFormat(TextureCompression::Color, transparent.data(), 8, 8), Format::FORMAT_BC3_SRGB);
+    EXPECT_EQ(BlockCompression::ChooseFormat(TextureCompression::ColorHighQuality, opaque.data(), 8, 8), Format::FORMAT_BC7_SRGB);
+    EXPECT_EQ(BlockCompression::ChooseFormat(TextureCompression::TwoChannel, opaque.data(), 8, 8), Format::FORMAT_BC5_UNORM);
+    EXPECT_EQ(BlockCompression::ChooseFormat(TextureCompression::None, opaque.data(), 8, 8), Format::FORMAT_R8G8B8A8_SRGB);
+
+    // A flat block is exact in every format
+    const std::vector<std::uint8_t> flat(4 * 4 * 4, 255);
+    std::array<std::uint8_t, 16> block;
+    BlockCompression::Compress(Format::FORMAT_BC1_RGBA_SRGB, flat.data(), 4, 4, block.data());
+    EXPECT_EQ(GetError(Format::FORMAT_BC1_RGBA_SRGB, flat, 4, 4, {0, 1, 2, 3}), 0.0f);
+    EXPECT_EQ(GetError(Format::FORMAT_BC7_SRGB, flat, 4, 4, {0, 1, 2, 3}), 0.0f);
+}
@@ -141,3 +141,33 @@ TEST(CacheTest, OnEraseCallback) {
     EXPECT_EQ(erasedKey, 1);
     EXPECT_EQ(erasedValue, 1.0f);
 }
+
+TEST(Caching, LRUEviction) {
+    Core::Cache<std::size_t, float, Core::CacheLRUPolicy<std::size_t, 2>> cache;
+
+    cache.Put(0, 1.0f);
+    cache.Put(1, 2.0f);
+    
+    // Touch key 0 so key 1 becomes the least recently used entry
+    cache.Get(0);
+    cache.Put(2, 3.0f);
+
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_EQ(cache.Contains(0), true);
+    EXPECT_EQ(cache.Contains(1), false);
+    EXPECT_EQ(cache.Contains(2), true);
+}
+
+TEST(Caching, HitMissCounters) {
+    Core::Cache<std::size_t, float> cache;
+    cache.Put(0, 1.0f);
+
+    float value = 0.0f;
+    EXPECT_TRUE(cache.TryGet(0, value));
+    EXPECT_EQ(value, 1.0f);
+    EXPECT_FALSE(cache.TryGet(1, value));
+    EXPECT_THROW(cache.Get(1), std::out_of_range);
+
+    EXPECT_EQ(cache.GetHitCount(), 1);
+    EXPECT_EQ(cache.GetMissCount(), 2);
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+#include "Core/CookedMesh.hpp"
+#include <filesystem>
+
+namespace {
+    struct Vertex {
+        glm::vec3 _position;
+        glm::vec2 _texCoords;
+    };
+
+    std::string GetTemporaryPath(const char* name) {
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // Two nodes, one primitive with a coarser level, two meshlets and a texture. The last indices are parameters so they
+    // can point past the four vertices
+    void WriteSample(const std::string& path, std::uint32_t lastIndex = 3, std::uint32_t lastLodIndex = 2) {
+        static const std::vector<Vertex> vertices = {{{0, 0, 0}, {0, 0}}, {{1, 0, 0}, {1, 0}}, {{1, 1, 0}, {1, 1}}, {{0, 1, 0}, {0, 1}}};
+        const std::vector<std::uint32_t> indices = {0, 1, 2, 0, 2, lastIndex};
+        const std::vector<std::uint32_t> lodIndices = {0, 1, lastLodIndex};
+        static const std::vector<Meshlet> meshlets(2);
+        static const std::array<std::uint8_t, 5> texture = {1, 2, 3, 4, 5};
+
+        CookedMeshWriter writer(sizeof(Vertex));
+        const std::uint32_t root = writer.AddNode(glm::mat4(1.0f), -1);
+        const std::uint32_t child = writer.AddNode(glm::mat4(2.0f), static_cast<std::int32_t>(root));
+
+        CookedPrimitiveSource primitive;
+        primitive._node = child;
+        primitive._diffuseTexture = static_cast<std::int32_t>(writer.AddTexture(texture.data(), texture.size()));
+        primitive._shaderFeatures = 3;
+        primitive._vertices = vertices.data();
+        primitive._vertexCount = static_cast<std::uint32_t>(vertices.size());
+        primitive._indices = indices;
+        primitive._lods.emplace_back(lodIndices, 0.5f);
+        primitive._meshlets = meshlets;
+        primitive._boundsMax = glm::vec3(1.0f, 1.0f, 0.0f);
+        primitive._boundsRadius = 0.75f;
+        writer.AddPrimitive(std::move(primitive));
+
+        ASSERT_TRUE(writer.Write(path));
+    }
+}
+
+TEST(CookedMesh, RoundTrip) {
+    const std::string path = GetTemporaryPath("cookedMeshRoundTrip.cmesh");
+    WriteSample(path);
+
+    const std::shared_ptr<const CookedMesh> cookedMesh = CookedMesh::Open(path, sizeof(Vertex));
+    ASSERT_NE(cookedMesh, nullptr);
+
+    ASSERT_EQ(cookedMesh->GetNodes().size(), 2);
+    EXPECT_EQ(cookedMesh->GetNodes()[1]._parent, 0);
+    EXPECT_EQ(cookedMesh->GetNodes()[1]._matrix[3][3], 2.0f);
+
+    ASSERT_EQ(cookedMesh->GetPrimitives().size(), 1);
+    const CookedPrimitive& primitive = cookedMesh->GetPrimitives()[0];
+    EXPECT_EQ(primitive._node, 1);
+    EXPECT_EQ(primitive._shaderFeatures, 3);
+    EXPECT_EQ(primitive._boundsRadius, 0.75f);
+
+    ASSERT_EQ(primitive._vertexCount, 4);
+    EXPECT_EQ(static_cast<const Vertex*>(cookedMesh->GetVertices(primitive))[2]._texCoords.y, 1.0f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(cookedMesh->GetVertices(primitive)) % CookedMesh::Alignment, 0);
+
+    const std::span<const std::uint32_t> indices = cookedMesh->GetIndices(primitive);
+    EXPECT_EQ(std::vector<std::uint32_t>(indices.begin(), indices.end()), std::vector<std::uint32_t>({0, 1, 2, 0, 2, 3}));
+
+    ASSERT_EQ(cookedMesh->GetLods(primitive).size(), 1);
+    EXPECT_EQ(cookedMesh->GetLods(primitive)[0]._error, 0.5f);
+    EXPECT_EQ(cookedMesh->GetIndices(cookedMesh->GetLods(primitive)[0]).size(), 3);
+    EXPECT_EQ(cookedMesh->GetMeshlets(primitive).size(), 2);
+
+    ASSERT_EQ(primitive._diffuseTexture, 0);
+    const std::span<const std::uint8_t> texture = cookedMesh->GetTexture(0);
+    EXPECT_EQ(std::vector<std::uint8_t>(texture.begin(), texture.end()), std::vector<std::uint8_t>({1, 2, 3, 4, 5}));
+
+    std::filesystem::remove(path);
+}
+
+TEST(CookedMesh, RejectsMismatchedOrTruncatedFiles) {
+    const std::string path = GetTemporaryPath("cookedMeshRejects.cmesh");
+    WriteSample(path);
+
+    // Another vertex layout has to be cooked again
+    EXPECT_EQ(CookedMesh::Open(path, sizeof(Vertex) + 4), nullptr);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_EQ(CookedMesh::Open(path, sizeof(Vertex)), nullptr);
+
+    std::filesystem::remove(path);
+    EXPECT_EQ(CookedMesh::Open(path, sizeof(Vertex)), nullptr);
+}
+
+TEST(CookedMesh, RejectsIndicesPastTheVertices) {
+    const std::string path = GetTemporaryPath("cookedMeshIndices.cmesh");
+
+    WriteSample(path, 4, 2);
+    EXPECT_EQ(CookedMesh::Open(path, sizeof(Vertex)), nullptr);
+
+    WriteSample(path, 3, 4);
+    EXPECT_EQ(CookedMesh::Open(path, sizeof(Vertex)), nullptr);
+
+    WriteSample(path, 3, 2);
+    EXPECT_NE(CookedMesh::Open(path, sizeof(Vertex)), nullptr);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "Core/DynamicBVH.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+#include <random>
+
+namespace {
+    AABB MakeBox(glm::vec3 center, float halfSize) {
+        return {center - glm::vec3(halfSize), center + glm::vec3(halfSize)};
+    }
+
+    struct TestScene {
+        DynamicBVH _tree;
+        std::vector<AABB> _boxes;
+        std::vector<std::int32_t> _proxies;
+
+        explicit TestScene(std::size_t count) {
+            std::mt19937 generator(11);
+            std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+            for(std::size_t i = 0; i < count; i++) {
+                _boxes.push_back(MakeBox({distribution(generator), distribution(generator), distribution(generator)}, 1.0f));
+                _proxies.push_back(_tree.Insert(_boxes.back(), static_cast<entt::entity>(i)));
+            }
+        }
+    };
+}
+
+TEST(DynamicBVH, QueryAABBMatchesBruteForce) {
+    TestScene scene(2000);
+
+    // Move a quarter of the boxes far enough to leave their enlarged bounds, this also triggers a rebuild
+    for(std::size_t i = 0; i < scene._boxes.size(); i += 4) {
+        scene._boxes[i] = MakeBox(scene._boxes[i].GetCenter() + glm::vec3(5.0f, 0.0f, 0.0f), 1.0f);
+        scene._tree.Move(scene._proxies[i], scene._boxes[i]);
+    }
+
+    const AABB query = MakeBox({10.0f, -20.0f, 5.0f}, 30.0f);
+
+    std::vector<std::uint32_t> found;
+    scene._tree.QueryAABB(query, [&](entt::entity entity, std::int32_t proxy) {
+        if(query.Overlaps(scene._boxes[static_cast<std::uint32_t>(entity)])) {
+            found.push_back(static_cast<std::uint32_t>(entity));
+        }
+    });
+
+    std::vector<std::uint32_t> expected;
+    for(std::uint32_t i = 0; i < scene._boxes.size(); i++) {
+        if(query.Overlaps(scene._boxes[i])) {
+            expected.push_back(i);
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    EXPECT_EQ(found, expected);
+    EXPECT_EQ(scene._tree.GetLeafCount(), scene._boxes.size());
+}
+
+TEST(DynamicBVH, RemoveKeepsOtherLeaves) {
+    TestScene scene(500);
+    for(std::size_t i = 0; i < scene._proxies.size(); i += 2) {
+        scene._tree.Remove(scene._proxies[i]);
+    }
+
+    std::size_t visited = 0;
+    scene._tree.QueryAABB(MakeBox(glm::vec3(0.0f), 1000.0f), [&](entt::entity entity, std::int32_t proxy) {
+        EXPECT_EQ(static_cast<std::uint32_t>(entity) % 2, 1u);
+        visited++;
+    });
+
+    EXPECT_EQ(visited, 250u);
+}
+
+TEST(DynamicBVH, RaycastFindsClosest) {
+    DynamicBVH tree;
+    tree.Insert(MakeBox({0.0f, 0.0f, -10.0f}, 1.0f), static_cast<entt::entity>(0));
+    tree.Insert(MakeBox({0.0f, 0.0f, -5.0f}, 1.0f), static_cast<entt::entity>(1));
+    tree.Insert(MakeBox({5.0f, 0.0f, -2.0f}, 1.0f), static_cast<entt::entity>(2));
+
+    Ray ray;
+    ray._direction = glm::vec3(0.0f, 0.0f, -1.0f);
+
+    std::optional<std::uint32_t> closest;
+    tree.Raycast(ray, 100.0f, [&](entt::entity entity, std::int32_t proxy, float maxDistance) {
+        float distance = 0.0f;
+        if(!ray.Intersects(tree.GetBounds(proxy), maxDistance, distance)) {
+            return maxDistance;
+        }
+
+        closest = static_cast<std::uint32_t>(entity);
+        return distance;
+    });
+
+    EXPECT_EQ(closest, 1u);
+}
+
+TEST(DynamicBVH, FrustumQueryRejectsOutside) {
+    TestScene scene(2000);
+    const Frustum frustum = Frustum::FromViewProjection(glm::perspective(1.0f, 1.0f, 0.1f, 100.0f));
+
+    std::size_t inside = 0;
+    scene._tree.QueryFrustum(frustum, [&](entt::entity entity, std::int32_t proxy, bool bFullyInside) {
+        EXPECT_NE(DynamicBVH::TestFrustum(frustum, scene._tree.GetBounds(proxy)), FrustumTest::Outside);
+        if(bFullyInside) {
+            EXPECT_EQ(DynamicBVH::TestFrustum(frustum, scene._tree.GetBounds(proxy)), FrustumTest::Inside);
+        }
+        inside++;
+    });
+
+    std::size_t expected = 0;
+    for(std::int32_t proxy : scene._proxies) {
+        expected += DynamicBVH::TestFrustum(frustum, scene._tree.GetBounds(proxy)) != FrustumTest::Outside ? 1 : 0;
+    }
+
+    EXPECT_EQ(inside, expected);
+    EXPECT_LT(inside, scene._boxes.size());
+}
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "Core/FileWatcher.hpp"
+#include <fstream>
+
+namespace {
+    struct TempFile {
+        std::string _path;
+
+        explicit TempFile(const std::string& name)
+            : _path((std::filesystem::temp_directory_path() / name).string()) {
+            Write("initial");
+        }
+
+        ~TempFile() {
+            std::error_code error;
+            std::filesystem::remove(_path, error);
+        }
+
+        // The write time is moved explicitly, file systems with a coarse clock would miss a quick rewrite
+        void Write(const std::string& content) {
+            std::ofstream(_path, std::ios::trunc) << content;
+
+            static std::filesystem::file_time_type writeTime = std::filesystem::file_time_type::clock::now();
+            writeTime += std::chrono::seconds(1);
+            std::filesystem::last_write_time(_path, writeTime);
+        }
+    };
+}
+
+TEST(FileWatcher, ReportsModifiedFileOnce) {
+    TempFile file("FileWatcherTestModified.glsl");
+
+    FileWatcher watcher;
+    watcher.Watch(file._path);
+    EXPECT_TRUE(watcher.IsWatching(file._path));
+
+    // Watching sets the baseline, nothing changed yet
+    EXPECT_TRUE(watcher.Poll().empty());
+
+    file.Write("modified");
+
+    const std::vector<std::string> changed = watcher.Poll();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], file._path);
+
+    EXPECT_TRUE(watcher.Poll().empty());
+}
+
+TEST(FileWatcher, OnlyReportsChangedFiles) {
+    TempFile first("FileWatcherTestFirst.glsl");
+    TempFile second("FileWatcherTestSecond.glsl");
+
+    FileWatcher watcher;
+    watcher.Watch(first._path);
+    watcher.Watch(second._path);
+
+    second.Write("modified");
+
+    const std::vector<std::string> changed = watcher.Poll();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], second._path);
+}
+
+TEST(FileWatcher, SkipsMissingFileUntilItReturns) {
+    std::unique_ptr<TempFile> file = std::make_unique<TempFile>("FileWatcherTestMissing.glsl");
+    const std::string path = file->_path;
+
+    FileWatcher watcher;
+    watcher.Watch(path);
+
+    // An editor saving through a rename removes the file for a moment
+    std::filesystem::remove(path);
+    EXPECT_TRUE(watcher.Poll().empty());
+
+    file->Write("saved");
+
+    const std::vector<std::string> changed = watcher.Poll();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], path);
+}
+
+TEST(FileWatcher, UnwatchedFileIsNotReported) {
+    TempFile file("FileWatcherTestUnwatched.glsl");
+
+    FileWatcher watcher;
+    watcher.Watch(file._path);
+    watcher.Unwatch(file._path);
+    EXPECT_FALSE(watcher.IsWatching(file._path));
+
+    file.Write("modified");
+    EXPECT_TRUE(watcher.Poll().empty());
+}
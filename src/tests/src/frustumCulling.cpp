@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "Core/FrustumCulling.hpp"
+#include "Components/BoundsComponent.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+#include <cmath>
+#include <random>
+
+namespace {
+    // Camera at the origin looking down -z
+    Frustum MakeFrustum() {
+        return Frustum::FromViewProjection(glm::perspective(1.0f, 1.0f, 0.1f, 100.0f));
+    }
+
+    void SetBounds(CullingBoundsSoA& bounds, std::size_t i, glm::vec3 center, float halfSize) {
+        bounds._centerX[i] = center.x;
+        bounds._centerY[i] = center.y;
+        bounds._centerZ[i] = center.z;
+        bounds._extentX[i] = bounds._extentY[i] = bounds._extentZ[i] = halfSize;
+        bounds._radius[i] = halfSize * std::sqrt(3.0f);
+    }
+}
+
+TEST(FrustumCulling, ClassifiesBounds) {
+    CullingBoundsSoA bounds;
+    bounds.Resize(5);
+    SetBounds(bounds, 0, {0.0f, 0.0f, -10.0f}, 1.0f);   // In front
+    SetBounds(bounds, 1, {0.0f, 0.0f, 10.0f}, 1.0f);    // Behind
+    SetBounds(bounds, 2, {0.0f, 0.0f, -200.0f}, 1.0f);  // Past the far plane
+    SetBounds(bounds, 3, {50.0f, 0.0f, -10.0f}, 1.0f);  // Far to the right
+    SetBounds(bounds, 4, {0.0f, 0.0f, 0.5f}, 1.0f);     // Straddles the near plane
+
+    std::vector<std::uint8_t> visible(5);
+    FrustumCulling::Cull(SimdIsa::Scalar, MakeFrustum(), bounds, 0, 5, visible.data());
+
+    EXPECT_EQ(visible, (std::vector<std::uint8_t>{1, 0, 0, 0, 1}));
+}
+
+TEST(FrustumCulling, MatchesScalar) {
+    constexpr std::size_t count = 1027; // Leaves a tail for every register width
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    CullingBoundsSoA bounds;
+    bounds.Resize(count);
+    for(std::size_t i = 0; i < count; i++) {
+        SetBounds(bounds, i, {distribution(generator) * 100.0f, distribution(generator) * 100.0f, distribution(generator) * 150.0f}, 1.0f + distribution(generator) * 0.9f);
+    }
+
+    const Frustum frustum = MakeFrustum();
+    std::vector<std::uint8_t> expected(count);
+    FrustumCulling::Cull(SimdIsa::Scalar, frustum, bounds, 0, count, expected.data());
+
+    for(SimdIsa isa : {SimdIsa::SSE, SimdIsa::AVX2, SimdIsa::NEON}) {
+        if(!TransformKernels::IsSupported(isa)) {
+            continue;
+        }
+
+        // Odd begin so the SIMD loads are unaligned, the output is indexed from begin
+        std::vector<std::uint8_t> visible(count - 3);
+        FrustumCulling::Cull(isa, frustum, bounds, 3, count, visible.data());
+
+        EXPECT_TRUE(std::equal(visible.begin(), visible.end(), expected.begin() + 3)) << TransformKernels::GetIsaName(isa);
+    }
+}
+
+TEST(FrustumCulling, TransformsBounds) {
+    BoundsComponent local;
+    local._min = glm::vec3(-1.0f);
+    local._max = glm::vec3(1.0f);
+    local._radius = std::sqrt(3.0f);
+
+    // Scale by 2 and move to (5, 0, -20)
+    glm::mat4 matrix(2.0f);
+    matrix[3] = glm::vec4(5.0f, 0.0f, -20.0f, 1.0f);
+
+    CullingBoundsSoA world;
+    world.Resize(1);
+    FrustumCulling::TransformBounds(matrix, local, world, 0);
+
+    EXPECT_FLOAT_EQ(world._centerX[0], 5.0f);
+    EXPECT_FLOAT_EQ(world._centerZ[0], -20.0f);
+    EXPECT_FLOAT_EQ(world._extentY[0], 2.0f);
+    EXPECT_FLOAT_EQ(world._radius[0], 2.0f * std::sqrt(3.0f));
+}
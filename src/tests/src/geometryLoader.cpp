@@ -0,0 +1,190 @@
+#include "gtest/gtest.h"
+#include "Core/GeometryLoaderSystem.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/Scene.hpp"
+#include "Components/MeshComponent.hpp"
+#include "Components/PrimitiveProxyComponent.hpp"
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <thread>
+
+namespace {
+    // An object of a single triangle each, every object is a primitive of its own
+    struct TempModel {
+        std::string _path;
+
+        TempModel(const std::string& name, std::size_t objectCount)
+            : _path((std::filesystem::temp_directory_path() / name).string()) {
+            std::ofstream file(_path, std::ios::trunc);
+            for(std::size_t i = 0; i < objectCount; i++) {
+                const std::size_t first = i * 3 + 1;
+                file << "o Object" << i << "\n";
+                file << "v " << i << " 0 0\nv " << i + 1 << " 0 0\nv " << i << " 1 0\n";
+                file << "f " << first << " " << first + 1 << " " << first + 2 << "\n";
+            }
+        }
+
+        ~TempModel() {
+            std::error_code error;
+            std::filesystem::remove(_path, error);
+        }
+    };
+
+    // State of the only import once its worker is done with it
+    ImportState WaitForWorker(const GeometryLoaderSystem& loader) {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while(std::chrono::steady_clock::now() < timeout) {
+            const std::vector<ImportProgress> progress = loader.GetProgress();
+            if(progress.size() != 1 || progress[0]._state != ImportState::Importing) {
+                return progress.empty() ? ImportState::Finished : progress[0]._state;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return ImportState::Importing;
+    }
+
+    // Number of Process calls until nothing is left to commit
+    std::size_t ProcessAll(GeometryLoaderSystem& loader, Scene& scene) {
+        std::size_t frames = 0;
+        while(!loader.GetProgress().empty() && frames < 1000) {
+            loader.Process(&scene);
+            frames++;
+        }
+        return frames;
+    }
+
+    std::size_t CountPrimitives(Scene& scene) {
+        return scene.GetRegistry().view<PrimitiveProxyComponentCPU>().size();
+    }
+
+    std::vector<MeshComponentNew*> GetMeshGroups(Scene& scene) {
+        std::vector<MeshComponentNew*> groups;
+        auto view = scene.GetRegistry().view<MeshComponentNew>();
+        for(entt::entity entity : view) {
+            groups.push_back(&view.get<MeshComponentNew>(entity));
+        }
+        return groups;
+    }
+}
+
+TEST(GeometryLoader, CommitsWholeImportAsOneGroup) {
+    TempModel model("GeometryLoaderTestWhole.obj", 4);
+    GeometryLoaderSystem loader;
+    loader.SetImportCache(nullptr);
+    Scene scene;
+
+    loader.EnqueueFileLoad(model._path);
+    ASSERT_EQ(WaitForWorker(loader), ImportState::Committing);
+    ProcessAll(loader, scene);
+
+    EXPECT_TRUE(loader.GetProgress().empty());
+    EXPECT_EQ(CountPrimitives(scene), 4);
+
+    const std::vector<MeshComponentNew*> groups = GetMeshGroups(scene);
+    ASSERT_EQ(groups.size(), 1);
+    EXPECT_EQ(groups[0]->_primitives.size(), 4);
+}
+
+TEST(GeometryLoader, CancelledBeforeImportCommitsNothing) {
+    TempModel model("GeometryLoaderTestCancelled.obj", 4);
+    GeometryLoaderSystem loader;
+    loader.SetImportCache(nullptr);
+    Scene scene;
+
+    // Every worker is busy, the import waits in the queue until it was cancelled
+    std::promise<void> release;
+    const std::shared_future<void> released = release.get_future().share();
+    for(std::size_t i = 0; i < JobSystem::Get().GetWorkerCount(); i++) {
+        JobSystem::Get().Schedule([released]() {
+            released.wait();
+        });
+    }
+
+    const std::uint32_t id = loader.EnqueueFileLoad(model._path);
+    loader.Cancel(id);
+    release.set_value();
+
+    EXPECT_EQ(WaitForWorker(loader), ImportState::Cancelled);
+    loader.Process(&scene);
+
+    EXPECT_TRUE(loader.GetProgress().empty());
+    EXPECT_EQ(CountPrimitives(scene), 0);
+    EXPECT_TRUE(GetMeshGroups(scene).empty());
+}
+
+TEST(GeometryLoader, CommitBudgetSpreadsCommitOverFrames) {
+    // A few commit batches worth of primitives
+    constexpr std::size_t objectCount = 600;
+
+    TempModel model("GeometryLoaderTestBudget.obj", objectCount);
+    GeometryLoaderSystem loader;
+    loader.SetImportCache(nullptr);
+    loader.SetCommitBudget(std::chrono::microseconds(0));
+    Scene scene;
+
+    loader.EnqueueFileLoad(model._path);
+    ASSERT_EQ(WaitForWorker(loader), ImportState::Committing);
+
+    // Out of time right away, still one batch is committed per frame
+    loader.Process(&scene);
+    const std::vector<ImportProgress> progress = loader.GetProgress();
+    ASSERT_EQ(progress.size(), 1);
+    EXPECT_EQ(progress[0]._state, ImportState::Committing);
+    EXPECT_LT(progress[0]._progress, 1.0f);
+
+    EXPECT_GT(ProcessAll(loader, scene), 2);
+    EXPECT_EQ(CountPrimitives(scene), objectCount);
+
+    const std::vector<MeshComponentNew*> groups = GetMeshGroups(scene);
+    ASSERT_EQ(groups.size(), 1);
+    EXPECT_EQ(groups[0]->_primitives.size(), objectCount);
+}
+
+TEST(GeometryLoader, CancelledDuringCommitKeepsCommittedGroup) {
+    constexpr std::size_t objectCount = 600;
+
+    TempModel model("GeometryLoaderTestCommitCancelled.obj", objectCount);
+    GeometryLoaderSystem loader;
+    loader.SetImportCache(nullptr);
+    loader.SetCommitBudget(std::chrono::microseconds(0));
+    Scene scene;
+
+    const std::uint32_t id = loader.EnqueueFileLoad(model._path);
+    ASSERT_EQ(WaitForWorker(loader), ImportState::Committing);
+
+    // The nodes go in first, then a batch of primitives per frame
+    for(std::size_t frame = 0; frame < 100 && CountPrimitives(scene) == 0; frame++) {
+        loader.Process(&scene);
+    }
+
+    const std::size_t committed = CountPrimitives(scene);
+    ASSERT_GT(committed, 0);
+    ASSERT_LT(committed, objectCount);
+
+    loader.Cancel(id);
+    loader.Process(&scene);
+    EXPECT_TRUE(loader.GetProgress().empty());
+
+    // What was committed is still a complete group, nothing else was added
+    EXPECT_EQ(CountPrimitives(scene), committed);
+    const std::vector<MeshComponentNew*> groups = GetMeshGroups(scene);
+    ASSERT_EQ(groups.size(), 1);
+    ASSERT_EQ(groups[0]->_primitives.size(), committed);
+    for(entt::entity primitive : groups[0]->_primitives) {
+        EXPECT_TRUE(scene.GetRegistry().all_of<PrimitiveProxyComponentCPU>(primitive));
+    }
+}
+
+TEST(GeometryLoader, MissingFileFails) {
+    GeometryLoaderSystem loader;
+    loader.SetImportCache(nullptr);
+    Scene scene;
+
+    loader.EnqueueFileLoad((std::filesystem::temp_directory_path() / "GeometryLoaderTestMissing.obj").string());
+    EXPECT_EQ(WaitForWorker(loader), ImportState::Failed);
+
+    loader.Process(&scene);
+    EXPECT_TRUE(loader.GetProgress().empty());
+    EXPECT_TRUE(GetMeshGroups(scene).empty());
+}
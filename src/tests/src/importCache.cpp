@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include "Core/ImportCache.hpp"
+#include <fstream>
+
+namespace {
+    void WriteFile(const std::string& path, std::size_t size) {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        const std::string data(size, 'x');
+        stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+}
+
+TEST(ImportCache, HashFollowsContent) {
+    std::vector<std::uint8_t> data(1000);
+    for(std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    const std::uint64_t hash = ImportCache::HashBytes(data.data(), data.size());
+    EXPECT_EQ(hash, ImportCache::HashBytes(data.data(), data.size()));
+    EXPECT_NE(hash, ImportCache::HashBytes(data.data(), data.size(), 1));
+    EXPECT_NE(hash, ImportCache::HashBytes(data.data(), data.size() - 1));
+
+    // Last byte of the unaligned tail
+    data.back() ^= 1;
+    EXPECT_NE(hash, ImportCache::HashBytes(data.data(), data.size()));
+}
+
+TEST(ImportCache, TrimEvictsLeastRecentlyUsed) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "importCacheTrimTest";
+    std::filesystem::remove_all(directory);
+
+    const ImportCache cache(directory, 2500);
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for(std::uint64_t key = 0; key < 4; key++) {
+        WriteFile(cache.GetEntryPath(key), 1000);
+        std::filesystem::last_write_time(cache.GetEntryPath(key), now - std::chrono::minutes(10 - key));
+    }
+
+    // Using the oldest one makes it the most recent
+    EXPECT_TRUE(cache.Touch(0));
+    EXPECT_FALSE(cache.Touch(4));
+
+    cache.Trim();
+    EXPECT_TRUE(std::filesystem::exists(cache.GetEntryPath(0)));
+    EXPECT_FALSE(std::filesystem::exists(cache.GetEntryPath(1)));
+    EXPECT_FALSE(std::filesystem::exists(cache.GetEntryPath(2)));
+    EXPECT_TRUE(std::filesystem::exists(cache.GetEntryPath(3)));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST(ImportCache, KeyFollowsDependencies) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "importCacheDependenciesTest";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory / "model");
+
+    const ImportCache cache(directory / "cache", 1 << 20);
+    const std::string source = (directory / "model" / "model.obj").string();
+    const std::string material = (directory / "model" / "model.mtl").string();
+    WriteFile(source, 100);
+    WriteFile(material, 100);
+
+    // Never stored
+    const std::uint64_t sourceKey = *ImportCache::HashFile(source);
+    EXPECT_FALSE(cache.FindImportKey(sourceKey, source).has_value());
+
+    // The source itself is among what an importer reads
+    const std::optional<std::uint64_t> key = cache.StoreDependencies(sourceKey, source, {source, material});
+    ASSERT_TRUE(key.has_value());
+    EXPECT_NE(*key, sourceKey);
+    EXPECT_EQ(cache.FindImportKey(sourceKey, source), key);
+
+    // Editing only the sidecar makes another key, removing it leaves none
+    WriteFile(material, 200);
+    const std::optional<std::uint64_t> editedKey = cache.FindImportKey(sourceKey, source);
+    ASSERT_TRUE(editedKey.has_value());
+    EXPECT_NE(*editedKey, *key);
+
+    std::filesystem::remove(material);
+    EXPECT_FALSE(cache.FindImportKey(sourceKey, source).has_value());
+
+    // Moving the directory keeps the entry
+    WriteFile(material, 100);
+    std::filesystem::rename(directory / "model", directory / "moved");
+    EXPECT_EQ(cache.FindImportKey(sourceKey, (directory / "moved" / "model.obj").string()), key);
+
+    std::filesystem::remove_all(directory);
+}
+
+#ifndef _WIN32
+TEST(ImportCache, DefaultDirectoryIsPerUser) {
+    const char* cacheHome = std::getenv("XDG_CACHE_HOME");
+    const std::string previous = cacheHome ? cacheHome : "";
+
+    setenv("XDG_CACHE_HOME", "/cacheHome", 1);
+    EXPECT_EQ(ImportCache::GetDefaultDirectory(), std::filesystem::path("/cacheHome") / "Engine" / "ImportCache");
+
+    // Relative values are to be ignored
+    setenv("XDG_CACHE_HOME", "relative", 1);
+    if(const char* home = std::getenv("HOME")) {
+        EXPECT_EQ(ImportCache::GetDefaultDirectory(), std::filesystem::path(home) / ".cache" / "Engine" / "ImportCache");
+    }
+
+    if(cacheHome) {
+        setenv("XDG_CACHE_HOME", previous.c_str(), 1);
+    } else {
+        unsetenv("XDG_CACHE_HOME");
+    }
+}
+#endif
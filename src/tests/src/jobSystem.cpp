@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "Core/JobSystem.hpp"
+
+TEST(JobSystem, ParallelForCoversRangeOnce) {
+    JobSystem jobSystem(3);
+
+    constexpr std::size_t count = 100003;
+    std::vector<std::atomic<int>> visits(count);
+
+    jobSystem.ParallelFor(count, 16, [&visits](std::size_t begin, std::size_t end) {
+        // Chunks start on grain boundaries
+        EXPECT_EQ(begin % 16, 0);
+
+        for(std::size_t i = begin; i < end; i++) {
+            visits[i].fetch_add(1);
+        }
+    });
+
+    for(std::size_t i = 0; i < count; i++) {
+        ASSERT_EQ(visits[i].load(), 1) << "index " << i;
+    }
+}
+
+TEST(JobSystem, RunsInlineWithoutWorkers) {
+    JobSystem jobSystem(0);
+
+    std::size_t calls = 0;
+    jobSystem.ParallelFor(1000, 1, [&calls](std::size_t begin, std::size_t end) {
+        EXPECT_EQ(begin, 0);
+        EXPECT_EQ(end, 1000);
+        calls++;
+    });
+
+    bool bRan = false;
+    jobSystem.Schedule([&bRan] { bRan = true; });
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(bRan);
+}
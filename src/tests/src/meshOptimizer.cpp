@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+#include "Core/MeshOptimizer.hpp"
+#include "testMeshes.hpp"
+#include <random>
+
+namespace {
+    using TestMeshes::Mesh;
+
+    // Flat grid with its triangles shuffled, the worst case for the post transform cache
+    Mesh MakeShuffledGrid(std::uint32_t size) {
+        Mesh mesh = TestMeshes::MakeGrid(size);
+
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        for(std::size_t i = 0; i < mesh._indices.size(); i += 3) {
+            triangles.push_back({mesh._indices[i], mesh._indices[i + 1], mesh._indices[i + 2]});
+        }
+
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(5));
+        mesh._indices.clear();
+        for(const auto& triangle : triangles) {
+            mesh._indices.insert(mesh._indices.end(), triangle.begin(), triangle.end());
+        }
+
+        return mesh;
+    }
+
+    // Triangles by position with the smallest corner first, order independent and keeps the winding
+    std::vector<std::array<float, 9>> GetTriangles(const Mesh& mesh) {
+        std::vector<std::array<float, 9>> triangles;
+        for(std::size_t i = 0; i < mesh._indices.size(); i += 3) {
+            std::array<glm::vec3, 3> corners = {mesh._positions[mesh._indices[i]], mesh._positions[mesh._indices[i + 1]], mesh._positions[mesh._indices[i + 2]]};
+            auto Less = [](const glm::vec3& lhs, const glm::vec3& rhs) {
+                return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+            };
+            std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end(), Less), corners.end());
+
+            std::array<float, 9> triangle;
+            std::memcpy(triangle.data(), corners.data(), sizeof(triangle));
+            triangles.push_back(triangle);
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+TEST(MeshOptimizer, DeduplicatesIdenticalVertices) {
+    std::vector<glm::vec3> vertices = {{0, 0, 0}, {1, 0, 0}, {9, 9, 9}, {0, 1, 0}, {1, 0, 0}, {0, 0, 0}, {1, 1, 0}};
+    std::vector<std::uint32_t> indices = {0, 1, 3, 4, 6, 5};
+
+    const std::size_t count = MeshOptimizer::DeduplicateVertices(vertices.data(), vertices.size(), sizeof(glm::vec3), indices.data(), indices.size());
+
+    // The unreferenced vertex is gone and the duplicates point at their first occurrence
+    ASSERT_EQ(count, 4u);
+    EXPECT_EQ(indices, (std::vector<std::uint32_t>{0, 1, 2, 1, 3, 0}));
+    EXPECT_EQ(vertices[2].y, 1.0f);
+    EXPECT_EQ(vertices[3].x, 1.0f);
+    EXPECT_EQ(vertices[3].y, 1.0f);
+}
+
+TEST(MeshOptimizer, PipelineImprovesCacheAndKeepsTriangles) {
+    Mesh mesh = MakeShuffledGrid(64);
+    const auto sourceTriangles = GetTriangles(mesh);
+    const std::size_t vertexCount = mesh._positions.size();
+
+    const VertexCacheStatistics source = MeshOptimizer::AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+    EXPECT_GT(source.GetAcmr(), 2.0f);
+
+    MeshOptimizer::OptimizeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+    const VertexCacheStatistics cache = MeshOptimizer::AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+    EXPECT_LT(cache.GetAcmr(), 0.8f);
+    EXPECT_LT(cache.GetAtvr(), 1.6f);
+    EXPECT_EQ(GetTriangles(mesh), sourceTriangles);
+
+    MeshOptimizer::OptimizeOverdraw(mesh._indices.data(), mesh._indices.size(), &mesh._positions[0].x, vertexCount, sizeof(glm::vec3));
+    const VertexCacheStatistics overdraw = MeshOptimizer::AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+    EXPECT_LE(overdraw.GetAcmr(), cache.GetAcmr() * 1.1f);
+    EXPECT_EQ(GetTriangles(mesh), sourceTriangles);
+
+    // Fetch order follows first use and does not change the cache behaviour
+    const std::vector<std::uint32_t> beforeFetch = mesh._indices;
+    const std::size_t count = MeshOptimizer::OptimizeVertexFetch(mesh._positions.data(), vertexCount, sizeof(glm::vec3), mesh._indices.data(), mesh._indices.size());
+    EXPECT_EQ(count, vertexCount);
+    EXPECT_EQ(GetTriangles(mesh), sourceTriangles);
+    EXPECT_EQ(MeshOptimizer::AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount).GetAcmr(), overdraw.GetAcmr());
+
+    std::uint32_t nextVertex = 0;
+    for(std::uint32_t index : mesh._indices) {
+        ASSERT_LE(index, nextVertex);
+        nextVertex = std::max(nextVertex, index + 1);
+    }
+
+    // Same input, same output
+    Mesh again = MakeShuffledGrid(64);
+    MeshOptimizer::OptimizeVertexCache(again._indices.data(), again._indices.size(), vertexCount);
+    MeshOptimizer::OptimizeOverdraw(again._indices.data(), again._indices.size(), &again._positions[0].x, vertexCount, sizeof(glm::vec3));
+    EXPECT_EQ(again._indices, beforeFetch);
+}
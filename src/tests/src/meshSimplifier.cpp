@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "Core/MeshSimplifier.hpp"
+#include "testMeshes.hpp"
+#include <cmath>
+#include <limits>
+
+namespace {
+    using TestMeshes::Mesh;
+    using TestMeshes::MakeGrid;
+    using TestMeshes::MakeSphere;
+
+    // From a point to the closest point of a triangle, through the plane when the projection falls inside
+    float GetDistance(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        const glm::vec3 normal = glm::normalize(glm::cross(b - a, c - a));
+        const glm::vec3 projected = point - normal * glm::dot(point - a, normal);
+
+        if(glm::dot(glm::cross(b - a, projected - a), normal) >= 0.0f && glm::dot(glm::cross(c - b, projected - b), normal) >= 0.0f &&
+            glm::dot(glm::cross(a - c, projected - c), normal) >= 0.0f) {
+            return std::abs(glm::dot(point - a, normal));
+        }
+
+        auto SegmentDistance = [&point](const glm::vec3& from, const glm::vec3& to) {
+            const float t = std::clamp(glm::dot(point - from, to - from) / glm::dot(to - from, to - from), 0.0f, 1.0f);
+            return glm::length(point - (from + (to - from) * t));
+        };
+
+        return std::min({SegmentDistance(a, b), SegmentDistance(b, c), SegmentDistance(c, a)});
+    }
+
+    MeshSimplifier::Result Simplify(const Mesh& mesh, std::size_t targetIndexCount, float maxError) {
+        return MeshSimplifier::Simplify(&mesh._positions[0].x, nullptr, 0, mesh._positions.size(), sizeof(glm::vec3),
+            mesh._indices.data(), mesh._indices.size(), targetIndexCount, maxError);
+    }
+}
+
+TEST(MeshSimplifier, CollapsesFlatGridKeepingBorders) {
+    const Mesh grid = MakeGrid(32);
+    const MeshSimplifier::Result result = Simplify(grid, grid._indices.size() / 10, 1e-3f);
+
+    EXPECT_LE(result._indices.size(), grid._indices.size() / 10);
+    EXPECT_LT(result._error, 1e-3f);
+
+    // The outline does not move, so the used vertices still span the whole square
+    glm::vec3 min(1e9f), max(-1e9f);
+    float area = 0.0f;
+    for(std::size_t i = 0; i < result._indices.size(); i += 3) {
+        const glm::vec3 a = grid._positions[result._indices[i]];
+        const glm::vec3 b = grid._positions[result._indices[i + 1]];
+        const glm::vec3 c = grid._positions[result._indices[i + 2]];
+        min = glm::min(min, glm::min(a, glm::min(b, c)));
+        max = glm::max(max, glm::max(a, glm::max(b, c)));
+
+        // Same winding as the source
+        const float signedArea = glm::cross(b - a, c - a).z * 0.5f;
+        EXPECT_GT(signedArea, 0.0f);
+        area += signedArea;
+    }
+
+    EXPECT_EQ(min.x, 0.0f);
+    EXPECT_EQ(min.y, 0.0f);
+    EXPECT_EQ(max.x, 32.0f);
+    EXPECT_EQ(max.y, 32.0f);
+    EXPECT_NEAR(area, 32.0f * 32.0f, 1e-2f);
+}
+
+TEST(MeshSimplifier, ReducesSphereWithinError) {
+    const Mesh sphere = MakeSphere(32, 64);
+    const MeshSimplifier::Result result = Simplify(sphere, sphere._indices.size() / 4, 0.05f);
+
+    EXPECT_LE(result._indices.size(), sphere._indices.size() / 4);
+    EXPECT_GT(result._indices.size(), 0u);
+    EXPECT_LE(result._error, 0.05f);
+
+    for(std::size_t i = 0; i < result._indices.size(); i += 3) {
+        ASSERT_LT(result._indices[i], sphere._positions.size());
+        EXPECT_NE(result._indices[i], result._indices[i + 1]);
+        EXPECT_NE(result._indices[i + 1], result._indices[i + 2]);
+        EXPECT_NE(result._indices[i], result._indices[i + 2]);
+
+        // Still facing outwards
+        const glm::vec3 a = sphere._positions[result._indices[i]];
+        const glm::vec3 b = sphere._positions[result._indices[i + 1]];
+        const glm::vec3 c = sphere._positions[result._indices[i + 2]];
+        EXPECT_GT(glm::dot(glm::cross(b - a, c - a), a + b + c), 0.0f);
+    }
+
+    // A tight error budget stops early instead of going to the target
+    const MeshSimplifier::Result tight = Simplify(sphere, 0, 1e-4f);
+    EXPECT_GT(tight._indices.size(), result._indices.size());
+}
+
+TEST(MeshSimplifier, ErrorBoundsVertexDistance) {
+    const Mesh sphere = MakeSphere(32, 64);
+
+    for(float maxError : {0.05f, 0.01f}) {
+        const MeshSimplifier::Result result = Simplify(sphere, 0, maxError);
+        ASSERT_GT(result._indices.size(), 0u);
+        EXPECT_LE(result._error, maxError);
+
+        // Every vertex of the source is within the reported error of the simplified surface
+        float largest = 0.0f;
+        for(const glm::vec3& position : sphere._positions) {
+            float distance = std::numeric_limits<float>::max();
+            for(std::size_t i = 0; i < result._indices.size(); i += 3) {
+                distance = std::min(distance, GetDistance(position, sphere._positions[result._indices[i]],
+                    sphere._positions[result._indices[i + 1]], sphere._positions[result._indices[i + 2]]));
+            }
+            largest = std::max(largest, distance);
+        }
+
+        EXPECT_LE(largest, result._error * 1.001f + 1e-6f) << maxError;
+        EXPECT_GT(largest, maxError * 0.5f) << maxError;
+    }
+}
@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "Core/Meshlets.hpp"
+#include "testMeshes.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+#include <cmath>
+
+namespace {
+    using TestMeshes::Mesh;
+    using TestMeshes::MakeSphere;
+
+    MeshletData Build(const Mesh& mesh) {
+        return MeshletBuilder::Build(&mesh._positions[0].x, mesh._positions.size(), sizeof(glm::vec3), mesh._indices.data(), mesh._indices.size());
+    }
+}
+
+TEST(MeshletBuilder, CoversEveryTriangleWithinLimits) {
+    const Mesh sphere = MakeSphere(48, 96);
+    const MeshletData data = Build(sphere);
+
+    ASSERT_FALSE(data._meshlets.empty());
+
+    std::size_t triangles = 0;
+    for(const Meshlet& meshlet : data._meshlets) {
+        EXPECT_LE(meshlet._vertexCount, MeshletBuilder::MaxVertices);
+        EXPECT_LE(meshlet._triangleCount, MeshletBuilder::MaxTriangles);
+        EXPECT_EQ(meshlet._triangleOffset, triangles);
+        triangles += meshlet._triangleCount;
+
+        for(std::uint32_t i = 0; i < meshlet._vertexCount; i++) {
+            const glm::vec3 position = sphere._positions[data._vertices[meshlet._vertexOffset + i]];
+            EXPECT_LE(glm::length(position - meshlet._center), meshlet._radius * 1.0001f);
+        }
+    }
+
+    // Well filled, not one meshlet per handful of triangles
+    EXPECT_LT(data._meshlets.size(), sphere._indices.size() / 3 / 60);
+
+    // The reordered indices hold the same triangles with the same winding
+    std::vector<std::uint32_t> indices = MeshletBuilder::BuildIndices(data);
+    ASSERT_EQ(indices.size(), sphere._indices.size());
+
+    auto Sorted = [](const std::vector<std::uint32_t>& source) {
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        for(std::size_t i = 0; i < source.size(); i += 3) {
+            // Rotated so the smallest index is first, which keeps the winding
+            std::array<std::uint32_t, 3> triangle = {source[i], source[i + 1], source[i + 2]};
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    };
+
+    EXPECT_EQ(Sorted(indices), Sorted(sphere._indices));
+}
+
+TEST(MeshletBuilder, ConeCullsOnlyBackfacingMeshlets) {
+    const Mesh sphere = MakeSphere(48, 96);
+    const MeshletData data = Build(sphere);
+    const std::vector<std::uint32_t> indices = MeshletBuilder::BuildIndices(data);
+
+    const glm::vec3 camera(0.0f, 0.0f, 4.0f);
+    std::size_t culledTriangles = 0;
+
+    for(const Meshlet& meshlet : data._meshlets) {
+        if(!MeshletCulling::IsBackfacing(meshlet, camera)) {
+            continue;
+        }
+
+        culledTriangles += meshlet._triangleCount;
+        for(std::uint32_t triangle = meshlet._triangleOffset; triangle < meshlet._triangleOffset + meshlet._triangleCount; triangle++) {
+            const glm::vec3 a = sphere._positions[indices[triangle * 3]];
+            const glm::vec3 b = sphere._positions[indices[triangle * 3 + 1]];
+            const glm::vec3 c = sphere._positions[indices[triangle * 3 + 2]];
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            if(glm::dot(normal, normal) > 0.0f) {
+                EXPECT_GE(glm::dot(normal, a - camera), 0.0f);
+            }
+        }
+    }
+
+    // Somewhat less than half the sphere faces away from a camera this close
+    EXPECT_GT(culledTriangles, sphere._indices.size() / 3 / 4);
+}
+
+TEST(MeshletCulling, RangesKeepEveryFrontFacingTriangle) {
+    const Mesh sphere = MakeSphere(48, 96);
+    const MeshletData data = Build(sphere);
+    const std::vector<std::uint32_t> indices = MeshletBuilder::BuildIndices(data);
+
+    // Camera at z = 4 looking down -z
+    glm::mat4 view(1.0f);
+    view[3] = glm::vec4(0.0f, 0.0f, -4.0f, 1.0f);
+    const glm::mat4 clipMatrix = glm::perspective(1.0f, 1.0f, 0.1f, 100.0f) * view;
+    const glm::vec3 camera(0.0f, 0.0f, 4.0f);
+
+    MeshletCulling culling;
+    std::vector<IndexRange> ranges;
+    const std::size_t culled = culling.Cull(TransformKernels::GetBestIsa(), data, clipMatrix, camera, true, ranges);
+
+    std::vector<std::uint8_t> drawn(indices.size() / 3);
+    std::size_t drawnTriangles = 0;
+    for(const IndexRange& range : ranges) {
+        for(std::uint32_t i = range._firstIndex; i < range._firstIndex + range._indexCount; i += 3) {
+            drawn[i / 3] = 1;
+            drawnTriangles++;
+        }
+    }
+
+    EXPECT_GT(culled, 0u);
+    EXPECT_EQ(drawnTriangles + culled, indices.size() / 3);
+
+    for(std::size_t triangle = 0; triangle < drawn.size(); triangle++) {
+        const glm::vec3 a = sphere._positions[indices[triangle * 3]];
+        const glm::vec3 b = sphere._positions[indices[triangle * 3 + 1]];
+        const glm::vec3 c = sphere._positions[indices[triangle * 3 + 2]];
+        if(glm::dot(glm::cross(b - a, c - a), a - camera) < 0.0f) {
+            EXPECT_TRUE(drawn[triangle]) << "front facing triangle " << triangle << " was culled";
+        }
+    }
+
+    // Sphere behind the camera, nothing is left even without the cone test
+    view[3] = glm::vec4(0.0f, 0.0f, 4.0f, 1.0f);
+    culling.Cull(TransformKernels::GetBestIsa(), data, glm::perspective(1.0f, 1.0f, 0.1f, 100.0f) * view, -camera, false, ranges);
+    EXPECT_TRUE(ranges.empty());
+}
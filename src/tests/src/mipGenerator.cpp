@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "Renderer/MipGenerator.hpp"
+#include "Renderer/TextureDecoder.hpp"
+
+TEST(MipGenerator, LaysOutChains) {
+    EXPECT_EQ(MipGenerator::GetLevelCount(1, 1), 1u);
+    EXPECT_EQ(MipGenerator::GetLevelCount(256, 256), 9u);
+    EXPECT_EQ(MipGenerator::GetLevelCount(37, 22), 6u);
+    EXPECT_EQ(MipGenerator::GetLevelExtent(22, 5), 1u);
+
+    // 37x22, 18x11, 9x5, 4x2, 2x1, 1x1
+    constexpr Format Rgba = Format::FORMAT_R8G8B8A8_SRGB;
+    EXPECT_EQ(MipGenerator::GetLevelOffset(Rgba, 37, 22, 2), (37 * 22 + 18 * 11) * 4);
+    EXPECT_EQ(MipGenerator::GetChainSize(Rgba, 37, 22, 6), (37 * 22 + 18 * 11 + 9 * 5 + 4 * 2 + 2 * 1 + 1) * 4);
+
+    // Every level takes at least a whole block once compressed
+    EXPECT_EQ(MipGenerator::GetChainSize(Format::FORMAT_BC1_RGBA_SRGB, 37, 22, 6), (10 * 6 + 5 * 3 + 3 * 2 + 1 + 1 + 1) * 8);
+
+    // A decoded image gets its chain and every level compressed
+    DecodedImage image;
+    image._width = 37;
+    image._height = 22;
+    image._pixels = std::unique_ptr<std::uint8_t[], DecodedImage::PixelsDeleter>(new std::uint8_t[image.GetSize()], {false});
+    std::memset(image._pixels.get(), 255, image.GetSize());
+
+    image = TextureDecoder::GenerateMips(std::move(image), true);
+    ASSERT_EQ(image._levelCount, 6u);
+    EXPECT_EQ(image._pixels[MipGenerator::GetLevelOffset(Rgba, 37, 22, 5)], 255);
+
+    image = TextureDecoder::Compress(std::move(image), TextureCompression::Color);
+    EXPECT_EQ(image._format, Format::FORMAT_BC1_RGBA_SRGB);
+    EXPECT_EQ(image._levelCount, 6u);
+    EXPECT_EQ(image.GetSize(), (10 * 6 + 5 * 3 + 3 * 2 + 1 + 1 + 1) * 8);
+}
+
+TEST(MipGenerator, AveragesColorInLinearSpace) {
+    // Black and white columns, the alpha channel going from 0 to 200
+    const std::array<std::uint8_t, 2 * 2 * 4> src = {
+        0, 0, 0, 0,     255, 255, 255, 200,
+        0, 0, 0, 0,     255, 255, 255, 200,
+    };
+
+    std::array<std::uint8_t, 4> srgb;
+    MipGenerator::Downsample(src.data(), 2, 2, srgb.data(), true);
+    // Half the light is 188 in sRGB, not 128
+    EXPECT_EQ(srgb[0], 188);
+    EXPECT_EQ(srgb[2], 188);
+    EXPECT_EQ(srgb[3], 100);
+
+    std::array<std::uint8_t, 4> linear;
+    MipGenerator::Downsample(src.data(), 2, 2, linear.data(), false);
+    EXPECT_EQ(linear[0], 128);
+    EXPECT_EQ(linear[3], 100);
+
+    // A single column is averaged with itself, only the rows pair up
+    const std::array<std::uint8_t, 1 * 2 * 4> column = {10, 20, 30, 40, 30, 40, 50, 60};
+    std::array<std::uint8_t, 4> texel;
+    MipGenerator::Downsample(column.data(), 1, 2, texel.data(), false);
+    EXPECT_EQ(texel, (std::array<std::uint8_t, 4> {20, 30, 40, 50}));
+}
@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+#include "Core/OcclusionBuffer.hpp"
+#include "glm/ext/matrix_clip_space.hpp"
+#include <random>
+
+namespace {
+    // Camera at the origin looking down -z
+    glm::mat4 MakeViewProjection() {
+        return glm::perspective(1.0f, 2.0f, 0.1f, 100.0f);
+    }
+
+    // Square facing the camera, two triangles
+    struct Quad {
+        std::vector<glm::vec3> _positions;
+        std::vector<std::uint32_t> _indices = {0, 1, 2, 0, 2, 3};
+
+        Quad(float halfSize, float z) {
+            _positions = {{-halfSize, -halfSize, z}, {halfSize, -halfSize, z}, {halfSize, halfSize, z}, {-halfSize, halfSize, z}};
+        }
+    };
+
+    void Rasterize(OcclusionBuffer& buffer, SimdIsa isa, const glm::mat4& clipMatrix, const Quad& quad) {
+        buffer.RasterizeTriangles(isa, clipMatrix, &quad._positions[0].x, sizeof(glm::vec3), quad._indices.data(), quad._indices.size());
+    }
+}
+
+TEST(OcclusionBuffer, OccludesBoxesBehindWall) {
+    OcclusionBuffer buffer;
+    buffer.Resize(256, 128);
+
+    const glm::mat4 viewProjection = MakeViewProjection();
+    Rasterize(buffer, TransformKernels::GetBestIsa(), viewProjection, Quad(2.0f, -5.0f));
+    buffer.BuildPyramid();
+
+    // The texels along the diagonal the two triangles share are covered by neither, the box stays clear of it
+    EXPECT_TRUE(buffer.IsOccluded(viewProjection, {{-2.3f, 1.7f, -10.5f}, {-1.7f, 2.3f, -10.0f}}));    // Behind the wall
+    EXPECT_FALSE(buffer.IsOccluded(viewProjection, {{-0.5f, -0.5f, -11.0f}, {0.5f, 0.5f, -10.0f}}));   // Behind the seam
+    EXPECT_FALSE(buffer.IsOccluded(viewProjection, {{-0.5f, -0.5f, -3.0f}, {0.5f, 0.5f, -2.0f}}));     // In front of it
+    EXPECT_FALSE(buffer.IsOccluded(viewProjection, {{-4.0f, -0.5f, -11.0f}, {-3.0f, 0.5f, -10.0f}}));  // Pokes out the side
+    EXPECT_FALSE(buffer.IsOccluded(viewProjection, {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}}));      // Around the camera
+}
+
+TEST(OcclusionBuffer, PartlyCoveredTexelsAreNotWritten) {
+    OcclusionBuffer buffer;
+    buffer.Resize(256, 128);
+
+    // Clip coordinates are given directly, the occluder at w = 0.5 ends 0.7 texels into column 150
+    glm::mat4 occluderMatrix(1.0f);
+    occluderMatrix[3][3] = 0.5f;
+    const float edge = 150.7f / 256.0f - 0.5f;
+    const std::vector<glm::vec3> positions = {{-0.4f, -0.4f, 0.0f}, {edge, -0.4f, 0.0f}, {edge, 0.4f, 0.0f}};
+    const std::vector<std::uint32_t> indices = {0, 1, 2};
+
+    for(SimdIsa isa : {SimdIsa::Scalar, SimdIsa::SSE, SimdIsa::AVX2, SimdIsa::NEON}) {
+        if(!TransformKernels::IsSupported(isa)) {
+            continue;
+        }
+
+        buffer.Clear();
+        buffer.RasterizeTriangles(isa, occluderMatrix, &positions[0].x, sizeof(glm::vec3), indices.data(), indices.size());
+        buffer.BuildPyramid();
+
+        // Column 150 has its center inside but its right part uncovered, a box behind that part shows
+        EXPECT_GT(buffer.GetDepth(149, 40), 0.0f) << TransformKernels::GetIsaName(isa);
+        EXPECT_EQ(buffer.GetDepth(150, 40), 0.0f) << TransformKernels::GetIsaName(isa);
+
+        const float boxMinX = 150.8f / 128.0f - 1.0f;
+        const float boxMaxX = 150.95f / 128.0f - 1.0f;
+        EXPECT_FALSE(buffer.IsOccluded(glm::mat4(1.0f), {{boxMinX, -0.4f, 0.0f}, {boxMaxX, -0.3f, 0.0f}})) << TransformKernels::GetIsaName(isa);
+        EXPECT_TRUE(buffer.IsOccluded(glm::mat4(1.0f), {{-0.05f, -0.65f, 0.0f}, {0.0f, -0.55f, 0.0f}})) << TransformKernels::GetIsaName(isa);
+    }
+}
+
+TEST(OcclusionBuffer, ClipsAgainstNearPlane) {
+    OcclusionBuffer buffer;
+    buffer.Resize(64, 64);
+
+    // Floor running from behind the camera into the distance, only the part past the near plane may be drawn
+    const glm::mat4 viewProjection = glm::perspective(1.0f, 1.0f, 0.1f, 100.0f);
+    const std::vector<glm::vec3> positions = {{-5.0f, -1.0f, 5.0f}, {5.0f, -1.0f, 5.0f}, {5.0f, -1.0f, -50.0f}, {-5.0f, -1.0f, -50.0f}};
+    const std::vector<std::uint32_t> indices = {0, 1, 2, 0, 2, 3};
+    buffer.RasterizeTriangles(SimdIsa::Scalar, viewProjection, &positions[0].x, sizeof(glm::vec3), indices.data(), indices.size());
+
+    // Nothing in the upper half and the bottom rows are nearer than the far end
+    float upperHalf = 0.0f;
+    for(std::uint32_t y = 32; y < 64; y++) {
+        for(std::uint32_t x = 0; x < 64; x++) {
+            upperHalf = std::max(upperHalf, buffer.GetDepth(x, y));
+        }
+    }
+
+    EXPECT_EQ(upperHalf, 0.0f);
+    EXPECT_GT(buffer.GetDepth(32, 0), buffer.GetDepth(32, 30));
+    EXPECT_LE(buffer.GetDepth(32, 0), 1.0f / 0.1f);
+}
+
+TEST(OcclusionBuffer, MatchesScalar) {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<float> coordinate(-6.0f, 6.0f);
+    std::uniform_real_distribution<float> depth(-30.0f, 2.0f);
+
+    std::vector<glm::vec3> positions(300);
+    for(glm::vec3& position : positions) {
+        position = {coordinate(generator), coordinate(generator), depth(generator)};
+    }
+
+    std::vector<std::uint32_t> indices(positions.size());
+    for(std::uint32_t i = 0; i < indices.size(); i++) {
+        indices[i] = i;
+    }
+
+    const glm::mat4 viewProjection = MakeViewProjection();
+
+    OcclusionBuffer reference;
+    reference.Resize(128, 64);
+    reference.RasterizeTriangles(SimdIsa::Scalar, viewProjection, &positions[0].x, sizeof(glm::vec3), indices.data(), indices.size());
+
+    for(SimdIsa isa : {SimdIsa::SSE, SimdIsa::AVX2, SimdIsa::NEON}) {
+        if(!TransformKernels::IsSupported(isa)) {
+            continue;
+        }
+
+        OcclusionBuffer buffer;
+        buffer.Resize(128, 64);
+        buffer.RasterizeTriangles(isa, viewProjection, &positions[0].x, sizeof(glm::vec3), indices.data(), indices.size());
+
+        for(std::uint32_t y = 0; y < buffer.GetHeight(); y++) {
+            for(std::uint32_t x = 0; x < buffer.GetWidth(); x++) {
+                ASSERT_EQ(buffer.GetDepth(x, y), reference.GetDepth(x, y)) << TransformKernels::GetIsaName(isa) << " at " << x << ", " << y;
+            }
+        }
+    }
+}
@@ -0,0 +1,178 @@
+#include "gtest/gtest.h"
+#include "Core/Scene.hpp"
+#include "Components/TransformComponent.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+    struct TagComponent {
+        int _value = 0;
+        std::vector<int> _data;
+    };
+
+    // Entities in the order their components were constructed
+    struct ConstructRecorder {
+        std::vector<entt::entity> _entities;
+
+        void Record(entt::registry&, entt::entity entity) {
+            _entities.push_back(entity);
+        }
+    };
+
+    std::vector<TagComponent> MakeTags(std::size_t count) {
+        std::vector<TagComponent> tags(count);
+        for(std::size_t i = 0; i < count; i++) {
+            tags[i]._value = static_cast<int>(i);
+            tags[i]._data.assign(4, static_cast<int>(i));
+        }
+        return tags;
+    }
+
+    // Every node parented to the one four places before it, about as wide as an imported hierarchy
+    std::vector<TransformComponent> MakeNodes(std::size_t count) {
+        std::vector<TransformComponent> nodes(count);
+        for(std::size_t i = 0; i < count; i++) {
+            nodes[i].m_Position = glm::vec3(1.0f, 0.0f, 0.0f);
+            if(i > 0) {
+                nodes[(i - 1) / 4]._childs.push_back(nodes[i]._id);
+            }
+        }
+        return nodes;
+    }
+}
+
+TEST(Scene, CreateEntitiesMakesDistinctEntities) {
+    Scene scene;
+    std::vector<entt::entity> entities(64);
+    scene.CreateEntities(entities);
+
+    for(entt::entity entity : entities) {
+        EXPECT_TRUE(scene.GetRegistry().valid(entity));
+    }
+
+    std::vector<entt::entity> sorted = entities;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(std::unique(sorted.begin(), sorted.end()), sorted.end());
+}
+
+TEST(Scene, ReserveComponentsGrowsStorageAhead) {
+    Scene scene;
+    scene.ReserveComponents<TagComponent>(100);
+    EXPECT_GE(scene.GetRegistry().storage<TagComponent>().capacity(), 100);
+
+    // On top of what is already stored
+    std::vector<entt::entity> entities(40);
+    scene.CreateEntities(entities);
+    scene.InsertComponents<TagComponent>(entities, MakeTags(entities.size()));
+    scene.ReserveComponents<TagComponent>(100);
+    EXPECT_GE(scene.GetRegistry().storage<TagComponent>().capacity(), 140);
+    EXPECT_EQ(scene.GetRegistry().storage<TagComponent>().size(), 40);
+}
+
+TEST(Scene, InsertComponentsMovesOneIntoEachEntity) {
+    Scene scene;
+    std::vector<entt::entity> entities(16);
+    scene.CreateEntities(entities);
+
+    std::vector<TagComponent> tags = MakeTags(entities.size());
+    scene.InsertComponents<TagComponent>(entities, tags);
+
+    for(std::size_t i = 0; i < entities.size(); i++) {
+        const TagComponent& tag = scene.GetRegistry().get<TagComponent>(entities[i]);
+        EXPECT_EQ(tag._value, static_cast<int>(i));
+        EXPECT_EQ(tag._data, std::vector<int>(4, static_cast<int>(i)));
+        EXPECT_TRUE(tags[i]._data.empty());
+    }
+}
+
+TEST(Scene, InsertComponentsTakesMembersOfStructs) {
+    struct Imported {
+        TagComponent _tag;
+        TransformComponent _transform;
+    };
+
+    std::vector<Imported> imported(8);
+    for(std::size_t i = 0; i < imported.size(); i++) {
+        imported[i]._tag._value = static_cast<int>(i);
+        imported[i]._transform.m_Position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+    }
+
+    Scene scene;
+    std::vector<entt::entity> entities(imported.size());
+    scene.CreateEntities(entities);
+    scene.InsertComponents<TagComponent>(entities, imported | std::views::transform(&Imported::_tag));
+    scene.InsertComponents<TransformComponent>(entities, imported | std::views::transform(&Imported::_transform));
+
+    for(std::size_t i = 0; i < entities.size(); i++) {
+        EXPECT_EQ(scene.GetRegistry().get<TagComponent>(entities[i])._value, static_cast<int>(i));
+        EXPECT_EQ(scene.GetRegistry().get<TransformComponent>(entities[i]).m_Position.x, static_cast<float>(i));
+        EXPECT_EQ(scene.GetRegistry().get<TransformComponent>(entities[i])._id, imported[i]._transform._id);
+    }
+}
+
+TEST(Scene, InsertComponentsSignalsEveryEntityInOrder) {
+    Scene scene;
+    ConstructRecorder tags;
+    ConstructRecorder transforms;
+    scene.GetRegistry().on_construct<TagComponent>().connect<&ConstructRecorder::Record>(tags);
+    scene.GetRegistry().on_construct<TransformComponent>().connect<&ConstructRecorder::Record>(transforms);
+
+    std::vector<entt::entity> entities(32);
+    scene.CreateEntities(entities);
+
+    // Not in creation order, the signals follow the span
+    std::reverse(entities.begin(), entities.end());
+    scene.InsertComponents<TagComponent>(entities, MakeTags(entities.size()));
+    scene.InsertComponents<TransformComponent>(entities, MakeNodes(entities.size()));
+
+    EXPECT_EQ(tags._entities, entities);
+    EXPECT_EQ(transforms._entities, entities);
+
+    // The systems attached by the scene saw them as well
+    scene.GetTransformHierarchy().Update(scene.GetRegistry());
+    EXPECT_EQ(scene.GetTransformHierarchy().GetSize(), entities.size());
+}
+
+// Not a pass/fail test, prints the cost of committing 100k transform nodes one at a time and through the bulk insert,
+// the hierarchy update included. Disabled so regular runs stay quiet, run it with --gtest_also_run_disabled_tests
+TEST(Scene, DISABLED_Benchmark100kNodes) {
+    constexpr std::size_t count = 100000;
+    constexpr int iterations = 5;
+
+    double emplaceTime = 0.0;
+    double insertTime = 0.0;
+    for(int iteration = 0; iteration < iterations; iteration++) {
+        {
+            Scene scene;
+            std::vector<TransformComponent> nodes = MakeNodes(count);
+
+            const auto start = std::chrono::steady_clock::now();
+            for(TransformComponent& node : nodes) {
+                scene.GetRegistry().emplace<TransformComponent>(scene.GetRegistry().create(), std::move(node));
+            }
+            scene.GetTransformHierarchy().Update(scene.GetRegistry());
+            emplaceTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        {
+            Scene scene;
+            std::vector<TransformComponent> nodes = MakeNodes(count);
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<entt::entity> entities(count);
+            scene.ReserveComponents<TransformComponent>(count);
+            scene.CreateEntities(entities);
+            scene.InsertComponents<TransformComponent>(entities, nodes);
+            scene.GetTransformHierarchy().Update(scene.GetRegistry());
+            insertTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    std::cout << "[ BENCH    ] emplace: " << emplaceTime / iterations << " ms per 100k nodes" << std::endl;
+    std::cout << "[ BENCH    ] bulk insert: " << insertTime / iterations << " ms per 100k nodes" << std::endl;
+    RecordProperty("emplace", std::to_string(emplaceTime / iterations));
+    RecordProperty("bulk insert", std::to_string(insertTime / iterations));
+
+    SUCCEED();
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "Renderer/ShaderDataPacking.hpp"
+
+namespace {
+    ShaderDataBlock MakeBlock(PushConstantDataType type, std::size_t size, ShaderStage stage) {
+        ShaderDataBlock block {};
+        block._type = type;
+        block._size = size;
+        block._usage = ShaderDataBlockUsage::NONE;
+        block._stage = stage;
+        return block;
+    }
+}
+
+TEST(ShaderDataPacking, Std430Layout) {
+    ShaderDataStream stream;
+    stream._usage = ShaderDataStreamUsage::PUSH_CONSTANT;
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Float, 4, STAGE_VERTEX));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Vec3, 12, STAGE_VERTEX));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Float, 4, STAGE_FRAGMENT));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Mat4, 64, STAGE_FRAGMENT));
+
+    ShaderDataPackingPlan plan = ShaderDataPackingPlan::Build({stream}, true, 128);
+    const auto& placements = plan.GetPlacements();
+
+    ASSERT_EQ(placements.size(), 4);
+    EXPECT_EQ(placements[0]._offset, 0);
+    EXPECT_EQ(placements[1]._offset, 16); // vec3 aligns to 16
+    EXPECT_EQ(placements[2]._offset, 28); // float fits right after the vec3
+    EXPECT_EQ(placements[3]._offset, 32);
+    EXPECT_EQ(plan.GetPushConstantsSize(), 96);
+    EXPECT_FALSE(plan.HasSpill());
+}
+
+TEST(ShaderDataPacking, SpillOverLimit) {
+    ShaderDataStream stream;
+    stream._usage = ShaderDataStreamUsage::PUSH_CONSTANT;
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Mat4, 64, STAGE_VERTEX));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Mat4, 64, STAGE_VERTEX));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Vec4, 16, STAGE_FRAGMENT));
+
+    ShaderDataPackingPlan plan = ShaderDataPackingPlan::Build({stream}, true, 128);
+    const auto& placements = plan.GetPlacements();
+
+    ASSERT_EQ(placements.size(), 3);
+    EXPECT_FALSE(placements[1]._bSpilled);
+    EXPECT_TRUE(placements[2]._bSpilled);
+    EXPECT_EQ(placements[2]._offset, 0);
+    EXPECT_EQ(plan.GetPushConstantsSize(), 128);
+    EXPECT_EQ(plan.GetSpillSize(), 16);
+    EXPECT_EQ(plan.GetSpillStages(), STAGE_FRAGMENT);
+
+    // Without push constants support everything goes to the uniform block
+    ShaderDataPackingPlan uniformPlan = ShaderDataPackingPlan::Build({stream}, false, 128);
+    EXPECT_EQ(uniformPlan.GetPushConstantsSize(), 0);
+    EXPECT_EQ(uniformPlan.GetSpillSize(), 144);
+}
+
+TEST(ShaderDataPacking, Pack) {
+    ShaderDataStream stream;
+    stream._usage = ShaderDataStreamUsage::PUSH_CONSTANT;
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Float, 4, STAGE_VERTEX));
+    stream._dataBlocks.push_back(MakeBlock(PCDT_Float, 4, STAGE_VERTEX));
+    stream._dataBlocks[0]._data = 1.0f;
+    stream._dataBlocks[1]._data = 2.0f;
+
+    ShaderDataPackingPlan plan = ShaderDataPackingPlan::Build({stream}, true, 4);
+
+    std::array<std::byte, ShaderDataPackingPlan::MaxPushConstantsSize> pushConstants {};
+    std::array<std::byte, 16> spill {};
+    plan.Pack({stream}, pushConstants.data(), spill.data());
+
+    float pushed = 0.0f;
+    float spilled = 0.0f;
+    std::memcpy(&pushed, pushConstants.data(), sizeof(float));
+    std::memcpy(&spilled, spill.data(), sizeof(float));
+
+    EXPECT_EQ(pushed, 1.0f);
+    EXPECT_EQ(spilled, 2.0f);
+}
@@ -0,0 +1,19 @@
+#include "gtest/gtest.h"
+#include "Renderer/ShaderPermutation.hpp"
+
+TEST(ShaderPermutation, DefinesFollowFeatureBits) {
+    EXPECT_TRUE(ShaderPermutation::GetDefines(SF_None).empty());
+
+    const std::vector<std::string> defines = ShaderPermutation::GetDefines(SF_VertexColor | SF_DiffuseTexture);
+    ASSERT_EQ(defines.size(), 2);
+    EXPECT_EQ(defines[0], "HAS_DIFFUSE_TEXTURE");
+    EXPECT_EQ(defines[1], "HAS_VERTEX_COLOR");
+}
+
+TEST(ShaderPermutation, InjectDefinesAfterVersion) {
+    const std::string source = "#version 450\nvoid main() {}\n";
+
+    EXPECT_EQ(ShaderPermutation::InjectDefines(source, {}), source);
+    EXPECT_EQ(ShaderPermutation::InjectDefines(source, {"A", "B"}), "#version 450\n#define A\n#define B\nvoid main() {}\n");
+    EXPECT_EQ(ShaderPermutation::InjectDefines("void main() {}\n", {"A"}), "#define A\nvoid main() {}\n");
+}
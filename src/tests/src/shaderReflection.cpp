@@ -0,0 +1,260 @@
+#include "gtest/gtest.h"
+#include "Renderer/ShaderReflection.hpp"
+
+namespace {
+    // Hand written modules, only the instructions the reflection reads
+    struct SpirvWriter {
+        std::vector<unsigned int> _words = {0x07230203, 0x00010000, 0, 64, 0};
+
+        void Op(std::uint32_t opcode, std::initializer_list<std::uint32_t> operands) {
+            _words.push_back((static_cast<std::uint32_t>(operands.size() + 1) << 16) | opcode);
+            _words.insert(_words.end(), operands.begin(), operands.end());
+        }
+
+        void Name(std::uint32_t id, const std::string& name) {
+            std::vector<std::uint32_t> literal((name.size() + 4) / 4, 0);
+            std::memcpy(literal.data(), name.data(), name.size());
+
+            _words.push_back((static_cast<std::uint32_t>(literal.size() + 2) << 16) | 5);
+            _words.push_back(id);
+            _words.insert(_words.end(), literal.begin(), literal.end());
+        }
+
+        void Decorate(std::uint32_t id, std::uint32_t decoration, std::uint32_t literal) {
+            Op(71, {id, decoration, literal});
+        }
+    };
+
+    constexpr std::uint32_t OpTypeFloat = 22;
+    constexpr std::uint32_t OpTypeVector = 23;
+    constexpr std::uint32_t OpTypeMatrix = 24;
+    constexpr std::uint32_t OpTypeImage = 25;
+    constexpr std::uint32_t OpTypeSampler = 26;
+    constexpr std::uint32_t OpTypeSampledImage = 27;
+    constexpr std::uint32_t OpTypeRuntimeArray = 29;
+    constexpr std::uint32_t OpTypeStruct = 30;
+    constexpr std::uint32_t OpTypePointer = 32;
+    constexpr std::uint32_t OpVariable = 59;
+    constexpr std::uint32_t OpMemberDecorate = 72;
+
+    constexpr std::uint32_t Block = 2;
+    constexpr std::uint32_t ArrayStride = 6;
+    constexpr std::uint32_t MatrixStride = 7;
+    constexpr std::uint32_t Binding = 33;
+    constexpr std::uint32_t DescriptorSet = 34;
+    constexpr std::uint32_t Offset = 35;
+
+    constexpr std::uint32_t UniformConstant = 0;
+    constexpr std::uint32_t Uniform = 2;
+    constexpr std::uint32_t PushConstant = 9;
+    constexpr std::uint32_t StorageBuffer = 12;
+
+    // float, vec4 and mat4 as ids 1 to 3
+    void WriteTypes(SpirvWriter& writer) {
+        writer.Op(OpTypeFloat, {1, 32});
+        writer.Op(OpTypeVector, {2, 1, 4});
+        writer.Op(OpTypeMatrix, {3, 2, 4});
+    }
+
+    // uniform Camera { mat4 viewProjection; vec4 position; } camera at set 0, binding 0
+    void WriteCameraBlock(SpirvWriter& writer) {
+        writer.Name(6, "camera");
+        writer.Decorate(4, Block, 0);
+        writer.Op(OpMemberDecorate, {4, 0, Offset, 0});
+        writer.Op(OpMemberDecorate, {4, 0, MatrixStride, 16});
+        writer.Op(OpMemberDecorate, {4, 1, Offset, 64});
+        writer.Decorate(6, DescriptorSet, 0);
+        writer.Decorate(6, Binding, 0);
+        writer.Op(OpTypeStruct, {4, 3, 2});
+        writer.Op(OpTypePointer, {5, Uniform, 4});
+        writer.Op(OpVariable, {5, 6, Uniform});
+    }
+
+    // push_constant { mat4 model; }
+    void WritePushConstants(SpirvWriter& writer) {
+        writer.Decorate(7, Block, 0);
+        writer.Op(OpMemberDecorate, {7, 0, Offset, 0});
+        writer.Op(OpMemberDecorate, {7, 0, MatrixStride, 16});
+        writer.Op(OpTypeStruct, {7, 3});
+        writer.Op(OpTypePointer, {8, PushConstant, 7});
+        writer.Op(OpVariable, {8, 9, PushConstant});
+    }
+
+    std::vector<unsigned int> MakeVertexModule() {
+        SpirvWriter writer;
+        WriteTypes(writer);
+        WriteCameraBlock(writer);
+        WritePushConstants(writer);
+        return writer._words;
+    }
+
+    // Camera and push constants again, a sampled texture and a sampler at set 1 and a storage buffer at set 2
+    std::vector<unsigned int> MakeFragmentModule() {
+        SpirvWriter writer;
+        WriteTypes(writer);
+        WriteCameraBlock(writer);
+        WritePushConstants(writer);
+
+        writer.Name(13, "diffuse");
+        writer.Op(OpTypeImage, {10, 1, 1, 0, 0, 0, 1, 0});
+        writer.Op(OpTypeSampledImage, {11, 10});
+        writer.Op(OpTypePointer, {12, UniformConstant, 11});
+        writer.Op(OpVariable, {12, 13, UniformConstant});
+        writer.Decorate(13, DescriptorSet, 1);
+        writer.Decorate(13, Binding, 0);
+
+        writer.Op(OpTypeSampler, {14});
+        writer.Op(OpTypePointer, {15, UniformConstant, 14});
+        writer.Op(OpVariable, {15, 16, UniformConstant});
+        writer.Decorate(16, DescriptorSet, 1);
+        writer.Decorate(16, Binding, 1);
+
+        // buffer Lights { vec4 header; vec4 lights[]; }
+        writer.Name(20, "lights");
+        writer.Decorate(17, ArrayStride, 16);
+        writer.Decorate(18, Block, 0);
+        writer.Op(OpMemberDecorate, {18, 0, Offset, 0});
+        writer.Op(OpMemberDecorate, {18, 1, Offset, 16});
+        writer.Op(OpTypeRuntimeArray, {17, 2});
+        writer.Op(OpTypeStruct, {18, 2, 17});
+        writer.Op(OpTypePointer, {19, StorageBuffer, 18});
+        writer.Op(OpVariable, {19, 20, StorageBuffer});
+        writer.Decorate(20, DescriptorSet, 2);
+        writer.Decorate(20, Binding, 0);
+
+        return writer._words;
+    }
+
+    ShaderDataBlock MakeBlock(ShaderDataBlockUsage usage, std::size_t size) {
+        ShaderDataBlock block {};
+        block._type = PCDT_ContiguosMemory;
+        block._size = size;
+        block._usage = usage;
+        block._stage = (ShaderStage)(STAGE_VERTEX | STAGE_FRAGMENT);
+        return block;
+    }
+
+    ShaderDataStream MakeStream(std::initializer_list<ShaderDataBlock> blocks) {
+        ShaderDataStream stream;
+        stream._usage = ShaderDataStreamUsage::DATA;
+        stream._dataBlocks = blocks;
+        return stream;
+    }
+}
+
+TEST(ShaderReflection, UniformBlockAndPushConstants) {
+    ShaderReflection reflection;
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeVertexModule(), STAGE_VERTEX, reflection));
+
+    ASSERT_EQ(reflection._bindings.size(), 1);
+    const ShaderResourceBinding& camera = reflection._bindings[0];
+    EXPECT_EQ(camera._set, 0);
+    EXPECT_EQ(camera._binding, 0);
+    EXPECT_EQ(camera._usage, ShaderDataBlockUsage::UNIFORM_BUFFER);
+    EXPECT_EQ(camera._size, 80);
+    EXPECT_EQ(camera._stage, STAGE_VERTEX);
+    EXPECT_EQ(camera._identifier, "camera");
+
+    ASSERT_EQ(reflection._pushConstants.size(), 1);
+    EXPECT_EQ(reflection._pushConstants[0]._offset, 0);
+    EXPECT_EQ(reflection._pushConstants[0]._size, 64);
+    EXPECT_EQ(reflection.GetSetCount(), 1);
+}
+
+TEST(ShaderReflection, TextureSamplerAndStorageBuffer) {
+    ShaderReflection reflection;
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeFragmentModule(), STAGE_FRAGMENT, reflection));
+
+    ASSERT_EQ(reflection._bindings.size(), 4);
+
+    const ShaderResourceBinding* diffuse = reflection.FindBinding(1, 0);
+    ASSERT_NE(diffuse, nullptr);
+    EXPECT_EQ(diffuse->_usage, ShaderDataBlockUsage::TEXTURE);
+    EXPECT_EQ(diffuse->_identifier, "diffuse");
+
+    const ShaderResourceBinding* sampler = reflection.FindBinding(1, 1);
+    ASSERT_NE(sampler, nullptr);
+    EXPECT_EQ(sampler->_usage, ShaderDataBlockUsage::SAMPLER);
+
+    // The runtime array has no size, only the header counts
+    const ShaderResourceBinding* lights = reflection.FindBinding(2, 0);
+    ASSERT_NE(lights, nullptr);
+    EXPECT_EQ(lights->_usage, ShaderDataBlockUsage::STORAGE_BUFFER);
+    EXPECT_EQ(lights->_size, 16);
+    EXPECT_EQ(lights->_identifier, "lights");
+
+    EXPECT_EQ(reflection.GetSetCount(), 3);
+}
+
+TEST(ShaderReflection, MergesStages) {
+    ShaderReflection vertex;
+    ShaderReflection fragment;
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeVertexModule(), STAGE_VERTEX, vertex));
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeFragmentModule(), STAGE_FRAGMENT, fragment));
+
+    const ShaderReflection merged = ShaderReflection::Merge(vertex, fragment);
+    ASSERT_EQ(merged._bindings.size(), 4);
+
+    // Shared by both stages
+    EXPECT_EQ(merged._bindings[0]._set, 0);
+    EXPECT_EQ(merged._bindings[0]._stage, STAGE_VERTEX | STAGE_FRAGMENT);
+
+    // Only declared by the fragment stage, sorted by set and binding
+    EXPECT_EQ(merged._bindings[1]._set, 1);
+    EXPECT_EQ(merged._bindings[1]._binding, 0);
+    EXPECT_EQ(merged._bindings[1]._stage, STAGE_FRAGMENT);
+    EXPECT_EQ(merged._bindings[2]._binding, 1);
+    EXPECT_EQ(merged._bindings[3]._set, 2);
+
+    ASSERT_EQ(merged._pushConstants.size(), 1);
+    EXPECT_EQ(merged._pushConstants[0]._stage, STAGE_VERTEX | STAGE_FRAGMENT);
+}
+
+TEST(ShaderReflection, RejectsInvalidModules) {
+    ShaderReflection reflection;
+    EXPECT_FALSE(ShaderReflection::Reflect({}, STAGE_VERTEX, reflection));
+
+    std::vector<unsigned int> module = MakeVertexModule();
+    module[0] = 0;
+    EXPECT_FALSE(ShaderReflection::Reflect(module, STAGE_VERTEX, reflection));
+
+    // A storage image cannot be bound, the module fails instead of losing the binding
+    SpirvWriter writer;
+    WriteTypes(writer);
+    writer.Op(OpTypeImage, {10, 1, 1, 0, 0, 0, 2, 1});
+    writer.Op(OpTypePointer, {12, UniformConstant, 10});
+    writer.Op(OpVariable, {12, 13, UniformConstant});
+    EXPECT_FALSE(ShaderReflection::Reflect(writer._words, STAGE_FRAGMENT, reflection));
+}
+
+TEST(ShaderReflection, ValidatesDataStreams) {
+    ShaderReflection vertex;
+    ShaderReflection fragment;
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeVertexModule(), STAGE_VERTEX, vertex));
+    ASSERT_TRUE(ShaderReflection::Reflect(MakeFragmentModule(), STAGE_FRAGMENT, fragment));
+    const ShaderReflection reflection = ShaderReflection::Merge(vertex, fragment);
+
+    ShaderDataStream pushConstants;
+    pushConstants._usage = ShaderDataStreamUsage::PUSH_CONSTANT;
+    pushConstants._dataBlocks.push_back(MakeBlock(ShaderDataBlockUsage::NONE, 64));
+
+    const ShaderDataStream camera = MakeStream({MakeBlock(ShaderDataBlockUsage::UNIFORM_BUFFER, 80)});
+    const ShaderDataStream textures = MakeStream({MakeBlock(ShaderDataBlockUsage::TEXTURE, 0), MakeBlock(ShaderDataBlockUsage::SAMPLER, 0)});
+    const ShaderDataStream lights = MakeStream({MakeBlock(ShaderDataBlockUsage::STORAGE_BUFFER, 1024)});
+
+    // Push constant streams do not take a set
+    EXPECT_TRUE(reflection.ValidateDataStreams({pushConstants, camera, textures, lights}));
+
+    // Blocks past what the shaders use are fine, sets past the streams are not checked
+    const ShaderDataStream cameraAndUnused = MakeStream({MakeBlock(ShaderDataBlockUsage::UNIFORM_BUFFER, 80), MakeBlock(ShaderDataBlockUsage::UNIFORM_BUFFER, 16)});
+    EXPECT_TRUE(reflection.ValidateDataStreams({cameraAndUnused}));
+
+    const ShaderDataStream smallCamera = MakeStream({MakeBlock(ShaderDataBlockUsage::UNIFORM_BUFFER, 64)});
+    EXPECT_FALSE(reflection.ValidateDataStreams({smallCamera, textures, lights}));
+
+    const ShaderDataStream swappedTextures = MakeStream({MakeBlock(ShaderDataBlockUsage::SAMPLER, 0), MakeBlock(ShaderDataBlockUsage::TEXTURE, 0)});
+    EXPECT_FALSE(reflection.ValidateDataStreams({camera, swappedTextures, lights}));
+
+    const ShaderDataStream missingSampler = MakeStream({MakeBlock(ShaderDataBlockUsage::TEXTURE, 0)});
+    EXPECT_FALSE(reflection.ValidateDataStreams({camera, missingSampler, lights}));
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "glm/glm.hpp"
+#include <cmath>
+
+// Procedural meshes shared by the geometry tests
+namespace TestMeshes {
+    struct Mesh {
+        std::vector<glm::vec3> _positions;
+        std::vector<std::uint32_t> _indices;
+    };
+
+    // Flat square of size x size quads on the xy plane, facing +z
+    inline Mesh MakeGrid(std::uint32_t size) {
+        Mesh mesh;
+        for(std::uint32_t y = 0; y <= size; y++) {
+            for(std::uint32_t x = 0; x <= size; x++) {
+                mesh._positions.push_back({static_cast<float>(x), static_cast<float>(y), 0.0f});
+            }
+        }
+
+        for(std::uint32_t y = 0; y < size; y++) {
+            for(std::uint32_t x = 0; x < size; x++) {
+                const std::uint32_t v = y * (size + 1) + x;
+                mesh._indices.insert(mesh._indices.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+            }
+        }
+
+        return mesh;
+    }
+
+    // Closed unit sphere, the poles are single vertices and triangles face outwards
+    inline Mesh MakeSphere(std::uint32_t rings, std::uint32_t segments) {
+        Mesh mesh;
+        mesh._positions.push_back({0.0f, 1.0f, 0.0f});
+        for(std::uint32_t ring = 1; ring < rings; ring++) {
+            const float theta = 3.14159265f * static_cast<float>(ring) / static_cast<float>(rings);
+            for(std::uint32_t segment = 0; segment < segments; segment++) {
+                const float phi = 2.0f * 3.14159265f * static_cast<float>(segment) / static_cast<float>(segments);
+                mesh._positions.push_back({std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+        mesh._positions.push_back({0.0f, -1.0f, 0.0f});
+
+        const std::uint32_t south = static_cast<std::uint32_t>(mesh._positions.size() - 1);
+        auto Ring = [segments](std::uint32_t ring, std::uint32_t segment) {
+            return 1 + (ring - 1) * segments + segment % segments;
+        };
+
+        for(std::uint32_t segment = 0; segment < segments; segment++) {
+            mesh._indices.insert(mesh._indices.end(), {0, Ring(1, segment + 1), Ring(1, segment)});
+            mesh._indices.insert(mesh._indices.end(), {south, Ring(rings - 1, segment), Ring(rings - 1, segment + 1)});
+        }
+
+        for(std::uint32_t ring = 1; ring + 1 < rings; ring++) {
+            for(std::uint32_t segment = 0; segment < segments; segment++) {
+                const std::uint32_t a = Ring(ring, segment), b = Ring(ring, segment + 1);
+                const std::uint32_t c = Ring(ring + 1, segment), d = Ring(ring + 1, segment + 1);
+                mesh._indices.insert(mesh._indices.end(), {a, b, d, a, d, c});
+            }
+        }
+
+        return mesh;
+    }
+}
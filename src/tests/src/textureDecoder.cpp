@@ -0,0 +1,144 @@
+#include "gtest/gtest.h"
+#include "Renderer/TextureDecoder.hpp"
+#include "Core/ImportCache.hpp"
+#include "Core/MappedFile.hpp"
+#include <thread>
+
+namespace {
+    // Binary PPM, the smallest format stb_image reads, every pixel set to value
+    std::shared_ptr<const std::vector<std::uint8_t>> MakeImage(std::uint32_t width, std::uint32_t height, std::uint8_t value) {
+        const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+        auto image = std::make_shared<std::vector<std::uint8_t>>(header.begin(), header.end());
+        image->resize(image->size() + width * height * 3, value);
+        return image;
+    }
+
+    void WaitFor(const std::shared_ptr<TextureDecodeRequest>& request) {
+        while(!request->IsFinished()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TEST(TextureDecoder, DecodesToRgba) {
+    TextureDecoder decoder(1024 * 1024, 2);
+
+    auto request = decoder.DecodeMemory(MakeImage(4, 2, 7));
+    ASSERT_NE(request, nullptr);
+    WaitFor(request);
+    ASSERT_EQ(request->GetState(), TextureDecodeRequest::State::Decoded);
+
+    const DecodedImage image = request->TakeImage();
+    ASSERT_EQ(image._width, 4);
+    ASSERT_EQ(image._height, 2);
+    EXPECT_EQ(image._pixels[0], 7);
+    EXPECT_EQ(image._pixels[3], 255);
+    EXPECT_EQ(decoder.GetInFlightBytes(), 0);
+
+    EXPECT_EQ(decoder.DecodeMemory(std::make_shared<const std::vector<std::uint8_t>>(16, 0)), nullptr);
+}
+
+TEST(TextureDecoder, WaitsForMemoryInPriorityOrder) {
+    // Room for a single 16x16 image at a time
+    TextureDecoder decoder(16 * 16 * 4, 4);
+
+    auto first = decoder.DecodeMemory(MakeImage(16, 16, 1));
+    auto low = decoder.DecodeMemory(MakeImage(16, 16, 2), 1.0f);
+    auto high = decoder.DecodeMemory(MakeImage(16, 16, 3), 2.0f);
+
+    WaitFor(first);
+    EXPECT_EQ(low->GetState(), TextureDecodeRequest::State::Queued);
+    EXPECT_EQ(high->GetState(), TextureDecodeRequest::State::Queued);
+
+    // Taking the pixels makes room for the next one, the highest priority
+    first->TakeImage();
+    WaitFor(high);
+    EXPECT_EQ(low->GetState(), TextureDecodeRequest::State::Queued);
+
+    // Dropping a decoded request frees its memory just the same
+    high.reset();
+    WaitFor(low);
+    EXPECT_EQ(low->TakeImage()._pixels[0], 2);
+}
+
+TEST(TextureDecoder, CachesCompressedImages) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "textureDecoderCacheTest";
+    std::filesystem::remove_all(directory);
+
+    TextureDecoder decoder(1024 * 1024, 2);
+    decoder.SetCache(std::make_shared<ImportCache>(directory, 1024 * 1024));
+
+    auto Decode = [&decoder](TextureCompression compression) {
+        auto request = decoder.DecodeMemory(MakeImage(10, 6, 40), 0.0f, {compression});
+        WaitFor(request);
+        return request->TakeImage();
+    };
+
+    // Opaque, BC1 with 3x2 blocks of 8 bytes
+    const DecodedImage compressed = Decode(TextureCompression::Color);
+    ASSERT_EQ(compressed._format, Format::FORMAT_BC1_RGBA_SRGB);
+    ASSERT_EQ(compressed.GetSize(), 48);
+
+    std::vector<std::filesystem::path> entries;
+    for(const auto& file : std::filesystem::directory_iterator(directory)) {
+        if(file.path().extension() == ImportCache::TextureEntryExtension) {
+            entries.push_back(file.path());
+        }
+    }
+    ASSERT_EQ(entries.size(), 1u);
+
+    // Read back from the cache, the entry is replaced with different blocks to tell the two apart
+    std::vector<std::uint8_t> bytes(std::filesystem::file_size(entries[0]));
+    std::ifstream(entries[0], std::ios::binary).read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    bytes.back() ^= 0xFF;
+    std::ofstream(entries[0], std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    const DecodedImage cached = Decode(TextureCompression::Color);
+    ASSERT_EQ(cached._format, Format::FORMAT_BC1_RGBA_SRGB);
+    EXPECT_EQ(std::memcmp(cached._pixels.get(), compressed._pixels.get(), cached.GetSize() - 1), 0);
+    EXPECT_NE(cached._pixels[cached.GetSize() - 1], compressed._pixels[compressed.GetSize() - 1]);
+
+    // Without compression the cache is not involved
+    EXPECT_EQ(Decode(TextureCompression::None)._format, Format::FORMAT_R8G8B8A8_SRGB);
+
+    decoder.SetCache(nullptr);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TextureDecoder, CachedPixelsKeepTheirMapping) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "textureDecoderMappingTest";
+    std::filesystem::remove_all(directory);
+
+    TextureDecoder decoder(1024 * 1024, 2);
+    decoder.SetCache(std::make_shared<ImportCache>(directory, 1024 * 1024));
+
+    auto Decode = [&decoder]() {
+        auto request = decoder.DecodeMemory(MakeImage(8, 8, 40), 0.0f, {TextureCompression::Color});
+        WaitFor(request);
+        return request->TakeImage();
+    };
+
+    // The second decode reads the blocks the first one cached in place
+    const DecodedImage compressed = Decode();
+    std::weak_ptr<const MappedFile> mapping;
+    {
+        DecodedImage cached = Decode();
+        mapping = cached._pixels.get_deleter()._mapping;
+        ASSERT_FALSE(mapping.expired());
+
+        const std::shared_ptr<const MappedFile> file = mapping.lock();
+        EXPECT_GE(cached._pixels.get(), file->GetData());
+        EXPECT_LE(cached._pixels.get() + cached.GetSize(), file->GetData() + file->GetSize());
+
+        // Handed over like Texture2D::SetDecodedImage does, the mapping goes along
+        const DecodedImage moved = std::move(cached);
+        EXPECT_FALSE(mapping.expired());
+        EXPECT_EQ(std::memcmp(moved._pixels.get(), compressed._pixels.get(), moved.GetSize()), 0);
+    }
+
+    // Unmapped with the last image, the deleter never frees memory it does not own
+    EXPECT_TRUE(mapping.expired());
+
+    decoder.SetCache(nullptr);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+#include "Renderer/TextureRegistry.hpp"
+#include "Renderer/Texture2D.hpp"
+
+TEST(TextureRegistry, SharesIdenticalImages) {
+    TextureRegistry registry;
+    const std::array<std::uint32_t, 4> pixels = {1, 2, 3, 4};
+    const std::array<std::uint32_t, 4> otherPixels = {1, 2, 3, 5};
+
+    auto texture = registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels));
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels)), texture);
+    EXPECT_EQ(registry.GetHitCount(), 1u);
+
+    // Other bytes, shape or format are other textures
+    EXPECT_NE(registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, otherPixels.data(), sizeof(otherPixels)), texture);
+    EXPECT_NE(registry.FindOrMakeFromData(4, 1, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels)), texture);
+    EXPECT_NE(registry.FindOrMakeFromData(2, 2, Format::FORMAT_B8G8R8A8_SRGB, pixels.data(), sizeof(pixels)), texture);
+    EXPECT_EQ(registry.GetHitCount(), 1u);
+}
+
+TEST(TextureRegistry, ReleasesUnusedTextures) {
+    TextureRegistry registry;
+    const std::array<std::uint32_t, 4> pixels = {1, 2, 3, 4};
+    std::uint32_t initialized = 0;
+    const auto initialize = [&](Texture2D&) { initialized++; };
+
+    auto texture = registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels), initialize);
+    auto shared = registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels), initialize);
+    EXPECT_EQ(initialized, 1u);
+    EXPECT_EQ(registry.GetTextureCount(), 1u);
+
+    // Alive as long as one user holds it
+    texture.reset();
+    EXPECT_EQ(registry.GetTextureCount(), 1u);
+    shared.reset();
+    EXPECT_EQ(registry.GetTextureCount(), 0u);
+
+    EXPECT_NE(registry.FindOrMakeFromData(2, 2, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), sizeof(pixels), initialize), nullptr);
+    EXPECT_EQ(initialized, 2u);
+}
@@ -0,0 +1,236 @@
+#include "gtest/gtest.h"
+#include "Renderer/TextureResidency.hpp"
+#include "Renderer/Texture2D.hpp"
+#include "Renderer/TextureDecoder.hpp"
+#include "Renderer/MipGenerator.hpp"
+#include <thread>
+
+namespace {
+    std::shared_ptr<Texture2D> MakeTexture(std::uint32_t size) {
+        const std::vector<std::uint8_t> pixels(static_cast<std::size_t>(size) * size * 4, 0xFF);
+        return Texture2D::MakeFromData(size, size, Format::FORMAT_R8G8B8A8_SRGB, pixels.data(), pixels.size());
+    }
+
+    // Binary PPM, decoded on the TextureDecoder once requested
+    std::shared_ptr<Texture2D> MakeEncodedTexture(std::uint32_t size) {
+        const std::string header = "P6\n" + std::to_string(size) + " " + std::to_string(size) + "\n255\n";
+        auto image = std::make_shared<std::vector<std::uint8_t>>(header.begin(), header.end());
+        image->resize(image->size() + static_cast<std::size_t>(size) * size * 3, 0xFF);
+        return Texture2D::MakeFromEncodedData(std::move(image), Format::FORMAT_R8G8B8A8_SRGB);
+    }
+
+    // Requested with the footprint every frame until its decode finished and it was admitted
+    void MakeResident(TextureResidency& residency, const std::shared_ptr<Texture2D>& texture, float footprint) {
+        for(int frame = 0; frame < 1000; frame++) {
+            residency.BeginFrame(1);
+            residency.ReportFootprint(texture, footprint);
+            if(residency.Request(texture) == texture) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        FAIL() << "The texture was never admitted";
+    }
+
+    // Size of the levels of a 64x64 chain from the first one down to 1x1
+    std::size_t GetLevelsSize(std::uint32_t firstLevel) {
+        const std::uint32_t size = MipGenerator::GetLevelExtent(64, firstLevel);
+        return MipGenerator::GetChainSize(Format::FORMAT_R8G8B8A8_SRGB, size, size, MipGenerator::GetLevelCount(size, size));
+    }
+
+    // What the texture asked for in the frame, as counted by the next BeginFrame
+    std::size_t GetRequestedBytes(TextureResidency& residency, const std::shared_ptr<Texture2D>& texture, float footprint) {
+        residency.ReportFootprint(texture, footprint);
+        residency.Request(texture);
+        residency.BeginFrame(1);
+        return residency.GetRequestedBytes();
+    }
+}
+
+TEST(TextureResidency, EvictsLeastRecentlyRequestedFirst) {
+    const std::shared_ptr<Texture2D> first = MakeTexture(8);
+    const std::shared_ptr<Texture2D> second = MakeTexture(8);
+    const std::shared_ptr<Texture2D> third = MakeTexture(8);
+    const std::size_t size = first->GetImageDataSize();
+
+    TextureResidency residency;
+    residency.SetEvictionDelay(0);
+    residency.SetBudget(2 * size);
+
+    // One texture per frame, the first one is the oldest
+    for(const std::shared_ptr<Texture2D>& texture : {first, second, third}) {
+        residency.BeginFrame(1);
+        EXPECT_EQ(residency.Request(texture), texture);
+    }
+
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetResidentCount(), 2);
+    EXPECT_EQ(residency.GetResidentBytes(), 2 * size);
+    EXPECT_NE(residency.Resolve(first), first);
+    EXPECT_EQ(residency.Resolve(second), second);
+    EXPECT_EQ(residency.Resolve(third), third);
+
+    // Requested again it loads again, the next oldest goes once over the budget
+    EXPECT_EQ(residency.Request(first), first);
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetResidentCount(), 2);
+    EXPECT_NE(residency.Resolve(second), second);
+    EXPECT_EQ(residency.Resolve(first), first);
+}
+
+TEST(TextureResidency, KeepsTexturesInFlight) {
+    const std::shared_ptr<Texture2D> first = MakeTexture(8);
+    const std::shared_ptr<Texture2D> second = MakeTexture(8);
+
+    TextureResidency residency;
+    residency.SetEvictionDelay(0);
+    residency.SetBudget(first->GetImageDataSize());
+
+    residency.BeginFrame(2);
+    residency.Request(first);
+    residency.BeginFrame(2);
+    residency.Request(second);
+
+    // The first texture could still be sampled by the two frames in flight
+    residency.BeginFrame(2);
+    EXPECT_EQ(residency.GetResidentCount(), 2);
+    residency.BeginFrame(2);
+    EXPECT_EQ(residency.GetResidentCount(), 1);
+    EXPECT_EQ(residency.Resolve(second), second);
+}
+
+TEST(TextureResidency, ReusedAddressStartsOver) {
+    // Both textures live in the same storage, as when the allocator hands the memory of a freed texture out again
+    alignas(Texture2D) std::byte storage[sizeof(Texture2D)];
+    auto Make = [&storage]() {
+        return std::shared_ptr<Texture2D>(new(storage) Texture2D(), [](Texture2D* texture) { texture->~Texture2D(); });
+    };
+
+    TextureResidency residency;
+    residency.BeginFrame(1);
+
+    std::shared_ptr<Texture2D> texture = Make();
+    EXPECT_EQ(residency.Request(texture), texture);
+    EXPECT_EQ(residency.Resolve(texture), texture);
+    texture.reset();
+
+    texture = Make();
+    EXPECT_NE(residency.Resolve(texture), texture);
+    EXPECT_EQ(residency.Request(texture), texture);
+    texture.reset();
+
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetResidentCount(), 0);
+}
+
+TEST(TextureResidency, DecodedImageWaitsForAdmission) {
+    const std::shared_ptr<Texture2D> first = MakeEncodedTexture(8);
+    const std::shared_ptr<Texture2D> second = MakeEncodedTexture(8);
+
+    // Nothing is admitted, the decodes finish meanwhile
+    TextureResidency residency;
+    residency.SetMaxLoadsPerFrame(0);
+    for(int frame = 0; frame < 50; frame++) {
+        residency.BeginFrame(1);
+        EXPECT_NE(residency.Request(first), first);
+        EXPECT_NE(residency.Request(second), second);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    // The pixels stay with the requests until admitted
+    EXPECT_TRUE(first->NeedsDecode());
+    EXPECT_TRUE(second->NeedsDecode());
+    EXPECT_GT(TextureDecoder::Get().GetInFlightBytes(), 0);
+
+    residency.SetMaxLoadsPerFrame(1);
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.Request(first), first);
+    EXPECT_NE(residency.Request(second), second);
+    EXPECT_FALSE(first->NeedsDecode());
+    EXPECT_TRUE(second->NeedsDecode());
+
+    // Out of view, the decoded pixels are dropped with the request
+    residency.BeginFrame(1);
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetDecodingCount(), 0);
+    EXPECT_EQ(TextureDecoder::Get().GetInFlightBytes(), 0);
+    EXPECT_TRUE(second->NeedsDecode());
+}
+
+TEST(TextureResidency, AdmitsLimitedLoadsPerFrame) {
+    const std::shared_ptr<Texture2D> first = MakeTexture(8);
+    const std::shared_ptr<Texture2D> second = MakeTexture(8);
+    const std::shared_ptr<Texture2D> third = MakeTexture(8);
+
+    TextureResidency residency;
+    residency.SetMaxLoadsPerFrame(2);
+
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.Request(first), first);
+    EXPECT_EQ(residency.Request(second), second);
+    EXPECT_NE(residency.Request(third), third);
+
+    // Resident ones do not count against the limit
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.Request(first), first);
+    EXPECT_EQ(residency.Request(second), second);
+    EXPECT_EQ(residency.Request(third), third);
+
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetResidentCount(), 3);
+}
+
+TEST(TextureResidency, WantsLevelsForFootprint) {
+    const std::shared_ptr<Texture2D> texture = MakeEncodedTexture(64);
+    texture->SetGenerateMips(true);
+
+    TextureResidency residency;
+    MakeResident(residency, texture, 64.0f);
+
+    // About a texel per pixel, unreported footprints get every level
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 64.0f), GetLevelsSize(0));
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 16.0f), GetLevelsSize(2));
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 1.0f), GetLevelsSize(6));
+    residency.Request(texture);
+    residency.BeginFrame(1);
+    EXPECT_EQ(residency.GetRequestedBytes(), GetLevelsSize(0));
+}
+
+TEST(TextureResidency, FinerLevelsNeedMargin) {
+    const std::shared_ptr<Texture2D> texture = MakeEncodedTexture(64);
+    texture->SetGenerateMips(true);
+
+    // Admitted with the 16x16 level first
+    TextureResidency residency;
+    MakeResident(residency, texture, 16.0f);
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 16.0f), GetLevelsSize(2));
+
+    // Just past the threshold of the next level is not enough to stream it in
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 17.0f), GetLevelsSize(2));
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 24.0f), GetLevelsSize(1));
+}
+
+TEST(TextureResidency, MipBiasFollowsBudget) {
+    const std::shared_ptr<Texture2D> texture = MakeEncodedTexture(64);
+    texture->SetGenerateMips(true);
+
+    TextureResidency residency;
+    MakeResident(residency, texture, 64.0f);
+    EXPECT_EQ(residency.GetMipBias(), 0);
+
+    // The two finest levels have to go for the rest to fit
+    residency.SetBudget(GetLevelsSize(2));
+    for(int frame = 0; frame < 10; frame++) {
+        GetRequestedBytes(residency, texture, 64.0f);
+    }
+    EXPECT_EQ(residency.GetMipBias(), 2);
+    EXPECT_LE(residency.GetRequestedBytes(), GetLevelsSize(2));
+
+    // Back to every level once they fit again, one level per frame
+    residency.SetBudget(4 * GetLevelsSize(0));
+    GetRequestedBytes(residency, texture, 64.0f);
+    EXPECT_EQ(residency.GetMipBias(), 1);
+    GetRequestedBytes(residency, texture, 64.0f);
+    EXPECT_EQ(residency.GetMipBias(), 0);
+    EXPECT_EQ(GetRequestedBytes(residency, texture, 64.0f), GetLevelsSize(0));
+}
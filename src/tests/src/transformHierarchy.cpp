@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+#include "Core/TransformHierarchy.hpp"
+#include "Components/TransformComponent.hpp"
+
+namespace {
+    struct TestHierarchy {
+        entt::registry _registry;
+        TransformHierarchy _hierarchy;
+
+        TestHierarchy() {
+            _hierarchy.Attach(_registry);
+        }
+
+        entt::entity Add(const glm::vec3& position) {
+            const entt::entity entity = _registry.create();
+            _registry.emplace<TransformComponent>(entity).m_Position = position;
+            return entity;
+        }
+
+        void Parent(entt::entity parent, entt::entity child) {
+            _registry.get<TransformComponent>(parent)._childs.push_back(_registry.get<TransformComponent>(child)._id);
+        }
+
+        void Unparent(entt::entity parent, entt::entity child) {
+            std::erase(_registry.get<TransformComponent>(parent)._childs, _registry.get<TransformComponent>(child)._id);
+        }
+
+        void Move(entt::entity entity, const glm::vec3& position) {
+            _registry.patch<TransformComponent>(entity, [&position](TransformComponent& transform) {
+                transform.m_Position = position;
+            });
+        }
+
+        glm::vec3 GetWorldPosition(entt::entity entity) {
+            const std::optional<glm::mat4>& matrix = _registry.get<TransformComponent>(entity)._computedMatrix;
+            return matrix.has_value() ? glm::vec3((*matrix)[3]) : glm::vec3(NAN);
+        }
+
+        std::vector<entt::entity> GetUpdated() const {
+            std::vector<entt::entity> updated = _hierarchy.GetUpdatedEntities();
+            std::sort(updated.begin(), updated.end());
+            return updated;
+        }
+    };
+
+    void ExpectPosition(const glm::vec3& position, const glm::vec3& expected) {
+        EXPECT_NEAR(position.x, expected.x, 1e-3f);
+        EXPECT_NEAR(position.y, expected.y, 1e-3f);
+        EXPECT_NEAR(position.z, expected.z, 1e-3f);
+    }
+}
+
+TEST(TransformHierarchy, DirtyMiddleNodeUpdatesItsSubtreeOnly) {
+    TestHierarchy test;
+    const entt::entity root = test.Add({1.0f, 0.0f, 0.0f});
+    const entt::entity middle = test.Add({0.0f, 1.0f, 0.0f});
+    const entt::entity leaf = test.Add({0.0f, 0.0f, 1.0f});
+    const entt::entity sibling = test.Add({2.0f, 0.0f, 0.0f});
+    test.Parent(root, middle);
+    test.Parent(middle, leaf);
+    test.Parent(root, sibling);
+
+    test._hierarchy.Update(test._registry);
+    EXPECT_EQ(test._hierarchy.GetSize(), 4);
+    ExpectPosition(test.GetWorldPosition(leaf), {1.0f, 1.0f, 1.0f});
+    ExpectPosition(test.GetWorldPosition(sibling), {3.0f, 0.0f, 0.0f});
+
+    // Nothing moved, nothing is recomputed
+    test._hierarchy.Update(test._registry);
+    EXPECT_TRUE(test._hierarchy.GetUpdatedEntities().empty());
+
+    test.Move(middle, {0.0f, 5.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+
+    std::vector<entt::entity> expected = {middle, leaf};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(test.GetUpdated(), expected);
+    ExpectPosition(test.GetWorldPosition(middle), {1.0f, 5.0f, 0.0f});
+    ExpectPosition(test.GetWorldPosition(leaf), {1.0f, 5.0f, 1.0f});
+    ExpectPosition(test.GetWorldPosition(sibling), {3.0f, 0.0f, 0.0f});
+}
+
+TEST(TransformHierarchy, NestedDirtyNodesAreRecomputedOnce) {
+    TestHierarchy test;
+    const entt::entity root = test.Add({1.0f, 0.0f, 0.0f});
+    const entt::entity child = test.Add({1.0f, 0.0f, 0.0f});
+    test.Parent(root, child);
+    test._hierarchy.Update(test._registry);
+
+    test.Move(child, {2.0f, 0.0f, 0.0f});
+    test.Move(root, {3.0f, 0.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+
+    EXPECT_EQ(test._hierarchy.GetUpdatedEntities().size(), 2);
+    ExpectPosition(test.GetWorldPosition(child), {5.0f, 0.0f, 0.0f});
+}
+
+TEST(TransformHierarchy, Reparenting) {
+    TestHierarchy test;
+    const entt::entity first = test.Add({10.0f, 0.0f, 0.0f});
+    const entt::entity second = test.Add({0.0f, 10.0f, 0.0f});
+    const entt::entity child = test.Add({0.0f, 0.0f, 1.0f});
+    test.Parent(first, child);
+
+    test._hierarchy.Update(test._registry);
+    ExpectPosition(test.GetWorldPosition(child), {10.0f, 0.0f, 1.0f});
+
+    test.Unparent(first, child);
+    test.Parent(second, child);
+    test._hierarchy.MarkStructureDirty();
+    test._hierarchy.Update(test._registry);
+    ExpectPosition(test.GetWorldPosition(child), {0.0f, 10.0f, 1.0f});
+
+    // The old parent no longer drags the child along
+    test.Move(first, {20.0f, 0.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+    EXPECT_EQ(test.GetUpdated(), std::vector<entt::entity>{first});
+    ExpectPosition(test.GetWorldPosition(child), {0.0f, 10.0f, 1.0f});
+
+    test.Move(second, {0.0f, 20.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+    ExpectPosition(test.GetWorldPosition(child), {0.0f, 20.0f, 1.0f});
+}
+
+TEST(TransformHierarchy, NewTransformsRebuildTheOrder) {
+    TestHierarchy test;
+    const entt::entity root = test.Add({1.0f, 0.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+
+    const entt::entity child = test.Add({1.0f, 0.0f, 0.0f});
+    test.Parent(root, child);
+    test._hierarchy.Update(test._registry);
+
+    EXPECT_EQ(test._hierarchy.GetSize(), 2);
+    ExpectPosition(test.GetWorldPosition(child), {2.0f, 0.0f, 0.0f});
+}
+
+TEST(TransformHierarchy, DeepChain) {
+    // Long enough for the update to be split across the job system one level at a time
+    constexpr std::size_t depth = 5000;
+
+    TestHierarchy test;
+    std::vector<entt::entity> chain;
+    for(std::size_t i = 0; i < depth; i++) {
+        chain.push_back(test.Add({1.0f, 0.0f, 0.0f}));
+        if(i > 0) {
+            test.Parent(chain[i - 1], chain[i]);
+        }
+    }
+
+    test._hierarchy.Update(test._registry);
+    ASSERT_EQ(test._hierarchy.GetSize(), depth);
+    ExpectPosition(test.GetWorldPosition(chain.back()), {static_cast<float>(depth), 0.0f, 0.0f});
+
+    // Parents come first, the subtree of a node in the middle is the rest of the chain
+    const std::size_t middle = depth / 2;
+    test.Move(chain[middle], {2.0f, 0.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+
+    EXPECT_EQ(test._hierarchy.GetUpdatedEntities().size(), depth - middle);
+    ExpectPosition(test.GetWorldPosition(chain[middle - 1]), {static_cast<float>(middle), 0.0f, 0.0f});
+    ExpectPosition(test.GetWorldPosition(chain.back()), {static_cast<float>(depth + 1), 0.0f, 0.0f});
+
+    test.Move(chain.front(), {0.0f, 0.0f, 0.0f});
+    test._hierarchy.Update(test._registry);
+
+    EXPECT_EQ(test._hierarchy.GetUpdatedEntities().size(), depth);
+    ExpectPosition(test.GetWorldPosition(chain.back()), {static_cast<float>(depth), 0.0f, 0.0f});
+}
+
+TEST(TransformHierarchy, CycleIsReported) {
+    TestHierarchy test;
+    const entt::entity first = test.Add({1.0f, 0.0f, 0.0f});
+    const entt::entity second = test.Add({1.0f, 0.0f, 0.0f});
+    test.Parent(first, second);
+    test.Parent(second, first);
+
+    // Debug builds stop on the assert, release builds break the cycle and still update both transforms
+    EXPECT_DEBUG_DEATH(test._hierarchy.Update(test._registry), "parent cycle");
+
+#ifdef NDEBUG
+    EXPECT_EQ(test._hierarchy.GetSize(), 2);
+    EXPECT_FALSE(std::isnan(test.GetWorldPosition(first).x));
+    EXPECT_FALSE(std::isnan(test.GetWorldPosition(second).x));
+#endif
+}
@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+#include "Core/TransformKernels.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace {
+    TransformSoA MakeTransforms(std::size_t count) {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+        TransformSoA transforms;
+        transforms.Resize(count);
+
+        for(std::size_t i = 0; i < count; i++) {
+            transforms._positionX[i] = distribution(generator) * 100.0f;
+            transforms._positionY[i] = distribution(generator) * 100.0f;
+            transforms._positionZ[i] = distribution(generator) * 100.0f;
+
+            float x = distribution(generator), y = distribution(generator), z = distribution(generator), w = distribution(generator);
+            const float length = std::sqrt(x * x + y * y + z * z + w * w);
+            transforms._rotationX[i] = x / length;
+            transforms._rotationY[i] = y / length;
+            transforms._rotationZ[i] = z / length;
+            transforms._rotationW[i] = w / length;
+
+            transforms._scaleX[i] = 1.0f + distribution(generator) * 0.5f;
+            transforms._scaleY[i] = 1.0f + distribution(generator) * 0.5f;
+            transforms._scaleZ[i] = 1.0f + distribution(generator) * 0.5f;
+        }
+
+        return transforms;
+    }
+
+    std::vector<SimdIsa> GetSupportedIsas() {
+        std::vector<SimdIsa> isas;
+        for(SimdIsa isa : {SimdIsa::Scalar, SimdIsa::SSE, SimdIsa::AVX2, SimdIsa::NEON}) {
+            if(TransformKernels::IsSupported(isa)) {
+                isas.push_back(isa);
+            }
+        }
+
+        return isas;
+    }
+
+    // The composition the kernels stand in for, built with glm
+    glm::mat4 ComposeGlm(const TransformSoA& t, std::size_t i) {
+        const glm::vec3 position(t._positionX[i], t._positionY[i], t._positionZ[i]);
+        const glm::quat rotation(t._rotationW[i], t._rotationX[i], t._rotationY[i], t._rotationZ[i]);
+        const glm::vec3 scale(t._scaleX[i], t._scaleY[i], t._scaleZ[i]);
+        return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+    }
+
+    // Relative to the entry, chained products grow well past the unit range
+    void ExpectMatrix(const float* matrix, const glm::mat4& expected, SimdIsa isa) {
+        for(int i = 0; i < 16; i++) {
+            const float entry = (&expected[0][0])[i];
+            EXPECT_NEAR(matrix[i], entry, 1e-4f * std::max(1.0f, std::abs(entry))) << TransformKernels::GetIsaName(isa) << " entry " << i;
+        }
+    }
+}
+
+TEST(TransformKernels, MatchesScalar) {
+    // Not a multiple of 8 so the scalar tail runs too
+    constexpr std::size_t count = 67;
+    const TransformSoA transforms = MakeTransforms(count);
+
+    std::vector<float> expected(count * 16);
+    TransformKernels::ComposeLocal(SimdIsa::Scalar, transforms, 0, count, expected.data());
+
+    // Rotation and scale only touch the upper 3x3, the last column is the position whatever they are
+    EXPECT_FLOAT_EQ(expected[12], transforms._positionX[0]);
+    EXPECT_FLOAT_EQ(expected[15], 1.0f);
+
+    for(SimdIsa isa : GetSupportedIsas()) {
+        std::vector<float> matrices(count * 16);
+        TransformKernels::ComposeLocal(isa, transforms, 0, count, matrices.data());
+
+        for(std::size_t i = 0; i < matrices.size(); i++) {
+            EXPECT_NEAR(matrices[i], expected[i], 1e-4f) << TransformKernels::GetIsaName(isa) << " entry " << i;
+        }
+
+        std::vector<float> product(16), expectedProduct(16);
+        TransformKernels::MultiplyMatrix(SimdIsa::Scalar, &expected[0], &expected[16], expectedProduct.data());
+        TransformKernels::MultiplyMatrix(isa, &expected[0], &expected[16], product.data());
+
+        for(std::size_t i = 0; i < 16; i++) {
+            EXPECT_NEAR(product[i], expectedProduct[i], 1e-2f) << TransformKernels::GetIsaName(isa) << " entry " << i;
+        }
+    }
+}
+
+TEST(TransformKernels, MatchesGlm) {
+    constexpr std::size_t count = 67;
+    const TransformSoA transforms = MakeTransforms(count);
+
+    for(SimdIsa isa : GetSupportedIsas()) {
+        std::vector<float> matrices(count * 16);
+        TransformKernels::ComposeLocal(isa, transforms, 0, count, matrices.data());
+
+        for(std::size_t i = 0; i < count; i++) {
+            ExpectMatrix(&matrices[i * 16], ComposeGlm(transforms, i), isa);
+        }
+
+        // Parented the way the hierarchy does it, parent world * child local
+        float product[16];
+        TransformKernels::MultiplyMatrix(isa, &matrices[0], &matrices[16], product);
+        ExpectMatrix(product, ComposeGlm(transforms, 0) * ComposeGlm(transforms, 1), isa);
+    }
+}
+
+TEST(TransformKernels, BatchedMultiplyRunsInOrder) {
+    constexpr std::size_t count = 9;
+    const TransformSoA transforms = MakeTransforms(count);
+
+    for(SimdIsa isa : GetSupportedIsas()) {
+        std::vector<float> locals(count * 16);
+        TransformKernels::ComposeLocal(isa, transforms, 0, count, locals.data());
+
+        // A chain, every product reads the world matrix the previous one wrote
+        std::vector<float> worlds(count * 16);
+        std::copy(locals.begin(), locals.begin() + 16, worlds.begin());
+
+        std::vector<const float*> parents, children;
+        std::vector<float*> outputs;
+        for(std::size_t i = 1; i < count; i++) {
+            parents.push_back(&worlds[(i - 1) * 16]);
+            children.push_back(&locals[i * 16]);
+            outputs.push_back(&worlds[i * 16]);
+        }
+        TransformKernels::MultiplyMatrices(isa, parents.data(), children.data(), outputs.data(), outputs.size());
+
+        glm::mat4 expected = ComposeGlm(transforms, 0);
+        for(std::size_t i = 1; i < count; i++) {
+            expected = expected * ComposeGlm(transforms, i);
+            ExpectMatrix(&worlds[i * 16], expected, isa);
+        }
+
+        // In place on the right hand side, as the hierarchy applies imported matrices
+        std::vector<float> inPlace(locals.begin() + 16, locals.begin() + 32);
+        const float* lhs[] = {&locals[0]};
+        float* rhs[] = {inPlace.data()};
+        TransformKernels::MultiplyMatrices(isa, lhs, rhs, rhs, 1);
+        ExpectMatrix(inPlace.data(), ComposeGlm(transforms, 0) * ComposeGlm(transforms, 1), isa);
+    }
+}
+
+// Not a pass/fail test, prints the cost of composing and parenting 100k transforms with every available kernel.
+// Disabled so regular runs stay quiet, run it with --gtest_also_run_disabled_tests
+TEST(TransformKernels, DISABLED_Benchmark100k) {
+    constexpr std::size_t count = 100000;
+    constexpr int iterations = 10;
+    const TransformSoA transforms = MakeTransforms(count);
+
+    std::vector<float> locals(count * 16);
+    std::vector<float> worlds(count * 16);
+
+    for(SimdIsa isa : GetSupportedIsas()) {
+        const auto start = std::chrono::steady_clock::now();
+
+        for(int iteration = 0; iteration < iterations; iteration++) {
+            TransformKernels::ComposeLocal(isa, transforms, 0, count, locals.data());
+
+            // Every transform parented to the previous one, the multiply runs in hierarchy order
+            std::memcpy(worlds.data(), locals.data(), 16 * sizeof(float));
+            for(std::size_t i = 1; i < count; i++) {
+                TransformKernels::MultiplyMatrix(isa, &worlds[(i - 1) * 16], &locals[i * 16], &worlds[i * 16]);
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+        std::cout << "[ BENCH    ] " << TransformKernels::GetIsaName(isa) << ": " << elapsed << " ms per 100k transforms" << std::endl;
+        RecordProperty(TransformKernels::GetIsaName(isa), std::to_string(elapsed));
+    }
+
+    SUCCEED();
+}